@@ -1,158 +1,188 @@
-include(CMakeParseArguments)
-
-# add a new target which is a SFML3D library
-# ex: sfml_add_library(sfml3d-graphics
-#                      SOURCES sprite.cpp image.cpp ...
-#                      DEPENDS sfml3d-window sfml3d-system
-#                      EXTERNAL_LIBS opengl freetype ...)
-macro(sfml3d_add_library target)
-
-    # parse the arguments
-    cmake_parse_arguments(THIS "" "" "SOURCES;DEPENDS;EXTERNAL_LIBS" ${ARGN})
-
-    # create the target
-    add_library(${target} ${THIS_SOURCES})
-
-    # define the export symbol of the module
-    string(REPLACE "-" "_" NAME_UPPER "${target}")
-    string(TOUPPER "${NAME_UPPER}" NAME_UPPER)
-    set_target_properties(${target} PROPERTIES DEFINE_SYMBOL ${NAME_UPPER}_EXPORTS)
-
-    # adjust the output file prefix/suffix to match our conventions
-    if(BUILD_SHARED_LIBS)
-        if(SFML3D_OS_WINDOWS)
-            # include the major version number in Windows shared library names (but not import library names)
-            set_target_properties(${target} PROPERTIES DEBUG_POSTFIX -d)
-            set_target_properties(${target} PROPERTIES SUFFIX "-${VERSION_MAJOR}${CMAKE_SHARED_LIBRARY_SUFFIX}")
-        else()
-            set_target_properties(${target} PROPERTIES DEBUG_POSTFIX -d)
-        endif()
-        if (SFML3D_OS_WINDOWS AND SFML3D_COMPILER_GCC)
-            # on Windows/gcc get rid of "lib" prefix for shared libraries,
-            # and transform the ".dll.a" suffix into ".a" for import libraries
-            set_target_properties(${target} PROPERTIES PREFIX "")
-            set_target_properties(${target} PROPERTIES IMPORT_SUFFIX ".a")
-        endif()
-    else()
-        set_target_properties(${target} PROPERTIES DEBUG_POSTFIX -s-d)
-        set_target_properties(${target} PROPERTIES RELEASE_POSTFIX -s)
-        set_target_properties(${target} PROPERTIES MINSIZEREL_POSTFIX -s)
-    endif()
-
-    # set the version and soversion of the target (for compatible systems -- mostly Linuxes)
-    set_target_properties(${target} PROPERTIES SOVERSION ${VERSION_MAJOR})
-    set_target_properties(${target} PROPERTIES VERSION ${VERSION_MAJOR}.${VERSION_MINOR})
-
-    # set the target's folder (for IDEs that support it, e.g. Visual Studio)
-    set_target_properties(${target} PROPERTIES FOLDER "SFML3D")
-
-    # for gcc >= 4.0 on Windows, apply the SFML3D_USE_STATIC_STD_LIBS option if it is enabled
-    if(SFML3D_OS_WINDOWS AND SFML3D_COMPILER_GCC AND NOT SFML3D_GCC_VERSION VERSION_LESS "4")
-        if(SFML3D_USE_STATIC_STD_LIBS AND NOT SFML3D_COMPILER_GCC_TDM)
-            set_target_properties(${target} PROPERTIES LINK_FLAGS "-static-libgcc -static-libstdc++")
-        elseif(NOT SFML3D_USE_STATIC_STD_LIBS AND SFML3D_COMPILER_GCC_TDM)
-            set_target_properties(${target} PROPERTIES LINK_FLAGS "-shared-libgcc -shared-libstdc++")
-        endif()
-    endif()
-
-    # if using gcc >= 4.0 or clang >= 3.0 on a non-Windows platform, we must hide public symbols by default
-    # (exported ones are explicitely marked)
-    if(NOT SFML3D_OS_WINDOWS AND ((SFML3D_COMPILER_GCC AND NOT SFML3D_GCC_VERSION VERSION_LESS "4") OR (SFML3D_COMPILER_CLANG AND NOT SFML3D_CLANG_VERSION VERSION_LESS "3")))
-        set_target_properties(${target} PROPERTIES COMPILE_FLAGS -fvisibility=hidden)
-    endif()
-
-    # link the target to its SFML3D dependencies
-    if(THIS_DEPENDS)
-        target_link_libraries(${target} ${THIS_DEPENDS})
-    endif()
-
-    # build frameworks or dylibs
-    if(SFML3D_OS_MACOSX AND BUILD_SHARED_LIBS)
-        if(SFML3D_BUILD_FRAMEWORKS)
-            # adapt target to build frameworks instead of dylibs
-            set_target_properties(${target} PROPERTIES 
-                                  FRAMEWORK TRUE
-                                  FRAMEWORK_VERSION ${VERSION_MAJOR}.${VERSION_MINOR}.${VERSION_PATCH}
-                                  MACOSX_FRAMEWORK_IDENTIFIER org.sfml-dev.${target}
-                                  MACOSX_FRAMEWORK_SHORT_VERSION_STRING ${VERSION_MAJOR}.${VERSION_MINOR}.${VERSION_PATCH}
-                                  MACOSX_FRAMEWORK_BUNDLE_VERSION ${VERSION_MAJOR}.${VERSION_MINOR}.${VERSION_PATCH})
-        endif()
-        
-        # adapt install directory to allow distributing dylibs/frameworks in user’s frameworks/application bundle
-        set_target_properties(${target} PROPERTIES 
-                              BUILD_WITH_INSTALL_RPATH 1 
-                              INSTALL_NAME_DIR "@executable_path/../Frameworks")
-    endif()
-
-    # link the target to its external dependencies
-    if(THIS_EXTERNAL_LIBS)
-        target_link_libraries(${target} ${THIS_EXTERNAL_LIBS})
-    endif()
-
-    # add the install rule
-    install(TARGETS ${target}
-            RUNTIME DESTINATION bin COMPONENT bin
-            LIBRARY DESTINATION lib${LIB_SUFFIX} COMPONENT bin 
-            ARCHIVE DESTINATION lib${LIB_SUFFIX} COMPONENT devel
-            FRAMEWORK DESTINATION ${CMAKE_INSTALL_FRAMEWORK_PREFIX} COMPONENT bin)
-
-endmacro()
-
-# add a new target which is a SFML3D example
-# ex: sfml_add_example(ftp
-#                      SOURCES ftp.cpp ...
-#                      DEPENDS sfml-network sfml-system)
-macro(sfml_add_example target)
-
-    # parse the arguments
-    cmake_parse_arguments(THIS "GUI_APP" "" "SOURCES;DEPENDS" ${ARGN})
-
-    # set a source group for the source files
-    source_group("" FILES ${THIS_SOURCES})
-
-    # create the target
-    if(THIS_GUI_APP AND SFML3D_OS_WINDOWS)
-        add_executable(${target} WIN32 ${THIS_SOURCES})
-        target_link_libraries(${target} sfml-main)
-    else()
-        add_executable(${target} ${THIS_SOURCES})
-    endif()
-
-    # set the debug suffix
-    set_target_properties(${target} PROPERTIES DEBUG_POSTFIX -d)
-
-    # set the target's folder (for IDEs that support it, e.g. Visual Studio)
-    set_target_properties(${target} PROPERTIES FOLDER "Examples")
-
-    # for gcc >= 4.0 on Windows, apply the SFML3D_USE_STATIC_STD_LIBS option if it is enabled
-    if(SFML3D_OS_WINDOWS AND SFML3D_COMPILER_GCC AND NOT SFML3D_GCC_VERSION VERSION_LESS "4")
-        if(SFML3D_USE_STATIC_STD_LIBS AND NOT SFML3D_COMPILER_GCC_TDM)
-            set_target_properties(${target} PROPERTIES LINK_FLAGS "-static-libgcc -static-libstdc++")
-        elseif(NOT SFML3D_USE_STATIC_STD_LIBS AND SFML3D_COMPILER_GCC_TDM)
-            set_target_properties(${target} PROPERTIES LINK_FLAGS "-shared-libgcc -shared-libstdc++")
-        endif()
-    endif()
-
-    # link the target to its SFML3D dependencies
-    if(THIS_DEPENDS)
-        target_link_libraries(${target} ${THIS_DEPENDS})
-    endif()
-
-    # add the install rule
-    install(TARGETS ${target}
-            RUNTIME DESTINATION ${INSTALL_MISC_DIR}/examples/${target} COMPONENT examples)
-
-    # install the example's source code
-    install(FILES ${THIS_SOURCES}
-            DESTINATION ${INSTALL_MISC_DIR}/examples/${target}
-            COMPONENT examples)
-
-    # install the example's resources as well
-    set(EXAMPLE_RESOURCES "${CMAKE_SOURCE_DIR}/examples/${target}/resources")
-    if(EXISTS ${EXAMPLE_RESOURCES})
-        install(DIRECTORY ${EXAMPLE_RESOURCES}
-                DESTINATION ${INSTALL_MISC_DIR}/examples/${target}
-                COMPONENT examples)
-    endif()
-
-endmacro()
+include(CMakeParseArguments)
+
+# add a new target which is a SFML3D library
+# ex: sfml_add_library(sfml3d-graphics
+#                      SOURCES sprite.cpp image.cpp ...
+#                      DEPENDS sfml3d-window sfml3d-system
+#                      EXTERNAL_LIBS opengl freetype ...)
+macro(sfml3d_add_library target)
+
+    # parse the arguments
+    cmake_parse_arguments(THIS "" "" "SOURCES;DEPENDS;EXTERNAL_LIBS" ${ARGN})
+
+    # create the target
+    add_library(${target} ${THIS_SOURCES})
+
+    # define the export symbol of the module
+    string(REPLACE "-" "_" NAME_UPPER "${target}")
+    string(TOUPPER "${NAME_UPPER}" NAME_UPPER)
+    set_target_properties(${target} PROPERTIES DEFINE_SYMBOL ${NAME_UPPER}_EXPORTS)
+
+    # adjust the output file prefix/suffix to match our conventions
+    if(BUILD_SHARED_LIBS)
+        if(SFML3D_OS_WINDOWS)
+            # include the major version number in Windows shared library names (but not import library names)
+            set_target_properties(${target} PROPERTIES DEBUG_POSTFIX -d)
+            set_target_properties(${target} PROPERTIES SUFFIX "-${VERSION_MAJOR}${CMAKE_SHARED_LIBRARY_SUFFIX}")
+        else()
+            set_target_properties(${target} PROPERTIES DEBUG_POSTFIX -d)
+        endif()
+        if (SFML3D_OS_WINDOWS AND SFML3D_COMPILER_GCC)
+            # on Windows/gcc get rid of "lib" prefix for shared libraries,
+            # and transform the ".dll.a" suffix into ".a" for import libraries
+            set_target_properties(${target} PROPERTIES PREFIX "")
+            set_target_properties(${target} PROPERTIES IMPORT_SUFFIX ".a")
+        endif()
+    else()
+        set_target_properties(${target} PROPERTIES DEBUG_POSTFIX -s-d)
+        set_target_properties(${target} PROPERTIES RELEASE_POSTFIX -s)
+        set_target_properties(${target} PROPERTIES MINSIZEREL_POSTFIX -s)
+    endif()
+
+    # set the version and soversion of the target (for compatible systems -- mostly Linuxes)
+    set_target_properties(${target} PROPERTIES SOVERSION ${VERSION_MAJOR})
+    set_target_properties(${target} PROPERTIES VERSION ${VERSION_MAJOR}.${VERSION_MINOR})
+
+    # set the target's folder (for IDEs that support it, e.g. Visual Studio)
+    set_target_properties(${target} PROPERTIES FOLDER "SFML3D")
+
+    # for gcc >= 4.0 on Windows, apply the SFML3D_USE_STATIC_STD_LIBS option if it is enabled
+    if(SFML3D_OS_WINDOWS AND SFML3D_COMPILER_GCC AND NOT SFML3D_GCC_VERSION VERSION_LESS "4")
+        if(SFML3D_USE_STATIC_STD_LIBS AND NOT SFML3D_COMPILER_GCC_TDM)
+            set_target_properties(${target} PROPERTIES LINK_FLAGS "-static-libgcc -static-libstdc++")
+        elseif(NOT SFML3D_USE_STATIC_STD_LIBS AND SFML3D_COMPILER_GCC_TDM)
+            set_target_properties(${target} PROPERTIES LINK_FLAGS "-shared-libgcc -shared-libstdc++")
+        endif()
+    endif()
+
+    # if using gcc >= 4.0 or clang >= 3.0 on a non-Windows platform, we must hide public symbols by default
+    # (exported ones are explicitely marked)
+    if(NOT SFML3D_OS_WINDOWS AND ((SFML3D_COMPILER_GCC AND NOT SFML3D_GCC_VERSION VERSION_LESS "4") OR (SFML3D_COMPILER_CLANG AND NOT SFML3D_CLANG_VERSION VERSION_LESS "3")))
+        set_target_properties(${target} PROPERTIES COMPILE_FLAGS -fvisibility=hidden)
+    endif()
+
+    # link the target to its SFML3D dependencies
+    if(THIS_DEPENDS)
+        target_link_libraries(${target} ${THIS_DEPENDS})
+    endif()
+
+    # build frameworks or dylibs
+    if(SFML3D_OS_MACOSX AND BUILD_SHARED_LIBS)
+        if(SFML3D_BUILD_FRAMEWORKS)
+            # adapt target to build frameworks instead of dylibs
+            set_target_properties(${target} PROPERTIES 
+                                  FRAMEWORK TRUE
+                                  FRAMEWORK_VERSION ${VERSION_MAJOR}.${VERSION_MINOR}.${VERSION_PATCH}
+                                  MACOSX_FRAMEWORK_IDENTIFIER org.sfml-dev.${target}
+                                  MACOSX_FRAMEWORK_SHORT_VERSION_STRING ${VERSION_MAJOR}.${VERSION_MINOR}.${VERSION_PATCH}
+                                  MACOSX_FRAMEWORK_BUNDLE_VERSION ${VERSION_MAJOR}.${VERSION_MINOR}.${VERSION_PATCH})
+        endif()
+        
+        # adapt install directory to allow distributing dylibs/frameworks in user’s frameworks/application bundle
+        set_target_properties(${target} PROPERTIES 
+                              BUILD_WITH_INSTALL_RPATH 1 
+                              INSTALL_NAME_DIR "@executable_path/../Frameworks")
+    endif()
+
+    # link the target to its external dependencies
+    if(THIS_EXTERNAL_LIBS)
+        target_link_libraries(${target} ${THIS_EXTERNAL_LIBS})
+    endif()
+
+    # add the install rule
+    install(TARGETS ${target}
+            RUNTIME DESTINATION bin COMPONENT bin
+            LIBRARY DESTINATION lib${LIB_SUFFIX} COMPONENT bin 
+            ARCHIVE DESTINATION lib${LIB_SUFFIX} COMPONENT devel
+            FRAMEWORK DESTINATION ${CMAKE_INSTALL_FRAMEWORK_PREFIX} COMPONENT bin)
+
+endmacro()
+
+# add a new target which is a SFML3D example
+# ex: sfml3d_add_example(ftp
+#                      SOURCES ftp.cpp ...
+#                      DEPENDS sfml3d-network sfml3d-system)
+macro(sfml3d_add_example target)
+
+    # parse the arguments
+    cmake_parse_arguments(THIS "GUI_APP" "" "SOURCES;DEPENDS" ${ARGN})
+
+    # set a source group for the source files
+    source_group("" FILES ${THIS_SOURCES})
+
+    # create the target
+    if(THIS_GUI_APP AND SFML3D_OS_WINDOWS)
+        add_executable(${target} WIN32 ${THIS_SOURCES})
+        target_link_libraries(${target} sfml-main)
+    else()
+        add_executable(${target} ${THIS_SOURCES})
+    endif()
+
+    # set the debug suffix
+    set_target_properties(${target} PROPERTIES DEBUG_POSTFIX -d)
+
+    # set the target's folder (for IDEs that support it, e.g. Visual Studio)
+    set_target_properties(${target} PROPERTIES FOLDER "Examples")
+
+    # for gcc >= 4.0 on Windows, apply the SFML3D_USE_STATIC_STD_LIBS option if it is enabled
+    if(SFML3D_OS_WINDOWS AND SFML3D_COMPILER_GCC AND NOT SFML3D_GCC_VERSION VERSION_LESS "4")
+        if(SFML3D_USE_STATIC_STD_LIBS AND NOT SFML3D_COMPILER_GCC_TDM)
+            set_target_properties(${target} PROPERTIES LINK_FLAGS "-static-libgcc -static-libstdc++")
+        elseif(NOT SFML3D_USE_STATIC_STD_LIBS AND SFML3D_COMPILER_GCC_TDM)
+            set_target_properties(${target} PROPERTIES LINK_FLAGS "-shared-libgcc -shared-libstdc++")
+        endif()
+    endif()
+
+    # link the target to its SFML3D dependencies
+    if(THIS_DEPENDS)
+        target_link_libraries(${target} ${THIS_DEPENDS})
+    endif()
+
+    # add the install rule
+    install(TARGETS ${target}
+            RUNTIME DESTINATION ${INSTALL_MISC_DIR}/examples/${target} COMPONENT examples)
+
+    # install the example's source code
+    install(FILES ${THIS_SOURCES}
+            DESTINATION ${INSTALL_MISC_DIR}/examples/${target}
+            COMPONENT examples)
+
+    # install the example's resources as well
+    set(EXAMPLE_RESOURCES "${CMAKE_SOURCE_DIR}/examples/${target}/resources")
+    if(EXISTS ${EXAMPLE_RESOURCES})
+        install(DIRECTORY ${EXAMPLE_RESOURCES}
+                DESTINATION ${INSTALL_MISC_DIR}/examples/${target}
+                COMPONENT examples)
+    endif()
+
+endmacro()
+
+# add a new target which is a SFML3D test, and register it with CTest
+# ex: sfml3d_add_test(test-image-kernels
+#                     SOURCES ImageKernels.cpp ${PROJECT_SOURCE_DIR}/src/SFML3D/Graphics/ImageKernels.cpp)
+macro(sfml3d_add_test target)
+
+    # parse the arguments
+    cmake_parse_arguments(THIS "" "" "SOURCES;DEPENDS" ${ARGN})
+
+    # set a source group for the source files
+    source_group("" FILES ${THIS_SOURCES})
+
+    # create the target
+    add_executable(${target} ${THIS_SOURCES})
+
+    # set the debug suffix
+    set_target_properties(${target} PROPERTIES DEBUG_POSTFIX -d)
+
+    # set the target's folder (for IDEs that support it, e.g. Visual Studio)
+    set_target_properties(${target} PROPERTIES FOLDER "Tests")
+
+    # link the target to its SFML3D dependencies
+    if(THIS_DEPENDS)
+        target_link_libraries(${target} ${THIS_DEPENDS})
+    endif()
+
+    # run it with CTest; a non-zero exit code is a failure
+    add_test(NAME ${target} COMMAND ${target})
+
+endmacro()
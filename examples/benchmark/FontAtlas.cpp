@@ -0,0 +1,184 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/Graphics.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+
+////////////////////////////////////////////////////////////
+/// Row allocator that font pages used before the skyline,
+/// replayed on the glyph sizes to compare the occupancy
+///
+////////////////////////////////////////////////////////////
+class RowPacker
+{
+public :
+
+    RowPacker() :
+    m_width  (128),
+    m_height (128),
+    m_nextRow(3)
+    {
+    }
+
+    // Place a glyph, returns true if the page had to grow
+    bool insert(unsigned int width, unsigned int height)
+    {
+        // Find the row that fits the glyph best
+        Row* row = NULL;
+        float bestRatio = 0;
+        for (std::vector<Row>::iterator it = m_rows.begin(); it != m_rows.end() && !row; ++it)
+        {
+            float ratio = static_cast<float>(height) / it->height;
+            if ((ratio < 0.7f) || (ratio > 1.f) || (width > m_width - it->width) || (ratio < bestRatio))
+                continue;
+
+            row = &*it;
+            bestRatio = ratio;
+        }
+
+        // Otherwise create a new row, 10% taller than the glyph
+        bool grown = false;
+        if (!row)
+        {
+            unsigned int rowHeight = height + height / 10;
+            while (m_nextRow + rowHeight >= m_height)
+            {
+                m_width *= 2;
+                m_height *= 2;
+                grown = true;
+            }
+
+            Row newRow = {0, m_nextRow, rowHeight};
+            m_rows.push_back(newRow);
+            m_nextRow += rowHeight;
+            row = &m_rows.back();
+        }
+
+        row->width += width;
+        return grown;
+    }
+
+    sf3d::Vector2u getSize() const
+    {
+        return sf3d::Vector2u(m_width, m_height);
+    }
+
+private :
+
+    struct Row
+    {
+        unsigned int width;
+        unsigned int top;
+        unsigned int height;
+    };
+
+    unsigned int     m_width;
+    unsigned int     m_height;
+    unsigned int     m_nextRow;
+    std::vector<Row> m_rows;
+};
+
+
+////////////////////////////////////////////////////////////
+/// Time the growth the row allocator used: a readback, a
+/// copy into a larger image and a full upload
+///
+////////////////////////////////////////////////////////////
+float timeReadbackGrowth(unsigned int width, unsigned int height)
+{
+    sf3d::Texture texture;
+    texture.create(width / 2, height / 2);
+
+    sf3d::Clock clock;
+    sf3d::Image image;
+    image.create(width, height, sf3d::Color(255, 255, 255, 0));
+    image.copy(texture.copyToImage(), 0, 0);
+    texture.loadFromImage(image);
+
+    return clock.getElapsedTime().asSeconds();
+}
+
+
+////////////////////////////////////////////////////////////
+/// Entry point of application
+///
+/// \param argc Number of arguments
+/// \param argv Arguments, the first one may be the font to use
+///
+/// \return Application exit code
+///
+////////////////////////////////////////////////////////////
+int main(int argc, char* argv[])
+{
+    sf3d::Font font;
+    if (!font.loadFromFile((argc > 1) ? argv[1] : "resources/sansation.ttf"))
+        return EXIT_FAILURE;
+
+    double glyphArea = 0.0;
+    double skylineArea = 0.0;
+    double rowArea = 0.0;
+    unsigned int skylineGrowths = 0;
+    unsigned int rowGrowths = 0;
+    float skylineGrowthTime = 0.f;
+    float rowGrowthTime = 0.f;
+    float skylineWorst = 0.f;
+    float rowWorst = 0.f;
+
+    // Printable ASCII characters, regular and bold, at 20 sizes
+    for (unsigned int characterSize = 8; characterSize < 88; characterSize += 4)
+    {
+        RowPacker rows;
+
+        for (int bold = 0; bold < 2; ++bold)
+        {
+            for (sf3d::Uint32 codePoint = 32; codePoint < 127; ++codePoint)
+            {
+                sf3d::Vector2u before = font.getTexture(characterSize).getSize();
+
+                sf3d::Clock clock;
+                const sf3d::Glyph& glyph = font.getGlyph(codePoint, characterSize, bold != 0);
+                float elapsed = clock.getElapsedTime().asSeconds();
+
+                // Glyphs that grew the page measure the growth latency
+                if (font.getTexture(characterSize).getSize() != before)
+                {
+                    skylineGrowths++;
+                    skylineGrowthTime += elapsed;
+                    skylineWorst = std::max(skylineWorst, elapsed);
+                }
+
+                unsigned int width = glyph.textureRect.width;
+                unsigned int height = glyph.textureRect.height;
+                glyphArea += width * height;
+
+                if (width && height && rows.insert(width, height))
+                {
+                    sf3d::Vector2u size = rows.getSize();
+                    float growth = timeReadbackGrowth(size.x, size.y);
+                    rowGrowths++;
+                    rowGrowthTime += growth;
+                    rowWorst = std::max(rowWorst, growth);
+                }
+            }
+        }
+
+        sf3d::Vector2u skylineSize = font.getTexture(characterSize).getSize();
+        sf3d::Vector2u rowSize = rows.getSize();
+        skylineArea += skylineSize.x * skylineSize.y;
+        rowArea += rowSize.x * rowSize.y;
+    }
+
+    std::cout << "Font pages, 2 x 95 glyphs at 20 sizes" << std::endl;
+    std::cout << "  skyline on the GPU : " << glyphArea * 100.0 / skylineArea << "% occupancy, "
+              << skylineGrowths << " growths, " << (skylineGrowths ? skylineGrowthTime * 1000.f / skylineGrowths : 0.f)
+              << " ms on average, " << skylineWorst * 1000.f << " ms at most" << std::endl;
+    std::cout << "  rows with readback : " << glyphArea * 100.0 / rowArea << "% occupancy, "
+              << rowGrowths << " growths, " << (rowGrowths ? rowGrowthTime * 1000.f / rowGrowths : 0.f)
+              << " ms on average, " << rowWorst * 1000.f << " ms at most" << std::endl;
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,81 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/Graphics.hpp>
+#include <cstdlib>
+#include <iostream>
+
+
+////////////////////////////////////////////////////////////
+/// Lay out the same text at 20 sizes with a new font, and
+/// print the layout time and the memory of the glyph textures
+///
+////////////////////////////////////////////////////////////
+bool run(const char* filename, bool distanceField)
+{
+    const sf3d::String string = "The quick brown fox jumps over the lazy dog. 0123456789 !?%&()[]";
+
+    sf3d::Font font;
+    if (!font.loadFromFile(filename))
+        return false;
+
+    // The first layout at every size rasterizes the glyphs
+    sf3d::Clock clock;
+    for (unsigned int i = 0; i < 20; ++i)
+    {
+        sf3d::Text text(string, font, 8 + i * 4);
+        text.setDistanceField(distanceField);
+        text.getLocalBounds();
+    }
+
+    float elapsed = clock.getElapsedTime().asSeconds();
+
+    // Glyph textures are RGBA
+    std::size_t bytes = 0;
+    if (distanceField)
+    {
+        sf3d::Vector2u size = font.getDistanceFieldTexture().getSize();
+        bytes = size.x * size.y * 4;
+    }
+    else
+    {
+        for (unsigned int i = 0; i < 20; ++i)
+        {
+            sf3d::Vector2u size = font.getTexture(8 + i * 4).getSize();
+            bytes += size.x * size.y * 4;
+        }
+    }
+
+    std::cout << "  " << (distanceField ? "distance field" : "bitmaps       ") << ": "
+              << elapsed * 1000.f << " ms for the first layout, "
+              << bytes / 1024 << " KB of glyph textures" << std::endl;
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Entry point of application
+///
+/// \param argc Number of arguments
+/// \param argv Arguments, the first one may be the font to use
+///
+/// \return Application exit code
+///
+////////////////////////////////////////////////////////////
+int main(int argc, char* argv[])
+{
+    const char* filename = (argc > 1) ? argv[1] : "resources/sansation.ttf";
+
+    std::cout << "Glyph cache, 20 character sizes from 8 to 84" << std::endl;
+
+    if (!run(filename, false))
+        return EXIT_FAILURE;
+
+    if (sf3d::Text::isDistanceFieldAvailable())
+        run(filename, true);
+    else
+        std::cout << "  distance field: not available, the non-legacy pipeline is required" << std::endl;
+
+    return EXIT_SUCCESS;
+}
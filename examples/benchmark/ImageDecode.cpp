@@ -0,0 +1,81 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/Graphics.hpp>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+
+////////////////////////////////////////////////////////////
+/// Upload images to textures, and return the elapsed time
+///
+////////////////////////////////////////////////////////////
+float upload(const std::vector<sf3d::Image>& images)
+{
+    sf3d::Clock clock;
+
+    std::vector<sf3d::Texture> textures(images.size());
+    for (std::size_t i = 0; i < images.size(); ++i)
+        textures[i].loadFromImage(images[i]);
+
+    return clock.getElapsedTime().asSeconds();
+}
+
+
+////////////////////////////////////////////////////////////
+/// Entry point of application
+///
+/// \param argc Number of arguments
+/// \param argv Arguments, the image files to load
+///
+/// \return Application exit code
+///
+////////////////////////////////////////////////////////////
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        std::cout << "Usage: " << argv[0] << " <image files...>" << std::endl;
+        std::cout << "For example: " << argv[0] << " assets/*.png assets/*.jpg" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::vector<std::string> filenames(argv + 1, argv + argc);
+
+    // The first pass brings the files into the system cache, so that both paths read from memory
+    std::vector<sf3d::Image> images;
+    sf3d::Image::loadMany(filenames, images);
+
+    std::size_t bytes = 0;
+    for (std::size_t i = 0; i < images.size(); ++i)
+        bytes += images[i].getSize().x * images[i].getSize().y * 4;
+
+    std::cout << "Image decoding, " << filenames.size() << " files, "
+              << bytes / (1024 * 1024) << " MB of pixels" << std::endl;
+
+    // One file after the other
+    sf3d::Clock clock;
+    std::vector<sf3d::Image> sequential(filenames.size());
+    for (std::size_t i = 0; i < filenames.size(); ++i)
+        sequential[i].loadFromFile(filenames[i]);
+
+    float decode = clock.getElapsedTime().asSeconds();
+    float total = decode + upload(sequential);
+    std::cout << "  loadFromFile loop : decode " << decode * 1000.f << " ms, "
+              << "decode and upload " << total * 1000.f << " ms" << std::endl;
+
+    // All the files at once, on every processor
+    clock.restart();
+    std::vector<sf3d::Image> parallel;
+    std::size_t loaded = sf3d::Image::loadMany(filenames, parallel);
+
+    decode = clock.getElapsedTime().asSeconds();
+    total = decode + upload(parallel);
+    std::cout << "  loadMany          : decode " << decode * 1000.f << " ms, "
+              << "decode and upload " << total * 1000.f << " ms ("
+              << loaded << " images loaded)" << std::endl;
+
+    return EXIT_SUCCESS;
+}
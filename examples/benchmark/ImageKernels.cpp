@@ -0,0 +1,140 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/System.hpp>
+#include <SFML3D/Graphics/ImageKernels.hpp>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+
+namespace
+{
+    const unsigned int width = 1920;
+    const unsigned int height = 1080;
+    const std::size_t count = width * height;
+
+    std::vector<sf3d::Uint8> pixels;
+    std::vector<sf3d::Uint8> other;
+    std::vector<sf3d::Uint8> output;
+
+    void maskColor()
+    {
+        const sf3d::Uint8 color[4] = {255, 0, 255, 255};
+        sf3d::priv::maskColor(&pixels[0], count, color, 0);
+    }
+
+    void blendPixels()
+    {
+        sf3d::priv::blendPixels(&other[0], &pixels[0], count);
+    }
+
+    void premultiplyAlpha()
+    {
+        sf3d::priv::premultiplyAlpha(&pixels[0], count);
+    }
+
+    void reversePixels()
+    {
+        sf3d::priv::reversePixels(&pixels[0], count);
+    }
+
+    void swapPixels()
+    {
+        sf3d::priv::swapPixels(&pixels[0], &other[0], count);
+    }
+
+    void downsampleBox()
+    {
+        sf3d::priv::downsampleBox(&pixels[0], width, height, &output[0]);
+    }
+
+    void resizeBilinearDown()
+    {
+        sf3d::priv::resizeBilinear(&pixels[0], width, height, &output[0], width * 2 / 3, height * 2 / 3);
+    }
+
+    void resizeBilinearUp()
+    {
+        sf3d::priv::resizeBilinear(&other[0], width * 2 / 3, height * 2 / 3, &pixels[0], width, height);
+    }
+
+    void resizeBox()
+    {
+        sf3d::priv::resizeBox(&pixels[0], width, height, &output[0], width / 3, height / 3);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+/// Run a kernel for about a second, and return the number
+/// of source pixels processed per second
+///
+////////////////////////////////////////////////////////////
+double measure(void (*kernel)(), bool simd)
+{
+    sf3d::priv::setSimdEnabled(simd);
+
+    unsigned int runs = 0;
+    sf3d::Clock clock;
+    do
+    {
+        kernel();
+        ++runs;
+    }
+    while (clock.getElapsedTime() < sf3d::seconds(1.f));
+
+    return static_cast<double>(count) * runs / clock.getElapsedTime().asSeconds();
+}
+
+
+////////////////////////////////////////////////////////////
+/// Entry point of application
+///
+/// \return Application exit code
+///
+////////////////////////////////////////////////////////////
+int main()
+{
+    pixels.resize(count * 4);
+    other.resize(count * 4);
+    output.resize(count * 4);
+    for (std::size_t i = 0; i < pixels.size(); ++i)
+    {
+        pixels[i] = static_cast<sf3d::Uint8>(std::rand());
+        other[i] = static_cast<sf3d::Uint8>(std::rand());
+    }
+
+    struct Kernel
+    {
+        const char* name;
+        void (*function)();
+    };
+    const Kernel kernels[] =
+    {
+        {"maskColor           ", maskColor},
+        {"blendPixels         ", blendPixels},
+        {"premultiplyAlpha    ", premultiplyAlpha},
+        {"reversePixels       ", reversePixels},
+        {"swapPixels          ", swapPixels},
+        {"downsampleBox       ", downsampleBox},
+        {"resizeBilinear 2/3  ", resizeBilinearDown},
+        {"resizeBilinear 3/2  ", resizeBilinearUp},
+        {"resizeBox 1/3       ", resizeBox}
+    };
+
+    std::cout << width << "x" << height << " RGBA, MPixel/s of the full-size image with and without SIMD" << std::endl;
+    for (std::size_t i = 0; i < sizeof(kernels) / sizeof(kernels[0]); ++i)
+    {
+        double simd = measure(kernels[i].function, true);
+        double scalar = measure(kernels[i].function, false);
+
+        std::cout << "  " << kernels[i].name << ": "
+                  << simd / 1000000.0 << " / " << scalar / 1000000.0 << " MPixel/s, x"
+                  << simd / scalar << std::endl;
+    }
+
+    sf3d::priv::setSimdEnabled(true);
+
+    return EXIT_SUCCESS;
+}
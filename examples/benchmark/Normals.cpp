@@ -0,0 +1,70 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/Graphics.hpp>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+
+////////////////////////////////////////////////////////////
+/// Wavy grid, with the faces expanded like an imported mesh
+///
+////////////////////////////////////////////////////////////
+class Surface : public sf3d::Model
+{
+public :
+
+    void build(unsigned int size)
+    {
+        for (unsigned int y = 0; y <= size; ++y)
+        {
+            for (unsigned int x = 0; x <= size; ++x)
+            {
+                float height = std::sin(x * 0.05f) * std::cos(y * 0.05f) * 4.f;
+                addVertex(sf3d::Vertex(sf3d::Vector3f(static_cast<float>(x), height, static_cast<float>(y))));
+            }
+        }
+
+        for (unsigned int y = 0; y < size; ++y)
+        {
+            for (unsigned int x = 0; x < size; ++x)
+            {
+                unsigned int a = y * (size + 1) + x;
+                unsigned int b = a + size + 1;
+                addFace(a, b, a + 1);
+                addFace(a + 1, b, b + 1);
+            }
+        }
+
+        update();
+    }
+};
+
+
+////////////////////////////////////////////////////////////
+/// Entry point of application
+///
+/// \return Application exit code
+///
+////////////////////////////////////////////////////////////
+int main()
+{
+    // 708 x 708 quads, a bit more than a million triangles
+    Surface surface;
+    surface.build(708);
+
+    std::cout << "Normal generation, " << surface.getFaceCount() << " triangles" << std::endl;
+
+    sf3d::Clock clock;
+    surface.generateNormals();
+    std::cout << "  flat normals                  : " << clock.restart().asMilliseconds() << " ms" << std::endl;
+
+    surface.generateSmoothNormals();
+    std::cout << "  smooth normals                : " << clock.restart().asMilliseconds() << " ms" << std::endl;
+
+    surface.generateSmoothNormals(30.f);
+    std::cout << "  smooth normals, 30 deg crease : " << clock.restart().asMilliseconds() << " ms" << std::endl;
+
+    return EXIT_SUCCESS;
+}
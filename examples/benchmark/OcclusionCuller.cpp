@@ -0,0 +1,152 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/Graphics.hpp>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+
+////////////////////////////////////////////////////////////
+/// Hilly ground under the city, a single occluder made of
+/// many small triangles
+///
+////////////////////////////////////////////////////////////
+class Ground : public sf3d::Model
+{
+public :
+
+    void build(unsigned int size, float spacing)
+    {
+        float offset = size * spacing / 2.f;
+        for (unsigned int z = 0; z <= size; ++z)
+        {
+            for (unsigned int x = 0; x <= size; ++x)
+            {
+                float height = std::sin(x * 0.1f) * std::cos(z * 0.1f) * 3.f - 3.f;
+                addVertex(sf3d::Vertex(sf3d::Vector3f(x * spacing - offset, height, -(z * spacing))));
+            }
+        }
+
+        for (unsigned int z = 0; z < size; ++z)
+        {
+            for (unsigned int x = 0; x < size; ++x)
+            {
+                unsigned int a = z * (size + 1) + x;
+                unsigned int b = a + size + 1;
+                addFace(a, b, a + 1);
+                addFace(a + 1, b, b + 1);
+            }
+        }
+
+        update();
+    }
+};
+
+
+////////////////////////////////////////////////////////////
+/// Entry point of application
+///
+/// \return Application exit code
+///
+////////////////////////////////////////////////////////////
+int main()
+{
+    std::srand(42);
+
+    // Blocks of buildings on both sides of a long street, on 256 x 256 quads of ground
+    Ground ground;
+    ground.build(256, 4.f);
+
+    std::vector<sf3d::Cuboid*> buildings;
+    for (int row = 0; row < 64; ++row)
+    {
+        for (int column = -16; column < 16; ++column)
+        {
+            if (column == 0)
+                continue;
+
+            float height = 10.f + std::rand() % 40;
+            sf3d::Cuboid* building = new sf3d::Cuboid(sf3d::Vector3f(12.f, height, 12.f));
+            building->setPosition(column * 16.f, height / 2.f - 3.f, -(row * 16.f + 8.f));
+            buildings.push_back(building);
+        }
+    }
+
+    // Props scattered between the buildings, most of them hidden from the street
+    std::vector<sf3d::FloatBox> props(50000);
+    for (std::size_t i = 0; i < props.size(); ++i)
+    {
+        float x = (std::rand() % 5120) / 10.f - 256.f;
+        float z = -(std::rand() % 10240) / 10.f;
+        props[i] = sf3d::FloatBox(x, -3.f, z, 1.f, 2.f, 1.f);
+    }
+
+    unsigned int faceCount = ground.getFaceCount();
+    for (std::size_t i = 0; i < buildings.size(); ++i)
+        faceCount += buildings[i]->getFaceCount();
+
+    std::cout << "Occlusion culling, " << buildings.size() + 1 << " occluders of " << faceCount
+              << " triangles, " << props.size() << " boxes tested per frame" << std::endl;
+
+    const unsigned int resolutions[][2] = {{256, 128}, {512, 256}, {1024, 512}};
+    const unsigned int threadCounts[] = {1, 0};
+    const char* threadNames[] = {"1 thread  ", "all cores "};
+    const unsigned int frames = 100;
+
+    for (int i = 0; i < 3; ++i)
+    {
+        std::cout << " " << resolutions[i][0] << "x" << resolutions[i][1] << " depth buffer" << std::endl;
+
+        for (int j = 0; j < 2; ++j)
+        {
+            sf3d::OcclusionCuller culler;
+            culler.setResolution(resolutions[i][0], resolutions[i][1]);
+            culler.setThreadCount(threadCounts[j]);
+            culler.addOccluder(ground);
+            for (std::size_t k = 0; k < buildings.size(); ++k)
+                culler.addOccluder(*buildings[k]);
+
+            sf3d::Camera camera(90.f, 0.5f, 1000.f);
+
+            sf3d::Time updateTime;
+            sf3d::Time testTime;
+            double triangles = 0;
+            double tested = 0;
+            double culled = 0;
+
+            // Walk down the street, looking around
+            for (unsigned int frame = 0; frame < frames; ++frame)
+            {
+                float angle = std::sin(frame * 0.1f) * 0.5f;
+                camera.setPosition(0.f, 1.7f, -(frame * 5.f));
+                camera.setDirection(std::sin(angle), 0.f, -std::cos(angle));
+
+                culler.update(camera);
+                updateTime += culler.getUpdateTime();
+                triangles += culler.getTriangleCount();
+
+                sf3d::Clock clock;
+                for (std::size_t k = 0; k < props.size(); ++k)
+                    culler.isVisible(props[k]);
+                testTime += clock.getElapsedTime();
+
+                tested += culler.getTestedCount();
+                culled += culler.getCulledCount();
+            }
+
+            std::cout << "  " << threadNames[j] << ": update " << updateTime.asSeconds() * 1000.f / frames << " ms, "
+                      << static_cast<double>(faceCount) * frames / updateTime.asSeconds() / 1000000.0 << " Mtris/s submitted, "
+                      << triangles / updateTime.asSeconds() / 1000000.0 << " Mtris/s rasterized ("
+                      << triangles / frames << " per frame), tests "
+                      << tested / testTime.asSeconds() / 1000000.0 << " Mboxes/s, "
+                      << culled * 100.0 / tested << "% culled" << std::endl;
+        }
+    }
+
+    for (std::size_t i = 0; i < buildings.size(); ++i)
+        delete buildings[i];
+
+    return EXIT_SUCCESS;
+}
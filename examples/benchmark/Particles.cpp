@@ -0,0 +1,95 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/Graphics.hpp>
+#include <cstdlib>
+#include <iostream>
+
+
+////////////////////////////////////////////////////////////
+/// Return a random number in the range [-1, 1]
+///
+////////////////////////////////////////////////////////////
+float randomUnit()
+{
+    return std::rand() * 2.f / RAND_MAX - 1.f;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Fill a particle system with particles living long enough
+/// to survive the whole benchmark
+///
+////////////////////////////////////////////////////////////
+void fill(sf3d::ParticleSystem& system, unsigned int count)
+{
+    system.clear();
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        sf3d::ParticleSystem::Particle particle;
+        particle.position = sf3d::Vector3f(randomUnit(), randomUnit(), randomUnit()) * 10.f;
+        particle.velocity = sf3d::Vector3f(randomUnit(), randomUnit() + 2.f, randomUnit());
+        particle.color = sf3d::Color::White;
+        particle.size = 0.1f;
+        particle.lifetime = sf3d::seconds(1000.f);
+        system.emit(particle);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+/// Entry point of application
+///
+/// \return Application exit code
+///
+////////////////////////////////////////////////////////////
+int main()
+{
+    const unsigned int count = 100000;
+    const unsigned int frames = 100;
+
+    // Small off-screen target, so that the fill rate doesn't hide the emission cost
+    sf3d::RenderTexture target;
+    if (!target.create(64, 64, true))
+        return EXIT_FAILURE;
+
+    sf3d::Camera camera(90.f, 0.1f, 100.f);
+    camera.setPosition(0.f, 0.f, 30.f);
+    target.setView(camera);
+
+    sf3d::ParticleSystem system;
+    system.setAcceleration(sf3d::Vector3f(0.f, -9.81f, 0.f));
+    system.setCamera(camera);
+
+    std::cout << "Particle system, " << count << " particles" << std::endl;
+
+    const unsigned int threadCounts[] = {1, 0};
+    for (int i = 0; i < 2; ++i)
+    {
+        fill(system, count);
+        system.setThreadCount(threadCounts[i]);
+
+        // Simulation only
+        sf3d::Clock clock;
+        for (unsigned int frame = 0; frame < frames; ++frame)
+            system.update(sf3d::milliseconds(16));
+
+        float update = clock.restart().asSeconds() * 1000.f / frames;
+
+        // Camera-facing quads written to the streaming buffer, and drawn
+        for (unsigned int frame = 0; frame < frames; ++frame)
+        {
+            target.clear();
+            target.draw(system);
+            target.display();
+        }
+
+        float emit = clock.getElapsedTime().asSeconds() * 1000.f / frames;
+
+        std::cout << "  " << (threadCounts[i] ? "1 thread    " : "all threads ") << ": "
+                  << "update " << update << " ms (" << count / update << " particles/ms), "
+                  << "emit and draw " << emit << " ms (" << count / emit << " particles/ms)" << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
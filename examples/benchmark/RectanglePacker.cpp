@@ -0,0 +1,180 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/System.hpp>
+#include <SFML3D/Graphics/RectanglePacker.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+
+////////////////////////////////////////////////////////////
+/// Shelf packer using the row heuristics of the font pages:
+/// a rectangle goes in the first row whose height fits it
+/// within 70%, otherwise in a new row 10% taller than itself
+///
+////////////////////////////////////////////////////////////
+class ShelfPacker
+{
+public :
+
+    void reset(unsigned int width, unsigned int height)
+    {
+        m_width = width;
+        m_height = height;
+        m_nextRow = 0;
+        m_usedArea = 0;
+        m_rows.clear();
+    }
+
+    bool insert(unsigned int width, unsigned int height)
+    {
+        if (width > m_width)
+            return false;
+
+        Row* row = NULL;
+        for (std::vector<Row>::iterator it = m_rows.begin(); it != m_rows.end() && !row; ++it)
+        {
+            float ratio = static_cast<float>(height) / it->height;
+            if ((ratio >= 0.7f) && (ratio <= 1.f) && (width <= m_width - it->width))
+                row = &*it;
+        }
+
+        if (!row)
+        {
+            unsigned int rowHeight = height + height / 10;
+            if (m_nextRow + rowHeight > m_height)
+                return false;
+
+            Row newRow = {0, rowHeight};
+            m_rows.push_back(newRow);
+            m_nextRow += rowHeight;
+            row = &m_rows.back();
+        }
+
+        row->width += width;
+        m_usedArea += width * height;
+        return true;
+    }
+
+    float getOccupancy() const
+    {
+        return static_cast<float>(m_usedArea) / (m_width * m_height);
+    }
+
+private :
+
+    struct Row
+    {
+        unsigned int width;
+        unsigned int height;
+    };
+
+    unsigned int     m_width;
+    unsigned int     m_height;
+    unsigned int     m_nextRow;
+    std::size_t      m_usedArea;
+    std::vector<Row> m_rows;
+};
+
+
+////////////////////////////////////////////////////////////
+/// Try to insert all the rectangles into a 1024x1024 area,
+/// and print the occupancy and the total time
+///
+////////////////////////////////////////////////////////////
+template <typename Insert>
+void run(const char* name, const std::vector<sf3d::Vector2u>& sizes, Insert insert)
+{
+    unsigned int placed = 0;
+    sf3d::Clock clock;
+    for (std::size_t i = 0; i < sizes.size(); ++i)
+    {
+        if (insert(sizes[i]))
+            ++placed;
+    }
+    float elapsed = clock.getElapsedTime().asSeconds();
+
+    std::cout << "  " << name << ": " << insert.getOccupancy() * 100.f << "% occupancy, "
+              << placed << " rectangles placed, " << elapsed * 1000.f << " ms for all the insertions" << std::endl;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Adapters giving both packers the same interface
+///
+////////////////////////////////////////////////////////////
+struct Shelf
+{
+    Shelf() {packer.reset(1024, 1024);}
+    bool operator ()(sf3d::Vector2u size) {return packer.insert(size.x, size.y);}
+    float getOccupancy() const {return packer.getOccupancy();}
+    ShelfPacker packer;
+};
+
+struct MaxRects
+{
+    MaxRects(bool rotate) : allowRotation(rotate) {packer.reset(1024, 1024);}
+    bool operator ()(sf3d::Vector2u size)
+    {
+        sf3d::IntRect rectangle;
+        bool rotated;
+        return packer.insert(size.x, size.y, allowRotation, rectangle, rotated);
+    }
+    float getOccupancy() const {return packer.getOccupancy();}
+    sf3d::priv::RectanglePacker packer;
+    bool allowRotation;
+};
+
+
+////////////////////////////////////////////////////////////
+/// Sort rectangles by decreasing height, like the vector
+/// overload of TextureAtlas::add does
+///
+////////////////////////////////////////////////////////////
+bool isTaller(sf3d::Vector2u left, sf3d::Vector2u right)
+{
+    return left.y > right.y;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Entry point of application
+///
+/// \return Application exit code
+///
+////////////////////////////////////////////////////////////
+int main()
+{
+    std::srand(42);
+
+    // Glyph-like rectangles, and sprites of very different sizes
+    const unsigned int ranges[][2] = {{8, 48}, {16, 256}};
+    const char* names[] = {"8 to 48 pixels", "16 to 256 pixels"};
+
+    for (int i = 0; i < 2; ++i)
+    {
+        std::vector<sf3d::Vector2u> sizes(4000);
+        for (std::size_t j = 0; j < sizes.size(); ++j)
+        {
+            sizes[j].x = ranges[i][0] + std::rand() % (ranges[i][1] - ranges[i][0] + 1);
+            sizes[j].y = ranges[i][0] + std::rand() % (ranges[i][1] - ranges[i][0] + 1);
+        }
+
+        std::vector<sf3d::Vector2u> sorted = sizes;
+        std::sort(sorted.begin(), sorted.end(), isTaller);
+
+        std::cout << "1024x1024 page, random rectangles of " << names[i] << std::endl;
+        std::cout << " in arrival order" << std::endl;
+        run("shelf              ", sizes, Shelf());
+        run("MaxRects           ", sizes, MaxRects(false));
+        run("MaxRects, rotation ", sizes, MaxRects(true));
+        std::cout << " largest first" << std::endl;
+        run("shelf              ", sorted, Shelf());
+        run("MaxRects           ", sorted, MaxRects(false));
+        run("MaxRects, rotation ", sorted, MaxRects(true));
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,132 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/Graphics.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+
+////////////////////////////////////////////////////////////
+/// Tube wrapped around a chain of bones that bend over time
+///
+////////////////////////////////////////////////////////////
+class Tentacle : public sf3d::SkinnedModel
+{
+public :
+
+    using sf3d::SkinnedModel::getVertexCount;
+
+    void build(unsigned int boneCount, unsigned int ringCount, unsigned int ringSize)
+    {
+        const float length = 10.f;
+        const float radius = 0.5f;
+        float boneLength = length / boneCount;
+
+        // Bones follow the x axis, each one bends around z back and forth
+        for (unsigned int i = 0; i < boneCount; ++i)
+        {
+            sf3d::Transform bind;
+            bind.translate(i * boneLength, 0.f, 0.f);
+            addBone(static_cast<int>(i) - 1, bind);
+
+            for (int k = 0; k < 3; ++k)
+            {
+                Keyframe keyframe;
+                keyframe.time = sf3d::seconds(k * 0.5f);
+                keyframe.translation = sf3d::Vector3f(i ? boneLength : 0.f, 0.f, 0.f);
+                keyframe.rotationAngle = (k == 1) ? 10.f : -10.f;
+                addKeyframe(i, keyframe);
+            }
+        }
+
+        // Rings of vertices, weighted by the two closest bones
+        for (unsigned int ring = 0; ring < ringCount; ++ring)
+        {
+            float x = length * ring / (ringCount - 1);
+            float bonePosition = std::min(x / boneLength, boneCount - 1.f);
+            unsigned int bone = static_cast<unsigned int>(bonePosition);
+            unsigned int nextBone = std::min(bone + 1, boneCount - 1);
+            float blend = bonePosition - bone;
+
+            for (unsigned int i = 0; i < ringSize; ++i)
+            {
+                float angle = 6.283185f * i / ringSize;
+                sf3d::Vector3f normal(0.f, std::cos(angle), std::sin(angle));
+                addVertex(sf3d::Vertex(sf3d::Vector3f(x, 0.f, 0.f) + normal * radius, sf3d::Color::White, sf3d::Vector2f(), normal));
+
+                VertexWeights weights;
+                weights.bones[0] = bone;
+                weights.bones[1] = nextBone;
+                weights.weights[0] = 1.f - blend;
+                weights.weights[1] = blend;
+                setVertexWeights(getVertexCount() - 1, weights);
+            }
+        }
+
+        for (unsigned int ring = 0; ring + 1 < ringCount; ++ring)
+        {
+            for (unsigned int i = 0; i < ringSize; ++i)
+            {
+                unsigned int a = ring * ringSize + i;
+                unsigned int b = ring * ringSize + (i + 1) % ringSize;
+                addFace(a, b, a + ringSize);
+                addFace(b, b + ringSize, a + ringSize);
+            }
+        }
+
+        updateBindPose();
+        update();
+    }
+};
+
+
+////////////////////////////////////////////////////////////
+/// Pose the model for a number of frames and print the
+/// number of skinned vertices per second
+///
+////////////////////////////////////////////////////////////
+void run(Tentacle& tentacle, unsigned int threadCount, unsigned int frames)
+{
+    tentacle.setThreadCount(threadCount);
+
+    sf3d::Clock clock;
+    for (unsigned int frame = 0; frame < frames; ++frame)
+        tentacle.setAnimationTime(sf3d::milliseconds(frame * 16));
+
+    float elapsed = clock.getElapsedTime().asSeconds();
+    double vertices = static_cast<double>(tentacle.getVertexCount()) * frames;
+
+    std::cout << "  " << (threadCount ? "1 thread    " : "all threads ") << ": "
+              << elapsed * 1000.f / frames << " ms per frame, "
+              << vertices / elapsed / 1000000.0 << " M vertices/s" << std::endl;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Entry point of application
+///
+/// \return Application exit code
+///
+////////////////////////////////////////////////////////////
+int main()
+{
+    // Typical character, and a crowd-sized mesh that is split across threads
+    const unsigned int sizes[][3] = {{32, 256, 32}, {64, 2048, 128}};
+
+    for (int i = 0; i < 2; ++i)
+    {
+        Tentacle tentacle;
+        tentacle.build(sizes[i][0], sizes[i][1], sizes[i][2]);
+        tentacle.setSkinningMode(sf3d::SkinnedModel::CpuSkinning);
+
+        std::cout << "CPU skinning, " << tentacle.getVertexCount() << " vertices, "
+                  << tentacle.getBoneCount() << " bones (skinning and upload)" << std::endl;
+
+        run(tentacle, 1, 200);
+        run(tentacle, 0, 200);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,73 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/Graphics.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+
+////////////////////////////////////////////////////////////
+/// Entry point of application
+///
+/// \return Application exit code
+///
+////////////////////////////////////////////////////////////
+int main()
+{
+    // Rolling hills of 1025 x 1025 samples
+    const unsigned int size = 1025;
+    std::vector<float> heights(size * size);
+    for (unsigned int z = 0; z < size; ++z)
+    {
+        for (unsigned int x = 0; x < size; ++x)
+            heights[z * size + x] = std::sin(x * 0.02f) * std::cos(z * 0.03f) * 20.f;
+    }
+
+    const unsigned int chunkSizes[] = {16, 32, 64};
+
+    for (int i = 0; i < 3; ++i)
+    {
+        sf3d::Terrain terrain;
+        terrain.setChunkSize(chunkSizes[i]);
+
+        std::cout << "Terrain " << size << "x" << size << ", chunks of " << chunkSizes[i] << " cells" << std::endl;
+
+        // The first update builds every chunk on the calling thread, at full resolution
+        sf3d::Clock clock;
+        terrain.loadFromHeights(&heights[0], size, size);
+        terrain.setLodDistance(0.f);
+        terrain.update(sf3d::Vector3f(512.f, 50.f, 512.f));
+        float elapsed = clock.getElapsedTime().asSeconds();
+
+        std::cout << "  initial build : " << elapsed * 1000.f << " ms, "
+                  << elapsed * 1000000.f / terrain.getChunkCount() << " us per chunk ("
+                  << terrain.getChunkCount() << " chunks)" << std::endl;
+
+        // Edits are rebuilt by the worker thread, the frame only pays for scheduling and collecting them
+        const unsigned int frames = 200;
+        float total = 0.f;
+        float longest = 0.f;
+        for (unsigned int frame = 0; frame < frames; ++frame)
+        {
+            unsigned int x = (frame * 37) % size;
+            unsigned int z = (frame * 91) % size;
+            terrain.setHeight(x, z, terrain.getHeight(x, z) + 1.f);
+
+            sf3d::Clock frameClock;
+            terrain.update(sf3d::Vector3f(512.f, 50.f, 512.f));
+            float frameTime = frameClock.getElapsedTime().asSeconds();
+            total += frameTime;
+            longest = std::max(longest, frameTime);
+
+            sf3d::sleep(sf3d::milliseconds(1));
+        }
+
+        std::cout << "  edit frames   : " << total * 1000.f / frames << " ms on average, "
+                  << longest * 1000.f << " ms at most" << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
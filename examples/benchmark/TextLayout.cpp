@@ -0,0 +1,71 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/Graphics.hpp>
+#include <cstdlib>
+#include <iostream>
+
+
+////////////////////////////////////////////////////////////
+/// Change one character of a long text every frame, and
+/// print the average cost of the geometry update
+///
+////////////////////////////////////////////////////////////
+void run(sf3d::Text& text, const sf3d::String& base, std::size_t position, const char* name)
+{
+    const unsigned int frames = 500;
+
+    // Start from a fully built text
+    text.setString(base);
+    text.getLocalBounds();
+
+    sf3d::String string = base;
+    sf3d::Time total;
+    for (unsigned int frame = 0; frame < frames; ++frame)
+    {
+        if (position < string.getSize())
+            string[position] = static_cast<sf3d::Uint32>('a' + frame % 26);
+        else
+            string += static_cast<sf3d::Uint32>('a' + frame % 26);
+
+        sf3d::Clock clock;
+        text.setString(string);
+        text.getLocalBounds();
+        total += clock.getElapsedTime();
+    }
+
+    std::cout << "  " << name << ": " << total.asSeconds() * 1000000.f / frames << " us per frame" << std::endl;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Entry point of application
+///
+/// \param argc Number of arguments
+/// \param argv Arguments, the first one may be the font to use
+///
+/// \return Application exit code
+///
+////////////////////////////////////////////////////////////
+int main(int argc, char* argv[])
+{
+    sf3d::Font font;
+    if (!font.loadFromFile((argc > 1) ? argv[1] : "resources/sansation.ttf"))
+        return EXIT_FAILURE;
+
+    // A chat log of 10000 characters, in lines of 80
+    sf3d::String base;
+    for (std::size_t i = 0; i < 10000; ++i)
+        base += static_cast<sf3d::Uint32>((i % 80 == 79) ? '\n' : 'a' + (i * 7) % 26);
+
+    sf3d::Text text(base, font, 16);
+
+    std::cout << "Text layout, " << base.getSize() << " characters, one character changed per frame" << std::endl;
+
+    run(text, base, 0, "first character (full rebuild)");
+    run(text, base, base.getSize() / 2, "middle character              ");
+    run(text, base, base.getSize() - 1, "last character                ");
+    run(text, base, base.getSize(), "appended character            ");
+
+    return EXIT_SUCCESS;
+}
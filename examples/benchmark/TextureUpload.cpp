@@ -0,0 +1,123 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/Graphics.hpp>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+
+////////////////////////////////////////////////////////////
+/// Fill a frame with a pattern that changes every frame,
+/// like a decoded video frame would
+///
+////////////////////////////////////////////////////////////
+void fill(sf3d::Uint8* pixels, unsigned int width, unsigned int height, unsigned int frame)
+{
+    for (unsigned int y = 0; y < height; ++y)
+    {
+        for (unsigned int x = 0; x < width; ++x)
+        {
+            sf3d::Uint8* pixel = pixels + (x + y * width) * 4;
+            pixel[0] = static_cast<sf3d::Uint8>(x + frame);
+            pixel[1] = static_cast<sf3d::Uint8>(y + frame);
+            pixel[2] = static_cast<sf3d::Uint8>(frame);
+            pixel[3] = 255;
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+/// Print the throughput of a run; the time of the final
+/// readback, which waits for the uploads to complete, is
+/// included in the total but not in the time of the calls
+///
+////////////////////////////////////////////////////////////
+void print(const char* name, unsigned int width, unsigned int height, unsigned int frames, sf3d::Time calls, sf3d::Time total)
+{
+    double megabytes = static_cast<double>(width) * height * 4 * frames / (1024.0 * 1024.0);
+
+    std::cout << "  " << name << ": "
+              << megabytes / total.asSeconds() << " MB/s, "
+              << calls.asSeconds() * 1000.f / frames << " ms per frame blocked in the upload call" << std::endl;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Entry point of application
+///
+/// \return Application exit code
+///
+////////////////////////////////////////////////////////////
+int main()
+{
+    const unsigned int sizes[][2] = {{640, 480}, {1920, 1080}, {3840, 2160}};
+    const unsigned int frames = 200;
+
+    std::cout << "Streaming pixel buffers: " << (sf3d::PixelWriter::isAvailable() ? "yes" : "no") << std::endl;
+
+    for (int i = 0; i < 3; ++i)
+    {
+        unsigned int width = sizes[i][0];
+        unsigned int height = sizes[i][1];
+
+        sf3d::Texture texture;
+        if (!texture.create(width, height))
+            return EXIT_FAILURE;
+
+        std::cout << width << "x" << height << " RGBA, " << frames << " frames" << std::endl;
+
+        // Texture::update from system memory, synchronous
+        std::vector<sf3d::Uint8> pixels(width * height * 4);
+        sf3d::Time calls;
+        sf3d::Clock total;
+        for (unsigned int frame = 0; frame < frames; ++frame)
+        {
+            fill(&pixels[0], width, height, frame);
+
+            sf3d::Clock clock;
+            texture.update(&pixels[0]);
+            calls += clock.getElapsedTime();
+        }
+        texture.copyToImage();
+        print("Texture::update      ", width, height, frames, calls, total.getElapsedTime());
+
+        // PixelWriter::update, one copy into the mapped buffer
+        sf3d::PixelWriter writer;
+        calls = sf3d::Time::Zero;
+        total.restart();
+        for (unsigned int frame = 0; frame < frames; ++frame)
+        {
+            fill(&pixels[0], width, height, frame);
+
+            sf3d::Clock clock;
+            writer.update(texture, &pixels[0], width, height);
+            calls += clock.getElapsedTime();
+        }
+        texture.copyToImage();
+        print("PixelWriter::update  ", width, height, frames, calls, total.getElapsedTime());
+
+        // PixelWriter::map, the frame is written directly to the buffer
+        calls = sf3d::Time::Zero;
+        total.restart();
+        for (unsigned int frame = 0; frame < frames; ++frame)
+        {
+            sf3d::Clock clock;
+            sf3d::Uint8* mapped = writer.map(width, height);
+            calls += clock.getElapsedTime();
+            if (!mapped)
+                return EXIT_FAILURE;
+
+            fill(mapped, width, height, frame);
+
+            clock.restart();
+            writer.upload(texture);
+            calls += clock.getElapsedTime();
+        }
+        texture.copyToImage();
+        print("PixelWriter::map     ", width, height, frames, calls, total.getElapsedTime());
+    }
+
+    return EXIT_SUCCESS;
+}
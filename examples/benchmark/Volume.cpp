@@ -0,0 +1,104 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/Graphics.hpp>
+#include <SFML3D/OpenGL.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+
+////////////////////////////////////////////////////////////
+/// Print the upload throughput of a volume
+///
+////////////////////////////////////////////////////////////
+void print(const char* name, const sf3d::VolumeImage& volume, sf3d::Time time)
+{
+    sf3d::Vector3u size = volume.getSize();
+    double megabytes = static_cast<double>(size.x) * size.y * size.z * 4 / (1024.0 * 1024.0);
+
+    std::cout << "  " << name << ": " << time.asSeconds() * 1000.f << " ms, "
+              << megabytes / time.asSeconds() << " MB/s" << std::endl;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Entry point of application
+///
+/// \return Application exit code
+///
+////////////////////////////////////////////////////////////
+int main(int argc, char* argv[])
+{
+    const unsigned int size = 512;
+
+    sf3d::VolumeImage volume;
+    sf3d::Clock clock;
+    if (argc > 1)
+    {
+        // Raw RGBA file of 512^3 pixels, mapped rather than read
+        if (!volume.loadFromFile(argv[1], size, size, size))
+            return EXIT_FAILURE;
+        std::cout << "Mapping " << argv[1] << ": " << clock.getElapsedTime().asSeconds() * 1000.f << " ms" << std::endl;
+    }
+    else
+    {
+        volume.create(size, size, size);
+        for (unsigned int z = 0; z < size; z += 8)
+            for (unsigned int y = 0; y < size; y += 8)
+                for (unsigned int x = 0; x < size; x += 8)
+                    volume.setPixel(x, y, z, sf3d::Color(x / 2, y / 2, z / 2));
+        std::cout << "Creating the volume: " << clock.getElapsedTime().asSeconds() * 1000.f << " ms" << std::endl;
+    }
+
+    std::cout << size << "x" << size << "x" << size << " RGBA volume" << std::endl;
+
+    // Mip chain on the CPU
+    std::vector<sf3d::VolumeImage> levels;
+    clock.restart();
+    volume.createMipmaps(levels);
+    std::cout << "  CPU mipmaps          : " << clock.getElapsedTime().asSeconds() * 1000.f << " ms" << std::endl;
+    levels.clear();
+
+    // Whole volume, split in slabs by the texture; glFinish waits
+    // for the upload to complete on the graphics card
+    sf3d::Texture texture;
+    clock.restart();
+    if (!texture.loadFromVolumeImage(volume))
+    {
+        std::cout << "  The graphics card does not support " << size << "^3 textures" << std::endl;
+        return EXIT_FAILURE;
+    }
+    glFinish();
+    print("loadFromVolumeImage  ", volume, clock.getElapsedTime());
+
+    clock.restart();
+    texture.update(volume);
+    glFinish();
+    print("update               ", volume, clock.getElapsedTime());
+
+    // Slice by slice, the way a volume is streamed over several frames
+    sf3d::Time slowest;
+    clock.restart();
+    for (unsigned int z = 0; z < size; ++z)
+    {
+        sf3d::Clock sliceClock;
+        texture.updateSlice(volume.getSlicePtr(z), z);
+        slowest = std::max(slowest, sliceClock.getElapsedTime());
+    }
+    glFinish();
+    print("updateSlice          ", volume, clock.getElapsedTime());
+    std::cout << "  slowest slice        : " << slowest.asSeconds() * 1000.f << " ms" << std::endl;
+
+    // With the mipmaps generated by the texture
+    sf3d::Texture mipmapped;
+    clock.restart();
+    if (mipmapped.loadFromVolumeImage(volume, true))
+    {
+        glFinish();
+        print("with mipmaps         ", volume, clock.getElapsedTime());
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,179 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/Graphics.hpp>
+#include <cstdlib>
+#include <iostream>
+
+
+namespace
+{
+    // Writes the vertex color to the first texture and a constant to the second one
+    const char* vertexShader =
+        "#version 130\n"
+        "uniform mat4 sf_ModelMatrix;\n"
+        "uniform mat4 sf_ViewMatrix;\n"
+        "uniform mat4 sf_ProjectionMatrix;\n"
+        "in vec3 sf_Vertex;\n"
+        "in vec4 sf_Color;\n"
+        "out vec4 color;\n"
+        "void main()\n"
+        "{\n"
+        "    gl_Position = sf_ProjectionMatrix * sf_ViewMatrix * sf_ModelMatrix * vec4(sf_Vertex, 1.0);\n"
+        "    color = sf_Color;\n"
+        "}\n";
+
+    const char* fragmentShader =
+        "#version 130\n"
+        "in vec4 color;\n"
+        "void main()\n"
+        "{\n"
+        "    gl_FragData[0] = color;\n"
+        "    gl_FragData[1] = vec4(0.25, 0.5, 0.75, 1.0);\n"
+        "}\n";
+
+    // Number of failed checks
+    unsigned int failures = 0;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Check a pixel of a resolved texture, with a tolerance of
+/// 1 for the conversions between formats
+///
+////////////////////////////////////////////////////////////
+void check(const char* name, const sf3d::Image& image, unsigned int x, unsigned int y, sf3d::Color expected)
+{
+    sf3d::Color color = image.getPixel(x, y);
+    if ((std::abs(color.r - expected.r) > 1) || (std::abs(color.g - expected.g) > 1) ||
+        (std::abs(color.b - expected.b) > 1) || (std::abs(color.a - expected.a) > 1))
+    {
+        std::cout << "  " << name << " (" << x << ", " << y << ") is "
+                  << static_cast<int>(color.r) << " " << static_cast<int>(color.g) << " "
+                  << static_cast<int>(color.b) << " " << static_cast<int>(color.a) << ", expected "
+                  << static_cast<int>(expected.r) << " " << static_cast<int>(expected.g) << " "
+                  << static_cast<int>(expected.b) << " " << static_cast<int>(expected.a) << std::endl;
+        ++failures;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+/// Count the pixels whose channel is between the clear value
+/// and the drawn value, which only the resolve of a
+/// multisampled buffer produces
+///
+////////////////////////////////////////////////////////////
+unsigned int countEdgePixels(const sf3d::Image& image, unsigned int channel)
+{
+    unsigned int count = 0;
+    const sf3d::Uint8* pixels = image.getPixelsPtr();
+    for (unsigned int i = 0; i < image.getSize().x * image.getSize().y; ++i)
+    {
+        sf3d::Uint8 value = pixels[i * 4 + channel];
+        if ((value > 8) && (value < 247))
+            ++count;
+    }
+
+    return count;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Entry point of application
+///
+/// \return Application exit code
+///
+////////////////////////////////////////////////////////////
+int main()
+{
+    const unsigned int size = 64;
+
+    if (!sf3d::Shader::isAvailable())
+    {
+        std::cout << "Shaders are not available" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Two color textures, a depth texture and 4x multisampling
+    sf3d::RenderTexture::Settings settings;
+    settings.colorFormats.push_back(sf3d::RenderTexture::isFormatAvailable(sf3d::RenderTexture::Rgba16f) ?
+                                    sf3d::RenderTexture::Rgba16f : sf3d::RenderTexture::Rgba8);
+    settings.depthTexture = true;
+    settings.antialiasingLevel = 4;
+
+    std::cout << "Maximum color textures: " << sf3d::RenderTexture::getMaximumColorTextureCount() << std::endl;
+    std::cout << "Rgba16f available: " << (sf3d::RenderTexture::isFormatAvailable(sf3d::RenderTexture::Rgba16f) ? "yes" : "no") << std::endl;
+
+    sf3d::RenderTexture target;
+    if (!target.create(size, size, settings))
+    {
+        std::cout << "Failed to create a multisampled render-texture with 2 color textures and a depth texture" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    sf3d::Shader shader;
+    if (!shader.loadFromMemory(vertexShader, fragmentShader))
+        return EXIT_FAILURE;
+
+    // A rotated square in the middle, so that its edges are antialiased
+    sf3d::RectangleShape square(sf3d::Vector2f(32.f, 32.f));
+    square.setOrigin(16.f, 16.f);
+    square.setPosition(size / 2.f, size / 2.f);
+    square.setRotation(30.f);
+    square.setFillColor(sf3d::Color::Red);
+
+    target.enableDepthTest(true);
+    target.clear(sf3d::Color::Transparent);
+    target.draw(square, &shader);
+    target.display();
+
+    std::cout << target.getColorTextureCount() << " color textures" << std::endl;
+
+    // Resolved color textures: the square in the middle, the clear color in the corners
+    sf3d::Image colors = target.getTexture(0).copyToImage();
+    sf3d::Image constants = target.getTexture(1).copyToImage();
+    check("texture 0", colors, size / 2, size / 2, sf3d::Color::Red);
+    check("texture 0", colors, 0, 0, sf3d::Color::Transparent);
+    check("texture 1", constants, size / 2, size / 2, sf3d::Color(64, 128, 191, 255));
+    check("texture 1", constants, 0, 0, sf3d::Color::Transparent);
+
+    // Both textures must be resolved, with partially covered pixels on the edges
+    unsigned int colorEdges = countEdgePixels(colors, 0);
+    unsigned int constantEdges = countEdgePixels(constants, 3);
+    std::cout << "Partially covered pixels: " << colorEdges << " in texture 0, " << constantEdges << " in texture 1" << std::endl;
+    if (colorEdges != constantEdges)
+    {
+        std::cout << "  the two textures were not resolved the same way" << std::endl;
+        ++failures;
+    }
+
+    // Depth texture: draw it to a plain render-texture to read it back;
+    // the square is closer than the cleared depth of 1
+    sf3d::RenderTexture depthView;
+    if (!depthView.create(size, size))
+        return EXIT_FAILURE;
+
+    depthView.clear();
+    depthView.draw(sf3d::Sprite(target.getDepthTexture()));
+    depthView.display();
+
+    sf3d::Image depth = depthView.getTexture().copyToImage();
+    std::cout << "Depth: " << static_cast<int>(depth.getPixel(size / 2, size / 2).r) << " in the middle, "
+              << static_cast<int>(depth.getPixel(0, 0).r) << " in the corners" << std::endl;
+    check("depth texture", depth, 0, 0, sf3d::Color(255, depth.getPixel(0, 0).g, depth.getPixel(0, 0).b));
+    if (depth.getPixel(size / 2, size / 2).r >= 255)
+    {
+        std::cout << "  the depth of the square was not written" << std::endl;
+        ++failures;
+    }
+
+    if (failures)
+    {
+        std::cout << failures << " checks failed" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "The multisampled textures were resolved correctly" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -35,24 +35,37 @@
 #include <SFML3D/Graphics/Font.hpp>
 #include <SFML3D/Graphics/Glyph.hpp>
 #include <SFML3D/Graphics/Image.hpp>
+#include <SFML3D/Graphics/CompressedImage.hpp>
+#include <SFML3D/Graphics/VolumeImage.hpp>
+#include <SFML3D/Graphics/PixelReader.hpp>
+#include <SFML3D/Graphics/PixelWriter.hpp>
+#include <SFML3D/Graphics/PostProcessChain.hpp>
 #include <SFML3D/Graphics/RenderStates.hpp>
 #include <SFML3D/Graphics/RenderTexture.hpp>
 #include <SFML3D/Graphics/RenderWindow.hpp>
 #include <SFML3D/Graphics/Shader.hpp>
+#include <SFML3D/Graphics/ShadowMap.hpp>
 #include <SFML3D/Graphics/Shape.hpp>
 #include <SFML3D/Graphics/CircleShape.hpp>
 #include <SFML3D/Graphics/RectangleShape.hpp>
 #include <SFML3D/Graphics/ConvexShape.hpp>
 #include <SFML3D/Graphics/Light.hpp>
+#include <SFML3D/Graphics/Material.hpp>
 #include <SFML3D/Graphics/Polyhedron.hpp>
 #include <SFML3D/Graphics/SphericalPolyhedron.hpp>
 #include <SFML3D/Graphics/Cuboid.hpp>
 #include <SFML3D/Graphics/ConvexPolyhedron.hpp>
+#include <SFML3D/Graphics/OcclusionCuller.hpp>
 #include <SFML3D/Graphics/Model.hpp>
+#include <SFML3D/Graphics/SkinnedModel.hpp>
 #include <SFML3D/Graphics/Sprite.hpp>
 #include <SFML3D/Graphics/Billboard.hpp>
+#include <SFML3D/Graphics/ParticleSystem.hpp>
+#include <SFML3D/Graphics/Terrain.hpp>
 #include <SFML3D/Graphics/Text.hpp>
+#include <SFML3D/Graphics/TextBatch.hpp>
 #include <SFML3D/Graphics/Texture.hpp>
+#include <SFML3D/Graphics/TextureAtlas.hpp>
 #include <SFML3D/Graphics/Transform.hpp>
 #include <SFML3D/Graphics/Vertex.hpp>
 #include <SFML3D/Graphics/VertexArray.hpp>
@@ -0,0 +1,224 @@
+#ifndef SFML3D_COMPRESSEDIMAGE_HPP
+#define SFML3D_COMPRESSEDIMAGE_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/Graphics/Export.hpp>
+#include <SFML3D/Graphics/Image.hpp>
+#include <SFML3D/System/Vector2.hpp>
+#include <string>
+#include <vector>
+
+
+namespace sf3d
+{
+////////////////////////////////////////////////////////////
+/// \brief Block compressed image, with its mipmap levels,
+///        stored in system memory
+///
+////////////////////////////////////////////////////////////
+class SFML3D_GRAPHICS_API CompressedImage
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Block compression formats
+    ///
+    ////////////////////////////////////////////////////////////
+    enum Format
+    {
+        Bc1,     ///< BC1 (DXT1): RGB and 1 bit alpha, 8 bytes per 4x4 block
+        Bc2,     ///< BC2 (DXT3): RGB and explicit 4 bits alpha, 16 bytes per 4x4 block
+        Bc3,     ///< BC3 (DXT5): RGB and interpolated alpha, 16 bytes per 4x4 block
+        Etc2Rgb, ///< ETC2 RGB, 8 bytes per 4x4 block
+        Etc2Rgba ///< ETC2 RGBA (with EAC alpha), 16 bytes per 4x4 block
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// Creates an empty image.
+    ///
+    ////////////////////////////////////////////////////////////
+    CompressedImage();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Compress an image
+    ///
+    /// Only the Bc1 and Bc3 formats can be produced. When
+    /// \a generateMipmaps is true, the full mipmap chain is
+    /// computed with a box filter and compressed too.
+    ///
+    /// \param image           Image to compress
+    /// \param format          Compression format, Bc1 or Bc3
+    /// \param generateMipmaps Compress the mipmap levels too?
+    ///
+    /// \return True if compression was successful
+    ///
+    ////////////////////////////////////////////////////////////
+    bool compress(const Image& image, Format format, bool generateMipmaps = true);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Decompress a level of the image
+    ///
+    /// Only the BC formats can be decompressed; an empty image
+    /// is returned for the ETC2 formats.
+    ///
+    /// \param level Mipmap level to decompress
+    ///
+    /// \return Decompressed image
+    ///
+    ////////////////////////////////////////////////////////////
+    Image decompress(unsigned int level = 0) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Load the image from a file on disk
+    ///
+    /// The supported containers are DDS, with BC1, BC2 or BC3
+    /// data, and KTX, with BC or ETC2 data.
+    /// If this function fails, the image is left empty.
+    ///
+    /// \param filename Path of the file to load
+    ///
+    /// \return True if loading was successful
+    ///
+    /// \see loadFromMemory, saveToFile
+    ///
+    ////////////////////////////////////////////////////////////
+    bool loadFromFile(const std::string& filename);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Load the image from a file in memory
+    ///
+    /// \param data Pointer to the file data in memory
+    /// \param size Size of the data to load, in bytes
+    ///
+    /// \return True if loading was successful
+    ///
+    /// \see loadFromFile
+    ///
+    ////////////////////////////////////////////////////////////
+    bool loadFromMemory(const void* data, std::size_t size);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Save the image to a file on disk
+    ///
+    /// The container is chosen from the extension: KTX for
+    /// ".ktx", DDS otherwise. DDS can't hold the ETC2 formats.
+    ///
+    /// \param filename Path of the file to save
+    ///
+    /// \return True if saving was successful
+    ///
+    /// \see loadFromFile
+    ///
+    ////////////////////////////////////////////////////////////
+    bool saveToFile(const std::string& filename) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the compression format of the image
+    ///
+    /// \return Compression format
+    ///
+    ////////////////////////////////////////////////////////////
+    Format getFormat() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the size of a level of the image
+    ///
+    /// \param level Mipmap level
+    ///
+    /// \return Size of the level, in pixels
+    ///
+    ////////////////////////////////////////////////////////////
+    Vector2u getSize(unsigned int level = 0) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of mipmap levels
+    ///
+    /// \return Number of levels, 0 if the image is empty
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getLevelCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the compressed data of a level
+    ///
+    /// \param level Mipmap level
+    ///
+    /// \return Pointer to the compressed blocks of the level
+    ///
+    ////////////////////////////////////////////////////////////
+    const Uint8* getLevelData(unsigned int level) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the size of the compressed data of a level
+    ///
+    /// \param level Mipmap level
+    ///
+    /// \return Size of the compressed blocks of the level, in bytes
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getLevelDataSize(unsigned int level) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the size of a 4x4 block in a given format
+    ///
+    /// \param format Compression format
+    ///
+    /// \return Size of a block, in bytes
+    ///
+    ////////////////////////////////////////////////////////////
+    static std::size_t getBlockSize(Format format);
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    Format                           m_format; ///< Compression format
+    Vector2u                         m_size;   ///< Size of the first level
+    std::vector<std::vector<Uint8> > m_levels; ///< Compressed blocks of each mipmap level
+};
+
+} // namespace sf3d
+
+
+#endif // SFML3D_COMPRESSEDIMAGE_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class sf3d::CompressedImage
+/// \ingroup graphics
+///
+/// sf3d::CompressedImage holds an image in one of the block
+/// compression formats that graphics cards sample directly,
+/// with its mipmap chain. Compared to sf3d::Image, it takes
+/// 4 to 8 times less memory once uploaded to a texture with
+/// sf3d::Texture::loadFromCompressedImage, and loads faster
+/// since the mipmaps are precomputed.
+///
+/// Compressed images are usually produced offline: load an
+/// sf3d::Image, compress it to BC1 (opaque or cut-out images)
+/// or BC3 (smooth alpha), and save it as a DDS or KTX file.
+///
+/// Usage example:
+/// \code
+/// // Offline
+/// sf3d::Image image;
+/// image.loadFromFile("grass.png");
+/// sf3d::CompressedImage compressed;
+/// compressed.compress(image, sf3d::CompressedImage::Bc1);
+/// compressed.saveToFile("grass.dds");
+///
+/// // In the game
+/// sf3d::CompressedImage grass;
+/// grass.loadFromFile("grass.dds");
+/// sf3d::Texture texture;
+/// texture.loadFromCompressedImage(grass);
+/// \endcode
+///
+/// \see sf3d::Image, sf3d::Texture
+///
+////////////////////////////////////////////////////////////
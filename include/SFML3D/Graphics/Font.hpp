@@ -206,6 +206,133 @@ public :
     ////////////////////////////////////////////////////////////
     const Texture& getTexture(unsigned int characterSize) const;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Retrieve a glyph of the font as a signed distance field
+    ///
+    /// Distance field glyphs are rasterized once, at the size
+    /// returned by getDistanceFieldSize, and can be scaled to
+    /// any character size when rendered with a shader that
+    /// thresholds the distance (see sf3d::Text::setDistanceField).
+    /// The alpha channel of the texture stores the distance to
+    /// the outline of the glyph: 0.5 on the outline, increasing
+    /// inside and decreasing outside.
+    ///
+    /// The metrics of the returned glyph are expressed at the
+    /// distance field size, they must be scaled by
+    /// characterSize / getDistanceFieldSize() before use.
+    ///
+    /// \param codePoint Unicode code point of the character to get
+    /// \param bold      Retrieve the bold version or the regular one?
+    ///
+    /// \return The glyph corresponding to \a codePoint
+    ///
+    /// \see getDistanceFieldTexture, getDistanceFieldSize
+    ///
+    ////////////////////////////////////////////////////////////
+    const Glyph& getDistanceFieldGlyph(Uint32 codePoint, bool bold) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Retrieve the texture containing the distance field glyphs
+    ///
+    /// This texture is shared by all the character sizes.
+    ///
+    /// \return Texture containing the distance field glyphs
+    ///
+    /// \see getDistanceFieldGlyph
+    ///
+    ////////////////////////////////////////////////////////////
+    const Texture& getDistanceFieldTexture() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the character size distance field glyphs are rasterized at
+    ///
+    /// \return Reference character size of distance field glyphs
+    ///
+    /// \see getDistanceFieldGlyph
+    ///
+    ////////////////////////////////////////////////////////////
+    static unsigned int getDistanceFieldSize();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Rasterize a set of glyphs in the background
+    ///
+    /// The glyphs of \a characters that are not loaded yet are
+    /// rasterized by a worker thread, so that they are ready
+    /// when a text first needs them. This is typically done
+    /// right after loading the font, or before showing a screen
+    /// with new text, to avoid the hitch caused by rasterizing
+    /// many glyphs at once (CJK text in particular).
+    ///
+    /// The rasterized glyphs are uploaded to the texture all at
+    /// once by the next call to update, or when one of them is
+    /// requested with getGlyph.
+    ///
+    /// \param characters    Characters to load
+    /// \param characterSize Reference character size
+    /// \param bold          Load the bold version or the regular one?
+    ///
+    /// \see update, setAsynchronousLoading
+    ///
+    ////////////////////////////////////////////////////////////
+    void preload(const String& characters, unsigned int characterSize, bool bold = false) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Enable or disable asynchronous glyph loading
+    ///
+    /// By default, getGlyph rasterizes a missing glyph right
+    /// away. When asynchronous loading is enabled, the missing
+    /// glyph is handed to the worker thread instead, and an
+    /// empty placeholder glyph is returned until the next call
+    /// to update that finds it rasterized. sf3d::Text detects
+    /// it and updates its geometry automatically.
+    ///
+    /// \param asynchronous True to enable, false to disable
+    ///
+    /// \see isAsynchronousLoading, update
+    ///
+    ////////////////////////////////////////////////////////////
+    void setAsynchronousLoading(bool asynchronous);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether asynchronous glyph loading is enabled
+    ///
+    /// \return True if asynchronous loading is enabled
+    ///
+    /// \see setAsynchronousLoading
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isAsynchronousLoading() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Upload the glyphs rasterized in the background
+    ///
+    /// The glyphs finished by the worker thread since the last
+    /// call are packed together and uploaded with a single
+    /// texture update per page, and the glyphs queued since
+    /// then are handed to the worker thread.
+    /// This function never waits for the worker thread. It is
+    /// meant to be called once per frame; sf3d::Text calls it
+    /// when it is drawn.
+    ///
+    /// \see preload, getRevision
+    ///
+    ////////////////////////////////////////////////////////////
+    void update() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the revision of the loaded glyphs
+    ///
+    /// The revision changes every time glyphs rasterized in the
+    /// background are added to the font, which may replace
+    /// placeholders returned by getGlyph.
+    ///
+    /// \return Current revision
+    ///
+    /// \see update
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getRevision() const;
+
     ////////////////////////////////////////////////////////////
     /// \brief Overload of assignment operator
     ///
@@ -218,17 +345,23 @@ public :
 
 private :
 
+    struct Bitmap;
+    struct Loader;
+
     ////////////////////////////////////////////////////////////
-    /// \brief Structure defining a row of glyphs
+    /// \brief Structure defining a horizontal segment of the skyline
+    ///
+    /// The skyline is the lowest edge of the area already
+    /// occupied by glyphs in a page, from left to right.
     ///
     ////////////////////////////////////////////////////////////
-    struct Row
+    struct SkylineNode
     {
-        Row(unsigned int rowTop, unsigned int rowHeight) : width(0), top(rowTop), height(rowHeight) {}
+        SkylineNode(unsigned int nodeX, unsigned int nodeY, unsigned int nodeWidth) : x(nodeX), y(nodeY), width(nodeWidth) {}
 
-        unsigned int width;  ///< Current width of the row
-        unsigned int top;    ///< Y position of the row into the texture
-        unsigned int height; ///< Height of the row
+        unsigned int x;     ///< X position of the segment into the texture
+        unsigned int y;     ///< Y position of the segment into the texture
+        unsigned int width; ///< Width of the segment
     };
 
     ////////////////////////////////////////////////////////////
@@ -244,10 +377,9 @@ private :
     {
         Page();
 
-        GlyphTable       glyphs;  ///< Table mapping code points to their corresponding glyph
-        sf3d::Texture      texture; ///< Texture containing the pixels of the glyphs
-        unsigned int     nextRow; ///< Y position of the next new row in the texture
-        std::vector<Row> rows;    ///< List containing the position of all the existing rows
+        GlyphTable               glyphs;  ///< Table mapping code points to their corresponding glyph
+        sf3d::Texture            texture; ///< Texture containing the pixels of the glyphs
+        std::vector<SkylineNode> skyline; ///< Segments of the skyline, from left to right
     };
 
     ////////////////////////////////////////////////////////////
@@ -262,11 +394,59 @@ private :
     /// \param codePoint     Unicode code point of the character to load
     /// \param characterSize Reference character size
     /// \param bold          Retrieve the bold version or the regular one?
+    /// \param distanceField Store the glyph as a signed distance field?
     ///
     /// \return The glyph corresponding to \a codePoint and \a characterSize
     ///
     ////////////////////////////////////////////////////////////
-    Glyph loadGlyph(Uint32 codePoint, unsigned int characterSize, bool bold) const;
+    Glyph loadGlyph(Uint32 codePoint, unsigned int characterSize, bool bold, bool distanceField = false) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Find a glyph in the cache, or load it
+    ///
+    /// \param codePoint     Unicode code point of the character to get
+    /// \param characterSize Reference character size
+    /// \param bold          Retrieve the bold version or the regular one?
+    /// \param distanceField Retrieve the signed distance field glyph?
+    ///
+    /// \return The glyph, or a placeholder if it is being loaded asynchronously
+    ///
+    ////////////////////////////////////////////////////////////
+    const Glyph& findGlyph(Uint32 codePoint, unsigned int characterSize, bool bold, bool distanceField) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Rasterize a glyph into a bitmap
+    ///
+    /// This function doesn't touch the pages, it can be called
+    /// from the worker thread.
+    ///
+    /// \param codePoint     Unicode code point of the character to load
+    /// \param characterSize Reference character size
+    /// \param bold          Rasterize the bold version or the regular one?
+    /// \param distanceField Store the glyph as a signed distance field?
+    /// \param bitmap        Bitmap receiving the glyph's metrics and padded pixels
+    ///
+    ////////////////////////////////////////////////////////////
+    void rasterizeGlyph(Uint32 codePoint, unsigned int characterSize, bool bold, bool distanceField, Bitmap& bitmap) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add rasterized glyphs to their pages
+    ///
+    /// The glyphs of each page are packed together into shelves,
+    /// each shelf being uploaded with a single texture update.
+    ///
+    /// \param bitmaps Glyphs to add
+    ///
+    ////////////////////////////////////////////////////////////
+    void commitGlyphs(std::vector<Bitmap>& bitmaps) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add the glyphs finished by the worker thread
+    ///
+    /// \param wait Wait for the worker thread if it is still busy?
+    ///
+    ////////////////////////////////////////////////////////////
+    void collectGlyphs(bool wait) const;
 
     ////////////////////////////////////////////////////////////
     /// \brief Find a suitable rectangle within the texture for a glyph
@@ -280,6 +460,19 @@ private :
     ////////////////////////////////////////////////////////////
     IntRect findGlyphRect(Page& page, unsigned int width, unsigned int height) const;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Make the texture of a page twice as big
+    ///
+    /// The existing glyphs are copied on the graphics card,
+    /// they keep their position in the texture.
+    ///
+    /// \param page Page of glyphs to grow
+    ///
+    /// \return True if the page was grown, false if the maximum texture size is reached
+    ///
+    ////////////////////////////////////////////////////////////
+    bool growPage(Page& page) const;
+
     ////////////////////////////////////////////////////////////
     /// \brief Make sure that the given size is the current one
     ///
@@ -293,18 +486,24 @@ private :
     ////////////////////////////////////////////////////////////
     // Types
     ////////////////////////////////////////////////////////////
-    typedef std::map<unsigned int, Page> PageTable; ///< Table mapping a character size to its page (texture)
+    typedef std::map<unsigned int, Page> PageTable;                ///< Table mapping a character size to its page (texture)
+    typedef std::map<std::pair<Uint32, Uint32>, int> KerningTable; ///< Table mapping a pair of code points to their kerning
+    typedef std::map<unsigned int, KerningTable> KerningTables;    ///< Table mapping a character size to its kerning table
 
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
-    void*                      m_library;     ///< Pointer to the internal library interface (it is typeless to avoid exposing implementation details)
-    void*                      m_face;        ///< Pointer to the internal font face (it is typeless to avoid exposing implementation details)
-    void*                      m_streamRec;   ///< Pointer to the stream rec instance (it is typeless to avoid exposing implementation details)
-    int*                       m_refCount;    ///< Reference counter used by implicit sharing
-    Info                       m_info;        ///< Information about the font
-    mutable PageTable          m_pages;       ///< Table containing the glyphs pages by character size
-    mutable std::vector<Uint8> m_pixelBuffer; ///< Pixel buffer holding a glyph's pixels before being written to the texture
+    void*                      m_library;            ///< Pointer to the internal library interface (it is typeless to avoid exposing implementation details)
+    void*                      m_face;               ///< Pointer to the internal font face (it is typeless to avoid exposing implementation details)
+    void*                      m_streamRec;          ///< Pointer to the stream rec instance (it is typeless to avoid exposing implementation details)
+    int*                       m_refCount;           ///< Reference counter used by implicit sharing
+    Info                       m_info;               ///< Information about the font
+    mutable PageTable          m_pages;              ///< Table containing the glyphs pages by character size
+    mutable PageTable          m_distanceFieldPages; ///< Table containing the distance field glyphs page, at the distance field size
+    mutable KerningTables      m_kerning;            ///< Kerning of the pairs already queried, by character size
+    mutable Loader*            m_loader;             ///< Background glyph rasterization, created on first use
+    bool                       m_asynchronous;       ///< Are missing glyphs loaded asynchronously?
+    mutable unsigned int       m_revision;           ///< Revision of the glyphs loaded in the background
 };
 
 } // namespace sf3d
@@ -341,6 +540,12 @@ private :
 /// Note that it is also possible to bind several sf3d::Text instances
 /// to the same sf3d::Font.
 ///
+/// Glyphs are rasterized the first time they are requested,
+/// which may cause a visible hitch when a lot of new characters
+/// appear at once. Use preload to rasterize them in advance on
+/// a worker thread, or setAsynchronousLoading to never rasterize
+/// on the calling thread and draw the glyphs once they are ready.
+///
 /// It is important to note that the sf3d::Text instance doesn't
 /// copy the font that it uses, it only keeps a reference to it.
 /// Thus, a sf3d::Font must not be destructed while it is
@@ -47,6 +47,16 @@ class SFML3D_GRAPHICS_API Image
 {
 public :
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Filters that can be used to resize an image
+    ///
+    ////////////////////////////////////////////////////////////
+    enum ResizeFilter
+    {
+        Bilinear, ///< Interpolate between the 4 nearest pixels
+        Box       ///< Average all the pixels covered by the new pixel
+    };
+
     ////////////////////////////////////////////////////////////
     /// \brief Default constructor
     ///
@@ -97,6 +107,29 @@ public :
     ////////////////////////////////////////////////////////////
     bool loadFromFile(const std::string& filename);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Load several images from files on disk, in parallel
+    ///
+    /// The files are decoded on several threads at once, which
+    /// is much faster than calling loadFromFile in a loop when
+    /// loading many images, typically at startup. The images
+    /// can then be uploaded to textures by the calling thread.
+    ///
+    /// \a images is resized to the number of files; the image
+    /// at index i receives the file at index i, and is left
+    /// empty if that file can't be loaded.
+    ///
+    /// \param filenames   Paths of the image files to load
+    /// \param images      Array receiving the loaded images
+    /// \param threadCount Maximum number of threads, 0 for one per processor
+    ///
+    /// \return Number of images successfully loaded
+    ///
+    /// \see loadFromFile
+    ///
+    ////////////////////////////////////////////////////////////
+    static std::size_t loadMany(const std::vector<std::string>& filenames, std::vector<Image>& images, unsigned int threadCount = 0);
+
     ////////////////////////////////////////////////////////////
     /// \brief Load the image from a file in memory
     ///
@@ -252,6 +285,46 @@ public :
     ////////////////////////////////////////////////////////////
     void flipVertically();
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Compute the mipmap chain of the image
+    ///
+    /// Every level is half the size of the previous one, computed
+    /// with a 2x2 box filter, down to a 1x1 image. The first
+    /// element of \a levels is the level 1 (the image itself is
+    /// the level 0). An empty image produces no level.
+    ///
+    /// \param levels Vector receiving the mipmap levels
+    ///
+    ////////////////////////////////////////////////////////////
+    void createMipmaps(std::vector<Image>& levels) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Multiply the color components of every pixel by its alpha
+    ///
+    /// Premultiplied alpha avoids dark fringes when transparent
+    /// images are filtered, and must be drawn with a blend mode
+    /// that doesn't multiply the source color by its alpha again.
+    ///
+    ////////////////////////////////////////////////////////////
+    void premultiplyAlpha();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Resize the image
+    ///
+    /// The Bilinear filter interpolates the 4 nearest source
+    /// pixels; it is fast and suits magnification and small
+    /// reductions. The Box filter averages all the source pixels
+    /// covered by each destination pixel; it is the better
+    /// choice to shrink an image by a large factor.
+    /// Resizing to a null width or height gives an empty image.
+    ///
+    /// \param width  New width of the image
+    /// \param height New height of the image
+    /// \param filter Filter used to compute the new pixels
+    ///
+    ////////////////////////////////////////////////////////////
+    void resize(unsigned int width, unsigned int height, ResizeFilter filter = Bilinear);
+
 private :
 
     ////////////////////////////////////////////////////////////
@@ -16,6 +16,7 @@
 namespace sf3d
 {
 class Shader;
+class ShadowMap;
 
 ////////////////////////////////////////////////////////////
 /// \brief Light source, either positional or directional
@@ -511,6 +512,8 @@ public :
 
 private :
 
+    friend class ShadowMap;
+
     ////////////////////////////////////////////////////////////
     /// \brief Get a free identifier for this light
     ///
@@ -537,6 +540,7 @@ private :
     float               m_linearAttenuation;    ///< Linear attenuation used during lighting computations
     float               m_quadraticAttenuation; ///< Quadratic attenuation used during lighting computations
     bool                m_enabled;              ///< Whether the light is enabled
+    ShadowMap*          m_shadowMap;            ///< Shadow map attached to the light, if any
     mutable std::string m_shaderElement;        ///< Cached string containing the element used to access lighting data in a shader
 };
 
@@ -0,0 +1,343 @@
+#ifndef SFML3D_MATERIAL_HPP
+#define SFML3D_MATERIAL_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/Graphics/Export.hpp>
+#include <SFML3D/Graphics/Color.hpp>
+#include <SFML3D/Config.hpp>
+
+
+namespace sf3d
+{
+class Shader;
+class Texture;
+
+////////////////////////////////////////////////////////////
+/// \brief Surface properties of drawn objects, rendered
+///        with specialized variants of the default shader
+///
+////////////////////////////////////////////////////////////
+class SFML3D_GRAPHICS_API Material
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Features of the material
+    ///
+    ////////////////////////////////////////////////////////////
+    enum Flags
+    {
+        Lighting     = 1 << 0, ///< The material is affected by the enabled lights
+        VertexColors = 1 << 1, ///< The colors of the vertices are multiplied with the material
+        AlphaTest    = 1 << 2, ///< Fragments less opaque than the alpha threshold are discarded
+
+        Default = Lighting | VertexColors ///< Default flags
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// Creates a white, non-specular material without texture,
+    /// using the default flags.
+    ///
+    ////////////////////////////////////////////////////////////
+    Material();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Copy constructor
+    ///
+    /// \param copy Instance to copy
+    ///
+    ////////////////////////////////////////////////////////////
+    Material(const Material& copy);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    ////////////////////////////////////////////////////////////
+    ~Material();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Overload of assignment operator
+    ///
+    /// \param right Instance to assign
+    ///
+    /// \return Reference to self
+    ///
+    ////////////////////////////////////////////////////////////
+    Material& operator =(const Material& right);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the diffuse color of the material
+    ///
+    /// The diffuse color is multiplied with the vertex colors
+    /// and the texture. Its alpha component sets the opacity
+    /// of the material. The default diffuse color is white.
+    ///
+    /// \param color New diffuse color
+    ///
+    /// \see getDiffuseColor
+    ///
+    ////////////////////////////////////////////////////////////
+    void setDiffuseColor(const Color& color);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the diffuse color of the material
+    ///
+    /// \return Diffuse color
+    ///
+    /// \see setDiffuseColor
+    ///
+    ////////////////////////////////////////////////////////////
+    const Color& getDiffuseColor() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the specular color of the material
+    ///
+    /// The specular color is multiplied with the specular color
+    /// of the lights to produce highlights. The default specular
+    /// color is black, which disables the highlights.
+    ///
+    /// \param color New specular color
+    ///
+    /// \see getSpecularColor
+    ///
+    ////////////////////////////////////////////////////////////
+    void setSpecularColor(const Color& color);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the specular color of the material
+    ///
+    /// \return Specular color
+    ///
+    /// \see setSpecularColor
+    ///
+    ////////////////////////////////////////////////////////////
+    const Color& getSpecularColor() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the shininess of the material
+    ///
+    /// The higher the shininess, the smaller and sharper the
+    /// highlights. The default shininess is 1.
+    ///
+    /// \param shininess New shininess
+    ///
+    /// \see getShininess
+    ///
+    ////////////////////////////////////////////////////////////
+    void setShininess(float shininess);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the shininess of the material
+    ///
+    /// \return Shininess
+    ///
+    /// \see setShininess
+    ///
+    ////////////////////////////////////////////////////////////
+    float getShininess() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the alpha threshold of the material
+    ///
+    /// When the AlphaTest flag is set, fragments whose alpha
+    /// is lower than the threshold are discarded. The default
+    /// threshold is 0.5.
+    ///
+    /// \param threshold New alpha threshold, in range [0, 1]
+    ///
+    /// \see getAlphaThreshold
+    ///
+    ////////////////////////////////////////////////////////////
+    void setAlphaThreshold(float threshold);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the alpha threshold of the material
+    ///
+    /// \return Alpha threshold
+    ///
+    /// \see setAlphaThreshold
+    ///
+    ////////////////////////////////////////////////////////////
+    float getAlphaThreshold() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the texture of the material
+    ///
+    /// The texture of the material replaces the one of the
+    /// render states. If the material has no texture, the
+    /// texture of the render states (if any) is used.
+    /// The \a texture argument refers to a texture that must
+    /// exist as long as the material uses it.
+    ///
+    /// \param texture New texture, or NULL to use the one of the render states
+    ///
+    /// \see getTexture
+    ///
+    ////////////////////////////////////////////////////////////
+    void setTexture(const Texture* texture);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the texture of the material
+    ///
+    /// \return Texture of the material, or NULL if it has none
+    ///
+    /// \see setTexture
+    ///
+    ////////////////////////////////////////////////////////////
+    const Texture* getTexture() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the features of the material
+    ///
+    /// \param flags Combination of sf3d::Material::Flags
+    ///
+    /// \see getFlags
+    ///
+    ////////////////////////////////////////////////////////////
+    void setFlags(Uint32 flags);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the features of the material
+    ///
+    /// \return Combination of sf3d::Material::Flags
+    ///
+    /// \see setFlags
+    ///
+    ////////////////////////////////////////////////////////////
+    Uint32 getFlags() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Compile the shaders the material can be drawn with
+    ///
+    /// Shaders are otherwise compiled the first time they are
+    /// needed, which may cause a hitch during rendering. Call
+    /// this function while loading to compile them up front,
+    /// after creating the shadow maps if any: lit materials use
+    /// separate shaders to sample them. An OpenGL context must
+    /// be active.
+    ///
+    /// \return True if all the shaders were compiled successfully
+    ///
+    ////////////////////////////////////////////////////////////
+    bool precompile() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of shader permutations compiled so far
+    ///
+    /// Materials sharing the same combination of features
+    /// share the same shader, each combination is only
+    /// compiled once.
+    ///
+    /// \return Number of compiled shader permutations
+    ///
+    ////////////////////////////////////////////////////////////
+    static unsigned int getPermutationCount();
+
+private :
+
+    friend class RenderTarget;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the shader permutation drawing the material
+    ///
+    /// \param textured Is a texture applied to the drawn object?
+    ///
+    /// \return Shader of the permutation, or NULL if it couldn't be compiled
+    ///
+    ////////////////////////////////////////////////////////////
+    const Shader* getShader(bool textured) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether the material is currently lit
+    ///
+    /// \return True if the material has the Lighting flag and lighting is enabled
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isLit() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Increase the reference count of the shader permutations
+    ///
+    /// Render targets hold a reference, so that the permutations
+    /// they may still point to outlive the materials.
+    ///
+    ////////////////////////////////////////////////////////////
+    static void increasePermutationReferences();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Decrease the reference count of the shader permutations
+    ///
+    /// The permutations are destroyed when the last material
+    /// and render target release them.
+    ///
+    ////////////////////////////////////////////////////////////
+    static void decreasePermutationReferences();
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    Color          m_diffuseColor;   ///< Diffuse color
+    Color          m_specularColor;  ///< Specular color
+    float          m_shininess;      ///< Specular exponent
+    float          m_alphaThreshold; ///< Minimum alpha of the fragments when alpha testing
+    const Texture* m_texture;        ///< Texture of the material
+    Uint32         m_flags;          ///< Combination of features
+    Uint64         m_cacheId;        ///< Unique number identifying the current state of the material
+};
+
+} // namespace sf3d
+
+
+#endif // SFML3D_MATERIAL_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class sf3d::Material
+/// \ingroup graphics
+///
+/// sf3d::Material describes how the surface of an object
+/// reacts to light: its diffuse and specular colors, its
+/// shininess and its texture.
+///
+/// The default shader handles every feature with runtime
+/// branches. When a material is given in the render states,
+/// the object is instead drawn with a variant of the default
+/// shader compiled for the exact features of the material:
+/// whether it is lit, textured, uses the vertex colors or
+/// discards transparent fragments. The variants are compiled
+/// once and shared by all the materials, and drawing with a
+/// material only uploads the material's own parameters when
+/// it changes.
+///
+/// Materials require the non-legacy rendering pipeline. A
+/// shader given in the render states takes precedence over
+/// the material, only its texture is used then.
+///
+/// Usage example:
+/// \code
+/// sf3d::Material metal;
+/// metal.setDiffuseColor(sf3d::Color(180, 180, 190));
+/// metal.setSpecularColor(sf3d::Color::White);
+/// metal.setShininess(32);
+/// metal.setTexture(&scratches);
+///
+/// sf3d::Material foliage;
+/// foliage.setTexture(&leaves);
+/// foliage.setFlags(sf3d::Material::Lighting | sf3d::Material::AlphaTest);
+///
+/// // While loading
+/// metal.precompile();
+/// foliage.precompile();
+///
+/// // In the main loop
+/// window.draw(robot, &metal);
+/// window.draw(tree, &foliage);
+/// \endcode
+///
+/// \see sf3d::RenderStates, sf3d::Light
+///
+////////////////////////////////////////////////////////////
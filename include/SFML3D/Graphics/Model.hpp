@@ -50,6 +50,18 @@ public :
     ////////////////////////////////////////////////////////////
     virtual Face getFace(unsigned int index) const;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Get a range of faces of the model
+    ///
+    /// \param vertices Array of vertices to fill, must have room for 3 * \a count vertices
+    /// \param first    Index of the first face to get
+    /// \param count    Number of faces to get
+    ///
+    /// \see getFace
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void getFaces(Vertex* vertices, unsigned int first, unsigned int count) const;
+
 protected :
 
     ////////////////////////////////////////////////////////////
@@ -146,6 +158,21 @@ protected :
     ////////////////////////////////////////////////////////////
     void clearFaces();
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the vertex indices of a face
+    ///
+    /// The result is undefined if \a index is out of the valid range.
+    ///
+    /// \param index  Index of the face to get, in range [0 .. getFaceCount() - 1]
+    /// \param index0 Receives the index of the first vertex
+    /// \param index1 Receives the index of the second vertex
+    /// \param index2 Receives the index of the third vertex
+    ///
+    /// \see addFace, getFaceCount
+    ///
+    ////////////////////////////////////////////////////////////
+    void getFaceIndices(unsigned int index, unsigned int& index0, unsigned int& index1, unsigned int& index2) const;
+
 private :
 
     ////////////////////////////////////////////////////////////
@@ -0,0 +1,371 @@
+#ifndef SFML3D_OCCLUSIONCULLER_HPP
+#define SFML3D_OCCLUSIONCULLER_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/Graphics/Export.hpp>
+#include <SFML3D/Graphics/Box.hpp>
+#include <SFML3D/Graphics/Image.hpp>
+#include <SFML3D/Graphics/RenderStates.hpp>
+#include <SFML3D/Graphics/Vertex.hpp>
+#include <SFML3D/Window/GlResource.hpp>
+#include <SFML3D/System/NonCopyable.hpp>
+#include <SFML3D/System/Vector2.hpp>
+#include <SFML3D/System/Time.hpp>
+#include <vector>
+
+
+namespace sf3d
+{
+class Drawable;
+class Polyhedron;
+class RenderTarget;
+class View;
+
+////////////////////////////////////////////////////////////
+/// \brief Skips the objects hidden behind occluders
+///
+////////////////////////////////////////////////////////////
+class SFML3D_GRAPHICS_API OcclusionCuller : GlResource, NonCopyable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// Creates a culler without occluders, with a 256x128
+    /// depth buffer and GPU queries disabled.
+    ///
+    ////////////////////////////////////////////////////////////
+    OcclusionCuller();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    /// The GPU queries are deleted in the context of the render
+    /// target that created them, see setGpuQueriesEnabled.
+    ///
+    ////////////////////////////////////////////////////////////
+    ~OcclusionCuller();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the resolution of the depth buffer
+    ///
+    /// The occluders are rasterized into a small depth buffer
+    /// on the CPU. A higher resolution culls more precisely
+    /// around the edges of the occluders, but costs more to
+    /// rasterize. The width is rounded up to a multiple of 4.
+    /// The default resolution is 256x128.
+    ///
+    /// \param width  Width of the depth buffer, in pixels
+    /// \param height Height of the depth buffer, in pixels
+    ///
+    /// \see getResolution
+    ///
+    ////////////////////////////////////////////////////////////
+    void setResolution(unsigned int width, unsigned int height);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the resolution of the depth buffer
+    ///
+    /// \return Size of the depth buffer, in pixels
+    ///
+    /// \see setResolution
+    ///
+    ////////////////////////////////////////////////////////////
+    Vector2u getResolution() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the maximum number of threads used to rasterize the occluders
+    ///
+    /// The depth buffer is split in tiles rasterized in
+    /// parallel. A count of 0 (the default) uses one thread per
+    /// processor, a count of 1 keeps all the work on the
+    /// calling thread.
+    ///
+    /// \param count Maximum number of threads
+    ///
+    /// \see getThreadCount
+    ///
+    ////////////////////////////////////////////////////////////
+    void setThreadCount(unsigned int count);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the maximum number of threads used to rasterize the occluders
+    ///
+    /// \return Maximum number of threads
+    ///
+    /// \see setThreadCount
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getThreadCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add a polyhedron hiding the objects behind it
+    ///
+    /// Good occluders are large and have few faces: walls,
+    /// floors, simplified versions of buildings. Their faces
+    /// are read by every update, so that they can move.
+    /// The \a occluder argument refers to an object that must
+    /// exist as long as the culler uses it.
+    ///
+    /// \param occluder Polyhedron hiding objects
+    ///
+    ////////////////////////////////////////////////////////////
+    void addOccluder(const Polyhedron& occluder);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove an occluder
+    ///
+    /// \param occluder Polyhedron to remove
+    ///
+    ////////////////////////////////////////////////////////////
+    void removeOccluder(const Polyhedron& occluder);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove all the occluders
+    ///
+    ////////////////////////////////////////////////////////////
+    void clearOccluders();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Rasterize the occluders as seen from a view
+    ///
+    /// This function must be called once per frame, before
+    /// testing or drawing the occludees, with the view used to
+    /// render the scene. It doesn't need an OpenGL context.
+    ///
+    /// \param view View used to render the scene
+    ///
+    ////////////////////////////////////////////////////////////
+    void update(const View& view);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether a box may be visible
+    ///
+    /// The test is conservative: a box is only reported as
+    /// hidden when it is outside the view, or entirely behind
+    /// the occluders rasterized by the last update.
+    ///
+    /// \param bounds Global bounds of the tested object
+    ///
+    /// \return True if the object may be visible, false if it is hidden
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isVisible(const FloatBox& bounds) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw an object unless it is hidden
+    ///
+    /// The bounds are first tested against the depth buffer
+    /// of the culler. When GPU queries are enabled, objects
+    /// that pass this test are additionally drawn with
+    /// conditional rendering: their bounding box is tested
+    /// against the depth buffer of the target, and the GPU
+    /// skips the object if none of the box is visible. Draw
+    /// the occluders, and the objects from front to back, to
+    /// get the most out of it.
+    ///
+    /// \param target   Render target to draw to
+    /// \param occludee Object to draw
+    /// \param bounds   Global bounds of the object
+    /// \param states   Render states to use for drawing
+    ///
+    /// \return True if the object was drawn, false if it was culled on the CPU
+    ///
+    ////////////////////////////////////////////////////////////
+    bool draw(RenderTarget& target, const Drawable& occludee, const FloatBox& bounds, const RenderStates& states = RenderStates::Default);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Enable or disable the GPU occlusion queries
+    ///
+    /// GPU queries are disabled by default. They are ignored
+    /// if the system doesn't support them. The queries belong
+    /// to the context of the render target they are drawn to,
+    /// so that target must exist as long as the culler keeps
+    /// them. They are deleted when the queries are disabled,
+    /// when the culler is destroyed, or when it draws to
+    /// another render target.
+    ///
+    /// \param enabled True to enable the GPU queries
+    ///
+    /// \see areGpuQueriesEnabled, isGpuQueryAvailable
+    ///
+    ////////////////////////////////////////////////////////////
+    void setGpuQueriesEnabled(bool enabled);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether the GPU occlusion queries are enabled
+    ///
+    /// \return True if the GPU queries are enabled
+    ///
+    /// \see setGpuQueriesEnabled
+    ///
+    ////////////////////////////////////////////////////////////
+    bool areGpuQueriesEnabled() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of occluder triangles rasterized by the last update
+    ///
+    /// \return Number of triangles
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getTriangleCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the time spent rasterizing the occluders during the last update
+    ///
+    /// Together with getTriangleCount, it gives the throughput
+    /// of the rasterizer.
+    ///
+    /// \return Duration of the last update
+    ///
+    ////////////////////////////////////////////////////////////
+    Time getUpdateTime() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of boxes tested since the last update
+    ///
+    /// \return Number of tested boxes
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getTestedCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of boxes found hidden since the last update
+    ///
+    /// Divided by getTestedCount, it gives the ratio of
+    /// objects culled on the CPU.
+    ///
+    /// \return Number of hidden boxes
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getCulledCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Copy the depth buffer to an image
+    ///
+    /// Close occluders are bright, empty areas are black.
+    /// This function is meant for debugging.
+    ///
+    /// \return Image containing the depth buffer
+    ///
+    ////////////////////////////////////////////////////////////
+    Image copyToImage() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether or not the system supports GPU occlusion queries
+    ///
+    /// Both occlusion queries and conditional rendering are
+    /// required.
+    ///
+    /// \return True if GPU occlusion queries are supported
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool isGpuQueryAvailable();
+
+private :
+
+    struct RasterTask;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Delete the GPU queries in the context of the render target that created them
+    ///
+    ////////////////////////////////////////////////////////////
+    void releaseQueries();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Clip, project and bin a triangle
+    ///
+    /// \param clip Clip space coordinates of the 3 vertices (x, y, z, w)
+    ///
+    ////////////////////////////////////////////////////////////
+    void addTriangle(const float* clip);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Rasterize the triangles of a tile
+    ///
+    /// \param tile Index of the tile
+    ///
+    ////////////////////////////////////////////////////////////
+    void rasterizeTile(std::size_t tile);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Test a box against the depth buffer
+    ///
+    /// \param bounds    Global bounds of the tested object
+    /// \param nearPlane Set to true if the box crosses the near plane
+    ///
+    /// \return True if the box may be visible
+    ///
+    ////////////////////////////////////////////////////////////
+    bool testBounds(const FloatBox& bounds, bool& nearPlane) const;
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    std::vector<const Polyhedron*>    m_occluders;     ///< Polyhedra hiding objects
+    unsigned int                      m_width;         ///< Width of the depth buffer
+    unsigned int                      m_height;        ///< Height of the depth buffer
+    unsigned int                      m_threadCount;   ///< Maximum number of threads
+    float                             m_matrix[16];    ///< View projection matrix of the last update
+    std::vector<float>                m_depth;         ///< Depth buffer, normalized device depth
+    std::vector<float>                m_triangles;     ///< Screen space triangles, 3 vertices of (x, y, z)
+    std::vector<std::vector<Uint32> > m_bins;          ///< Triangles overlapping each tile
+    std::vector<Vertex>               m_faces;         ///< Faces of the occluder being rasterized
+    bool                              m_gpuQueries;    ///< Are the GPU queries enabled?
+    std::vector<unsigned int>         m_queries;       ///< Pool of query objects
+    RenderTarget*                     m_queryTarget;   ///< Render target whose context owns the queries
+    std::size_t                       m_nextQuery;     ///< Index of the next free query of the pool
+    unsigned int                      m_triangleCount; ///< Number of triangles rasterized by the last update
+    Time                              m_updateTime;    ///< Duration of the last update
+    mutable unsigned int              m_tested;        ///< Number of boxes tested since the last update
+    mutable unsigned int              m_culled;        ///< Number of boxes hidden since the last update
+};
+
+} // namespace sf3d
+
+
+#endif // SFML3D_OCCLUSIONCULLER_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class sf3d::OcclusionCuller
+/// \ingroup graphics
+///
+/// In dense scenes, most objects are hidden behind walls but
+/// still cost a draw call and their whole geometry.
+/// sf3d::OcclusionCuller rasterizes a few large occluders
+/// into a small depth buffer on the CPU, then tests the
+/// bounding boxes of the other objects against it, so that
+/// hidden objects are not drawn at all.
+///
+/// The rasterizer bins the triangles into tiles that are
+/// rasterized in parallel, using SIMD instructions where
+/// available. It doesn't use OpenGL, so it can also run
+/// without a window.
+///
+/// Optionally, the objects passing the CPU test can be
+/// drawn with GPU occlusion queries and conditional
+/// rendering, which catches the objects hidden by geometry
+/// that isn't registered as an occluder.
+///
+/// Usage example:
+/// \code
+/// sf3d::OcclusionCuller culler;
+/// culler.addOccluder(walls);
+/// culler.addOccluder(floor);
+///
+/// // In the main loop
+/// culler.update(camera);
+/// window.setView(camera);
+/// window.draw(walls);
+/// window.draw(floor);
+/// for (std::size_t i = 0; i < props.size(); ++i)
+///     culler.draw(window, props[i], props[i].getGlobalBounds());
+/// \endcode
+///
+/// \see sf3d::Polyhedron, sf3d::View
+///
+////////////////////////////////////////////////////////////
@@ -0,0 +1,325 @@
+#ifndef SFML3D_PARTICLESYSTEM_HPP
+#define SFML3D_PARTICLESYSTEM_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/Graphics/Export.hpp>
+#include <SFML3D/Graphics/Drawable.hpp>
+#include <SFML3D/Graphics/Transformable.hpp>
+#include <SFML3D/Graphics/Vertex.hpp>
+#include <SFML3D/Graphics/Color.hpp>
+#include <SFML3D/Graphics/Rect.hpp>
+#include <SFML3D/System/Vector3.hpp>
+#include <SFML3D/System/Time.hpp>
+#include <SFML3D/System/NonCopyable.hpp>
+#include <vector>
+
+
+namespace sf3d
+{
+class Camera;
+class Texture;
+class VertexBuffer;
+
+////////////////////////////////////////////////////////////
+/// \brief Large set of textured quads simulated and drawn together
+///
+////////////////////////////////////////////////////////////
+class SFML3D_GRAPHICS_API ParticleSystem : public Drawable, public Transformable, NonCopyable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Initial state of a particle
+    ///
+    ////////////////////////////////////////////////////////////
+    struct SFML3D_GRAPHICS_API Particle
+    {
+        ////////////////////////////////////////////////////////////
+        /// \brief Default constructor
+        ///
+        /// Creates a white particle of size 1 at the origin,
+        /// without velocity and living for 1 second.
+        ///
+        ////////////////////////////////////////////////////////////
+        Particle();
+
+        Vector3f position; ///< Position, in local coordinates
+        Vector3f velocity; ///< Velocity, in units per second
+        Color    color;    ///< Color
+        float    size;     ///< Length of the sides of the quad
+        Time     lifetime; ///< Time before the particle disappears
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// Creates an empty particle system.
+    ///
+    ////////////////////////////////////////////////////////////
+    ParticleSystem();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    ////////////////////////////////////////////////////////////
+    ~ParticleSystem();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add a particle to the system
+    ///
+    /// \param particle Initial state of the particle
+    ///
+    ////////////////////////////////////////////////////////////
+    void emit(const Particle& particle);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove all the particles
+    ///
+    ////////////////////////////////////////////////////////////
+    void clear();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of living particles
+    ///
+    /// \return Number of particles
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getParticleCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the acceleration applied to every particle
+    ///
+    /// This is typically used for gravity or wind.
+    /// The default acceleration is (0, 0, 0).
+    ///
+    /// \param acceleration Acceleration, in units per second squared
+    ///
+    /// \see getAcceleration
+    ///
+    ////////////////////////////////////////////////////////////
+    void setAcceleration(const Vector3f& acceleration);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the acceleration applied to every particle
+    ///
+    /// \return Acceleration, in units per second squared
+    ///
+    /// \see setAcceleration
+    ///
+    ////////////////////////////////////////////////////////////
+    const Vector3f& getAcceleration() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the camera the particles should face
+    ///
+    /// Like sf3d::Billboard, every particle is rotated to face
+    /// the camera. The \a camera argument refers to a camera
+    /// that must exist as long as the particle system uses it.
+    /// Without camera, the particles face the Z axis.
+    ///
+    /// \param camera Camera to face
+    ///
+    /// \see getCamera
+    ///
+    ////////////////////////////////////////////////////////////
+    void setCamera(const Camera& camera);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the camera the particles face
+    ///
+    /// \return Pointer to the camera, NULL if none is set
+    ///
+    /// \see setCamera
+    ///
+    ////////////////////////////////////////////////////////////
+    const Camera* getCamera() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change the texture of the particles
+    ///
+    /// The \a texture argument refers to a texture that must
+    /// exist as long as the particle system uses it.
+    ///
+    /// \param texture   New texture, can be NULL
+    /// \param resetRect Should the texture rect be reset to the size of the new texture?
+    ///
+    /// \see getTexture, setTextureRect
+    ///
+    ////////////////////////////////////////////////////////////
+    void setTexture(const Texture* texture, bool resetRect = false);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the texture of the particles
+    ///
+    /// \return Pointer to the texture
+    ///
+    /// \see setTexture
+    ///
+    ////////////////////////////////////////////////////////////
+    const Texture* getTexture() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the part of the texture mapped on every particle
+    ///
+    /// \param rectangle Rectangle defining the region of the texture to display
+    ///
+    /// \see getTextureRect, setTexture
+    ///
+    ////////////////////////////////////////////////////////////
+    void setTextureRect(const IntRect& rectangle);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the part of the texture mapped on every particle
+    ///
+    /// \return Texture rectangle of the particles
+    ///
+    /// \see setTextureRect
+    ///
+    ////////////////////////////////////////////////////////////
+    const IntRect& getTextureRect() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the maximum number of threads used to update and draw
+    ///
+    /// Large particle counts are split across several threads.
+    /// A count of 0 (the default) uses one thread per processor,
+    /// a count of 1 keeps all the work on the calling thread.
+    ///
+    /// \param count Maximum number of threads
+    ///
+    /// \see getThreadCount
+    ///
+    ////////////////////////////////////////////////////////////
+    void setThreadCount(unsigned int count);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the maximum number of threads used to update and draw
+    ///
+    /// \return Maximum number of threads
+    ///
+    /// \see setThreadCount
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getThreadCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Advance the simulation
+    ///
+    /// Moves the particles according to their velocity and
+    /// the acceleration of the system, and removes those whose
+    /// lifetime is over.
+    ///
+    /// \param elapsed Time elapsed since the last update
+    ///
+    ////////////////////////////////////////////////////////////
+    void update(Time elapsed);
+
+private :
+
+    struct UpdateTask;
+    struct EmitTask;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw the particles to a render target
+    ///
+    /// \param target Render target to draw to
+    /// \param states Current render states
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void draw(RenderTarget& target, RenderStates states) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Simulate a range of particles
+    ///
+    /// \param begin   Index of the first particle
+    /// \param end     Index one past the last particle
+    /// \param seconds Elapsed time, in seconds
+    ///
+    ////////////////////////////////////////////////////////////
+    void updateParticles(std::size_t begin, std::size_t end, float seconds);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Write the quads of a range of particles
+    ///
+    /// \param begin    Index of the first particle
+    /// \param end      Index one past the last particle
+    /// \param viewer   Position of the camera in local coordinates
+    /// \param vertices Array receiving 6 vertices per particle
+    ///
+    ////////////////////////////////////////////////////////////
+    void emitQuads(std::size_t begin, std::size_t end, const Vector3f& viewer, Vertex* vertices) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove a particle, replacing it with the last one
+    ///
+    /// \param index Index of the particle to remove
+    ///
+    ////////////////////////////////////////////////////////////
+    void removeParticle(std::size_t index);
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    std::vector<float>          m_positionsX;   ///< X coordinate of the particles
+    std::vector<float>          m_positionsY;   ///< Y coordinate of the particles
+    std::vector<float>          m_positionsZ;   ///< Z coordinate of the particles
+    std::vector<float>          m_velocitiesX;  ///< X velocity of the particles
+    std::vector<float>          m_velocitiesY;  ///< Y velocity of the particles
+    std::vector<float>          m_velocitiesZ;  ///< Z velocity of the particles
+    std::vector<float>          m_sizes;        ///< Size of the particles
+    std::vector<float>          m_lifetimes;    ///< Remaining lifetime of the particles, in seconds
+    std::vector<Color>          m_colors;       ///< Color of the particles
+    Vector3f                    m_acceleration; ///< Acceleration applied to the particles
+    const Camera*               m_camera;       ///< Camera the particles face
+    const Texture*              m_texture;      ///< Texture of the particles
+    IntRect                     m_textureRect;  ///< Rectangle of the texture mapped on the particles
+    unsigned int                m_threadCount;  ///< Maximum number of threads
+    VertexBuffer*               m_buffer;       ///< Streaming buffer receiving the quads, NULL if unsupported
+    mutable std::vector<Vertex> m_vertices;     ///< Quads, when vertex buffers are not supported
+};
+
+} // namespace sf3d
+
+
+#endif // SFML3D_PARTICLESYSTEM_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class sf3d::ParticleSystem
+/// \ingroup graphics
+///
+/// sf3d::ParticleSystem simulates and draws a large number of
+/// small textured quads, such as smoke, sparks or rain, far
+/// more efficiently than one sf3d::Billboard per particle.
+///
+/// The particles are stored attribute by attribute rather than
+/// particle by particle, which lets update and draw process
+/// several particles at once with SIMD instructions, and split
+/// big systems across threads. All the quads are written to a
+/// single streaming vertex buffer and drawn in one call.
+///
+/// The whole system shares the texture, texture rectangle and
+/// transform; each particle has its own position, velocity,
+/// color, size and lifetime.
+///
+/// Usage example:
+/// \code
+/// sf3d::ParticleSystem smoke;
+/// smoke.setTexture(&puff, true);
+/// smoke.setCamera(camera);
+/// smoke.setAcceleration(sf3d::Vector3f(0, 2, 0));
+///
+/// sf3d::ParticleSystem::Particle particle;
+/// particle.velocity = sf3d::Vector3f(0, 1, 0);
+/// particle.lifetime = sf3d::seconds(3);
+/// smoke.emit(particle);
+///
+/// smoke.update(clock.restart());
+/// window.draw(smoke);
+/// \endcode
+///
+/// \see sf3d::Billboard, sf3d::Camera
+///
+////////////////////////////////////////////////////////////
@@ -0,0 +1,204 @@
+#ifndef SFML3D_PIXELREADER_HPP
+#define SFML3D_PIXELREADER_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/Graphics/Export.hpp>
+#include <SFML3D/Window/GlResource.hpp>
+#include <SFML3D/System/NonCopyable.hpp>
+#include <vector>
+
+
+namespace sf3d
+{
+class Image;
+class Texture;
+class Window;
+
+////////////////////////////////////////////////////////////
+/// \brief Copies textures and windows to images without
+///        stalling the graphics pipeline
+///
+////////////////////////////////////////////////////////////
+class SFML3D_GRAPHICS_API PixelReader : GlResource, NonCopyable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Constructor
+    ///
+    /// The reader can have up to \a bufferCount copies in flight
+    /// at the same time. With one copy requested per frame and
+    /// fetched a frame or two later, 3 buffers never block.
+    ///
+    /// \param bufferCount Maximum number of pending copies
+    ///
+    ////////////////////////////////////////////////////////////
+    explicit PixelReader(unsigned int bufferCount = 3);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    ////////////////////////////////////////////////////////////
+    ~PixelReader();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Start copying the contents of a texture
+    ///
+    /// The copy is queued on the graphics card, and returns
+    /// immediately. Only 2D textures can be copied.
+    ///
+    /// \param texture Texture to copy
+    ///
+    /// \return True if the copy was queued, false if all the buffers are pending
+    ///
+    /// \see fetch
+    ///
+    ////////////////////////////////////////////////////////////
+    bool requestCopy(const Texture& texture);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Start copying the contents of a window
+    ///
+    /// The back buffer is copied, so this should be called
+    /// after drawing and before display, like RenderWindow::capture.
+    /// The window is activated for rendering.
+    ///
+    /// \param window Window to copy
+    ///
+    /// \return True if the copy was queued, false if all the buffers are pending
+    ///
+    /// \see fetch
+    ///
+    ////////////////////////////////////////////////////////////
+    bool requestCopy(const Window& window);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether the oldest pending copy has completed
+    ///
+    /// \return True if fetch would return without waiting
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isReady() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Retrieve the oldest pending copy
+    ///
+    /// Copies are fetched in the order they were requested.
+    /// If the copy has not completed yet, the function either
+    /// returns false immediately or, if \a wait is true, waits
+    /// for it to complete.
+    ///
+    /// \param image Image receiving the copied pixels
+    /// \param wait  Wait for the copy if it is not ready?
+    ///
+    /// \return True if an image was fetched
+    ///
+    /// \see requestCopy, isReady
+    ///
+    ////////////////////////////////////////////////////////////
+    bool fetch(Image& image, bool wait = false);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of copies requested but not fetched yet
+    ///
+    /// \return Number of pending copies
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getPendingCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether the system supports asynchronous copies
+    ///
+    /// This requires pixel buffer objects. Without them, the
+    /// reader still works, but every copy is made synchronously
+    /// when it is requested.
+    ///
+    /// \return True if copies are asynchronous
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool isAvailable();
+
+private :
+
+    struct Request;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the slot of the next request, if any is free
+    ///
+    /// \return Pointer to the free slot, NULL if all are pending
+    ///
+    ////////////////////////////////////////////////////////////
+    Request* getFreeRequest();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Size the buffer of a request and bind it for packing
+    ///
+    /// \param request Request to prepare
+    /// \param size    Number of bytes that will be copied
+    ///
+    ////////////////////////////////////////////////////////////
+    void prepareBuffer(Request& request, std::size_t size);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Mark a request as pending, once its copy is queued
+    ///
+    /// \param request Request that was just queued
+    ///
+    ////////////////////////////////////////////////////////////
+    void submit(Request& request);
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    std::vector<Request*> m_requests; ///< Ring of requests
+    std::size_t           m_first;    ///< Index of the oldest pending request
+    std::size_t           m_count;    ///< Number of pending requests
+};
+
+} // namespace sf3d
+
+
+#endif // SFML3D_PIXELREADER_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class sf3d::PixelReader
+/// \ingroup graphics
+///
+/// Texture::copyToImage and RenderWindow::capture wait for the
+/// graphics card to finish rendering, then for the pixels to be
+/// transferred, before they return. When done every frame, for
+/// video recording for example, this stall costs far more than
+/// the copy itself.
+///
+/// sf3d::PixelReader splits the copy in two: requestCopy queues
+/// the transfer into a pixel buffer object on the graphics card
+/// and returns immediately, and fetch retrieves the pixels once
+/// the transfer has completed, usually a frame or two later.
+/// Several copies can be in flight at the same time, so that
+/// continuous capture never waits.
+///
+/// When pixel buffer objects are not supported, the copy is
+/// made synchronously by requestCopy, and fetch returns it.
+///
+/// Usage example:
+/// \code
+/// sf3d::PixelReader reader;
+/// while (window.isOpen())
+/// {
+///     ... draw the scene ...
+///
+///     reader.requestCopy(window);
+///     window.display();
+///
+///     sf3d::Image frame;
+///     while (reader.fetch(frame))
+///         recorder.addFrame(frame);
+/// }
+/// \endcode
+///
+/// \see sf3d::Texture, sf3d::RenderWindow, sf3d::Image
+///
+////////////////////////////////////////////////////////////
@@ -0,0 +1,180 @@
+#ifndef SFML3D_PIXELWRITER_HPP
+#define SFML3D_PIXELWRITER_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/Graphics/Export.hpp>
+#include <SFML3D/Window/GlResource.hpp>
+#include <SFML3D/System/NonCopyable.hpp>
+#include <SFML3D/System/Vector2.hpp>
+#include <vector>
+
+
+namespace sf3d
+{
+class Image;
+class Texture;
+
+////////////////////////////////////////////////////////////
+/// \brief Streams pixels to textures without stalling the
+///        graphics pipeline
+///
+////////////////////////////////////////////////////////////
+class SFML3D_GRAPHICS_API PixelWriter : GlResource, NonCopyable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Constructor
+    ///
+    /// The writer cycles through \a bufferCount buffers, so
+    /// that a new upload never waits for the graphics card to
+    /// finish reading the previous ones.
+    ///
+    /// \param bufferCount Number of buffers in the ring
+    ///
+    ////////////////////////////////////////////////////////////
+    explicit PixelWriter(unsigned int bufferCount = 3);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    ////////////////////////////////////////////////////////////
+    ~PixelWriter();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get memory to write the pixels of the next upload to
+    ///
+    /// The returned array has room for \a width x \a height RGBA
+    /// pixels, row by row. It is mapped directly from a buffer
+    /// of the graphics card when possible, so writing the pixels
+    /// there (decoding a video frame into it, for example) saves
+    /// a copy. It stays valid until upload is called.
+    ///
+    /// \param width  Width of the area to upload
+    /// \param height Height of the area to upload
+    ///
+    /// \return Pointer to the pixels to fill, NULL on failure
+    ///
+    /// \see upload
+    ///
+    ////////////////////////////////////////////////////////////
+    Uint8* map(unsigned int width, unsigned int height);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Upload the pixels written to the mapped memory
+    ///
+    /// The upload is queued on the graphics card and the function
+    /// returns immediately. The area must fit in the texture.
+    ///
+    /// \param texture Texture to update
+    /// \param x       X offset in the texture where to copy the pixels
+    /// \param y       Y offset in the texture where to copy the pixels
+    ///
+    /// \return True if the upload was queued
+    ///
+    /// \see map
+    ///
+    ////////////////////////////////////////////////////////////
+    bool upload(Texture& texture, unsigned int x = 0, unsigned int y = 0);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Update a part of a texture from an array of pixels
+    ///
+    /// This is a shortcut for map, a copy of the pixels, and upload.
+    ///
+    /// \param texture Texture to update
+    /// \param pixels  Array of pixels to copy to the texture
+    /// \param width   Width of the pixel region contained in \a pixels
+    /// \param height  Height of the pixel region contained in \a pixels
+    /// \param x       X offset in the texture where to copy the source pixels
+    /// \param y       Y offset in the texture where to copy the source pixels
+    ///
+    /// \return True if the upload was queued
+    ///
+    ////////////////////////////////////////////////////////////
+    bool update(Texture& texture, const Uint8* pixels, unsigned int width, unsigned int height, unsigned int x = 0, unsigned int y = 0);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Update a part of a texture from an image
+    ///
+    /// \param texture Texture to update
+    /// \param image   Image to copy to the texture
+    /// \param x       X offset in the texture where to copy the image
+    /// \param y       Y offset in the texture where to copy the image
+    ///
+    /// \return True if the upload was queued
+    ///
+    ////////////////////////////////////////////////////////////
+    bool update(Texture& texture, const Image& image, unsigned int x = 0, unsigned int y = 0);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether the system supports streaming uploads
+    ///
+    /// This requires pixel buffer objects. Without them, the
+    /// writer still works, but uploads are made synchronously
+    /// from system memory, like Texture::update.
+    ///
+    /// \return True if uploads are streamed
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool isAvailable();
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    std::vector<unsigned int> m_buffers;    ///< Ring of pixel buffer objects
+    std::vector<std::size_t>  m_sizes;      ///< Allocated size of each buffer, in bytes
+    std::size_t               m_current;    ///< Index of the buffer used by the next upload
+    Vector2u                  m_mappedSize; ///< Size of the mapped area, (0, 0) if nothing is mapped
+    std::vector<Uint8>        m_pixels;     ///< Pixels in system memory, when pixel buffers are not supported
+};
+
+} // namespace sf3d
+
+
+#endif // SFML3D_PIXELWRITER_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class sf3d::PixelWriter
+/// \ingroup graphics
+///
+/// Texture::update copies the pixels from system memory when
+/// it is called, and the driver often has to wait for the
+/// graphics card to stop using the texture before it can
+/// return. For textures updated every frame, such as video
+/// frames or a dynamic minimap, this stall dominates the frame.
+///
+/// sf3d::PixelWriter writes the pixels into a pixel buffer
+/// object instead, and queues the transfer to the texture from
+/// that buffer. The buffers are used in turn, so that writing
+/// the next frame never waits for the previous one to be read.
+///
+/// Usage example:
+/// \code
+/// sf3d::Texture texture;
+/// texture.create(1280, 720);
+/// sf3d::PixelWriter writer;
+///
+/// while (window.isOpen())
+/// {
+///     // Decode the next video frame directly into the buffer
+///     sf3d::Uint8* pixels = writer.map(1280, 720);
+///     if (pixels)
+///     {
+///         decoder.decodeFrame(pixels);
+///         writer.upload(texture);
+///     }
+///
+///     window.draw(sf3d::Sprite(texture));
+///     ...
+/// }
+/// \endcode
+///
+/// \see sf3d::Texture, sf3d::PixelReader
+///
+////////////////////////////////////////////////////////////
@@ -121,6 +121,26 @@ public :
     ////////////////////////////////////////////////////////////
     virtual Face getFace(unsigned int index) const = 0;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Get a range of faces of the polyhedron
+    ///
+    /// The vertices of the faces are written contiguously to
+    /// \a vertices, which must have room for 3 * \a count
+    /// vertices. The default implementation calls getFace for
+    /// each face, derived classes that store their geometry
+    /// can override it to copy it in bulk.
+    ///
+    /// The result is undefined if the range is out of bounds.
+    ///
+    /// \param vertices Array of vertices to fill
+    /// \param first    Index of the first face to get
+    /// \param count    Number of faces to get
+    ///
+    /// \see getFace, getFaceCount
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void getFaces(Vertex* vertices, unsigned int first, unsigned int count) const;
+
     ////////////////////////////////////////////////////////////
     /// \brief Get the local bounding box of the entity
     ///
@@ -158,12 +178,34 @@ public :
     ///
     /// This will generate the same normal for all 3 vertices
     /// of a face, so if smooth lighting or per-pixel lighting
-    /// is required, you still need to specify your own normal
-    /// data through other means.
+    /// is required, use generateSmoothNormals or specify your
+    /// own normal data through other means.
+    ///
+    /// \see generateSmoothNormals
     ///
     ////////////////////////////////////////////////////////////
     virtual void generateNormals();
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Generate smooth normals using face data
+    ///
+    /// Vertices sharing the same position are welded together
+    /// and receive the average of the normals of the faces
+    /// around them, weighted by the angle of each face at the
+    /// vertex. Faces whose normals differ by more than
+    /// \a creaseAngle are not averaged, which keeps sharp
+    /// edges (e.g. the sides of a cylinder) hard.
+    ///
+    /// Shared positions are found with a spatial hash, and
+    /// large meshes are processed by several threads.
+    ///
+    /// \param creaseAngle Maximum angle between faces that are smoothed, in degrees
+    ///
+    /// \see generateNormals
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void generateSmoothNormals(float creaseAngle = 180.f);
+
 protected :
 
     ////////////////////////////////////////////////////////////
@@ -183,17 +225,21 @@ protected :
     ////////////////////////////////////////////////////////////
     void update() const;
 
-private :
-
     ////////////////////////////////////////////////////////////
     /// \brief Draw the polyhedron to a render target
     ///
+    /// Derived classes can override this function to alter
+    /// the render states (e.g. to set a shader) and then
+    /// forward the call to the base implementation.
+    ///
     /// \param target Render target to draw to
     /// \param states Current render states
     ///
     ////////////////////////////////////////////////////////////
     virtual void draw(RenderTarget& target, RenderStates states) const;
 
+private :
+
     ////////////////////////////////////////////////////////////
     /// \brief Update the vertices' color
     ///
@@ -0,0 +1,249 @@
+#ifndef SFML3D_POSTPROCESSCHAIN_HPP
+#define SFML3D_POSTPROCESSCHAIN_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/Graphics/Export.hpp>
+#include <SFML3D/Graphics/RenderTexture.hpp>
+#include <SFML3D/System/NonCopyable.hpp>
+#include <SFML3D/System/Vector2.hpp>
+#include <SFML3D/System/Time.hpp>
+#include <vector>
+
+
+namespace sf3d
+{
+class Shader;
+class Texture;
+
+////////////////////////////////////////////////////////////
+/// \brief Sequence of full-screen shader passes sharing
+///        a pool of render textures
+///
+////////////////////////////////////////////////////////////
+class SFML3D_GRAPHICS_API PostProcessChain : NonCopyable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// Creates a chain without passes, rendering to Rgba8 textures.
+    ///
+    ////////////////////////////////////////////////////////////
+    PostProcessChain();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    ////////////////////////////////////////////////////////////
+    ~PostProcessChain();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Append a pass to the chain
+    ///
+    /// The pass draws a triangle covering its whole output
+    /// with \a shader, the output of the previous pass (or the
+    /// source, for the first pass) being the current texture.
+    /// The output of the pass is \a scale times the size of
+    /// the source: 0.5 for a half resolution pass, 0.25 for a
+    /// quarter resolution one.
+    ///
+    /// The \a shader argument refers to a shader that must
+    /// exist as long as the chain uses it.
+    ///
+    /// \param shader Shader of the pass
+    /// \param scale  Size of the output, relative to the source
+    ///
+    /// \return Index of the pass
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t addPass(const Shader& shader, float scale = 1.f);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove all the passes
+    ///
+    /// The pooled render textures are kept.
+    ///
+    ////////////////////////////////////////////////////////////
+    void clearPasses();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of passes
+    ///
+    /// \return Number of passes
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getPassCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the format of the intermediate textures
+    ///
+    /// Floating point formats keep the high dynamic range of a
+    /// scene until the tone mapping pass. Changing the format
+    /// releases the pooled render textures.
+    ///
+    /// \param format Format of the intermediate textures
+    ///
+    /// \see getFormat
+    ///
+    ////////////////////////////////////////////////////////////
+    void setFormat(RenderTexture::Format format);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the format of the intermediate textures
+    ///
+    /// \return Format of the intermediate textures
+    ///
+    /// \see setFormat
+    ///
+    ////////////////////////////////////////////////////////////
+    RenderTexture::Format getFormat() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Enable or disable the profiling of the passes
+    ///
+    /// The graphics card runs asynchronously, so by default the
+    /// pass timings only measure the time spent issuing the
+    /// passes. When profiling is enabled, the chain waits for
+    /// every pass to complete, so that the timings measure its
+    /// execution by the graphics card too. This stalls the
+    /// pipeline: only enable it while profiling.
+    ///
+    /// \param enabled True to enable profiling
+    ///
+    /// \see getPassTime
+    ///
+    ////////////////////////////////////////////////////////////
+    void setProfilingEnabled(bool enabled);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether the profiling of the passes is enabled
+    ///
+    /// \return True if profiling is enabled
+    ///
+    /// \see setProfilingEnabled
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isProfilingEnabled() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Run all the passes on a texture
+    ///
+    /// Every pass renders to a render texture of the pool. A
+    /// render texture goes back to the pool as soon as the next
+    /// pass has read it, so a chain of passes of the same size
+    /// only ever uses two of them, alternately. The pool keeps
+    /// the render textures from one call to the next, and
+    /// releases those that the call didn't need.
+    ///
+    /// The returned texture is owned by the chain, and is only
+    /// valid until the next call to apply. If the chain has no
+    /// pass, or a render texture can't be created, the source is
+    /// returned.
+    ///
+    /// \param source Texture to process
+    ///
+    /// \return Output of the last pass
+    ///
+    ////////////////////////////////////////////////////////////
+    const Texture& apply(const Texture& source);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the time taken by a pass during the last apply
+    ///
+    /// \param index Index of the pass
+    ///
+    /// \return Duration of the pass
+    ///
+    /// \see setProfilingEnabled
+    ///
+    ////////////////////////////////////////////////////////////
+    Time getPassTime(std::size_t index) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the video memory used by the pooled render textures
+    ///
+    /// \return Size of the pooled render textures, in bytes
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getMemoryUsage() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destroy all the pooled render textures
+    ///
+    ////////////////////////////////////////////////////////////
+    void releaseTextures();
+
+private :
+
+    struct Pass;
+    struct Target;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get a free render texture of a given size from the pool
+    ///
+    /// A new render texture is created if none is available.
+    ///
+    /// \param size Size of the render texture
+    ///
+    /// \return Pooled render texture, NULL if it couldn't be created
+    ///
+    ////////////////////////////////////////////////////////////
+    Target* acquireTarget(const Vector2u& size);
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    std::vector<Pass*>    m_passes;    ///< Passes, in order
+    std::vector<Target*>  m_targets;   ///< Pool of render textures
+    RenderTexture::Format m_format;    ///< Format of the render textures
+    bool                  m_profiling; ///< Wait for every pass to complete?
+};
+
+} // namespace sf3d
+
+
+#endif // SFML3D_POSTPROCESSCHAIN_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class sf3d::PostProcessChain
+/// \ingroup graphics
+///
+/// sf3d::PostProcessChain runs a sequence of full-screen effects,
+/// such as bloom, blur or tone mapping, on a rendered scene.
+/// Each pass is a shader drawn on a single triangle covering
+/// its output, reading the output of the previous pass as its
+/// current texture.
+///
+/// Instead of one render texture per effect, the chain keeps a
+/// small pool of render textures, grouped by size, and reuses
+/// them from pass to pass and from frame to frame. Passes can
+/// run at a fraction of the source resolution, which is both
+/// cheaper and what blur effects usually want.
+///
+/// The shaders of the passes are regular sf3d::Shader programs:
+/// they receive the input texture like any textured drawable.
+/// Extra inputs, like the original scene for a bloom combine
+/// pass, are passed as shader parameters.
+///
+/// Usage example:
+/// \code
+/// sf3d::PostProcessChain chain;
+/// chain.setFormat(sf3d::RenderTexture::Rgba16f);
+/// chain.addPass(brightPass, 0.5f);
+/// chain.addPass(horizontalBlur, 0.25f);
+/// chain.addPass(verticalBlur, 0.25f);
+/// chain.addPass(combine);
+///
+/// // In the main loop, after rendering the scene to a render texture
+/// combine.setParameter("scene", scene.getTexture());
+/// const sf3d::Texture& result = chain.apply(scene.getTexture());
+/// window.draw(sf3d::Sprite(result));
+/// \endcode
+///
+/// \see sf3d::RenderTexture, sf3d::Shader
+///
+////////////////////////////////////////////////////////////
@@ -36,6 +36,7 @@
 namespace sf3d
 {
 class Shader;
+class Material;
 class Texture;
 
 ////////////////////////////////////////////////////////////
@@ -56,6 +57,7 @@ public :
     /// \li the identity transform
     /// \li a null texture
     /// \li a null shader
+    /// \li a null material
     ///
     ////////////////////////////////////////////////////////////
     RenderStates();
@@ -92,6 +94,14 @@ public :
     ////////////////////////////////////////////////////////////
     RenderStates(const Shader* theShader);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Construct a default set of render states with a custom material
+    ///
+    /// \param theMaterial Material to use
+    ///
+    ////////////////////////////////////////////////////////////
+    RenderStates(const Material* theMaterial);
+
     ////////////////////////////////////////////////////////////
     /// \brief Construct a set of render states with all its attributes
     ///
@@ -112,10 +122,11 @@ public :
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
-    BlendMode      blendMode;      ///< Blending mode
-    Transform      transform;      ///< Transform
-    const Texture* texture;        ///< Texture
-    const Shader*  shader;         ///< Shader
+    BlendMode       blendMode; ///< Blending mode
+    Transform       transform; ///< Transform
+    const Texture*  texture;   ///< Texture
+    const Shader*   shader;    ///< Shader
+    const Material* material;  ///< Material
 };
 
 } // namespace sf3d
@@ -128,12 +139,13 @@ public :
 /// \class sf3d::RenderStates
 /// \ingroup graphics
 ///
-/// There are four global states that can be applied to
+/// There are five global states that can be applied to
 /// the drawn objects:
 /// \li the blend mode: how pixels of the object are blended with the background
 /// \li the transform: how the object is positioned/rotated/scaled
 /// \li the texture: what image is mapped to the object
 /// \li the shader: what custom effect is applied to the object
+/// \li the material: how the surface of the object reacts to light
 ///
 /// High-level objects such as sprites or text force some of
 /// these states when they are drawn. For example, a sprite
@@ -372,6 +372,8 @@ protected :
 
 private:
 
+    friend class OcclusionCuller;
+
     ////////////////////////////////////////////////////////////
     /// \brief Apply the current view
     ///
@@ -416,6 +418,14 @@ private:
     ////////////////////////////////////////////////////////////
     void applyShader(const Shader* shader);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Apply the parameters of a material
+    ///
+    /// \param material Material to apply
+    ///
+    ////////////////////////////////////////////////////////////
+    void applyMaterial(const Material& material);
+
     ////////////////////////////////////////////////////////////
     /// \brief Apply a new vertex buffer
     ///
@@ -445,6 +455,8 @@ private:
     /// 1.30 or greater is supported. If that is the case, it will
     /// set up the default shader used for rendering that will
     /// emulate the legacy pipeline using the non-legacy OpenGL API.
+    /// The default shader is compiled once and shared by all the
+    /// render targets.
     ///
     ////////////////////////////////////////////////////////////
     void setupNonLegacyPipeline();
@@ -459,6 +471,7 @@ private:
         bool      viewChanged;        ///< Has the current view changed since last draw?
         BlendMode lastBlendMode;      ///< Cached blending mode
         Uint64    lastTextureId;      ///< Cached texture
+        Uint64    lastMaterialId;     ///< Cached material
         Uint64    lastVertexBufferId; ///< Cached vertex buffer
     };
 
@@ -470,17 +483,18 @@ private:
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
-    View          m_defaultView;            ///< Default view
-    View*         m_view;                   ///< Current view
-    StatesCache   m_cache;                  ///< Render states cache
-    bool          m_depthTest;              ///< Whether depth testing is enabled
-    Shader*       m_defaultShader;          ///< Default non-legacy shader, only created if supported
-    const Shader* m_currentNonLegacyShader; ///< Used during a draw call to set uniforms of the target shader
-    const Shader* m_lastNonLegacyShader;    ///< Used during a draw call to check if shader changed since the last draw
-    Uint64        m_id;                     ///< Unique number that identifies the render target
-    ArrayAgeCount m_arrayAgeCount;          ///< Map tracking the age of vertex array objects
-    IntRect       m_previousViewport;       ///< Cached viewport
-    Color         m_previousClearColor;     ///< Cached clear color
+    View            m_defaultView;            ///< Default view
+    View*           m_view;                   ///< Current view
+    StatesCache     m_cache;                  ///< Render states cache
+    bool            m_depthTest;              ///< Whether depth testing is enabled
+    Shader*         m_defaultShader;          ///< Default non-legacy shader, shared by all the render targets, only created if supported
+    const Shader*   m_currentNonLegacyShader; ///< Used during a draw call to set uniforms of the target shader
+    const Shader*   m_lastNonLegacyShader;    ///< Used during a draw call to check if shader changed since the last draw
+    const Material* m_currentMaterial;        ///< Material drawn by the current draw call, if drawn with its own shader
+    Uint64          m_id;                     ///< Unique number that identifies the render target
+    ArrayAgeCount   m_arrayAgeCount;          ///< Map tracking the age of vertex array objects
+    IntRect         m_previousViewport;       ///< Cached viewport
+    Color           m_previousClearColor;     ///< Cached clear color
 };
 
 #include <SFML3D/Graphics/RenderTarget.inl>
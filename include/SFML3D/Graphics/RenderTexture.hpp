@@ -31,6 +31,7 @@
 #include <SFML3D/Graphics/Export.hpp>
 #include <SFML3D/Graphics/Texture.hpp>
 #include <SFML3D/Graphics/RenderTarget.hpp>
+#include <vector>
 
 
 namespace sf3d
@@ -48,6 +49,47 @@ class SFML3D_GRAPHICS_API RenderTexture : public RenderTarget
 {
 public :
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Storage formats of the color textures
+    ///
+    ////////////////////////////////////////////////////////////
+    enum Format
+    {
+        Rgba8,   ///< 8 bits unsigned normalized RGBA, the default
+        Rgba16f, ///< 16 bits floating point RGBA
+        Rgba32f, ///< 32 bits floating point RGBA
+        Rg16f,   ///< 16 bits floating point red and green
+        R32f     ///< 32 bits floating point red
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Structure defining the buffers of a render-texture
+    ///
+    ////////////////////////////////////////////////////////////
+    struct SFML3D_GRAPHICS_API Settings
+    {
+        ////////////////////////////////////////////////////////////
+        /// \brief Default constructor
+        ///
+        /// Requests a single Rgba8 color texture.
+        ///
+        /// \param depth        Request a depth buffer?
+        /// \param stencil      Request a stencil buffer?
+        /// \param antialiasing Number of samples per pixel, 0 to disable multisampling
+        ///
+        ////////////////////////////////////////////////////////////
+        explicit Settings(bool depth = false, bool stencil = false, unsigned int antialiasing = 0);
+
+        ////////////////////////////////////////////////////////////
+        // Member data
+        ////////////////////////////////////////////////////////////
+        std::vector<Format> colorFormats;      ///< Format of each color texture, at least one
+        bool                depthBuffer;       ///< Request a depth buffer?
+        bool                depthTexture;      ///< Store the depth in a texture that can be sampled? (implies depthBuffer)
+        bool                stencilBuffer;     ///< Request a stencil buffer?
+        unsigned int        antialiasingLevel; ///< Number of samples per pixel, 0 to disable multisampling
+    };
+
     ////////////////////////////////////////////////////////////
     /// \brief Default constructor
     ///
@@ -86,6 +128,33 @@ public :
     ////////////////////////////////////////////////////////////
     bool create(unsigned int width, unsigned int height, bool depthBuffer = false, bool stencilBuffer = false);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Create the render-texture with several targets
+    ///
+    /// This overload gives full control over the buffers of
+    /// the render-texture:
+    /// \li several color textures, written at once by a shader
+    ///     through gl_FragData (multiple render targets)
+    /// \li floating point color formats, for HDR or G-buffers
+    /// \li a depth texture that can be sampled after display()
+    /// \li multisampling, resolved to the textures by display()
+    ///
+    /// Everything except a single Rgba8 color texture without
+    /// depth texture requires framebuffer objects. Float formats
+    /// must be supported by the driver (see isFormatAvailable),
+    /// and the number of color textures is limited by
+    /// getMaximumColorTextureCount. The antialiasing level is
+    /// lowered to the maximum supported by the driver.
+    ///
+    /// \param width    Width of the render-texture
+    /// \param height   Height of the render-texture
+    /// \param settings Buffers of the render-texture
+    ///
+    /// \return True if creation has been successful
+    ///
+    ////////////////////////////////////////////////////////////
+    bool create(unsigned int width, unsigned int height, const Settings& settings);
+
     ////////////////////////////////////////////////////////////
     /// \brief Enable or disable texture smoothing
     ///
@@ -172,7 +241,7 @@ public :
     virtual Vector2u getSize() const;
 
     ////////////////////////////////////////////////////////////
-    /// \brief Get a read-only reference to the target texture
+    /// \brief Get a read-only reference to a target texture
     ///
     /// After drawing to the render-texture and calling Display,
     /// you can retrieve the updated texture using this function,
@@ -182,10 +251,56 @@ public :
     /// once and keep a reference to the texture even after it is
     /// modified.
     ///
+    /// \param index Index of the color texture, in the order of Settings::colorFormats
+    ///
     /// \return Const reference to the texture
     ///
+    /// \see getColorTextureCount, getDepthTexture
+    ///
+    ////////////////////////////////////////////////////////////
+    const Texture& getTexture(unsigned int index = 0) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of color textures
+    ///
+    /// \return Number of color textures
+    ///
+    /// \see getTexture
+    ///
     ////////////////////////////////////////////////////////////
-    const Texture& getTexture() const;
+    unsigned int getColorTextureCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get a read-only reference to the depth texture
+    ///
+    /// The depth texture is only created when requested in
+    /// the settings; otherwise the returned texture is empty.
+    /// Like the color textures, it is updated by display().
+    ///
+    /// \return Const reference to the depth texture
+    ///
+    /// \see getTexture
+    ///
+    ////////////////////////////////////////////////////////////
+    const Texture& getDepthTexture() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the maximum number of color textures
+    ///
+    /// \return Maximum number of color textures of a render-texture
+    ///
+    ////////////////////////////////////////////////////////////
+    static unsigned int getMaximumColorTextureCount();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether a color format is supported by the driver
+    ///
+    /// \param format Format to check
+    ///
+    /// \return True if color textures can use the format
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool isFormatAvailable(Format format);
 
 private :
 
@@ -205,8 +320,10 @@ private :
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
-    priv::RenderTextureImpl* m_impl;    ///< Platform/hardware specific implementation
-    Texture                  m_texture; ///< Target texture to draw on
+    priv::RenderTextureImpl* m_impl;          ///< Platform/hardware specific implementation
+    Texture                  m_texture;       ///< Target texture to draw on
+    std::vector<Texture*>    m_extraTextures; ///< Additional color textures
+    Texture                  m_depthTexture;  ///< Depth texture, when requested
 };
 
 } // namespace sf3d
@@ -276,6 +393,31 @@ private :
 /// and regular SFML3D drawing commands. If you need a depth buffer for
 /// 3D rendering, don't forget to request it when calling RenderTexture::create.
 ///
+/// Deferred renderers and post-processing effects can fill several
+/// textures in a single pass: request them in a
+/// sf3d::RenderTexture::Settings, along with a depth texture and
+/// multisampling if needed, and write them from a shader with
+/// gl_FragData.
+///
+/// \code
+/// sf3d::RenderTexture::Settings settings;
+/// settings.colorFormats.push_back(sf3d::RenderTexture::Rgba16f); // normals
+/// settings.depthTexture = true;
+/// settings.antialiasingLevel = 4;
+///
+/// sf3d::RenderTexture gbuffer;
+/// if (!gbuffer.create(1280, 720, settings))
+///     return -1;
+///
+/// gbuffer.clear();
+/// gbuffer.draw(scene, &geometryShader);
+/// gbuffer.display();
+///
+/// lightingShader.setParameter("albedo", gbuffer.getTexture(0));
+/// lightingShader.setParameter("normals", gbuffer.getTexture(1));
+/// lightingShader.setParameter("depth", gbuffer.getDepthTexture());
+/// \endcode
+///
 /// \see sf3d::RenderTarget, sf3d::RenderWindow, sf3d::View, sf3d::Texture
 ///
 ////////////////////////////////////////////////////////////
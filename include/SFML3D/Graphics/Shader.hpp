@@ -37,6 +37,7 @@
 #include <SFML3D/System/Vector3.hpp>
 #include <map>
 #include <string>
+#include <vector>
 
 
 namespace sf3d
@@ -64,6 +65,18 @@ public :
         Geometry  ///< Geometry shader
     };
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Compilation status of a shader
+    ///
+    ////////////////////////////////////////////////////////////
+    enum Status
+    {
+        Unloaded,  ///< No shader was loaded
+        Compiling, ///< The shader is being compiled and linked in the background
+        Ready,     ///< The shader was compiled and linked successfully
+        Failed     ///< The shader failed to compile or link
+    };
+
     ////////////////////////////////////////////////////////////
     /// \brief Special type that can be passed to setParameter,
     ///        and that represents the texture of the object being drawn
@@ -247,6 +260,70 @@ public :
     ////////////////////////////////////////////////////////////
     bool loadFromStream(InputStream& vertexShaderStream, InputStream& fragmentShaderStream, InputStream& geometryShaderStream);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Start loading the vertex and fragment shaders and optionally a geometry shader from files
+    ///
+    /// This function reads the sources and submits their
+    /// compilation and linking to the driver, but doesn't wait
+    /// for them to finish: the render thread isn't blocked while
+    /// the driver compiles, which keeps loading screens
+    /// responsive. Poll getStatus() to know when the shader is
+    /// ready; compilation errors are reported once it is known
+    /// that they happened.
+    ///
+    /// Until the shader is ready, render targets draw with
+    /// their default shader instead of it. Don't set parameters
+    /// of the shader before it is ready, it would wait for the
+    /// compilation to finish.
+    ///
+    /// \param vertexShaderFilename   Path of the vertex shader file to load
+    /// \param fragmentShaderFilename Path of the fragment shader file to load
+    /// \param geometryShaderFilename Path of the geometry shader file to load (optional)
+    ///
+    /// \return True if the compilation was submitted, false if the files couldn't be read
+    ///
+    /// \see loadFromMemoryAsync, getStatus
+    ///
+    ////////////////////////////////////////////////////////////
+    bool loadFromFileAsync(const std::string& vertexShaderFilename, const std::string& fragmentShaderFilename, const std::string& geometryShaderFilename = "");
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Start loading the vertex and fragment shaders and optionally a geometry shader from source codes in memory
+    ///
+    /// This function submits the compilation and linking of
+    /// the sources to the driver, but doesn't wait for them to
+    /// finish. Poll getStatus() to know when the shader is
+    /// ready. See loadFromFileAsync for details.
+    ///
+    /// \param vertexShader   String containing the source code of the vertex shader
+    /// \param fragmentShader String containing the source code of the fragment shader
+    /// \param geometryShader String containing the source code of the geometry shader (optional)
+    ///
+    /// \return True if the compilation was submitted, false if shaders are not supported
+    ///
+    /// \see loadFromFileAsync, getStatus
+    ///
+    ////////////////////////////////////////////////////////////
+    bool loadFromMemoryAsync(const std::string& vertexShader, const std::string& fragmentShader, const std::string& geometryShader = "");
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the compilation status of the shader
+    ///
+    /// Shaders loaded synchronously are either Ready or Failed.
+    /// For a shader loaded asynchronously, this function returns
+    /// Compiling while the driver is still working on it. When
+    /// the driver compiles in parallel (see isParallelCompileAvailable),
+    /// polling doesn't block. Otherwise, the first poll waits for
+    /// the driver to finish: polling once per frame leaves it a
+    /// frame to compile in the background.
+    ///
+    /// \return Current status of the shader
+    ///
+    /// \see loadFromFileAsync, loadFromMemoryAsync
+    ///
+    ////////////////////////////////////////////////////////////
+    Status getStatus() const;
+
     ////////////////////////////////////////////////////////////
     /// \brief Change a int parameter of the shader
     ///
@@ -844,6 +921,70 @@ public :
     ////////////////////////////////////////////////////////////
     static unsigned int getMaximumUniformComponents();
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether or not the system supports program binaries
+    ///
+    /// Program binaries allow a linked program to be saved and
+    /// loaded again later, without compiling its sources.
+    ///
+    /// \return True if program binaries are supported, false otherwise
+    ///
+    /// \see setProgramCacheDirectory
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool isProgramBinaryAvailable();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the directory where linked programs are cached
+    ///
+    /// When a cache directory is set and program binaries are
+    /// supported, every program linked from source is saved in
+    /// the directory. Loading the same sources again, even in a
+    /// later run of the application, reuses the saved binary
+    /// instead of compiling the sources, which makes startup
+    /// much faster when many shaders are used.
+    ///
+    /// Cached binaries are identified by the sources of the
+    /// program and by the vendor, renderer and version of the
+    /// OpenGL driver. A binary that doesn't match, or that the
+    /// driver rejects, is ignored: the program is compiled from
+    /// source and the binary is replaced.
+    ///
+    /// The directory must exist and be writable. An empty
+    /// string, the default, disables the cache.
+    ///
+    /// \param directory Path of the cache directory, or an empty string to disable the cache
+    ///
+    /// \see getProgramCacheDirectory, isProgramBinaryAvailable
+    ///
+    ////////////////////////////////////////////////////////////
+    static void setProgramCacheDirectory(const std::string& directory);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the directory where linked programs are cached
+    ///
+    /// \return Path of the cache directory, empty if the cache is disabled
+    ///
+    /// \see setProgramCacheDirectory
+    ///
+    ////////////////////////////////////////////////////////////
+    static std::string getProgramCacheDirectory();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether or not the driver compiles shaders in parallel
+    ///
+    /// When supported (GL_KHR_parallel_shader_compile or
+    /// GL_ARB_parallel_shader_compile), the completion of
+    /// shaders loaded asynchronously can be polled without
+    /// blocking.
+    ///
+    /// \return True if parallel compilation is supported, false otherwise
+    ///
+    /// \see getStatus
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool isParallelCompileAvailable();
+
 private :
 
     friend class RenderTarget;
@@ -857,11 +998,23 @@ private :
     /// \param vertexShaderCode   Source code of the vertex shader
     /// \param fragmentShaderCode Source code of the fragment shader
     /// \param geometryShaderCode Source code of the geometry shader
+    /// \param async              Return without waiting for the compilation to finish?
     ///
     /// \return True on success, false if any error happened
     ///
     ////////////////////////////////////////////////////////////
-    bool compile(const char* vertexShaderCode, const char* fragmentShaderCode, const char* geometryShaderCode);
+    bool compile(const char* vertexShaderCode, const char* fragmentShaderCode, const char* geometryShaderCode, bool async = false);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Check the result of a submitted compilation
+    ///
+    /// Reports the compilation and link errors, if any, and
+    /// releases the shader objects.
+    ///
+    /// \return True if the program was compiled and linked successfully
+    ///
+    ////////////////////////////////////////////////////////////
+    bool finishCompile() const;
 
     ////////////////////////////////////////////////////////////
     /// \brief Bind all the textures used by the shader
@@ -898,11 +1051,12 @@ private :
     typedef std::map<int, const Texture*> TextureTable;
     typedef std::map<std::string, int> LocationTable;
     typedef std::map<std::string, unsigned int> BufferTable;
+    typedef std::vector<unsigned int> ObjectArray;
 
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
-    unsigned int          m_shaderProgram;  ///< OpenGL identifier for the program
+    mutable unsigned int  m_shaderProgram;  ///< OpenGL identifier for the program
     mutable int           m_currentTexture; ///< Location of the current texture in the shader
     mutable TextureTable  m_textures;       ///< Texture variables in the shader, mapped to their location
     mutable LocationTable m_params;         ///< Parameters location cache
@@ -911,6 +1065,11 @@ private :
     mutable BufferTable   m_boundBuffers;   ///< Buffers bound to this shader
     mutable bool          m_warnMissing;    ///< Whether to warn the user that variables could not be found.
     Uint64                m_id;             ///< Unique number that identifies the compiled and linked program
+    mutable Uint64        m_targetId;       ///< Render target that set the current values of the default uniforms
+    mutable Status        m_status;         ///< Compilation status of the program
+    mutable ObjectArray   m_pendingStages;  ///< Shader objects whose compilation wasn't checked yet
+    mutable std::string   m_cachePath;      ///< Cache file to save the program to once linked
+    mutable Uint64        m_cacheHash;      ///< Hash identifying the program in the cache
     mutable bool          m_parameterBlock; ///< Whether we are in a parameter block
     mutable unsigned int  m_blockProgram;   ///< The program to restore after a parameter block
 };
@@ -1065,6 +1224,21 @@ private :
 /// second one doesn't impact the rendering process and can be
 /// easily inserted anywhere without impacting all the code.
 ///
+/// Compiling many shaders can take a while. The asynchronous
+/// load functions submit the compilation without waiting for
+/// it, and render targets keep drawing with their default
+/// shader until the shader is ready:
+/// \code
+/// shader.loadFromFileAsync("water.vert", "water.frag");
+///
+/// // In the loading screen loop
+/// if (shader.getStatus() == sf3d::Shader::Ready)
+///     shader.setParameter("waveHeight", 0.5f);
+/// \endcode
+/// Setting a program cache directory with setProgramCacheDirectory
+/// also saves the linked programs, so that later runs of the
+/// application don't compile them again.
+///
 /// Like sf3d::Texture that can be used as a raw OpenGL texture,
 /// sf3d::Shader can also be used directly as a raw shader for
 /// custom OpenGL geometry.
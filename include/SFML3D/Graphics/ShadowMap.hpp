@@ -0,0 +1,356 @@
+#ifndef SFML3D_SHADOWMAP_HPP
+#define SFML3D_SHADOWMAP_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/Graphics/Export.hpp>
+#include <SFML3D/Graphics/RenderTexture.hpp>
+#include <SFML3D/Graphics/Box.hpp>
+#include <SFML3D/System/NonCopyable.hpp>
+#include <vector>
+
+
+namespace sf3d
+{
+class Drawable;
+class Light;
+class Polyhedron;
+class Shader;
+class View;
+
+////////////////////////////////////////////////////////////
+/// \brief Depth maps casting the shadows of a light
+///
+////////////////////////////////////////////////////////////
+class SFML3D_GRAPHICS_API ShadowMap : NonCopyable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// Creates an empty shadow map, attached to no light.
+    ///
+    ////////////////////////////////////////////////////////////
+    ShadowMap();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    /// The light stops casting shadows.
+    ///
+    ////////////////////////////////////////////////////////////
+    ~ShadowMap();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Create the shadow map of a light
+    ///
+    /// A directional light gets \a cascadeCount cascades: depth
+    /// maps covering increasing distances from the viewer, so
+    /// that shadows near the viewer get more texels than distant
+    /// ones. A positional light gets the six faces of a cube
+    /// around it. Each cascade or face is \a resolution x
+    /// \a resolution texels, all of them are stored as tiles of
+    /// a single depth texture.
+    ///
+    /// Once created, the shadows of the light are taken into
+    /// account by the default shader. Shadow mapping requires
+    /// shader lighting, and depth textures. The highest texture
+    /// units are reserved for the shadow maps.
+    ///
+    /// \param light        Light casting the shadows, must exist as long as the shadow map uses it
+    /// \param resolution   Width and height of each cascade or face, in texels
+    /// \param cascadeCount Number of cascades of a directional light (1 to 4)
+    ///
+    /// \return True if creation was successful
+    ///
+    ////////////////////////////////////////////////////////////
+    bool create(Light& light, unsigned int resolution, unsigned int cascadeCount = 3);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the range of the shadows
+    ///
+    /// For a positional light, this is the distance up to which
+    /// the light casts shadows. For a directional light, this is
+    /// the distance from the viewer covered by the cascades.
+    /// The default range is 1000.
+    ///
+    /// \param range Range of the shadows
+    ///
+    /// \see getRange
+    ///
+    ////////////////////////////////////////////////////////////
+    void setRange(float range);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the range of the shadows
+    ///
+    /// \return Range of the shadows
+    ///
+    /// \see setRange
+    ///
+    ////////////////////////////////////////////////////////////
+    float getRange() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the depth bias
+    ///
+    /// The bias is added to the depth of the lit surfaces before
+    /// comparing it with the shadow map, so that surfaces don't
+    /// shadow themselves. It is expressed in depth buffer units,
+    /// the default bias is 0.001.
+    ///
+    /// \param bias Depth bias
+    ///
+    /// \see getDepthBias
+    ///
+    ////////////////////////////////////////////////////////////
+    void setDepthBias(float bias);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the depth bias
+    ///
+    /// \return Depth bias
+    ///
+    /// \see setDepthBias
+    ///
+    ////////////////////////////////////////////////////////////
+    float getDepthBias() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add a polyhedron casting shadows
+    ///
+    /// The bounds of the polyhedron are checked by every update,
+    /// so that it is re-rendered when it moves.
+    /// The \a caster argument refers to an object that must
+    /// exist as long as the shadow map uses it.
+    ///
+    /// \param caster Polyhedron casting shadows
+    ///
+    ////////////////////////////////////////////////////////////
+    void addCaster(const Polyhedron& caster);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add a drawable casting shadows
+    ///
+    /// The shadow map can't know where an arbitrary drawable is,
+    /// its global bounds must be given, and kept up to date with
+    /// setCasterBounds when it moves.
+    /// The \a caster argument refers to an object that must
+    /// exist as long as the shadow map uses it.
+    ///
+    /// \param caster Drawable casting shadows
+    /// \param bounds Global bounds of the drawable
+    ///
+    /// \see setCasterBounds
+    ///
+    ////////////////////////////////////////////////////////////
+    void addCaster(const Drawable& caster, const FloatBox& bounds);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Update the global bounds of a caster
+    ///
+    /// \param caster Drawable casting shadows
+    /// \param bounds New global bounds of the drawable
+    ///
+    ////////////////////////////////////////////////////////////
+    void setCasterBounds(const Drawable& caster, const FloatBox& bounds);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove a caster
+    ///
+    /// \param caster Drawable to remove
+    ///
+    ////////////////////////////////////////////////////////////
+    void removeCaster(const Drawable& caster);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove all the casters
+    ///
+    ////////////////////////////////////////////////////////////
+    void clearCasters();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Force all the cascades or faces to be re-rendered
+    ///
+    /// Call this function when casters change without moving,
+    /// for example when a model is animated.
+    ///
+    ////////////////////////////////////////////////////////////
+    void invalidate();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Update the shadow map
+    ///
+    /// The cascades of a directional light are fitted to the
+    /// view. A cascade or face is only re-rendered when it moved,
+    /// or when a caster inside it was added, removed or moved:
+    /// shadows of static scenes are rendered once and reused.
+    /// Only the casters inside a cascade or face are drawn to it.
+    ///
+    /// \param view View used to render the scene
+    ///
+    ////////////////////////////////////////////////////////////
+    void update(const View& view);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of cascades or faces re-rendered by the last update
+    ///
+    /// \return Number of cascades or faces rendered by the last update
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getUpdatedTileCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the depth texture holding the cascades or faces
+    ///
+    /// \return Depth texture of the shadow map
+    ///
+    ////////////////////////////////////////////////////////////
+    const Texture& getTexture() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the maximum number of shadow maps that can exist at the same time
+    ///
+    /// \return Maximum number of shadow maps
+    ///
+    ////////////////////////////////////////////////////////////
+    static unsigned int getMaximumShadowMaps();
+
+private :
+
+    friend class Light;
+    friend class Material;
+    friend class RenderTarget;
+
+    struct Caster;
+    struct Tile;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Fit the cascades of a directional light to a view
+    ///
+    /// \param view View used to render the scene
+    ///
+    ////////////////////////////////////////////////////////////
+    void computeCascades(const View& view);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Compute the cube faces around a positional light
+    ///
+    ////////////////////////////////////////////////////////////
+    void computeFaces();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Render the casters of a cascade or face
+    ///
+    /// \param index Index of the cascade or face
+    ///
+    ////////////////////////////////////////////////////////////
+    void renderTile(std::size_t index);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add the shadow data to the given shader
+    ///
+    /// \param shader Shader to add the shadow data to
+    ///
+    ////////////////////////////////////////////////////////////
+    static void addShadowMapsToShader(const Shader& shader);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether at least one shadow map exists
+    ///
+    /// Lit shaders only sample the shadow maps (SF_SHADOWS)
+    /// while this is true.
+    ///
+    /// \return True if a shadow map exists
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool hasShadowMaps();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether the default shader can sample the shadow map
+    ///
+    /// The shadow map must hold a slot, be attached to a light
+    /// and have been rendered. The caller must lock the mutex
+    /// protecting the slots.
+    ///
+    /// \return True if the shadow map can be sampled
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isReady() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the slot sampled by the default shader for the light
+    ///
+    /// \return Index of the slot, or -1 until the shadow map can be sampled
+    ///
+    ////////////////////////////////////////////////////////////
+    int getShaderSlot() const;
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    Light*                m_light;         ///< Light casting the shadows
+    int                   m_slot;          ///< Index of the shadow map in the default shader, -1 if none
+    RenderTexture         m_texture;       ///< Render texture holding the tiles
+    unsigned int          m_resolution;    ///< Size of a tile
+    unsigned int          m_cascadeCount;  ///< Number of cascades requested for a directional light
+    bool                  m_directional;   ///< Was the shadow map created for a directional light?
+    float                 m_range;         ///< Range of the shadows
+    float                 m_depthBias;     ///< Depth bias
+    std::vector<Caster*>  m_casters;       ///< Drawables casting shadows
+    std::vector<Tile*>    m_tiles;         ///< Cascades or cube faces
+    std::vector<FloatBox> m_changes;       ///< Bounds of the casters added, removed or moved since the last update
+    unsigned int          m_updatedTiles;  ///< Number of tiles rendered by the last update
+};
+
+} // namespace sf3d
+
+
+#endif // SFML3D_SHADOWMAP_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class sf3d::ShadowMap
+/// \ingroup graphics
+///
+/// sf3d::ShadowMap renders the depth of the scene as seen from
+/// a light, so that the default shader can tell which surfaces
+/// the light doesn't reach.
+///
+/// Directional lights use cascaded shadow maps: the view is
+/// split in a few slices of increasing depth, each covered by
+/// its own depth map. The cascades are snapped to their texels,
+/// so that shadows don't shimmer when the viewer moves. Point
+/// lights use a cube of six depth maps around the light.
+///
+/// The casters are registered once. Each update only draws the
+/// casters that are inside a cascade or face, and only renders
+/// the cascades and faces that actually changed, so shadows of
+/// static geometry cost nothing once rendered.
+///
+/// Usage example:
+/// \code
+/// sf3d::Light sun;
+/// sun.setDirectional(true);
+/// sun.setDirection(-1, -2, -1);
+/// sun.enable();
+///
+/// sf3d::ShadowMap shadows;
+/// if (!shadows.create(sun, 2048))
+///     return -1;
+/// shadows.setRange(500);
+/// shadows.addCaster(terrainModel);
+/// shadows.addCaster(player);
+///
+/// // In the main loop
+/// shadows.update(camera);
+/// window.setView(camera);
+/// window.draw(terrainModel);
+/// window.draw(player);
+/// \endcode
+///
+/// \see sf3d::Light, sf3d::RenderTexture
+///
+////////////////////////////////////////////////////////////
@@ -0,0 +1,453 @@
+#ifndef SFML3D_SKINNEDMODEL_HPP
+#define SFML3D_SKINNEDMODEL_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/Graphics/Export.hpp>
+#include <SFML3D/Graphics/Model.hpp>
+#include <SFML3D/Graphics/Texture.hpp>
+#include <SFML3D/Graphics/Transform.hpp>
+#include <SFML3D/System/Time.hpp>
+#include <vector>
+
+
+namespace sf3d
+{
+class Shader;
+
+////////////////////////////////////////////////////////////
+/// \brief Base class for 3D models animated by a bone hierarchy
+///
+////////////////////////////////////////////////////////////
+class SFML3D_GRAPHICS_API SkinnedModel : public Model
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Where the vertices are transformed by the bones
+    ///
+    ////////////////////////////////////////////////////////////
+    enum SkinningMode
+    {
+        CpuSkinning, ///< Vertices are skinned on the CPU and re-uploaded
+        GpuSkinning  ///< Vertices are skinned by the default vertex shader
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Local transformation of a bone at a given time
+    ///
+    ////////////////////////////////////////////////////////////
+    struct SFML3D_GRAPHICS_API Keyframe
+    {
+        ////////////////////////////////////////////////////////////
+        /// \brief Default constructor
+        ///
+        /// Creates an identity keyframe at time zero.
+        ///
+        ////////////////////////////////////////////////////////////
+        Keyframe();
+
+        Time     time;          ///< Time of the keyframe in the animation
+        Vector3f translation;   ///< Translation of the bone relative to its parent
+        Vector3f rotationAxis;  ///< Axis of the rotation of the bone relative to its parent
+        float    rotationAngle; ///< Angle of the rotation of the bone relative to its parent, in degrees
+        Vector3f scale;         ///< Scale of the bone relative to its parent
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Bones influencing a vertex and their weights
+    ///
+    /// Unused slots must have a weight of 0. The weights don't
+    /// need to be normalized, they are divided by their sum.
+    ///
+    ////////////////////////////////////////////////////////////
+    struct SFML3D_GRAPHICS_API VertexWeights
+    {
+        ////////////////////////////////////////////////////////////
+        /// \brief Default constructor
+        ///
+        /// Creates weights that leave the vertex in its bind pose.
+        ///
+        ////////////////////////////////////////////////////////////
+        VertexWeights();
+
+        unsigned int bones[4];   ///< Indices of the bones influencing the vertex
+        float        weights[4]; ///< Weights of the bones influencing the vertex
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Copy constructor
+    ///
+    /// \param copy Instance to copy
+    ///
+    ////////////////////////////////////////////////////////////
+    SkinnedModel(const SkinnedModel& copy);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Virtual destructor
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual ~SkinnedModel();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of bones of the skeleton
+    ///
+    /// \return Number of bones
+    ///
+    /// \see addBone
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getBoneCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the parent of a bone
+    ///
+    /// The result is undefined if \a bone is out of the valid range.
+    ///
+    /// \param bone Index of the bone
+    ///
+    /// \return Index of the parent bone, or -1 if \a bone is a root
+    ///
+    ////////////////////////////////////////////////////////////
+    int getBoneParent(unsigned int bone) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the current skinning transform of a bone
+    ///
+    /// The skinning transform maps a vertex from the bind pose
+    /// to its animated position in model space. It is the
+    /// product of the animated global transform of the bone
+    /// with the inverse of its bind transform.
+    ///
+    /// The result is undefined if \a bone is out of the valid range.
+    ///
+    /// \param bone Index of the bone
+    ///
+    /// \return Skinning transform of the bone
+    ///
+    ////////////////////////////////////////////////////////////
+    const Transform& getBoneTransform(unsigned int bone) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Pose the model at a given time of its animation
+    ///
+    /// The keyframes surrounding \a time are interpolated for
+    /// every bone (linearly for translation and scale, spherically
+    /// for rotation), the bone hierarchy is evaluated and the
+    /// vertices are skinned according to the skinning mode.
+    ///
+    /// \param time Time in the animation
+    ///
+    /// \see getAnimationTime, getAnimationDuration, setLooping
+    ///
+    ////////////////////////////////////////////////////////////
+    void setAnimationTime(Time time);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the time the model is currently posed at
+    ///
+    /// \return Time in the animation, wrapped if looping
+    ///
+    /// \see setAnimationTime
+    ///
+    ////////////////////////////////////////////////////////////
+    Time getAnimationTime() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the duration of the animation
+    ///
+    /// \return Time of the last keyframe of all bones
+    ///
+    /// \see setAnimationTime
+    ///
+    ////////////////////////////////////////////////////////////
+    Time getAnimationDuration() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Enable or disable looping of the animation
+    ///
+    /// When looping, times passed to setAnimationTime are wrapped
+    /// around the animation duration, otherwise they are clamped.
+    /// Looping is enabled by default.
+    ///
+    /// \param looping True to loop the animation
+    ///
+    /// \see isLooping
+    ///
+    ////////////////////////////////////////////////////////////
+    void setLooping(bool looping);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether the animation loops
+    ///
+    /// \return True if the animation loops
+    ///
+    /// \see setLooping
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isLooping() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Choose where the vertices are skinned
+    ///
+    /// GPU skinning is only possible with the non-legacy pipeline
+    /// and a skeleton of at most getMaximumGpuBones() bones. If
+    /// it is not available the model falls back to CPU skinning.
+    /// The default mode is CpuSkinning.
+    ///
+    /// \param mode New skinning mode
+    ///
+    /// \see getSkinningMode, isGpuSkinningAvailable
+    ///
+    ////////////////////////////////////////////////////////////
+    void setSkinningMode(SkinningMode mode);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the skinning mode currently in use
+    ///
+    /// \return Current skinning mode
+    ///
+    /// \see setSkinningMode
+    ///
+    ////////////////////////////////////////////////////////////
+    SkinningMode getSkinningMode() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the number of threads used for CPU skinning
+    ///
+    /// Small models are always skinned on the calling thread.
+    /// A value of 0 (the default) uses one thread per processor.
+    ///
+    /// \param count Maximum number of threads
+    ///
+    /// \see getThreadCount
+    ///
+    ////////////////////////////////////////////////////////////
+    void setThreadCount(unsigned int count);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of threads used for CPU skinning
+    ///
+    /// \return Maximum number of threads, 0 for one per processor
+    ///
+    /// \see setThreadCount
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getThreadCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether GPU skinning is supported
+    ///
+    /// \return True if the non-legacy pipeline is available
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool isGpuSkinningAvailable();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the maximum number of bones for GPU skinning
+    ///
+    /// \return Maximum number of bones of a GPU skinned model
+    ///
+    ////////////////////////////////////////////////////////////
+    static unsigned int getMaximumGpuBones();
+
+protected :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    ////////////////////////////////////////////////////////////
+    SkinnedModel();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add a bone to the skeleton
+    ///
+    /// Bones are referenced by their index, in the order in
+    /// which they were added. A bone must be added after its
+    /// parent.
+    ///
+    /// \param parent        Index of the parent bone, -1 for a root bone
+    /// \param bindTransform Model space transform of the bone in the bind pose
+    ///
+    /// \return Index of the new bone
+    ///
+    /// \see getBoneCount, addKeyframe
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int addBone(int parent, const Transform& bindTransform);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the bones influencing a vertex
+    ///
+    /// The result is undefined if \a index is out of the valid range.
+    ///
+    /// \param index   Index of the vertex, as added with addVertex
+    /// \param weights Bones influencing the vertex and their weights
+    ///
+    /// \see addBone
+    ///
+    ////////////////////////////////////////////////////////////
+    void setVertexWeights(unsigned int index, const VertexWeights& weights);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add a keyframe to the animation track of a bone
+    ///
+    /// Keyframes can be added in any order. A bone without
+    /// keyframes keeps its bind pose relative to its parent.
+    ///
+    /// \param bone     Index of the bone
+    /// \param keyframe Keyframe to add
+    ///
+    /// \see clearKeyframes, setAnimationTime
+    ///
+    ////////////////////////////////////////////////////////////
+    void addKeyframe(unsigned int bone, const Keyframe& keyframe);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove the keyframes of all bones
+    ///
+    /// \see addKeyframe
+    ///
+    ////////////////////////////////////////////////////////////
+    void clearKeyframes();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Capture the current vertices as the bind pose
+    ///
+    /// Call this function after loading or modifying the vertex
+    /// data with addVertex/setVertex. It is called automatically
+    /// the first time the model is posed if the number of
+    /// vertices changed.
+    ///
+    ////////////////////////////////////////////////////////////
+    void updateBindPose();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw the model to a render target
+    ///
+    /// \param target Render target to draw to
+    /// \param states Current render states
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void draw(RenderTarget& target, RenderStates states) const;
+
+private :
+
+    struct SkinningTask;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Bone of the skeleton
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Bone
+    {
+        int       parent;         ///< Index of the parent bone, -1 for a root bone
+        Transform bindLocal;      ///< Bind transform relative to the parent bone
+        Transform inverseBind;    ///< Inverse of the model space bind transform
+        Transform global;         ///< Current model space transform
+        Transform skinning;       ///< Current skinning transform
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Compute the local transform of a bone at a time
+    ///
+    /// \param bone    Index of the bone
+    /// \param time    Time in the animation, in seconds
+    ///
+    /// \return Interpolated local transform
+    ///
+    ////////////////////////////////////////////////////////////
+    Transform sampleBone(unsigned int bone, float time) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Skin a range of vertices on the CPU
+    ///
+    /// \param begin Index of the first vertex to skin
+    /// \param end   Index one past the last vertex to skin
+    ///
+    ////////////////////////////////////////////////////////////
+    void skinVertices(std::size_t begin, std::size_t end);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Write the bind pose back to the vertices
+    ///
+    ////////////////////////////////////////////////////////////
+    void restoreBindPose();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Rebuild the bone weights texture used for GPU skinning
+    ///
+    ////////////////////////////////////////////////////////////
+    void updateWeightsTexture() const;
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    std::vector<Bone>                   m_bones;           ///< Skeleton
+    std::vector<std::vector<Keyframe> > m_tracks;          ///< Keyframes of each bone, sorted by time
+    std::vector<VertexWeights>          m_weights;         ///< Bone weights of each vertex
+    std::vector<Vector3f>               m_bindPositions;   ///< Vertex positions in the bind pose
+    std::vector<Vector3f>               m_bindNormals;     ///< Vertex normals in the bind pose
+    std::vector<float>                  m_skinMatrices;    ///< Skinning matrices packed for the skinning kernel
+    Time                                m_time;            ///< Current time in the animation
+    Time                                m_duration;        ///< Duration of the animation
+    bool                                m_looping;         ///< Whether the animation loops
+    SkinningMode                        m_mode;            ///< Current skinning mode
+    unsigned int                        m_threadCount;     ///< Maximum number of skinning threads
+    mutable Texture                     m_weightsTexture;  ///< Bone weights of the expanded vertices, for GPU skinning
+    mutable bool                        m_weightsChanged;  ///< Whether the bone weights texture must be rebuilt
+};
+
+} // namespace sf3d
+
+
+#endif // SFML3D_SKINNEDMODEL_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class sf3d::SkinnedModel
+/// \ingroup graphics
+///
+/// sf3d::SkinnedModel extends sf3d::Model with a skeleton:
+/// a hierarchy of bones, per-vertex bone weights and one
+/// animation made of per-bone keyframes. As with sf3d::Model,
+/// loading is handled by user code in a derived class, which
+/// specifies the geometry with addVertex/addFace and the
+/// skeleton with addBone, setVertexWeights and addKeyframe.
+///
+/// Every frame, call setAnimationTime to pose the model. The
+/// vertices are then skinned either on the CPU, using SIMD
+/// instructions when available and several threads for large
+/// models, or on the GPU by a variant of the default shader
+/// when the non-legacy pipeline is in use. In the latter case
+/// the vertex data is never re-uploaded, only the bone
+/// transforms change.
+///
+/// Example:
+/// \code
+/// class Character : public sf3d::SkinnedModel
+/// {
+/// public :
+///
+///     bool load(const std::string& filename)
+///     {
+///         // ... addVertex, addFace, addBone, setVertexWeights, addKeyframe ...
+///         updateBindPose();
+///         update();
+///         return true;
+///     }
+/// };
+///
+/// Character character;
+/// character.load("character.dat");
+/// character.setSkinningMode(sf3d::SkinnedModel::GpuSkinning);
+///
+/// // in the main loop
+/// character.setAnimationTime(clock.getElapsedTime());
+/// window.draw(character);
+/// \endcode
+///
+/// \see sf3d::Model, sf3d::Polyhedron
+///
+////////////////////////////////////////////////////////////
@@ -94,6 +94,18 @@ public :
     ////////////////////////////////////////////////////////////
     virtual Face getFace(unsigned int index) const;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Get a range of faces of the polyhedron
+    ///
+    /// \param vertices Array of vertices to fill, must have room for 3 * \a count vertices
+    /// \param first    Index of the first face to get
+    /// \param count    Number of faces to get
+    ///
+    /// \see getFace
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void getFaces(Vertex* vertices, unsigned int first, unsigned int count) const;
+
 private :
 
     ////////////////////////////////////////////////////////////
@@ -0,0 +1,385 @@
+#ifndef SFML3D_TERRAIN_HPP
+#define SFML3D_TERRAIN_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/Graphics/Export.hpp>
+#include <SFML3D/Graphics/Drawable.hpp>
+#include <SFML3D/Graphics/Transformable.hpp>
+#include <SFML3D/Graphics/VertexContainer.hpp>
+#include <SFML3D/Graphics/Box.hpp>
+#include <SFML3D/System/Vector2.hpp>
+#include <SFML3D/System/Vector3.hpp>
+#include <SFML3D/System/NonCopyable.hpp>
+#include <SFML3D/System/Thread.hpp>
+#include <SFML3D/System/Mutex.hpp>
+#include <vector>
+
+
+namespace sf3d
+{
+class Image;
+class Texture;
+
+////////////////////////////////////////////////////////////
+/// \brief Heightfield terrain split into chunks with
+///        distance based level of detail
+///
+////////////////////////////////////////////////////////////
+class SFML3D_GRAPHICS_API Terrain : public Drawable, public Transformable, NonCopyable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// Creates an empty terrain.
+    ///
+    ////////////////////////////////////////////////////////////
+    Terrain();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    /// Waits for the chunks being rebuilt in the background.
+    ///
+    ////////////////////////////////////////////////////////////
+    ~Terrain();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Load the heightfield from an image
+    ///
+    /// Each pixel of the image is a sample of the heightfield,
+    /// its height is the average of its red, green and blue
+    /// components mapped to [0, \a heightScale].
+    ///
+    /// \param image       Source image, at least 2x2 pixels
+    /// \param heightScale Height of a white pixel
+    ///
+    /// \return True if loading was successful
+    ///
+    /// \see loadFromHeights
+    ///
+    ////////////////////////////////////////////////////////////
+    bool loadFromImage(const Image& image, float heightScale = 1.f);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Load the heightfield from an array of heights
+    ///
+    /// \a heights must contain \a width * \a depth values,
+    /// stored row by row (along the X axis first).
+    ///
+    /// \param heights Array of heights
+    /// \param width   Number of samples along the X axis, at least 2
+    /// \param depth   Number of samples along the Z axis, at least 2
+    ///
+    /// \return True if loading was successful
+    ///
+    /// \see loadFromImage
+    ///
+    ////////////////////////////////////////////////////////////
+    bool loadFromHeights(const float* heights, unsigned int width, unsigned int depth);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of samples of the heightfield
+    ///
+    /// Samples are one unit apart in local coordinates, use
+    /// setScale to change the size of the terrain.
+    ///
+    /// \return Number of samples along the X and Z axes
+    ///
+    ////////////////////////////////////////////////////////////
+    Vector2u getSize() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change the height of a sample
+    ///
+    /// The chunks touching the sample are rebuilt in the
+    /// background during the following calls to update.
+    ///
+    /// \param x      X coordinate of the sample
+    /// \param z      Z coordinate of the sample
+    /// \param height New height of the sample
+    ///
+    /// \see getHeight
+    ///
+    ////////////////////////////////////////////////////////////
+    void setHeight(unsigned int x, unsigned int z, float height);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the height of a sample
+    ///
+    /// \param x X coordinate of the sample
+    /// \param z Z coordinate of the sample
+    ///
+    /// \return Height of the sample
+    ///
+    /// \see setHeight
+    ///
+    ////////////////////////////////////////////////////////////
+    float getHeight(unsigned int x, unsigned int z) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the size of the chunks
+    ///
+    /// \a size is the number of cells along each side of a
+    /// chunk, it is rounded up to a power of two. Changing it
+    /// after loading the heightfield rebuilds all the chunks.
+    /// The default size is 32.
+    ///
+    /// \param size Number of cells along a side of a chunk
+    ///
+    /// \see getChunkSize
+    ///
+    ////////////////////////////////////////////////////////////
+    void setChunkSize(unsigned int size);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the size of the chunks
+    ///
+    /// \return Number of cells along a side of a chunk
+    ///
+    /// \see setChunkSize
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getChunkSize() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the total number of chunks
+    ///
+    /// \return Number of chunks
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getChunkCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the distance at which the level of detail starts to decrease
+    ///
+    /// Chunks closer than \a distance to the viewer are drawn
+    /// at full resolution, and the resolution is halved every
+    /// time the distance doubles. A distance of 0 disables
+    /// the level of detail. The default distance is 64.
+    ///
+    /// \param distance Distance in local coordinates
+    ///
+    /// \see getLodDistance, update
+    ///
+    ////////////////////////////////////////////////////////////
+    void setLodDistance(float distance);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the distance at which the level of detail starts to decrease
+    ///
+    /// \return Distance in local coordinates
+    ///
+    /// \see setLodDistance
+    ///
+    ////////////////////////////////////////////////////////////
+    float getLodDistance() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change the source texture of the terrain
+    ///
+    /// The texture is stretched over the whole terrain.
+    /// The \a texture argument refers to a texture that must
+    /// exist as long as the terrain uses it.
+    ///
+    /// \param texture New texture, can be NULL
+    ///
+    /// \see getTexture
+    ///
+    ////////////////////////////////////////////////////////////
+    void setTexture(const Texture* texture);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the source texture of the terrain
+    ///
+    /// \return Pointer to the terrain's texture
+    ///
+    /// \see setTexture
+    ///
+    ////////////////////////////////////////////////////////////
+    const Texture* getTexture() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the local bounding box of the terrain
+    ///
+    /// \return Local bounding box of the terrain
+    ///
+    ////////////////////////////////////////////////////////////
+    FloatBox getLocalBounds() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Update the chunks for a new viewer position
+    ///
+    /// This function selects the level of detail of each chunk
+    /// from its distance to the viewer, collects the chunks
+    /// rebuilt by the worker thread since the last call and
+    /// schedules the chunks that changed to be rebuilt.
+    /// Chunks that were never built are built immediately.
+    /// It should be called once per frame, before drawing.
+    ///
+    /// \param viewerPosition Position of the viewer in global coordinates
+    ///
+    ////////////////////////////////////////////////////////////
+    void update(const Vector3f& viewerPosition);
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw the terrain to a render target
+    ///
+    /// \param target Render target to draw to
+    /// \param states Current render states
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void draw(RenderTarget& target, RenderStates states) const;
+
+    struct BuildTask;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Geometry request for a chunk
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Job
+    {
+        unsigned int        chunk;          ///< Index of the chunk to build
+        unsigned int        lod;            ///< Level of detail of the chunk
+        unsigned int        edgeLods[4];    ///< Level of detail of the left, right, top and bottom edges
+        Vector2f            textureSize;    ///< Size of the texture to map
+        std::vector<float>  heights;        ///< Copy of the heights around the chunk
+        std::vector<Vertex> vertices;       ///< Resulting triangles
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Chunk of the terrain
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Chunk
+    {
+        Chunk();
+
+        unsigned int    lod;         ///< Level of detail of the built geometry
+        unsigned int    edgeLods[4]; ///< Edge levels of detail of the built geometry
+        bool            dirty;       ///< Whether the heights changed since the last build
+        bool            building;    ///< Whether the chunk is being rebuilt
+        VertexContainer vertices;    ///< Triangles of the chunk
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Create the chunks and shared index lists after loading
+    ///
+    ////////////////////////////////////////////////////////////
+    void initialize();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Prepare the request to build a chunk
+    ///
+    /// \param job   Job to fill
+    /// \param chunk Index of the chunk
+    /// \param lod   Level of detail of the chunk
+    /// \param edges Level of detail of the chunk edges
+    ///
+    ////////////////////////////////////////////////////////////
+    void prepareJob(Job& job, unsigned int chunk, unsigned int lod, const unsigned int* edges) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Build the geometry of a chunk
+    ///
+    /// Only reads the job and immutable terrain parameters,
+    /// so it can run on the worker thread.
+    ///
+    /// \param job Job to process
+    ///
+    ////////////////////////////////////////////////////////////
+    void buildChunk(Job& job) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Apply the result of a job to its chunk
+    ///
+    /// \param job Processed job
+    ///
+    ////////////////////////////////////////////////////////////
+    void applyJob(const Job& job);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Worker thread entry point
+    ///
+    ////////////////////////////////////////////////////////////
+    void processJobs();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Wait for the worker thread and collect its results
+    ///
+    ////////////////////////////////////////////////////////////
+    void collectJobs();
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    std::vector<float>                     m_heights;       ///< Heights of the samples
+    Vector2u                               m_size;          ///< Number of samples along X and Z
+    unsigned int                           m_chunkSize;     ///< Number of cells along a side of a chunk
+    Vector2u                               m_chunkCount;    ///< Number of chunks along X and Z
+    unsigned int                           m_maxLod;        ///< Coarsest level of detail
+    float                                  m_lodDistance;   ///< Distance of the first level of detail change
+    const Texture*                         m_texture;       ///< Texture of the terrain
+    Vector2f                               m_textureSize;   ///< Size of the texture when the chunks were built
+    FloatBox                               m_bounds;        ///< Bounding box of the heightfield
+    std::vector<Chunk>                     m_chunks;        ///< Chunks of the terrain
+    std::vector<std::vector<unsigned int> > m_indices;      ///< Grid index lists, shared by all the chunks, one per level of detail
+    std::vector<Job*>                      m_pendingJobs;   ///< Jobs waiting for the worker thread
+    std::vector<Job*>                      m_activeJobs;    ///< Jobs processed by the worker thread
+    Thread                                 m_thread;        ///< Worker thread rebuilding the chunks
+    mutable Mutex                          m_mutex;         ///< Mutex protecting the worker state
+    bool                                   m_working;       ///< Whether the worker thread was launched
+    bool                                   m_workDone;      ///< Whether the worker thread finished its jobs
+};
+
+} // namespace sf3d
+
+
+#endif // SFML3D_TERRAIN_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class sf3d::Terrain
+/// \ingroup graphics
+///
+/// sf3d::Terrain draws a heightfield loaded from an image or
+/// an array of heights. The samples are laid out on the XZ
+/// plane, one unit apart, with their height along the Y axis.
+///
+/// The terrain is split into square chunks. Every chunk uses
+/// a level of detail chosen from its distance to the viewer
+/// (geomipmapping): the further it is, the fewer samples it
+/// uses. The vertices on the edge of a chunk that borders a
+/// coarser chunk are moved onto the coarser edge, so that no
+/// cracks appear between chunks of different resolutions.
+///
+/// When heights are edited with setHeight, only the chunks
+/// touching the modified samples are rebuilt, on a worker
+/// thread, and swapped in by a later call to update. The chunk
+/// keeps drawing its previous geometry in the meantime.
+///
+/// Usage example:
+/// \code
+/// sf3d::Image heightmap;
+/// heightmap.loadFromFile("heightmap.png");
+///
+/// sf3d::Terrain terrain;
+/// terrain.loadFromImage(heightmap, 40.f);
+/// terrain.setScale(4.f, 1.f, 4.f);
+/// terrain.setTexture(&grass);
+///
+/// while (window.isOpen())
+/// {
+///     terrain.update(camera.getPosition());
+///     window.draw(terrain);
+/// }
+/// \endcode
+///
+/// \see sf3d::Image, sf3d::Texture, sf3d::Transformable
+///
+////////////////////////////////////////////////////////////
@@ -79,6 +79,20 @@ public :
     ////////////////////////////////////////////////////////////
     Text(const String& string, const Font& font, unsigned int characterSize = 30);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Copy constructor
+    ///
+    /// \param copy Instance to copy
+    ///
+    ////////////////////////////////////////////////////////////
+    Text(const Text& copy);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    ////////////////////////////////////////////////////////////
+    ~Text();
+
     ////////////////////////////////////////////////////////////
     /// \brief Set the text's string
     ///
@@ -155,6 +169,28 @@ public :
     ////////////////////////////////////////////////////////////
     void setColor(const Color& color);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Enable or disable distance field rendering
+    ///
+    /// When enabled, the glyphs are taken from the font's
+    /// distance field page (see Font::getDistanceFieldGlyph)
+    /// and scaled to the character size, instead of being
+    /// rasterized once per character size. The text remains
+    /// sharp when scaled, rotated or seen in perspective, and
+    /// all the sizes share a single texture.
+    ///
+    /// Distance field rendering requires shaders; when they are
+    /// not available (see isDistanceFieldAvailable), the text
+    /// is drawn with regular glyphs.
+    /// Distance field rendering is disabled by default.
+    ///
+    /// \param distanceField True to enable, false to disable
+    ///
+    /// \see isDistanceField
+    ///
+    ////////////////////////////////////////////////////////////
+    void setDistanceField(bool distanceField);
+
     ////////////////////////////////////////////////////////////
     /// \brief Get the text's string
     ///
@@ -218,6 +254,26 @@ public :
     ////////////////////////////////////////////////////////////
     const Color& getColor() const;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether distance field rendering is enabled
+    ///
+    /// \return True if distance field rendering is enabled
+    ///
+    /// \see setDistanceField
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isDistanceField() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether distance field rendering is supported
+    ///
+    /// \return True if texts can be drawn with distance fields
+    ///
+    /// \see setDistanceField
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool isDistanceFieldAvailable();
+
     ////////////////////////////////////////////////////////////
     /// \brief Return the position of the \a index-th character
     ///
@@ -265,6 +321,23 @@ public :
 
 private :
 
+    friend class TextBatch;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief State of the layout before a character
+    ///
+    ////////////////////////////////////////////////////////////
+    struct LayoutState
+    {
+        float        x;           ///< X position of the pen
+        float        y;           ///< Y position of the pen (baseline)
+        float        minX;        ///< Left of the bounds so far
+        float        minY;        ///< Top of the bounds so far
+        float        maxX;        ///< Right of the bounds so far
+        float        maxY;        ///< Bottom of the bounds so far
+        unsigned int vertexCount; ///< Number of vertices so far
+    };
+
     ////////////////////////////////////////////////////////////
     /// \brief Draw the text to a render target
     ///
@@ -279,21 +352,71 @@ private :
     ///
     /// All the attributes related to rendering are cached, such
     /// that the geometry is only updated when necessary.
+    /// When only the string changed, the layout resumes at the
+    /// first modified character rather than starting over.
     ///
     ////////////////////////////////////////////////////////////
     void ensureGeometryUpdate() const;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the texture and shader the text is drawn with
+    ///
+    /// The shader is only set if \a states doesn't have one.
+    ///
+    /// \param states Render states to complete
+    ///
+    ////////////////////////////////////////////////////////////
+    void applyRenderStates(RenderStates& states) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether the text is drawn with distance fields
+    ///
+    /// \return True if distance fields are enabled and supported
+    ///
+    ////////////////////////////////////////////////////////////
+    bool usesDistanceField() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add an underline quad to the geometry
+    ///
+    /// \param width     Width of the line
+    /// \param top       Top of the line
+    /// \param thickness Thickness of the line
+    ///
+    ////////////////////////////////////////////////////////////
+    void appendUnderline(float width, float top, float thickness) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get a glyph of the font, as the text draws it
+    ///
+    /// Distance field glyphs are returned at the distance
+    /// field size, and must be scaled to the character size.
+    ///
+    /// \param codePoint     Unicode code point of the character
+    /// \param bold          Retrieve the bold version or the regular one?
+    /// \param distanceField Retrieve the distance field glyph?
+    ///
+    /// \return The glyph corresponding to \a codePoint
+    ///
+    ////////////////////////////////////////////////////////////
+    const Glyph& getGlyph(Uint32 codePoint, bool bold, bool distanceField) const;
+
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
-    String                  m_string;             ///< String to display
-    const Font*             m_font;               ///< Font used to display the string
-    unsigned int            m_characterSize;      ///< Base size of characters, in pixels
-    Uint32                  m_style;              ///< Text style (see Style enum)
-    Color                   m_color;              ///< Text color
-    mutable VertexContainer m_vertices;           ///< Vertex array containing the text's geometry
-    mutable FloatRect       m_bounds;             ///< Bounding rectangle of the text (in local coordinates)
-    mutable bool            m_geometryNeedUpdate; ///< Does the geometry need to be recomputed?
+    String                           m_string;             ///< String to display
+    const Font*                      m_font;               ///< Font used to display the string
+    unsigned int                     m_characterSize;      ///< Base size of characters, in pixels
+    Uint32                           m_style;              ///< Text style (see Style enum)
+    Color                            m_color;              ///< Text color
+    bool                             m_distanceField;      ///< Is distance field rendering enabled?
+    mutable VertexContainer          m_vertices;           ///< Vertex array containing the text's geometry
+    mutable FloatRect                m_bounds;             ///< Bounding rectangle of the text (in local coordinates)
+    mutable bool                     m_geometryNeedUpdate; ///< Does the geometry need to be recomputed?
+    mutable unsigned int             m_fontRevision;       ///< Revision of the font's glyphs used by the geometry
+    mutable std::vector<Vertex>      m_layoutVertices;     ///< Contiguous copy of the geometry, uploaded at once
+    mutable std::vector<LayoutState> m_layout;             ///< Layout state before each character, and after the last one
+    mutable std::size_t              m_layoutStart;        ///< Index of the first character whose layout is outdated
 };
 
 } // namespace sf3d
@@ -352,6 +475,12 @@ private :
 /// window.draw(text);
 /// \endcode
 ///
+/// Texts that are scaled, rotated in 3D or drawn at many
+/// different sizes should enable distance field rendering
+/// with setDistanceField(true): the glyphs are then stored
+/// once, at a single reference size, and stay sharp at any
+/// scale.
+///
 /// \see sf3d::Font, sf3d::Transformable
 ///
 ////////////////////////////////////////////////////////////
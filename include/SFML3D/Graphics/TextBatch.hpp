@@ -0,0 +1,162 @@
+#ifndef SFML3D_TEXTBATCH_HPP
+#define SFML3D_TEXTBATCH_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/Graphics/Export.hpp>
+#include <SFML3D/Graphics/Drawable.hpp>
+#include <SFML3D/Graphics/Vertex.hpp>
+#include <SFML3D/Graphics/VertexContainer.hpp>
+#include <SFML3D/System/NonCopyable.hpp>
+#include <map>
+#include <vector>
+
+
+namespace sf3d
+{
+class Shader;
+class Text;
+class Texture;
+
+////////////////////////////////////////////////////////////
+/// \brief Set of texts drawn together, with one draw call
+///        per font texture
+///
+////////////////////////////////////////////////////////////
+class SFML3D_GRAPHICS_API TextBatch : public Drawable, NonCopyable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// Creates an empty batch.
+    ///
+    ////////////////////////////////////////////////////////////
+    TextBatch();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add a text to the batch
+    ///
+    /// The geometry of the text is copied into the batch, with
+    /// its transform and color applied. Later changes to the
+    /// text are not reflected in the batch: to update it, clear
+    /// it and add the texts again.
+    /// The font of the text must exist as long as the batch
+    /// uses its textures.
+    ///
+    /// \param text Text to add
+    ///
+    ////////////////////////////////////////////////////////////
+    void add(const Text& text);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove all the texts from the batch
+    ///
+    /// The memory allocated for the geometry is kept, so that
+    /// refilling the batch every frame doesn't reallocate it.
+    ///
+    ////////////////////////////////////////////////////////////
+    void clear();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of texts added to the batch
+    ///
+    /// \return Number of texts
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getTextCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the total number of vertices of the batch
+    ///
+    /// \return Number of vertices
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getVertexCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of draw calls needed to draw the batch
+    ///
+    /// There is one draw call per distinct font texture (and
+    /// distance field shader) used by the texts of the batch.
+    ///
+    /// \return Number of draw calls
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getDrawCallCount() const;
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Geometry sharing the same texture and shader
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Batch
+    {
+        Batch();
+
+        std::vector<Vertex>     vertices;   ///< Geometry of the texts
+        mutable VertexContainer container;  ///< Geometry, as uploaded to the graphics card
+        mutable bool            needUpload; ///< Does the container need to be updated?
+    };
+
+    ////////////////////////////////////////////////////////////
+    // Types
+    ////////////////////////////////////////////////////////////
+    typedef std::pair<const Texture*, const Shader*> BatchKey; ///< Texture and shader of a batch
+    typedef std::map<BatchKey, Batch> BatchTable;              ///< Table mapping render states to their batch
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw the batch to a render target
+    ///
+    /// \param target Render target to draw to
+    /// \param states Current render states
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void draw(RenderTarget& target, RenderStates states) const;
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    BatchTable   m_batches;   ///< Geometry of the texts, by texture and shader
+    unsigned int m_textCount; ///< Number of texts added to the batch
+};
+
+} // namespace sf3d
+
+
+#endif // SFML3D_TEXTBATCH_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class sf3d::TextBatch
+/// \ingroup graphics
+///
+/// Every sf3d::Text is drawn with its own draw call, which
+/// becomes the bottleneck when many small texts are shown,
+/// such as the name plates of a crowd of characters.
+/// sf3d::TextBatch bakes many texts, each one with its own
+/// transform, color and style, into shared vertex arrays and
+/// draws them with a single draw call per font texture.
+///
+/// Since the transforms of the texts are applied when they
+/// are added, the batch is typically cleared and refilled
+/// every frame with the texts that moved or changed.
+///
+/// Usage example:
+/// \code
+/// sf3d::TextBatch batch;
+///
+/// // In the game loop
+/// batch.clear();
+/// for (std::size_t i = 0; i < plates.size(); ++i)
+///     batch.add(plates[i]);
+///
+/// window.draw(batch);
+/// \endcode
+///
+/// \see sf3d::Text, sf3d::Font
+///
+////////////////////////////////////////////////////////////
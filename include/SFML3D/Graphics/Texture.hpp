@@ -30,6 +30,7 @@
 ////////////////////////////////////////////////////////////
 #include <SFML3D/Graphics/Export.hpp>
 #include <SFML3D/Graphics/Image.hpp>
+#include <SFML3D/Graphics/CompressedImage.hpp>
 #include <SFML3D/Window/GlResource.hpp>
 #include <SFML3D/System/Vector3.hpp>
 
@@ -40,6 +41,7 @@ class Window;
 class RenderTarget;
 class RenderTexture;
 class InputStream;
+class VolumeImage;
 
 ////////////////////////////////////////////////////////////
 /// \brief Image living on the graphics card that can be used for drawing
@@ -231,6 +233,50 @@ public :
     ////////////////////////////////////////////////////////////
     bool loadFromImage(const Image& image, const IntRect& area = IntRect());
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Load the texture from a compressed image
+    ///
+    /// The compressed blocks are uploaded as they are, with all
+    /// the mipmap levels of the image, and stay compressed in
+    /// video memory. The format must be supported by the graphics
+    /// driver (see isCompressedFormatAvailable), and the size must
+    /// be a power of two if the driver doesn't support NPOT
+    /// textures, since compressed textures can't be padded.
+    ///
+    /// A texture loaded this way can't be updated with update.
+    ///
+    /// If this function fails, the texture is left unchanged.
+    ///
+    /// \param image Compressed image to load into the texture
+    ///
+    /// \return True if loading was successful
+    ///
+    /// \see loadFromImage, isCompressedFormatAvailable
+    ///
+    ////////////////////////////////////////////////////////////
+    bool loadFromCompressedImage(const CompressedImage& image);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Load a 3D texture from a volume image
+    ///
+    /// The volume is uploaded in slabs of a few slices, so that
+    /// the driver never has to stage the whole volume at once
+    /// and volumes mapped from a file are read progressively.
+    /// When \a generateMipmaps is true, the mipmap levels are
+    /// computed too (see generateMipmap).
+    ///
+    /// If this function fails, the texture is left unchanged.
+    ///
+    /// \param volume          Volume image to load into the texture
+    /// \param generateMipmaps Generate the mipmap levels too?
+    ///
+    /// \return True if loading was successful
+    ///
+    /// \see create, updateSlice
+    ///
+    ////////////////////////////////////////////////////////////
+    bool loadFromVolumeImage(const VolumeImage& volume, bool generateMipmaps = false);
+
     ////////////////////////////////////////////////////////////
     /// \brief Return the size of the texture
     ///
@@ -374,6 +420,112 @@ public :
     ////////////////////////////////////////////////////////////
     void update(const Image& image, unsigned int x, unsigned int y);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Update a 3D texture from a volume image
+    ///
+    /// No additional check is performed on the size of the volume,
+    /// passing a volume bigger than the texture will lead to an
+    /// undefined behaviour.
+    ///
+    /// This function does nothing if the texture was not
+    /// previously created.
+    ///
+    /// \param volume Volume image to copy to the texture
+    ///
+    ////////////////////////////////////////////////////////////
+    void update(const VolumeImage& volume);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Update a part of a 3D texture from a volume image
+    ///
+    /// No additional check is performed on the size of the volume,
+    /// passing an invalid combination of volume size and offset
+    /// will lead to an undefined behaviour.
+    ///
+    /// This function does nothing if the texture was not
+    /// previously created.
+    ///
+    /// \param volume Volume image to copy to the texture
+    /// \param x      X offset in the texture where to copy the source volume
+    /// \param y      Y offset in the texture where to copy the source volume
+    /// \param z      Z offset in the texture where to copy the source volume
+    ///
+    ////////////////////////////////////////////////////////////
+    void update(const VolumeImage& volume, unsigned int x, unsigned int y, unsigned int z);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Replace a whole slice of a 3D texture
+    ///
+    /// The \a texels array must contain width x height 32-bits
+    /// RGBA texels, the size of the texture. Unlike the other
+    /// update functions, this one doesn't recompute the mipmaps:
+    /// it is meant for streaming a volume slice by slice, over
+    /// several frames. Call generateMipmap once all the slices
+    /// are uploaded.
+    ///
+    /// This function does nothing if \a texels is null or if the
+    /// texture was not previously created.
+    ///
+    /// \param texels Array of texels to copy to the slice
+    /// \param z      Index of the slice to replace
+    ///
+    ////////////////////////////////////////////////////////////
+    void updateSlice(const Uint8* texels, unsigned int z);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Replace a whole slice of a 3D texture with an image
+    ///
+    /// The image must have the width and height of the texture.
+    /// See the other overload for details.
+    ///
+    /// \param slice Image to copy to the slice
+    /// \param z     Index of the slice to replace
+    ///
+    ////////////////////////////////////////////////////////////
+    void updateSlice(const Image& slice, unsigned int z);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Update the texture from another texture
+    ///
+    /// Although the source texture can be smaller than this texture,
+    /// this function is usually used for updating the whole texture.
+    /// The other overload, which has (x, y) additional arguments,
+    /// is more convenient for updating a sub-area of this texture.
+    ///
+    /// No additional check is performed on the size of the passed
+    /// texture, passing a texture bigger than this texture
+    /// will lead to an undefined behaviour.
+    ///
+    /// This function does nothing if either texture was not
+    /// previously created.
+    ///
+    /// \param texture Source texture to copy to this texture
+    ///
+    ////////////////////////////////////////////////////////////
+    void update(const Texture& texture);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Update a part of this texture from another texture
+    ///
+    /// The pixels are copied directly on the graphics card when
+    /// framebuffer objects are supported, without going through
+    /// system memory; otherwise the source texture is read back
+    /// with copyToImage.
+    ///
+    /// No additional check is performed on the size of the texture,
+    /// passing an invalid combination of texture size and offset
+    /// will lead to an undefined behaviour.
+    ///
+    /// This function does nothing if either texture was not
+    /// previously created.
+    ///
+    /// \param texture Source texture to copy to this texture
+    /// \param x       X offset in this texture where to copy the source texture
+    /// \param y       Y offset in this texture where to copy the source texture
+    ///
+    ////////////////////////////////////////////////////////////
+    void update(const Texture& texture, unsigned int x, unsigned int y);
+
     ////////////////////////////////////////////////////////////
     /// \brief Update the texture from the contents of a window
     ///
@@ -418,6 +570,8 @@ public :
     /// so that pixels are less noticeable. However if you want
     /// the texture to look exactly the same as its source file,
     /// you should leave it disabled.
+    /// If the texture has mipmaps, the smooth filter also blends
+    /// between mipmap levels (trilinear filtering).
     /// The smooth filter is disabled by default.
     ///
     /// \param smooth True to enable smoothing, false to disable it
@@ -471,6 +625,68 @@ public :
     ////////////////////////////////////////////////////////////
     bool isRepeated() const;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Generate the mipmap levels of the texture
+    ///
+    /// Mipmaps are pre-computed, smaller versions of the texture,
+    /// used when it is drawn at a smaller size than its own (on
+    /// distant 3D geometry, for example). They remove aliasing
+    /// and make texture sampling much more cache friendly.
+    ///
+    /// The levels are computed on the graphics card when
+    /// framebuffer objects are supported, and with a box filter
+    /// on the CPU otherwise. Once generated, they are kept up to
+    /// date by update: for 2D textures, only the area touched by
+    /// the update is recomputed when the driver can blit between
+    /// framebuffers. Calling create, or one of the loadFrom
+    /// functions, removes the mipmaps. 1D textures can't have
+    /// mipmaps, and compressed textures only have the levels
+    /// stored in their compressed image.
+    ///
+    /// \return True if the mipmaps were generated
+    ///
+    /// \see hasMipmap, setSmooth, setAnisotropy
+    ///
+    ////////////////////////////////////////////////////////////
+    bool generateMipmap();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether the texture has mipmap levels
+    ///
+    /// \return True if the texture has mipmaps
+    ///
+    /// \see generateMipmap
+    ///
+    ////////////////////////////////////////////////////////////
+    bool hasMipmap() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the level of anisotropic filtering
+    ///
+    /// Anisotropic filtering keeps textures sharp when they are
+    /// seen at grazing angles, such as floors and roads. The
+    /// \a anisotropy is the maximum number of samples taken per
+    /// pixel; it is clamped to [1, getMaximumAnisotropy()].
+    /// It is mostly useful with mipmaps and the smooth filter.
+    /// The default anisotropy is 1 (disabled).
+    ///
+    /// \param anisotropy Level of anisotropic filtering
+    ///
+    /// \see getAnisotropy, getMaximumAnisotropy
+    ///
+    ////////////////////////////////////////////////////////////
+    void setAnisotropy(float anisotropy);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the level of anisotropic filtering
+    ///
+    /// \return Level of anisotropic filtering
+    ///
+    /// \see setAnisotropy
+    ///
+    ////////////////////////////////////////////////////////////
+    float getAnisotropy() const;
+
     ////////////////////////////////////////////////////////////
     /// \brief Overload of assignment operator
     ///
@@ -481,6 +697,16 @@ public :
     ////////////////////////////////////////////////////////////
     Texture& operator =(const Texture& right);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Swap the contents of this texture with those of another
+    ///
+    /// Unlike assignment, no pixel is copied.
+    ///
+    /// \param right Instance to swap with
+    ///
+    ////////////////////////////////////////////////////////////
+    void swap(Texture& right);
+
     ////////////////////////////////////////////////////////////
     /// \brief Bind a texture for rendering
     ///
@@ -552,10 +778,37 @@ public :
     ////////////////////////////////////////////////////////////
     static unsigned int getMaximumSize();
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether the graphics driver can sample a compression format
+    ///
+    /// The BC formats require EXT_texture_compression_s3tc,
+    /// the ETC2 formats require ARB_ES3_compatibility.
+    ///
+    /// \param format Compression format to check
+    ///
+    /// \return True if textures can be loaded in this format
+    ///
+    /// \see loadFromCompressedImage
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool isCompressedFormatAvailable(CompressedImage::Format format);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the maximum level of anisotropic filtering
+    ///
+    /// \return Maximum anisotropy, 1 if anisotropic filtering is not supported
+    ///
+    /// \see setAnisotropy
+    ///
+    ////////////////////////////////////////////////////////////
+    static float getMaximumAnisotropy();
+
 private :
 
     friend class RenderTexture;
     friend class RenderTarget;
+    friend class PixelReader;
+    friend class PixelWriter;
 
     ////////////////////////////////////////////////////////////
     /// \brief Get a valid image size according to hardware support
@@ -572,6 +825,94 @@ private :
     ////////////////////////////////////////////////////////////
     static unsigned int getValidSize(unsigned int size);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Create an empty 2D texture with a given storage format
+    ///
+    /// This is used by render textures for their floating point
+    /// and depth attachments.
+    ///
+    /// \param width          Width of the texture
+    /// \param height         Height of the texture
+    /// \param internalFormat OpenGL internal format of the texture
+    /// \param format         OpenGL format matching the internal format
+    /// \param type           OpenGL type matching the internal format
+    ///
+    /// \return True if creation was successful
+    ///
+    ////////////////////////////////////////////////////////////
+    bool createStorage(unsigned int width, unsigned int height, int internalFormat, unsigned int format, unsigned int type);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the minification filter matching the texture state
+    ///
+    /// \return OpenGL filter, depending on the smooth flag and mipmaps
+    ///
+    ////////////////////////////////////////////////////////////
+    int getMinificationFilter() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Recompute the mipmaps covering an area of the texture
+    ///
+    /// Does nothing if the texture has no mipmap.
+    ///
+    /// \param x      X offset of the updated area
+    /// \param y      Y offset of the updated area
+    /// \param width  Width of the updated area
+    /// \param height Height of the updated area
+    ///
+    ////////////////////////////////////////////////////////////
+    void updateMipmap(unsigned int x, unsigned int y, unsigned int width, unsigned int height);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Compute and upload the mipmaps on the CPU
+    ///
+    /// \return True if the mipmaps were generated
+    ///
+    ////////////////////////////////////////////////////////////
+    bool generateMipmapOnCpu();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Upload a box of texels to a 3D texture, a few slices at a time
+    ///
+    /// The texture must be bound to GL_TEXTURE_3D.
+    ///
+    /// \param texels Array of texels to copy to the texture
+    /// \param width  Width of the box
+    /// \param height Height of the box
+    /// \param depth  Depth of the box
+    /// \param x      X offset in the texture
+    /// \param y      Y offset in the texture
+    /// \param z      Z offset in the texture
+    ///
+    ////////////////////////////////////////////////////////////
+    void uploadSlices(const Uint8* texels, unsigned int width, unsigned int height, unsigned int depth, unsigned int x, unsigned int y, unsigned int z);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Read the visible area of the texture through a framebuffer
+    ///
+    /// This avoids reading the padding of the texture.
+    ///
+    /// \param pixels Array receiving the pixels, in the row order of the texture
+    ///
+    /// \return True if the pixels were read, false if framebuffers are not supported
+    ///
+    ////////////////////////////////////////////////////////////
+    bool readVisiblePixels(Uint8* pixels) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Update a part of the texture from the bound pixel unpack buffer
+    ///
+    /// The pixels are read from the start of the buffer. The
+    /// buffer is unbound before the mipmaps are updated.
+    ///
+    /// \param width  Width of the area to update
+    /// \param height Height of the area to update
+    /// \param x      X offset in the texture
+    /// \param y      Y offset in the texture
+    ///
+    ////////////////////////////////////////////////////////////
+    void updateFromPixelBuffer(unsigned int width, unsigned int height, unsigned int x, unsigned int y);
+
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
@@ -581,6 +922,9 @@ private :
     bool         m_isSmooth;      ///< Status of the smooth filter
     bool         m_isRepeated;    ///< Is the texture in repeat mode?
     mutable bool m_pixelsFlipped; ///< To work around the inconsistency in Y orientation
+    bool         m_hasMipmap;     ///< Does the texture have mipmap levels?
+    bool         m_isCompressed;  ///< Was the texture loaded from a compressed image?
+    float        m_anisotropy;    ///< Level of anisotropic filtering
     Uint64       m_cacheId;       ///< Unique number that identifies the texture to the render target's cache
 };
 
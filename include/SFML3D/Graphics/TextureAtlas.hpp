@@ -0,0 +1,227 @@
+#ifndef SFML3D_TEXTUREATLAS_HPP
+#define SFML3D_TEXTUREATLAS_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/Graphics/Export.hpp>
+#include <SFML3D/Graphics/Rect.hpp>
+#include <SFML3D/System/NonCopyable.hpp>
+#include <vector>
+
+
+namespace sf3d
+{
+class Image;
+class Texture;
+
+////////////////////////////////////////////////////////////
+/// \brief Set of textures holding many small images, packed
+///        together so that they can share draw calls
+///
+////////////////////////////////////////////////////////////
+class SFML3D_GRAPHICS_API TextureAtlas : NonCopyable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Location of an image in the atlas
+    ///
+    ////////////////////////////////////////////////////////////
+    struct SFML3D_GRAPHICS_API Region
+    {
+        ////////////////////////////////////////////////////////////
+        /// \brief Default constructor
+        ///
+        ////////////////////////////////////////////////////////////
+        Region();
+
+        unsigned int page;    ///< Index of the texture holding the image
+        IntRect      rect;    ///< Area of the image in the texture, to use as a texture rect
+        bool         rotated; ///< Is the image stored rotated by 90 degrees clockwise?
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// Creates an atlas with 1024x1024 pages, 1 pixel of
+    /// padding and no rotation.
+    ///
+    ////////////////////////////////////////////////////////////
+    TextureAtlas();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    ////////////////////////////////////////////////////////////
+    ~TextureAtlas();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove all the images and change the settings of the atlas
+    ///
+    /// The \a padding is the number of pixels added around every
+    /// image, filled with copies of its border so that filtering
+    /// doesn't bleed neighbouring images into it.
+    /// When \a allowRotation is true, images may be stored rotated
+    /// by 90 degrees to pack them more tightly; see Region::rotated.
+    ///
+    /// \param pageSize      Width and height of the textures
+    /// \param padding       Number of pixels added around each image
+    /// \param allowRotation Can images be rotated?
+    ///
+    /// \return True if the settings are valid for the graphics driver
+    ///
+    ////////////////////////////////////////////////////////////
+    bool create(unsigned int pageSize, unsigned int padding = 1, bool allowRotation = false);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add an image to the atlas
+    ///
+    /// The image is placed in the first texture that has room
+    /// for it; a new texture is created if none has. Images can
+    /// be added at any time, the regions of the images already
+    /// in the atlas never change.
+    ///
+    /// \param image  Image to add
+    /// \param region Receives the location of the image
+    ///
+    /// \return True if the image was added, false if it is larger than a page
+    ///
+    ////////////////////////////////////////////////////////////
+    bool add(const Image& image, Region& region);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add several images to the atlas
+    ///
+    /// The images are inserted from the largest to the smallest,
+    /// which packs them much more tightly than adding them one by
+    /// one in an arbitrary order. \a regions is filled in the same
+    /// order as \a images; the regions of images that couldn't be
+    /// added have an empty rectangle.
+    ///
+    /// \param images  Images to add
+    /// \param regions Receives the location of each image
+    ///
+    /// \return Number of images successfully added
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t add(const std::vector<Image>& images, std::vector<Region>& regions);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove all the images and destroy the textures
+    ///
+    ////////////////////////////////////////////////////////////
+    void clear();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of textures of the atlas
+    ///
+    /// \return Number of pages
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getPageCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the texture of a page
+    ///
+    /// \param page Index of the page
+    ///
+    /// \return Texture of the page
+    ///
+    ////////////////////////////////////////////////////////////
+    const Texture& getTexture(unsigned int page) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the ratio of a page covered by images
+    ///
+    /// The padding counts as covered.
+    ///
+    /// \param page Index of the page
+    ///
+    /// \return Occupancy of the page, in range [0, 1]
+    ///
+    ////////////////////////////////////////////////////////////
+    float getOccupancy(unsigned int page) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Enable or disable the smooth filter on all the textures
+    ///
+    /// \param smooth True to enable smoothing, false to disable it
+    ///
+    /// \see Texture::setSmooth
+    ///
+    ////////////////////////////////////////////////////////////
+    void setSmooth(bool smooth);
+
+private :
+
+    struct Page;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Copy an image to a page that has room for it
+    ///
+    /// \param image  Image to add
+    /// \param region Receives the location of the image
+    ///
+    /// \return True if the image was added
+    ///
+    ////////////////////////////////////////////////////////////
+    bool insert(const Image& image, Region& region);
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    unsigned int       m_pageSize;      ///< Width and height of the pages
+    unsigned int       m_padding;       ///< Pixels added around every image
+    bool               m_allowRotation; ///< Can images be rotated?
+    bool               m_isSmooth;      ///< Smooth filter of the textures
+    std::vector<Page*> m_pages;         ///< Textures and their free space
+};
+
+} // namespace sf3d
+
+
+#endif // SFML3D_TEXTUREATLAS_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class sf3d::TextureAtlas
+/// \ingroup graphics
+///
+/// Drawing many sprites or billboards that each use their own
+/// texture forces the render target to switch textures between
+/// every draw, and makes batching impossible. sf3d::TextureAtlas
+/// packs many small images into a few large textures, so that
+/// they can be drawn from the same texture.
+///
+/// Images are packed with the MaxRects algorithm, which wastes
+/// very little space; adding them all at once, with the vector
+/// overload of add, gives the best results. The location of
+/// every image is returned as a Region, whose rectangle plugs
+/// directly into Sprite::setTextureRect or
+/// Billboard::setTextureRect.
+///
+/// When rotation is allowed, some images may be stored rotated
+/// by 90 degrees clockwise (Region::rotated). Such an image is
+/// drawn upright by rotating its sprite by -90 degrees.
+///
+/// Usage example:
+/// \code
+/// std::vector<sf3d::Image> images = ...;
+///
+/// sf3d::TextureAtlas atlas;
+/// std::vector<sf3d::TextureAtlas::Region> regions;
+/// atlas.add(images, regions);
+///
+/// sf3d::Sprite sprite;
+/// sprite.setTexture(atlas.getTexture(regions[0].page));
+/// sprite.setTextureRect(regions[0].rect);
+///
+/// // Images can be added later too
+/// sf3d::TextureAtlas::Region region;
+/// atlas.add(lateImage, region);
+/// \endcode
+///
+/// \see sf3d::Texture, sf3d::Sprite, sf3d::Billboard
+///
+////////////////////////////////////////////////////////////
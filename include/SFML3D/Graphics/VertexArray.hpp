@@ -137,6 +137,19 @@ public :
     ////////////////////////////////////////////////////////////
     void append(const Vertex& vertex);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Replace the contents of the array
+    ///
+    /// The array is resized to \a vertexCount and the vertices
+    /// are copied in a single operation, which is much faster
+    /// than assigning them one by one through operator [].
+    ///
+    /// \param vertices    Pointer to the vertices to copy
+    /// \param vertexCount Number of vertices to copy
+    ///
+    ////////////////////////////////////////////////////////////
+    void assign(const Vertex* vertices, unsigned int vertexCount);
+
     ////////////////////////////////////////////////////////////
     /// \brief Set the type of primitives to draw
     ///
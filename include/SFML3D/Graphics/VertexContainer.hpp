@@ -127,6 +127,19 @@ public :
     ////////////////////////////////////////////////////////////
     virtual void append(const Vertex& vertex);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Replace the contents of the container
+    ///
+    /// The container is resized to \a vertexCount and the vertices
+    /// are copied in a single operation, which is much faster
+    /// than assigning them one by one through operator [].
+    ///
+    /// \param vertices    Pointer to the vertices to copy
+    /// \param vertexCount Number of vertices to copy
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void assign(const Vertex* vertices, unsigned int vertexCount);
+
     ////////////////////////////////////////////////////////////
     /// \brief Set the type of primitives to draw
     ///
@@ -0,0 +1,320 @@
+#ifndef SFML3D_VOLUMEIMAGE_HPP
+#define SFML3D_VOLUMEIMAGE_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/Graphics/Export.hpp>
+#include <SFML3D/Graphics/Image.hpp>
+#include <SFML3D/Graphics/Color.hpp>
+#include <SFML3D/System/Vector3.hpp>
+#include <string>
+#include <vector>
+
+
+namespace sf3d
+{
+namespace priv
+{
+    class FileMapping;
+}
+
+////////////////////////////////////////////////////////////
+/// \brief Three-dimensional image, stored in system memory
+///
+////////////////////////////////////////////////////////////
+class SFML3D_GRAPHICS_API VolumeImage
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// Creates an empty volume.
+    ///
+    ////////////////////////////////////////////////////////////
+    VolumeImage();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Copy constructor
+    ///
+    /// A volume mapped from a file is copied to memory.
+    ///
+    /// \param copy Instance to copy
+    ///
+    ////////////////////////////////////////////////////////////
+    VolumeImage(const VolumeImage& copy);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    ////////////////////////////////////////////////////////////
+    ~VolumeImage();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Create the volume and fill it with a unique color
+    ///
+    /// \param width  Width of the volume
+    /// \param height Height of the volume
+    /// \param depth  Depth of the volume (number of slices)
+    /// \param color  Fill color
+    ///
+    ////////////////////////////////////////////////////////////
+    void create(unsigned int width, unsigned int height, unsigned int depth, const Color& color = Color(0, 0, 0));
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Create the volume from an array of pixels
+    ///
+    /// The \a pixel array is assumed to contain 32-bits RGBA pixels,
+    /// slice by slice, and have the given \a width, \a height
+    /// and \a depth. If not, this is an undefined behaviour.
+    /// If \a pixels is null, an empty volume is created.
+    ///
+    /// \param width  Width of the volume
+    /// \param height Height of the volume
+    /// \param depth  Depth of the volume
+    /// \param pixels Array of pixels to copy to the volume
+    ///
+    ////////////////////////////////////////////////////////////
+    void create(unsigned int width, unsigned int height, unsigned int depth, const Uint8* pixels);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Load the volume from a stack of images
+    ///
+    /// Every image becomes a slice of the volume, in order.
+    /// All the images must have the same size.
+    /// If this function fails, the volume is left unchanged.
+    ///
+    /// \param slices Images to stack
+    ///
+    /// \return True if loading was successful
+    ///
+    ////////////////////////////////////////////////////////////
+    bool loadFromImages(const std::vector<Image>& slices);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Load the volume from a stack of image files
+    ///
+    /// The files are decoded in parallel, with the same
+    /// formats as sf3d::Image::loadFromFile, then stacked in
+    /// order. All the images must have the same size.
+    /// If this function fails, the volume is left unchanged.
+    ///
+    /// \param filenames   Paths of the image files, one per slice
+    /// \param threadCount Maximum number of threads, 0 to use one per processor
+    ///
+    /// \return True if loading was successful
+    ///
+    /// \see loadFromImages
+    ///
+    ////////////////////////////////////////////////////////////
+    bool loadFromFiles(const std::vector<std::string>& filenames, unsigned int threadCount = 0);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Load the volume from a raw file
+    ///
+    /// The file must contain 32-bits RGBA pixels, slice by
+    /// slice, starting at \a offset. The file is mapped in
+    /// memory rather than read: its pages are only loaded when
+    /// the pixels are accessed, so opening a large volume is
+    /// immediate and only the slices actually used take memory.
+    /// The pixels can still be modified, the changes are never
+    /// written back to the file.
+    /// If this function fails, the volume is left unchanged.
+    ///
+    /// \param filename Path of the raw file
+    /// \param width    Width of the volume
+    /// \param height   Height of the volume
+    /// \param depth    Depth of the volume
+    /// \param offset   Offset of the first pixel in the file, in bytes
+    ///
+    /// \return True if loading was successful
+    ///
+    /// \see saveToFile
+    ///
+    ////////////////////////////////////////////////////////////
+    bool loadFromFile(const std::string& filename, unsigned int width, unsigned int height, unsigned int depth, Uint64 offset = 0);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Save the volume to a raw file
+    ///
+    /// The pixels are written as they are stored, without
+    /// any header; the file can be reloaded with loadFromFile.
+    ///
+    /// \param filename Path of the file to save
+    ///
+    /// \return True if saving was successful
+    ///
+    /// \see loadFromFile
+    ///
+    ////////////////////////////////////////////////////////////
+    bool saveToFile(const std::string& filename) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Return the size (width, height and depth) of the volume
+    ///
+    /// \return Size of the volume, in pixels
+    ///
+    ////////////////////////////////////////////////////////////
+    Vector3u getSize() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change the color of a pixel
+    ///
+    /// This function doesn't check the validity of the pixel
+    /// coordinates, using out-of-range values will result in
+    /// an undefined behaviour.
+    ///
+    /// \param x     X coordinate of pixel to change
+    /// \param y     Y coordinate of pixel to change
+    /// \param z     Z coordinate (slice) of pixel to change
+    /// \param color New color of the pixel
+    ///
+    /// \see getPixel
+    ///
+    ////////////////////////////////////////////////////////////
+    void setPixel(unsigned int x, unsigned int y, unsigned int z, const Color& color);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the color of a pixel
+    ///
+    /// This function doesn't check the validity of the pixel
+    /// coordinates, using out-of-range values will result in
+    /// an undefined behaviour.
+    ///
+    /// \param x X coordinate of pixel to get
+    /// \param y Y coordinate of pixel to get
+    /// \param z Z coordinate (slice) of pixel to get
+    ///
+    /// \return Color of the pixel at coordinates (x, y, z)
+    ///
+    /// \see setPixel
+    ///
+    ////////////////////////////////////////////////////////////
+    Color getPixel(unsigned int x, unsigned int y, unsigned int z) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get a read-only pointer to the array of pixels
+    ///
+    /// The returned value points to an array of RGBA pixels
+    /// made of 8 bits integers components, slice by slice.
+    /// Warning: the returned pointer may become invalid if
+    /// you modify the volume, so you should never store it
+    /// for too long. If the volume is empty, a null pointer
+    /// is returned.
+    ///
+    /// \return Read-only pointer to the array of pixels
+    ///
+    ////////////////////////////////////////////////////////////
+    const Uint8* getPixelsPtr() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get a read-only pointer to the pixels of a slice
+    ///
+    /// \param z Index of the slice
+    ///
+    /// \return Read-only pointer to the first pixel of the slice
+    ///
+    /// \see getPixelsPtr
+    ///
+    ////////////////////////////////////////////////////////////
+    const Uint8* getSlicePtr(unsigned int z) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Copy a slice of the volume to an image
+    ///
+    /// \param z Index of the slice
+    ///
+    /// \return Image containing the pixels of the slice
+    ///
+    ////////////////////////////////////////////////////////////
+    Image copySlice(unsigned int z) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Compute the mipmap levels of the volume
+    ///
+    /// Every level is half the size of the previous one in
+    /// the three dimensions, computed with a 2x2x2 box filter,
+    /// down to 1x1x1. The volume itself is not included.
+    ///
+    /// \param levels Array receiving the levels, from the largest to the smallest
+    ///
+    ////////////////////////////////////////////////////////////
+    void createMipmaps(std::vector<VolumeImage>& levels) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Overload of assignment operator
+    ///
+    /// \param right Instance to assign
+    ///
+    /// \return Reference to self
+    ///
+    ////////////////////////////////////////////////////////////
+    VolumeImage& operator =(const VolumeImage& right);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Swap the contents of this volume with those of another
+    ///
+    /// \param right Instance to swap with
+    ///
+    ////////////////////////////////////////////////////////////
+    void swap(VolumeImage& right);
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get a writable pointer to the array of pixels
+    ///
+    /// \return Pointer to the array of pixels, NULL if the volume is empty
+    ///
+    ////////////////////////////////////////////////////////////
+    Uint8* getData();
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    Vector3u           m_size;    ///< Volume size
+    std::vector<Uint8> m_pixels;  ///< Pixels of the volume, when it is stored in memory
+    priv::FileMapping* m_mapping; ///< File mapped in memory, when the volume was loaded from a raw file
+};
+
+} // namespace sf3d
+
+
+#endif // SFML3D_VOLUMEIMAGE_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class sf3d::VolumeImage
+/// \ingroup graphics
+///
+/// sf3d::VolumeImage is the 3D counterpart of sf3d::Image: a
+/// stack of slices of RGBA pixels of the same size, stored in
+/// system memory, that can be uploaded to a 3D texture with
+/// sf3d::Texture::loadFromVolumeImage. Typical uses are
+/// volumetric fog, color grading tables and scanned data sets.
+///
+/// A volume can be built from a stack of images or image files,
+/// or loaded from a raw file. Raw files are mapped in memory, so
+/// that even volumes of several hundred megabytes open instantly
+/// and are paged in as they are streamed to the graphics card.
+///
+/// Usage example:
+/// \code
+/// // Load a 512x512x512 scan stored as raw RGBA pixels
+/// sf3d::VolumeImage volume;
+/// if (!volume.loadFromFile("scan.raw", 512, 512, 512))
+///     return -1;
+///
+/// // Upload it slice by slice to a 3D texture, with mipmaps
+/// sf3d::Texture texture;
+/// if (!texture.loadFromVolumeImage(volume, true))
+///     return -1;
+///
+/// // Replace a single slice later
+/// texture.updateSlice(volume.copySlice(42), 42);
+/// \endcode
+///
+/// \see sf3d::Image, sf3d::Texture
+///
+////////////////////////////////////////////////////////////
@@ -3,7 +3,7 @@
 ////////////////////////////////////////////////////////////
 #include <SFML3D/Graphics/Billboard.hpp>
 #include <SFML3D/Graphics/Camera.hpp>
-#include <cmath>
+#include <SFML3D/Graphics/BillboardAxes.hpp>
 
 
 namespace sf3d
@@ -39,23 +39,8 @@ void Billboard::draw(RenderTarget& target, RenderStates states) const
         Vector3f pos = getPosition();
 
         // Construct the basis of our rotation matrix
-        Vector3f zAxis = m_camera->getPosition() - pos;
-        float zAxisNorm = std::sqrt(zAxis.x * zAxis.x +
-                                    zAxis.y * zAxis.y +
-                                    zAxis.z * zAxis.z);
-        zAxis /= zAxisNorm;
-
-        Vector3f xAxis(zAxis.z, 0.f, -zAxis.x);
-        float xAxisNorm = std::sqrt(xAxis.x * xAxis.x +
-                                    xAxis.y * xAxis.y +
-                                    xAxis.z * xAxis.z);
-        xAxis /= xAxisNorm;
-
-        Vector3f yAxis(zAxis.y * xAxis.z - zAxis.z * xAxis.y,
-                       zAxis.z * xAxis.x - zAxis.x * xAxis.z,
-                       zAxis.x * xAxis.y - zAxis.y * xAxis.x);
-
-        // No need to normalize y axis, x and z orthogonal
+        Vector3f xAxis, yAxis, zAxis;
+        priv::computeBillboardAxes(pos, m_camera->getPosition(), xAxis, yAxis, zAxis);
 
         // Combine a translation, rotation and translation into 1 transform
         pos -= xAxis * pos.x + yAxis * pos.y + zAxis * pos.z;
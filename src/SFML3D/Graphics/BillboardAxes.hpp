@@ -0,0 +1,84 @@
+////////////////////////////////////////////////////////////
+//
+// SFML3D - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2014 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+#ifndef SFML3D_BILLBOARDAXES_HPP
+#define SFML3D_BILLBOARDAXES_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/System/Vector3.hpp>
+#include <cmath>
+
+
+namespace sf3d
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+/// \brief Compute the basis of a quad facing a viewer
+///
+/// The Z axis points from \a position to \a viewer, the X
+/// axis stays horizontal and the Y axis completes the basis.
+///
+/// \param position Position of the quad
+/// \param viewer   Position of the viewer
+/// \param xAxis    Receives the X axis of the basis
+/// \param yAxis    Receives the Y axis of the basis
+/// \param zAxis    Receives the Z axis of the basis
+///
+////////////////////////////////////////////////////////////
+inline void computeBillboardAxes(const Vector3f& position, const Vector3f& viewer,
+                                 Vector3f& xAxis, Vector3f& yAxis, Vector3f& zAxis)
+{
+    zAxis = viewer - position;
+    float zAxisNorm = std::sqrt(zAxis.x * zAxis.x +
+                                zAxis.y * zAxis.y +
+                                zAxis.z * zAxis.z);
+    if (zAxisNorm != 0.f)
+        zAxis /= zAxisNorm;
+
+    xAxis = Vector3f(zAxis.z, 0.f, -zAxis.x);
+    float xAxisNorm = std::sqrt(xAxis.x * xAxis.x +
+                                xAxis.y * xAxis.y +
+                                xAxis.z * xAxis.z);
+
+    // Viewer right above or below, any horizontal axis will do
+    if (xAxisNorm != 0.f)
+        xAxis /= xAxisNorm;
+    else
+        xAxis = Vector3f(1.f, 0.f, 0.f);
+
+    // No need to normalize y axis, x and z orthogonal
+    yAxis = Vector3f(zAxis.y * xAxis.z - zAxis.z * xAxis.y,
+                     zAxis.z * xAxis.x - zAxis.x * xAxis.z,
+                     zAxis.x * xAxis.y - zAxis.y * xAxis.x);
+}
+
+} // namespace priv
+
+} // namespace sf3d
+
+
+#endif // SFML3D_BILLBOARDAXES_HPP
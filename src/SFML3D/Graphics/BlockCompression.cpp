@@ -0,0 +1,396 @@
+////////////////////////////////////////////////////////////
+//
+// SFML3D - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2014 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/Graphics/BlockCompression.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <cmath>
+
+
+namespace
+{
+    // Pack a color to 5:6:5 bits, rounding to the nearest value
+    sf3d::Uint16 packColor(float r, float g, float b)
+    {
+        int r5 = static_cast<int>(std::max(0.f, std::min(r, 255.f)) * 31.f / 255.f + 0.5f);
+        int g6 = static_cast<int>(std::max(0.f, std::min(g, 255.f)) * 63.f / 255.f + 0.5f);
+        int b5 = static_cast<int>(std::max(0.f, std::min(b, 255.f)) * 31.f / 255.f + 0.5f);
+
+        return static_cast<sf3d::Uint16>((r5 << 11) | (g6 << 5) | b5);
+    }
+
+    // Expand a 5:6:5 color to 8 bits per channel
+    void unpackColor(sf3d::Uint16 color, int* rgb)
+    {
+        int r5 = (color >> 11) & 31;
+        int g6 = (color >> 5) & 63;
+        int b5 = color & 31;
+
+        rgb[0] = (r5 << 3) | (r5 >> 2);
+        rgb[1] = (g6 << 2) | (g6 >> 4);
+        rgb[2] = (b5 << 3) | (b5 >> 2);
+    }
+
+    // Build the 4 entries palette of a color block
+    void buildPalette(sf3d::Uint16 color0, sf3d::Uint16 color1, bool allowTransparent, int palette[4][4])
+    {
+        unpackColor(color0, palette[0]);
+        unpackColor(color1, palette[1]);
+        palette[0][3] = 255;
+        palette[1][3] = 255;
+
+        if ((color0 > color1) || !allowTransparent)
+        {
+            for (int c = 0; c < 3; ++c)
+            {
+                palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+                palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+            }
+            palette[2][3] = 255;
+            palette[3][3] = 255;
+        }
+        else
+        {
+            for (int c = 0; c < 3; ++c)
+            {
+                palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+                palette[3][c] = 0;
+            }
+            palette[2][3] = 255;
+            palette[3][3] = 0;
+        }
+    }
+
+    // Write a little endian 16 bits value
+    void write16(sf3d::Uint8* data, sf3d::Uint16 value)
+    {
+        data[0] = static_cast<sf3d::Uint8>(value & 0xFF);
+        data[1] = static_cast<sf3d::Uint8>(value >> 8);
+    }
+
+    // Compress the colors of a block; with allowTransparent, pixels
+    // with an alpha lower than 128 use the transparent entry
+    void encodeColorBlock(const sf3d::Uint8* pixels, sf3d::Uint8* block, bool allowTransparent)
+    {
+        bool transparent[16];
+        bool hasTransparent = false;
+        float mean[3] = {0.f, 0.f, 0.f};
+        int count = 0;
+
+        for (int i = 0; i < 16; ++i)
+        {
+            transparent[i] = allowTransparent && (pixels[i * 4 + 3] < 128);
+            hasTransparent = hasTransparent || transparent[i];
+
+            if (!transparent[i])
+            {
+                for (int c = 0; c < 3; ++c)
+                    mean[c] += pixels[i * 4 + c];
+                count++;
+            }
+        }
+
+        // Fully transparent block: equal endpoints select the 3 colors mode
+        if (count == 0)
+        {
+            write16(block, 0);
+            write16(block + 2, 0);
+            block[4] = block[5] = block[6] = block[7] = 0xFF;
+            return;
+        }
+
+        for (int c = 0; c < 3; ++c)
+            mean[c] /= count;
+
+        // Covariance of the colors
+        float covariance[6] = {0.f, 0.f, 0.f, 0.f, 0.f, 0.f};
+        for (int i = 0; i < 16; ++i)
+        {
+            if (transparent[i])
+                continue;
+
+            float r = pixels[i * 4 + 0] - mean[0];
+            float g = pixels[i * 4 + 1] - mean[1];
+            float b = pixels[i * 4 + 2] - mean[2];
+            covariance[0] += r * r;
+            covariance[1] += r * g;
+            covariance[2] += r * b;
+            covariance[3] += g * g;
+            covariance[4] += g * b;
+            covariance[5] += b * b;
+        }
+
+        // Principal axis of the colors, by power iteration; it starts from the
+        // largest column of the covariance, since a fixed vector such as (1, 1, 1)
+        // can be orthogonal to the axis (a red to green gradient, for example)
+        const int columns[3][3] = {{0, 1, 2}, {1, 3, 4}, {2, 4, 5}};
+        float axis[3] = {1.f, 1.f, 1.f};
+        float largest = 0.f;
+        for (int j = 0; j < 3; ++j)
+        {
+            float norm = 0.f;
+            for (int c = 0; c < 3; ++c)
+                norm += covariance[columns[j][c]] * covariance[columns[j][c]];
+
+            if (norm > largest)
+            {
+                largest = norm;
+                for (int c = 0; c < 3; ++c)
+                    axis[c] = covariance[columns[j][c]];
+            }
+        }
+
+        for (int iteration = 0; iteration < 8; ++iteration)
+        {
+            float x = covariance[0] * axis[0] + covariance[1] * axis[1] + covariance[2] * axis[2];
+            float y = covariance[1] * axis[0] + covariance[3] * axis[1] + covariance[4] * axis[2];
+            float z = covariance[2] * axis[0] + covariance[4] * axis[1] + covariance[5] * axis[2];
+            float length = std::max(std::max(std::fabs(x), std::fabs(y)), std::fabs(z));
+            if (length < 1e-6f)
+                break;
+
+            axis[0] = x / length;
+            axis[1] = y / length;
+            axis[2] = z / length;
+        }
+
+        float axisLength = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+
+        // Extent of the colors along the axis
+        float minT = 0.f;
+        float maxT = 0.f;
+        for (int i = 0; i < 16; ++i)
+        {
+            if (transparent[i])
+                continue;
+
+            float t = ((pixels[i * 4 + 0] - mean[0]) * axis[0] +
+                       (pixels[i * 4 + 1] - mean[1]) * axis[1] +
+                       (pixels[i * 4 + 2] - mean[2]) * axis[2]) / axisLength;
+            minT = std::min(minT, t);
+            maxT = std::max(maxT, t);
+        }
+
+        // Move the endpoints slightly inside, to reduce the error of the interpolated colors
+        float inset = (maxT - minT) / 16.f;
+        minT += inset;
+        maxT -= inset;
+
+        sf3d::Uint16 color0 = packColor(mean[0] + axis[0] * maxT, mean[1] + axis[1] * maxT, mean[2] + axis[2] * maxT);
+        sf3d::Uint16 color1 = packColor(mean[0] + axis[0] * minT, mean[1] + axis[1] * minT, mean[2] + axis[2] * minT);
+
+        // The order of the endpoints selects the mode: 4 colors if color0 > color1
+        if (hasTransparent)
+        {
+            if (color0 > color1)
+                std::swap(color0, color1);
+        }
+        else if (color0 < color1)
+        {
+            std::swap(color0, color1);
+        }
+
+        int palette[4][4];
+        buildPalette(color0, color1, allowTransparent, palette);
+        int entries = (!allowTransparent || (color0 > color1)) ? 4 : 3;
+
+        // Select the nearest palette entry for each pixel
+        sf3d::Uint32 indices = 0;
+        for (int i = 0; i < 16; ++i)
+        {
+            sf3d::Uint32 index = 3;
+            if (!transparent[i])
+            {
+                int bestDistance = 0x7FFFFFFF;
+                for (int j = 0; j < entries; ++j)
+                {
+                    int dr = pixels[i * 4 + 0] - palette[j][0];
+                    int dg = pixels[i * 4 + 1] - palette[j][1];
+                    int db = pixels[i * 4 + 2] - palette[j][2];
+                    int distance = dr * dr + dg * dg + db * db;
+                    if (distance < bestDistance)
+                    {
+                        bestDistance = distance;
+                        index = j;
+                    }
+                }
+            }
+
+            indices |= index << (i * 2);
+        }
+
+        write16(block, color0);
+        write16(block + 2, color1);
+        for (int i = 0; i < 4; ++i)
+            block[4 + i] = static_cast<sf3d::Uint8>((indices >> (i * 8)) & 0xFF);
+    }
+
+    // Decompress the colors of a block
+    void decodeColorBlock(const sf3d::Uint8* block, sf3d::Uint8* pixels, bool allowTransparent)
+    {
+        sf3d::Uint16 color0 = static_cast<sf3d::Uint16>(block[0] | (block[1] << 8));
+        sf3d::Uint16 color1 = static_cast<sf3d::Uint16>(block[2] | (block[3] << 8));
+
+        int palette[4][4];
+        buildPalette(color0, color1, allowTransparent, palette);
+
+        for (int i = 0; i < 16; ++i)
+        {
+            int index = (block[4 + i / 4] >> ((i % 4) * 2)) & 3;
+            for (int c = 0; c < 4; ++c)
+                pixels[i * 4 + c] = static_cast<sf3d::Uint8>(palette[index][c]);
+        }
+    }
+}
+
+
+namespace sf3d
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+void encodeBc1Block(const Uint8* pixels, Uint8* block)
+{
+    encodeColorBlock(pixels, block, true);
+}
+
+
+////////////////////////////////////////////////////////////
+void encodeBc3Block(const Uint8* pixels, Uint8* block)
+{
+    // Alpha endpoints: the extremes of the block, in the 8 values mode
+    int alpha0 = 0;
+    int alpha1 = 255;
+    for (int i = 0; i < 16; ++i)
+    {
+        alpha0 = std::max<int>(alpha0, pixels[i * 4 + 3]);
+        alpha1 = std::min<int>(alpha1, pixels[i * 4 + 3]);
+    }
+
+    int palette[8];
+    palette[0] = alpha0;
+    palette[1] = alpha1;
+    for (int i = 1; i < 7; ++i)
+        palette[i + 1] = ((7 - i) * alpha0 + i * alpha1) / 7;
+
+    // Select the nearest alpha value for each pixel, 3 bits each
+    Uint32 low = 0;
+    Uint32 high = 0;
+    for (int i = 0; i < 16; ++i)
+    {
+        Uint32 index = 0;
+        if (alpha0 != alpha1)
+        {
+            int bestDistance = 256;
+            for (int j = 0; j < 8; ++j)
+            {
+                int distance = std::abs(pixels[i * 4 + 3] - palette[j]);
+                if (distance < bestDistance)
+                {
+                    bestDistance = distance;
+                    index = j;
+                }
+            }
+        }
+
+        if (i < 8)
+            low |= index << (i * 3);
+        else
+            high |= index << ((i - 8) * 3);
+    }
+
+    block[0] = static_cast<Uint8>(alpha0);
+    block[1] = static_cast<Uint8>(alpha1);
+    for (int i = 0; i < 3; ++i)
+    {
+        block[2 + i] = static_cast<Uint8>((low >> (i * 8)) & 0xFF);
+        block[5 + i] = static_cast<Uint8>((high >> (i * 8)) & 0xFF);
+    }
+
+    // The color part never uses the transparent entry
+    encodeColorBlock(pixels, block + 8, false);
+}
+
+
+////////////////////////////////////////////////////////////
+void decodeBc1Block(const Uint8* block, Uint8* pixels)
+{
+    decodeColorBlock(block, pixels, true);
+}
+
+
+////////////////////////////////////////////////////////////
+void decodeBc2Block(const Uint8* block, Uint8* pixels)
+{
+    decodeColorBlock(block + 8, pixels, false);
+
+    // Explicit 4 bits alpha
+    for (int i = 0; i < 16; ++i)
+    {
+        int alpha = (block[i / 2] >> ((i % 2) * 4)) & 15;
+        pixels[i * 4 + 3] = static_cast<Uint8>(alpha * 17);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void decodeBc3Block(const Uint8* block, Uint8* pixels)
+{
+    decodeColorBlock(block + 8, pixels, false);
+
+    int alpha0 = block[0];
+    int alpha1 = block[1];
+
+    int palette[8];
+    palette[0] = alpha0;
+    palette[1] = alpha1;
+    if (alpha0 > alpha1)
+    {
+        for (int i = 1; i < 7; ++i)
+            palette[i + 1] = ((7 - i) * alpha0 + i * alpha1) / 7;
+    }
+    else
+    {
+        for (int i = 1; i < 5; ++i)
+            palette[i + 1] = ((5 - i) * alpha0 + i * alpha1) / 5;
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+
+    Uint32 low = block[2] | (block[3] << 8) | (block[4] << 16);
+    Uint32 high = block[5] | (block[6] << 8) | (block[7] << 16);
+    for (int i = 0; i < 16; ++i)
+    {
+        int index = (i < 8) ? (low >> (i * 3)) & 7 : (high >> ((i - 8) * 3)) & 7;
+        pixels[i * 4 + 3] = static_cast<Uint8>(palette[index]);
+    }
+}
+
+} // namespace priv
+
+} // namespace sf3d
@@ -0,0 +1,92 @@
+////////////////////////////////////////////////////////////
+//
+// SFML3D - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2014 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef SFML3D_BLOCKCOMPRESSION_HPP
+#define SFML3D_BLOCKCOMPRESSION_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/Config.hpp>
+
+
+namespace sf3d
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+/// \brief Compress a 4x4 block of pixels to BC1 (DXT1)
+///
+/// Blocks containing pixels with an alpha lower than 128 use
+/// the 3 colors mode, where these pixels become transparent.
+///
+/// \param pixels 16 RGBA pixels, row by row
+/// \param block  8 bytes receiving the compressed block
+///
+////////////////////////////////////////////////////////////
+void encodeBc1Block(const Uint8* pixels, Uint8* block);
+
+////////////////////////////////////////////////////////////
+/// \brief Compress a 4x4 block of pixels to BC3 (DXT5)
+///
+/// \param pixels 16 RGBA pixels, row by row
+/// \param block  16 bytes receiving the compressed block
+///
+////////////////////////////////////////////////////////////
+void encodeBc3Block(const Uint8* pixels, Uint8* block);
+
+////////////////////////////////////////////////////////////
+/// \brief Decompress a BC1 (DXT1) block
+///
+/// \param block  8 bytes of compressed data
+/// \param pixels 16 RGBA pixels receiving the block, row by row
+///
+////////////////////////////////////////////////////////////
+void decodeBc1Block(const Uint8* block, Uint8* pixels);
+
+////////////////////////////////////////////////////////////
+/// \brief Decompress a BC2 (DXT3) block
+///
+/// \param block  16 bytes of compressed data
+/// \param pixels 16 RGBA pixels receiving the block, row by row
+///
+////////////////////////////////////////////////////////////
+void decodeBc2Block(const Uint8* block, Uint8* pixels);
+
+////////////////////////////////////////////////////////////
+/// \brief Decompress a BC3 (DXT5) block
+///
+/// \param block  16 bytes of compressed data
+/// \param pixels 16 RGBA pixels receiving the block, row by row
+///
+////////////////////////////////////////////////////////////
+void decodeBc3Block(const Uint8* block, Uint8* pixels);
+
+} // namespace priv
+
+} // namespace sf3d
+
+
+#endif // SFML3D_BLOCKCOMPRESSION_HPP
@@ -0,0 +1,528 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/Graphics/CompressedImage.hpp>
+#include <SFML3D/Graphics/BlockCompression.hpp>
+#include <SFML3D/Graphics/ImageKernels.hpp>
+#include <SFML3D/Graphics/Parallel.hpp>
+#include <SFML3D/System/Err.hpp>
+#include <algorithm>
+#include <fstream>
+#include <cctype>
+#include <cstring>
+
+
+namespace
+{
+    // OpenGL internal formats stored in KTX files
+    const sf3d::Uint32 glCompressedRgbDxt1  = 0x83F0;
+    const sf3d::Uint32 glCompressedRgbaDxt1 = 0x83F1;
+    const sf3d::Uint32 glCompressedRgbaDxt3 = 0x83F2;
+    const sf3d::Uint32 glCompressedRgbaDxt5 = 0x83F3;
+    const sf3d::Uint32 glCompressedRgb8Etc2 = 0x9274;
+    const sf3d::Uint32 glCompressedRgba8Etc2 = 0x9278;
+
+    // Identifier at the start of every KTX 1.1 file
+    const sf3d::Uint8 ktxIdentifier[12] = {0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n'};
+
+    // Read a little-endian 32 bits value
+    sf3d::Uint32 readUint32(const sf3d::Uint8* data)
+    {
+        return static_cast<sf3d::Uint32>(data[0]) |
+               (static_cast<sf3d::Uint32>(data[1]) << 8) |
+               (static_cast<sf3d::Uint32>(data[2]) << 16) |
+               (static_cast<sf3d::Uint32>(data[3]) << 24);
+    }
+
+    // Read a 32 bits value with a given endianness
+    sf3d::Uint32 readUint32(const sf3d::Uint8* data, bool swap)
+    {
+        sf3d::Uint32 value = readUint32(data);
+        if (swap)
+            value = (value >> 24) | ((value >> 8) & 0xFF00) | ((value << 8) & 0xFF0000) | (value << 24);
+        return value;
+    }
+
+    // Append a little-endian 32 bits value
+    void writeUint32(std::vector<sf3d::Uint8>& data, sf3d::Uint32 value)
+    {
+        data.push_back(static_cast<sf3d::Uint8>(value));
+        data.push_back(static_cast<sf3d::Uint8>(value >> 8));
+        data.push_back(static_cast<sf3d::Uint8>(value >> 16));
+        data.push_back(static_cast<sf3d::Uint8>(value >> 24));
+    }
+
+    // Number of bytes used by a level of a given size
+    std::size_t getLevelSize(sf3d::Vector2u size, sf3d::CompressedImage::Format format)
+    {
+        std::size_t blocksX = size.x / 4 + (size.x % 4 ? 1 : 0);
+        std::size_t blocksY = size.y / 4 + (size.y % 4 ? 1 : 0);
+        return blocksX * blocksY * sf3d::CompressedImage::getBlockSize(format);
+    }
+
+    // Check whether a level of a given size fits in a number of bytes;
+    // sizes read from a file can be large enough to overflow getLevelSize
+    bool hasLevelData(sf3d::Vector2u size, sf3d::CompressedImage::Format format, std::size_t available)
+    {
+        std::size_t blocksX = size.x / 4 + (size.x % 4 ? 1 : 0);
+        std::size_t blocksY = size.y / 4 + (size.y % 4 ? 1 : 0);
+        std::size_t blockSize = sf3d::CompressedImage::getBlockSize(format);
+        if (!blocksX || !blocksY || (blocksX > available / blockSize))
+            return false;
+
+        return blocksY <= available / (blocksX * blockSize);
+    }
+
+    // Compresses rows of blocks of a level
+    struct EncodeTask : sf3d::priv::ParallelTask
+    {
+        EncodeTask(const sf3d::Uint8* thePixels, sf3d::Vector2u theSize, sf3d::CompressedImage::Format theFormat, sf3d::Uint8* theBlocks) :
+        pixels   (thePixels),
+        size     (theSize),
+        format   (theFormat),
+        blocks   (theBlocks),
+        blocksX  ((theSize.x + 3) / 4),
+        blockSize(sf3d::CompressedImage::getBlockSize(theFormat))
+        {
+        }
+
+        virtual void run(std::size_t begin, std::size_t end)
+        {
+            sf3d::Uint8 block[64];
+            for (std::size_t row = begin; row < end; ++row)
+            {
+                for (unsigned int column = 0; column < blocksX; ++column)
+                {
+                    // Gather the 4x4 pixels, repeating the last row/column on the edges
+                    for (unsigned int y = 0; y < 4; ++y)
+                    {
+                        unsigned int sourceY = std::min(static_cast<unsigned int>(row) * 4 + y, size.y - 1);
+                        for (unsigned int x = 0; x < 4; ++x)
+                        {
+                            unsigned int sourceX = std::min(column * 4 + x, size.x - 1);
+                            std::memcpy(&block[(x + y * 4) * 4], &pixels[(sourceX + sourceY * size.x) * 4], 4);
+                        }
+                    }
+
+                    sf3d::Uint8* destination = blocks + (column + row * blocksX) * blockSize;
+                    if (format == sf3d::CompressedImage::Bc1)
+                        sf3d::priv::encodeBc1Block(block, destination);
+                    else
+                        sf3d::priv::encodeBc3Block(block, destination);
+                }
+            }
+        }
+
+        const sf3d::Uint8*            pixels;
+        sf3d::Vector2u                size;
+        sf3d::CompressedImage::Format format;
+        sf3d::Uint8*                  blocks;
+        unsigned int                  blocksX;
+        std::size_t                   blockSize;
+    };
+}
+
+
+namespace sf3d
+{
+////////////////////////////////////////////////////////////
+CompressedImage::CompressedImage() :
+m_format(Bc1),
+m_size  (0, 0),
+m_levels()
+{
+
+}
+
+
+////////////////////////////////////////////////////////////
+bool CompressedImage::compress(const Image& image, Format format, bool generateMipmaps)
+{
+    if ((format != Bc1) && (format != Bc3))
+    {
+        err() << "Failed to compress image (only the BC1 and BC3 formats can be encoded)" << std::endl;
+        return false;
+    }
+
+    Vector2u size = image.getSize();
+    if ((size.x == 0) || (size.y == 0))
+    {
+        err() << "Failed to compress image (image is empty)" << std::endl;
+        return false;
+    }
+
+    m_format = format;
+    m_size = size;
+    m_levels.clear();
+
+    std::vector<Uint8> pixels(image.getPixelsPtr(), image.getPixelsPtr() + size.x * size.y * 4);
+    std::vector<Uint8> mipmap;
+    while (true)
+    {
+        // Compress the current level, one row of blocks per work item
+        m_levels.push_back(std::vector<Uint8>(getLevelSize(size, format)));
+        EncodeTask task(&pixels[0], size, format, &m_levels.back()[0]);
+        priv::parallelFor(task, (size.y + 3) / 4, 4);
+
+        if (!generateMipmaps || ((size.x == 1) && (size.y == 1)))
+            break;
+
+        // Compute the next level
+        Vector2u nextSize(std::max(size.x / 2, 1u), std::max(size.y / 2, 1u));
+        mipmap.resize(nextSize.x * nextSize.y * 4);
+        priv::downsampleBox(&pixels[0], size.x, size.y, &mipmap[0]);
+        pixels.swap(mipmap);
+        size = nextSize;
+    }
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+Image CompressedImage::decompress(unsigned int level) const
+{
+    Image image;
+    if ((level >= m_levels.size()) || (m_format == Etc2Rgb) || (m_format == Etc2Rgba))
+        return image;
+
+    Vector2u size = getSize(level);
+    std::vector<Uint8> pixels(size.x * size.y * 4);
+
+    const Uint8* blocks = &m_levels[level][0];
+    std::size_t blockSize = getBlockSize(m_format);
+    unsigned int blocksX = (size.x + 3) / 4;
+    unsigned int blocksY = (size.y + 3) / 4;
+    Uint8 block[64];
+    for (unsigned int row = 0; row < blocksY; ++row)
+    {
+        for (unsigned int column = 0; column < blocksX; ++column)
+        {
+            const Uint8* source = blocks + (column + row * blocksX) * blockSize;
+            switch (m_format)
+            {
+                case Bc1 : priv::decodeBc1Block(source, block); break;
+                case Bc2 : priv::decodeBc2Block(source, block); break;
+                default :  priv::decodeBc3Block(source, block); break;
+            }
+
+            // Copy the pixels that are inside the image
+            for (unsigned int y = 0; (y < 4) && (row * 4 + y < size.y); ++y)
+            {
+                unsigned int width = std::min(4u, size.x - column * 4);
+                std::memcpy(&pixels[(column * 4 + (row * 4 + y) * size.x) * 4], &block[y * 16], width * 4);
+            }
+        }
+    }
+
+    image.create(size.x, size.y, &pixels[0]);
+    return image;
+}
+
+
+////////////////////////////////////////////////////////////
+bool CompressedImage::loadFromFile(const std::string& filename)
+{
+    std::ifstream file(filename.c_str(), std::ios_base::binary);
+    if (!file)
+    {
+        err() << "Failed to load compressed image \"" << filename << "\". Reason : Unable to open file" << std::endl;
+        return false;
+    }
+
+    std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (data.empty() || !loadFromMemory(&data[0], data.size()))
+    {
+        err() << "Failed to load compressed image \"" << filename << "\"" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool CompressedImage::loadFromMemory(const void* data, std::size_t size)
+{
+    m_size = Vector2u(0, 0);
+    m_levels.clear();
+
+    const Uint8* bytes = static_cast<const Uint8*>(data);
+    if (!bytes || (size < 4))
+    {
+        err() << "Failed to load compressed image from memory, no data provided" << std::endl;
+        return false;
+    }
+
+    std::size_t offset = 0;
+    unsigned int levelCount = 0;
+    if ((size >= 128) && (std::memcmp(bytes, "DDS ", 4) == 0))
+    {
+        // DDS: 4 bytes magic, then a 124 bytes header
+        m_size.x = readUint32(bytes + 16);
+        m_size.y = readUint32(bytes + 12);
+        levelCount = std::max(readUint32(bytes + 28), 1u);
+        offset = 128;
+
+        const Uint8* fourCC = bytes + 84;
+        if (std::memcmp(fourCC, "DXT1", 4) == 0)
+        {
+            m_format = Bc1;
+        }
+        else if (std::memcmp(fourCC, "DXT3", 4) == 0)
+        {
+            m_format = Bc2;
+        }
+        else if (std::memcmp(fourCC, "DXT5", 4) == 0)
+        {
+            m_format = Bc3;
+        }
+        else if ((std::memcmp(fourCC, "DX10", 4) == 0) && (size >= 148))
+        {
+            // Extended header, holding a DXGI format
+            Uint32 dxgiFormat = readUint32(bytes + 128);
+            offset = 148;
+            if ((dxgiFormat == 71) || (dxgiFormat == 72))
+                m_format = Bc1;
+            else if ((dxgiFormat == 74) || (dxgiFormat == 75))
+                m_format = Bc2;
+            else if ((dxgiFormat == 77) || (dxgiFormat == 78))
+                m_format = Bc3;
+            else
+            {
+                err() << "Failed to load compressed image (unsupported DXGI format " << dxgiFormat << ")" << std::endl;
+                m_size = Vector2u(0, 0);
+                return false;
+            }
+        }
+        else
+        {
+            err() << "Failed to load compressed image (unsupported DDS pixel format)" << std::endl;
+            m_size = Vector2u(0, 0);
+            return false;
+        }
+    }
+    else if ((size >= 64) && (std::memcmp(bytes, ktxIdentifier, 12) == 0))
+    {
+        // KTX: identifier, endianness, then 12 header fields
+        Uint32 endianness = readUint32(bytes + 12);
+        if ((endianness != 0x04030201) && (endianness != 0x01020304))
+        {
+            err() << "Failed to load compressed image (invalid KTX endianness)" << std::endl;
+            return false;
+        }
+
+        bool swap = endianness != 0x04030201;
+        Uint32 internalFormat = readUint32(bytes + 28, swap);
+        m_size.x = readUint32(bytes + 36, swap);
+        m_size.y = std::max(readUint32(bytes + 40, swap), 1u);
+        levelCount = std::max(readUint32(bytes + 56, swap), 1u);
+        offset = 64 + std::min<std::size_t>(readUint32(bytes + 60, swap), size - 64);
+
+        if (readUint32(bytes + 44, swap) > 1 || readUint32(bytes + 48, swap) > 1 || readUint32(bytes + 52, swap) > 1)
+        {
+            err() << "Failed to load compressed image (KTX arrays, cube maps and 3D textures are not supported)" << std::endl;
+            m_size = Vector2u(0, 0);
+            return false;
+        }
+
+        switch (internalFormat)
+        {
+            case glCompressedRgbDxt1 :
+            case glCompressedRgbaDxt1 :  m_format = Bc1;      break;
+            case glCompressedRgbaDxt3 :  m_format = Bc2;      break;
+            case glCompressedRgbaDxt5 :  m_format = Bc3;      break;
+            case glCompressedRgb8Etc2 :  m_format = Etc2Rgb;  break;
+            case glCompressedRgba8Etc2 : m_format = Etc2Rgba; break;
+            default :
+            {
+                err() << "Failed to load compressed image (unsupported KTX internal format " << internalFormat << ")" << std::endl;
+                m_size = Vector2u(0, 0);
+                return false;
+            }
+        }
+
+        // Each level is preceded by its size, and padded to 4 bytes
+        Vector2u levelSize = m_size;
+        for (unsigned int i = 0; i < levelCount; ++i)
+        {
+            if (size - offset < 4)
+                break;
+
+            std::size_t dataSize = readUint32(bytes + offset, swap);
+            offset += 4;
+            if ((dataSize > size - offset) || !hasLevelData(levelSize, m_format, dataSize))
+                break;
+
+            m_levels.push_back(std::vector<Uint8>(bytes + offset, bytes + offset + getLevelSize(levelSize, m_format)));
+            offset += std::min((dataSize + 3) & ~static_cast<std::size_t>(3), size - offset);
+            if ((levelSize.x == 1) && (levelSize.y == 1))
+                break;
+            levelSize = Vector2u(std::max(levelSize.x / 2, 1u), std::max(levelSize.y / 2, 1u));
+        }
+        levelCount = 0;
+    }
+    else
+    {
+        err() << "Failed to load compressed image (unknown container, expected DDS or KTX)" << std::endl;
+        return false;
+    }
+
+    // DDS levels are stored back to back
+    Vector2u levelSize = m_size;
+    for (unsigned int i = 0; i < levelCount; ++i)
+    {
+        if (!hasLevelData(levelSize, m_format, size - offset))
+            break;
+
+        std::size_t dataSize = getLevelSize(levelSize, m_format);
+        m_levels.push_back(std::vector<Uint8>(bytes + offset, bytes + offset + dataSize));
+        offset += dataSize;
+        if ((levelSize.x == 1) && (levelSize.y == 1))
+            break;
+        levelSize = Vector2u(std::max(levelSize.x / 2, 1u), std::max(levelSize.y / 2, 1u));
+    }
+
+    if ((m_size.x == 0) || (m_size.y == 0) || m_levels.empty())
+    {
+        err() << "Failed to load compressed image (file is empty or truncated)" << std::endl;
+        m_size = Vector2u(0, 0);
+        m_levels.clear();
+        return false;
+    }
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool CompressedImage::saveToFile(const std::string& filename) const
+{
+    if (m_levels.empty())
+    {
+        err() << "Failed to save compressed image \"" << filename << "\" (image is empty)" << std::endl;
+        return false;
+    }
+
+    std::string extension = filename.size() > 4 ? filename.substr(filename.size() - 4) : "";
+    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+    bool ktx = extension == ".ktx";
+
+    std::vector<Uint8> header;
+    if (ktx)
+    {
+        static const Uint32 internalFormats[] = {glCompressedRgbaDxt1, glCompressedRgbaDxt3, glCompressedRgbaDxt5,
+                                                 glCompressedRgb8Etc2, glCompressedRgba8Etc2};
+        static const Uint32 baseFormats[] = {0x1908, 0x1908, 0x1908, 0x1907, 0x1908}; // GL_RGBA / GL_RGB
+
+        header.assign(ktxIdentifier, ktxIdentifier + 12);
+        writeUint32(header, 0x04030201);
+        writeUint32(header, 0); // glType
+        writeUint32(header, 1); // glTypeSize
+        writeUint32(header, 0); // glFormat
+        writeUint32(header, internalFormats[m_format]);
+        writeUint32(header, baseFormats[m_format]);
+        writeUint32(header, m_size.x);
+        writeUint32(header, m_size.y);
+        writeUint32(header, 0); // depth
+        writeUint32(header, 0); // array elements
+        writeUint32(header, 1); // faces
+        writeUint32(header, static_cast<Uint32>(m_levels.size()));
+        writeUint32(header, 0); // key/value data
+    }
+    else
+    {
+        if ((m_format == Etc2Rgb) || (m_format == Etc2Rgba))
+        {
+            err() << "Failed to save compressed image \"" << filename << "\" (DDS files can't hold ETC2 data, use KTX)" << std::endl;
+            return false;
+        }
+
+        static const char* fourCCs[] = {"DXT1", "DXT3", "DXT5"};
+
+        header.assign(4, 0);
+        std::memcpy(&header[0], "DDS ", 4);
+        writeUint32(header, 124);                                        // size
+        writeUint32(header, 0x1 | 0x2 | 0x4 | 0x1000 | 0x20000 | 0x80000); // caps, height, width, pixel format, mipmap count, linear size
+        writeUint32(header, m_size.y);
+        writeUint32(header, m_size.x);
+        writeUint32(header, static_cast<Uint32>(m_levels[0].size()));
+        writeUint32(header, 0);                                          // depth
+        writeUint32(header, static_cast<Uint32>(m_levels.size()));
+        header.resize(header.size() + 11 * 4, 0);                        // reserved
+        writeUint32(header, 32);                                         // pixel format size
+        writeUint32(header, 0x4);                                        // fourCC flag
+        header.insert(header.end(), fourCCs[m_format], fourCCs[m_format] + 4);
+        header.resize(header.size() + 5 * 4, 0);                         // bit masks
+        writeUint32(header, 0x1000 | 0x8 | 0x400000);                    // texture, complex, mipmap
+        header.resize(128, 0);
+    }
+
+    std::ofstream file(filename.c_str(), std::ios_base::binary);
+    if (!file)
+    {
+        err() << "Failed to save compressed image \"" << filename << "\" (unable to open file)" << std::endl;
+        return false;
+    }
+
+    file.write(reinterpret_cast<const char*>(&header[0]), header.size());
+    for (std::size_t i = 0; i < m_levels.size(); ++i)
+    {
+        if (ktx)
+        {
+            std::vector<Uint8> size;
+            writeUint32(size, static_cast<Uint32>(m_levels[i].size()));
+            file.write(reinterpret_cast<const char*>(&size[0]), size.size());
+        }
+        file.write(reinterpret_cast<const char*>(&m_levels[i][0]), m_levels[i].size());
+    }
+
+    return file.good();
+}
+
+
+////////////////////////////////////////////////////////////
+CompressedImage::Format CompressedImage::getFormat() const
+{
+    return m_format;
+}
+
+
+////////////////////////////////////////////////////////////
+Vector2u CompressedImage::getSize(unsigned int level) const
+{
+    if (level >= m_levels.size())
+        return Vector2u(0, 0);
+
+    return Vector2u(std::max(m_size.x >> level, 1u), std::max(m_size.y >> level, 1u));
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int CompressedImage::getLevelCount() const
+{
+    return static_cast<unsigned int>(m_levels.size());
+}
+
+
+////////////////////////////////////////////////////////////
+const Uint8* CompressedImage::getLevelData(unsigned int level) const
+{
+    return level < m_levels.size() ? &m_levels[level][0] : NULL;
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t CompressedImage::getLevelDataSize(unsigned int level) const
+{
+    return level < m_levels.size() ? m_levels[level].size() : 0;
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t CompressedImage::getBlockSize(Format format)
+{
+    return ((format == Bc1) || (format == Etc2Rgb)) ? 8 : 16;
+}
+
+} // namespace sf3d
@@ -2,6 +2,7 @@
 // Headers
 ////////////////////////////////////////////////////////////
 #include <SFML3D/Graphics/ConvexPolyhedron.hpp>
+#include <algorithm>
 
 
 namespace sf3d
@@ -45,4 +46,11 @@ ConvexPolyhedron::Face ConvexPolyhedron::getFace(unsigned int index) const
     return face;
 }
 
+
+////////////////////////////////////////////////////////////
+void ConvexPolyhedron::getFaces(Vertex* vertices, unsigned int first, unsigned int count) const
+{
+    std::copy(m_vertices.begin() + first * 3, m_vertices.begin() + (first + count) * 3, vertices);
+}
+
 } // namespace sf3d
@@ -38,6 +38,17 @@ unsigned int Cuboid::getFaceCount() const
 
 ////////////////////////////////////////////////////////////
 Polyhedron::Face Cuboid::getFace(unsigned int index) const
+{
+    Vertex vertices[3];
+    getFaces(vertices, index < 12 ? index : 0, 1);
+
+    Face face = {vertices[0], vertices[1], vertices[2]};
+    return face;
+}
+
+
+////////////////////////////////////////////////////////////
+void Cuboid::getFaces(Vertex* vertices, unsigned int first, unsigned int count) const
 {
     float left   = m_size.x / -2.f;
     float top    = m_size.y /  2.f;
@@ -48,34 +59,30 @@ Polyhedron::Face Cuboid::getFace(unsigned int index) const
 
     const Color& color = getColor();
 
-    switch (index)
+    const Vector3f corners[] =
+    {
+        Vector3f(left,  top,    front),
+        Vector3f(left,  bottom, front),
+        Vector3f(right, bottom, front),
+        Vector3f(right, top,    front),
+        Vector3f(right, bottom, back),
+        Vector3f(right, top,    back),
+        Vector3f(left,  bottom, back),
+        Vector3f(left,  top,    back)
+    };
+
+    static const unsigned char indices[] =
     {
-        default:
-        // Front 1
-        case 0:  { Face face = {Vertex(Vector3f(left, top, front), color), Vertex(Vector3f(left, bottom, front), color), Vertex(Vector3f(right, bottom, front), color)}; return face; }
-        // Front 2
-        case 1:  { Face face = {Vertex(Vector3f(left, top, front), color), Vertex(Vector3f(right, bottom, front), color), Vertex(Vector3f(right, top, front), color)}; return face; }
-        // Right 1
-        case 2:  { Face face = {Vertex(Vector3f(right, top, front), color), Vertex(Vector3f(right, bottom, front), color), Vertex(Vector3f(right, bottom, back), color)}; return face; }
-        // Right 2
-        case 3:  { Face face = {Vertex(Vector3f(right, top, front), color), Vertex(Vector3f(right, bottom, back), color), Vertex(Vector3f(right, top, back), color)}; return face; }
-        // Back 1
-        case 4:  { Face face = {Vertex(Vector3f(right, top, back), color), Vertex(Vector3f(right, bottom, back), color), Vertex(Vector3f(left, bottom, back), color)}; return face; }
-        // Back 2
-        case 5:  { Face face = {Vertex(Vector3f(right, top, back), color), Vertex(Vector3f(left, bottom, back), color), Vertex(Vector3f(left, top, back), color)}; return face; }
-        // Left 1
-        case 6:  { Face face = {Vertex(Vector3f(left, top, back), color), Vertex(Vector3f(left, bottom, back), color), Vertex(Vector3f(left, bottom, front), color)}; return face; }
-        // Left 2
-        case 7:  { Face face = {Vertex(Vector3f(left, top, back), color), Vertex(Vector3f(left, bottom, front), color), Vertex(Vector3f(left, top, front), color)}; return face; }
-        // Top 1
-        case 8:  { Face face = {Vertex(Vector3f(left, top, back), color), Vertex(Vector3f(left, top, front), color), Vertex(Vector3f(right, top, front), color)}; return face; }
-        // Top 2
-        case 9:  { Face face = {Vertex(Vector3f(left, top, back), color), Vertex(Vector3f(right, top, front), color), Vertex(Vector3f(right, top, back), color)}; return face; }
-        // Bottom 1
-        case 10: { Face face = {Vertex(Vector3f(left, bottom, front), color), Vertex(Vector3f(left, bottom, back), color), Vertex(Vector3f(right, bottom, back), color)}; return face; }
-        // Bottom 2
-        case 11: { Face face = {Vertex(Vector3f(left, bottom, front), color), Vertex(Vector3f(right, bottom, back), color), Vertex(Vector3f(right, bottom, front), color)}; return face; }
-    }
+        0, 1, 2,  0, 2, 3, // Front
+        3, 2, 4,  3, 4, 5, // Right
+        5, 4, 6,  5, 6, 7, // Back
+        7, 6, 1,  7, 1, 0, // Left
+        7, 0, 3,  7, 3, 5, // Top
+        1, 6, 4,  1, 4, 2  // Bottom
+    };
+
+    for (unsigned int i = 0; i < count * 3; ++i)
+        vertices[i] = Vertex(corners[indices[first * 3 + i]], color);
 }
 
 } // namespace sf3d
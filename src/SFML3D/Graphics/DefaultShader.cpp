@@ -0,0 +1,354 @@
+////////////////////////////////////////////////////////////
+//
+// SFML3D - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2014 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/Graphics/DefaultShader.hpp>
+#include <SFML3D/Graphics/Shader.hpp>
+#include <SFML3D/Graphics/Light.hpp>
+#include <SFML3D/Graphics/ShadowMap.hpp>
+#include <sstream>
+
+
+namespace sf3d
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+std::string getDefaultVertexShaderSource(const std::string& defines)
+{
+    std::stringstream vertexShaderSource;
+    vertexShaderSource << "#version 130\n"
+                       << defines
+                       << "\n"
+                          "// Uniforms\n"
+                          "uniform mat4 sf_ModelMatrix;\n"
+                          "uniform mat4 sf_ViewMatrix;\n"
+                          "uniform mat4 sf_ProjectionMatrix;\n"
+                          "uniform mat4 sf_TextureMatrix;\n"
+                          "uniform int sf_TextureEnabled;\n"
+                          "uniform int sf_LightingEnabled;\n"
+                          "\n"
+                          "// Features, materials define them as constants to strip the unused branches\n"
+                          "#ifndef SF_MATERIAL\n"
+                          "#define SF_TEXTURE_ENABLED (sf_TextureEnabled == 1)\n"
+                          "#define SF_LIGHTING_ENABLED (sf_LightingEnabled > 0)\n"
+                          "#define SF_VERTEX_COLORS true\n"
+                          "#endif\n"
+                          "\n"
+                          "#ifdef SF_SKINNING\n"
+                          "// Skinning data, the bone weights texture stores 2 texels per vertex:\n"
+                          "// bone indices followed by normalized bone weights\n"
+                          "uniform mat4 sf_BoneMatrices[SF_MAX_BONES];\n"
+                          "uniform sampler2D sf_BoneWeights;\n"
+                          "#endif\n"
+                          "\n"
+                          "// Vertex attributes\n"
+                          "in vec3 sf_Vertex;\n"
+                          "in vec4 sf_Color;\n"
+                          "in vec2 sf_MultiTexCoord0;\n"
+                          "in vec3 sf_Normal;\n"
+                          "\n"
+                          "// Vertex shader outputs\n"
+                          "out vec4 sf_FrontColor;\n"
+                          "out vec2 sf_TexCoord0;\n"
+                          "out vec3 sf_FragWorldPosition;\n"
+                          "out vec3 sf_FragNormal;\n"
+                          "\n"
+                          "void main()\n"
+                          "{\n"
+                          "    vec4 position = vec4(sf_Vertex, 1.0);\n"
+                          "    vec3 normal = sf_Normal;\n"
+                          "\n"
+                          "#ifdef SF_SKINNING\n"
+                          "    // Blend the bone matrices affecting this vertex\n"
+                          "    ivec2 texel = ivec2((gl_VertexID % SF_BONE_WEIGHTS_PER_ROW) * 2, gl_VertexID / SF_BONE_WEIGHTS_PER_ROW);\n"
+                          "    ivec4 bones = ivec4(texelFetch(sf_BoneWeights, texel, 0) * 255.0 + 0.5);\n"
+                          "    vec4 weights = texelFetch(sf_BoneWeights, texel + ivec2(1, 0), 0);\n"
+                          "    weights /= max(dot(weights, vec4(1.0)), 0.0001);\n"
+                          "    mat4 skinMatrix = sf_BoneMatrices[bones.x] * weights.x +\n"
+                          "                      sf_BoneMatrices[bones.y] * weights.y +\n"
+                          "                      sf_BoneMatrices[bones.z] * weights.z +\n"
+                          "                      sf_BoneMatrices[bones.w] * weights.w;\n"
+                          "    position = skinMatrix * position;\n"
+                          "    normal = mat3(skinMatrix) * normal;\n"
+                          "#endif\n"
+                          "\n"
+                          "    // Vertex position\n"
+                          "    gl_Position = sf_ProjectionMatrix * sf_ViewMatrix * sf_ModelMatrix * position;\n"
+                          "\n"
+                          "    // Vertex color\n"
+                          "    if (SF_VERTEX_COLORS)\n"
+                          "        sf_FrontColor = sf_Color;\n"
+                          "    else\n"
+                          "        sf_FrontColor = vec4(1.0, 1.0, 1.0, 1.0);\n"
+                          "\n"
+                          "    // Texture data\n"
+                          "    if (SF_TEXTURE_ENABLED)\n"
+                          "        sf_TexCoord0 = (sf_TextureMatrix * vec4(sf_MultiTexCoord0, 0.0, 1.0)).st;\n"
+                          "\n"
+                          "    // Lighting data\n"
+                          "    if (SF_LIGHTING_ENABLED)\n"
+                          "    {\n"
+                          "        sf_FragNormal = normal;\n"
+                          "        sf_FragWorldPosition = vec3(sf_ModelMatrix * position);\n"
+                          "    }\n"
+                          "}\n";
+
+    return vertexShaderSource.str();
+}
+
+
+////////////////////////////////////////////////////////////
+std::string getDefaultFragmentShaderSource(const std::string& defines)
+{
+    std::stringstream fragmentShaderSource;
+    fragmentShaderSource << "#version 130\n";
+
+    if (Shader::isUniformBufferAvailable())
+        fragmentShaderSource << "#extension GL_ARB_uniform_buffer_object : enable\n";
+
+    fragmentShaderSource << defines
+                         << "\n"
+                            "// Light structure\n"
+                            "struct Light\n"
+                            "{\n"
+                            "    vec4 ambientColor;\n"
+                            "    vec4 diffuseColor;\n"
+                            "    vec4 specularColor;\n"
+                            "    vec4 positionDirection;\n"
+                            "    vec4 attenuation;\n"
+                            "};\n"
+                            "\n"
+                            "// Uniforms\n"
+                            "uniform mat4 sf_ModelMatrix;\n"
+                            "uniform mat4 sf_NormalMatrix;\n"
+                            "uniform sampler2D sf_Texture0;\n"
+                            "uniform int sf_TextureEnabled;\n"
+                            "uniform int sf_LightCount;\n"
+                            "uniform int sf_LightingEnabled;\n"
+                            "uniform vec3 sf_ViewerPosition;\n"
+                            "\n"
+                            "// Material parameters\n"
+                            "uniform vec4 sf_MaterialDiffuseColor = vec4(1.0, 1.0, 1.0, 1.0);\n"
+                            "uniform vec4 sf_MaterialSpecularColor = vec4(0.0001, 0.0001, 0.0001, 1.0);\n"
+                            "uniform float sf_MaterialShininess = 1.0;\n"
+                            "uniform float sf_MaterialAlphaThreshold = 0.5;\n"
+                            "\n"
+                            "// Features, materials define them as constants to strip the unused branches\n"
+                            "#ifndef SF_MATERIAL\n"
+                            "#define SF_TEXTURE_ENABLED (sf_TextureEnabled == 1)\n"
+                            "#define SF_LIGHTING_ENABLED (sf_LightingEnabled > 0)\n"
+                            "#endif\n"
+                            "\n";
+
+    if (Shader::isUniformBufferAvailable())
+        fragmentShaderSource << "layout (std140) uniform Lights\n"
+                                "{\n"
+                                "    Light sf_Lights[" << Light::getMaximumLights() << "];\n"
+                                "};\n";
+    else
+        fragmentShaderSource << "uniform Light sf_Lights[" << Light::getMaximumLights() << "];\n";
+
+    // Shadow maps, only declared by the lit shaders compiled while shadow maps exist (SF_SHADOWS),
+    // the attenuation of a light stores the slot of its shadow map in w (-1 if it has none)
+    unsigned int maxShadowMaps = ShadowMap::getMaximumShadowMaps();
+    fragmentShaderSource << "#ifdef SF_SHADOWS\n"
+                            "uniform mat4 sf_ShadowMatrices[" << maxShadowMaps * 6 << "];\n"
+                            "uniform vec4 sf_ShadowInfo[" << maxShadowMaps << "];\n";
+    for (unsigned int i = 0; i < maxShadowMaps; ++i)
+        fragmentShaderSource << "uniform sampler2D sf_ShadowMap" << i << ";\n";
+    fragmentShaderSource << "#endif\n";
+
+    fragmentShaderSource << "\n"
+                            "// Fragment attributes\n"
+                            "in vec4 sf_FrontColor;\n"
+                            "in vec2 sf_TexCoord0;\n"
+                            "in vec3 sf_FragWorldPosition;\n"
+                            "in vec3 sf_FragNormal;\n"
+                            "\n"
+                            "// Fragment shader outputs\n"
+                            "out vec4 sf_FragColor;\n"
+                            "\n"
+                            "#ifdef SF_SHADOWS\n"
+                            "float sampleShadowMap(int slot, vec2 coordinates)\n"
+                            "{\n";
+    for (unsigned int i = 0; i < maxShadowMaps; ++i)
+        fragmentShaderSource << "    if (slot == " << i << ")\n"
+                                "        return texture2D(sf_ShadowMap" << i << ", coordinates).r;\n";
+    fragmentShaderSource << "    return 0.0;\n"
+                            "}\n"
+                            "\n"
+                            "float computeShadow(int slot, vec3 lightPosition)\n"
+                            "{\n"
+                            "    // x: number of cascades (0 for the cube of a point light), y: depth bias, z: size of a texel in a tile\n"
+                            "    vec4 info = sf_ShadowInfo[slot];\n"
+                            "    int cascades = int(info.x + 0.5);\n"
+                            "    vec4 position = vec4(sf_FragWorldPosition, 1.0);\n"
+                            "    vec4 clip;\n"
+                            "    int tile = 0;\n"
+                            "    int columns = 3;\n"
+                            "    int rows = 2;\n"
+                            "\n"
+                            "    if (cascades == 0)\n"
+                            "    {\n"
+                            "        // Point light: use the cube face the fragment is in\n"
+                            "        vec3 ray = sf_FragWorldPosition - lightPosition;\n"
+                            "        vec3 axis = abs(ray);\n"
+                            "        if ((axis.x >= axis.y) && (axis.x >= axis.z))\n"
+                            "            tile = (ray.x > 0.0) ? 0 : 1;\n"
+                            "        else if (axis.y >= axis.z)\n"
+                            "            tile = (ray.y > 0.0) ? 2 : 3;\n"
+                            "        else\n"
+                            "            tile = (ray.z > 0.0) ? 4 : 5;\n"
+                            "        clip = sf_ShadowMatrices[slot * 6 + tile] * position;\n"
+                            "    }\n"
+                            "    else\n"
+                            "    {\n"
+                            "        // Directional light: use the first cascade containing the fragment\n"
+                            "        columns = cascades;\n"
+                            "        rows = 1;\n"
+                            "        for (tile = 0; tile < cascades; ++tile)\n"
+                            "        {\n"
+                            "            clip = sf_ShadowMatrices[slot * 6 + tile] * position;\n"
+                            "            if (all(lessThanEqual(abs(clip.xyz), vec3(clip.w))))\n"
+                            "                break;\n"
+                            "        }\n"
+                            "\n"
+                            "        // Beyond the shadow distance\n"
+                            "        if (tile == cascades)\n"
+                            "            return 1.0;\n"
+                            "    }\n"
+                            "\n"
+                            "    vec3 coordinates = clip.xyz / clip.w;\n"
+                            "    if (abs(coordinates.z) > 1.0)\n"
+                            "        return 1.0;\n"
+                            "\n"
+                            "    // The depth range is reversed, closer fragments have greater depths\n"
+                            "    float depth = (1.0 - coordinates.z) * 0.5 + info.y;\n"
+                            "\n"
+                            "    // Locate the fragment in its tile, and filter 2x2 texels that stay inside it\n"
+                            "    vec2 tileSize = vec2(1.0 / float(columns), 1.0 / float(rows));\n"
+                            "    vec2 tileOrigin = vec2(float(tile % columns), float(tile / columns)) * tileSize;\n"
+                            "    vec2 texel = tileSize * info.z;\n"
+                            "    vec2 center = tileOrigin + (coordinates.xy * 0.5 + 0.5) * tileSize;\n"
+                            "    vec2 low = tileOrigin + texel * 0.5;\n"
+                            "    vec2 high = tileOrigin + tileSize - texel * 0.5;\n"
+                            "\n"
+                            "    float lit = step(sampleShadowMap(slot, clamp(center + vec2(-0.5, -0.5) * texel, low, high)), depth) +\n"
+                            "                step(sampleShadowMap(slot, clamp(center + vec2( 0.5, -0.5) * texel, low, high)), depth) +\n"
+                            "                step(sampleShadowMap(slot, clamp(center + vec2(-0.5,  0.5) * texel, low, high)), depth) +\n"
+                            "                step(sampleShadowMap(slot, clamp(center + vec2( 0.5,  0.5) * texel, low, high)), depth);\n"
+                            "\n"
+                            "    return lit * 0.25;\n"
+                            "}\n"
+                            "#endif\n"
+                            "\n"
+                            "vec4 computeLighting()\n"
+                            "{\n"
+                            "    // Early return in case lighting disabled\n"
+                            "    if (!SF_LIGHTING_ENABLED)\n"
+                            "        return vec4(1.0, 1.0, 1.0, 1.0);\n"
+                            "\n"
+                            "    vec3 fragmentNormal = normalize((sf_NormalMatrix * vec4(sf_FragNormal, 1.0)).xyz);\n"
+                            "    vec3 fragmentDistanceToViewer = normalize(sf_ViewerPosition - sf_FragWorldPosition);"
+                            "\n"
+                            "    vec4 totalIntensity = vec4(0.0, 0.0, 0.0, 0.0);\n"
+                            "\n"
+                            "    for (int index = 0; index < sf_LightCount; ++index)\n"
+                            "    {\n"
+                            "        vec3 rayDirection = normalize(sf_Lights[index].positionDirection.xyz);\n"
+                            "        float attenuationFactor = 1.0;"
+                            "\n"
+                            "        if (sf_Lights[index].positionDirection.w > 0.0)\n"
+                            "        {\n"
+                            "            rayDirection = normalize(sf_FragWorldPosition - sf_Lights[index].positionDirection.xyz);\n"
+                            "            float rayLength = length(sf_Lights[index].positionDirection.xyz - sf_FragWorldPosition);"
+                            "            vec4 attenuationCoefficients = vec4(1.0, rayLength, rayLength * rayLength, 0.0);"
+                            "            attenuationFactor = dot(sf_Lights[index].attenuation, attenuationCoefficients);\n"
+                            "        }\n"
+                            "\n"
+                            "        vec4 ambientIntensity = sf_Lights[index].ambientColor;\n"
+                            "\n"
+                            "        float diffuseCoefficient = max(0.0, dot(fragmentNormal, -rayDirection));\n"
+                            "        vec4 diffuseIntensity = sf_Lights[index].diffuseColor * diffuseCoefficient;\n"
+                            "\n"
+                            "        float specularCoefficient = 0.0;\n"
+                            "        if(diffuseCoefficient > 0.0)"
+                            "            specularCoefficient = pow(max(0.0, dot(fragmentDistanceToViewer, reflect(rayDirection, fragmentNormal))), sf_MaterialShininess);"
+                            "        vec4 specularIntensity = specularCoefficient * sf_MaterialSpecularColor * sf_Lights[index].specularColor;"
+                            "\n"
+                            "        float shadowFactor = 1.0;\n"
+                            "#ifdef SF_SHADOWS\n"
+                            "        if (sf_Lights[index].attenuation.w >= 0.0)\n"
+                            "            shadowFactor = computeShadow(int(sf_Lights[index].attenuation.w + 0.5), sf_Lights[index].positionDirection.xyz);\n"
+                            "#endif\n"
+                            "\n"
+                            "        totalIntensity += ambientIntensity + (diffuseIntensity + specularIntensity) * shadowFactor / attenuationFactor;\n"
+                            "    }\n"
+                            "\n"
+                            "    return vec4(totalIntensity.rgb, 1.0);\n"
+                            "}\n"
+                            "\n"
+                            "vec4 computeTexture()\n"
+                            "{\n"
+                            "    if (!SF_TEXTURE_ENABLED)\n"
+                            "        return vec4(1.0, 1.0, 1.0, 1.0);\n"
+                            "\n"
+                            "#ifdef SF_DISTANCE_FIELD\n"
+                            "    // Turn the distance stored in alpha into an antialiased edge\n"
+                            "    vec4 texel = texture2D(sf_Texture0, sf_TexCoord0);\n"
+                            "    float width = clamp(fwidth(texel.a), 0.0001, 0.5);\n"
+                            "    texel.a = smoothstep(0.5 - width, 0.5 + width, texel.a);\n"
+                            "    return texel;\n"
+                            "#else\n"
+                            "    return texture2D(sf_Texture0, sf_TexCoord0);\n"
+                            "#endif\n"
+                            "}\n"
+                            "\n"
+                            "void main()\n"
+                            "{\n"
+                            "#ifdef SF_DEPTH_ONLY\n"
+                            "    // Only the depth is needed, but transparent texels must not cast shadows\n"
+                            "    if (sf_FrontColor.a * computeTexture().a < 0.5)\n"
+                            "        discard;\n"
+                            "    sf_FragColor = vec4(1.0, 1.0, 1.0, 1.0);\n"
+                            "#else\n"
+                            "    // Fragment color\n"
+                            "    vec4 color = sf_MaterialDiffuseColor * sf_FrontColor * computeTexture();\n"
+                            "#ifdef SF_ALPHA_TEST\n"
+                            "    if (color.a < sf_MaterialAlphaThreshold)\n"
+                            "        discard;\n"
+                            "#endif\n"
+                            "    sf_FragColor = color * computeLighting();\n"
+                            "#endif\n"
+                            "}\n";
+
+    return fragmentShaderSource.str();
+}
+
+} // namespace priv
+
+} // namespace sf3d
@@ -0,0 +1,68 @@
+////////////////////////////////////////////////////////////
+//
+// SFML3D - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2014 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+#ifndef SFML3D_DEFAULTSHADER_HPP
+#define SFML3D_DEFAULTSHADER_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/Config.hpp>
+#include <string>
+
+
+namespace sf3d
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+/// \brief Get the source of the default non-legacy vertex shader
+///
+/// \a defines is inserted right after the version directive,
+/// it is used to select optional features of the shader
+/// (e.g. "#define SF_SKINNING\n").
+///
+/// \param defines Preprocessor definitions to prepend
+///
+/// \return GLSL source of the vertex shader
+///
+////////////////////////////////////////////////////////////
+std::string getDefaultVertexShaderSource(const std::string& defines = "");
+
+////////////////////////////////////////////////////////////
+/// \brief Get the source of the default non-legacy fragment shader
+///
+/// \param defines Preprocessor definitions to prepend
+///
+/// \return GLSL source of the fragment shader
+///
+////////////////////////////////////////////////////////////
+std::string getDefaultFragmentShaderSource(const std::string& defines = "");
+
+} // namespace priv
+
+} // namespace sf3d
+
+
+#endif // SFML3D_DEFAULTSHADER_HPP
@@ -0,0 +1,166 @@
+////////////////////////////////////////////////////////////
+//
+// SFML3D - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2014 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/Graphics/FileMapping.hpp>
+#if defined(SFML3D_SYSTEM_WINDOWS)
+    #include <windows.h>
+#else
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+
+namespace sf3d
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+FileMapping::FileMapping() :
+m_view    (NULL),
+m_viewSize(0),
+m_data    (NULL),
+m_size    (0)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+FileMapping::~FileMapping()
+{
+    close();
+}
+
+
+////////////////////////////////////////////////////////////
+bool FileMapping::open(const std::string& filename, Uint64 offset, std::size_t size)
+{
+    close();
+
+    if (!size)
+        return false;
+
+#if defined(SFML3D_SYSTEM_WINDOWS)
+
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || (static_cast<Uint64>(fileSize.QuadPart) < offset + size))
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+    CloseHandle(file);
+    if (!mapping)
+        return false;
+
+    // Views must start on a multiple of the allocation granularity
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    Uint64 start = offset - offset % info.dwAllocationGranularity;
+    std::size_t viewSize = static_cast<std::size_t>(offset - start) + size;
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_COPY, static_cast<DWORD>(start >> 32), static_cast<DWORD>(start & 0xFFFFFFFF), viewSize);
+    CloseHandle(mapping);
+    if (!view)
+        return false;
+
+#else
+
+    int file = ::open(filename.c_str(), O_RDONLY);
+    if (file < 0)
+        return false;
+
+    struct stat status;
+    if ((fstat(file, &status) != 0) || (static_cast<Uint64>(status.st_size) < offset + size))
+    {
+        ::close(file);
+        return false;
+    }
+
+    // Mappings must start on a page boundary
+    Uint64 pageSize = static_cast<Uint64>(sysconf(_SC_PAGESIZE));
+    Uint64 start = offset - offset % pageSize;
+    std::size_t viewSize = static_cast<std::size_t>(offset - start) + size;
+
+    void* view = mmap(NULL, viewSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, static_cast<off_t>(start));
+    ::close(file);
+    if (view == MAP_FAILED)
+        return false;
+
+#endif
+
+    m_view     = view;
+    m_viewSize = viewSize;
+    m_data     = static_cast<Uint8*>(view) + (offset - start);
+    m_size     = size;
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+void FileMapping::close()
+{
+    if (m_view)
+    {
+#if defined(SFML3D_SYSTEM_WINDOWS)
+        UnmapViewOfFile(m_view);
+#else
+        munmap(m_view, m_viewSize);
+#endif
+    }
+
+    m_view     = NULL;
+    m_viewSize = 0;
+    m_data     = NULL;
+    m_size     = 0;
+}
+
+
+////////////////////////////////////////////////////////////
+Uint8* FileMapping::getData() const
+{
+    return m_data;
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t FileMapping::getSize() const
+{
+    return m_size;
+}
+
+} // namespace priv
+
+} // namespace sf3d
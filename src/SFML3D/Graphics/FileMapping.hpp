@@ -0,0 +1,118 @@
+////////////////////////////////////////////////////////////
+//
+// SFML3D - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2014 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef SFML3D_FILEMAPPING_HPP
+#define SFML3D_FILEMAPPING_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/Config.hpp>
+#include <SFML3D/System/NonCopyable.hpp>
+#include <string>
+#include <cstddef>
+
+
+namespace sf3d
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+/// \brief Copy-on-write view of a part of a file, mapped in memory
+///
+/// The pages of the file are only read from the disk when they
+/// are accessed. The mapped memory can be modified, but the
+/// changes are private: they are never written to the file.
+///
+////////////////////////////////////////////////////////////
+class FileMapping : NonCopyable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    ////////////////////////////////////////////////////////////
+    FileMapping();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    ////////////////////////////////////////////////////////////
+    ~FileMapping();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Map a part of a file
+    ///
+    /// Any previous mapping is closed first.
+    ///
+    /// \param filename Path of the file to map
+    /// \param offset   Offset of the first byte to map
+    /// \param size     Number of bytes to map
+    ///
+    /// \return True if the file was mapped, false if it couldn't be opened or is too small
+    ///
+    ////////////////////////////////////////////////////////////
+    bool open(const std::string& filename, Uint64 offset, std::size_t size);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Unmap the file
+    ///
+    ////////////////////////////////////////////////////////////
+    void close();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the mapped bytes
+    ///
+    /// \return Pointer to the first mapped byte, NULL if nothing is mapped
+    ///
+    ////////////////////////////////////////////////////////////
+    Uint8* getData() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of mapped bytes
+    ///
+    /// \return Size of the mapping
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getSize() const;
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    void*       m_view;     ///< Start of the mapped pages
+    std::size_t m_viewSize; ///< Size of the mapped pages
+    Uint8*      m_data;     ///< First requested byte, inside the mapped pages
+    std::size_t m_size;     ///< Number of requested bytes
+};
+
+} // namespace priv
+
+} // namespace sf3d
+
+
+#endif // SFML3D_FILEMAPPING_HPP
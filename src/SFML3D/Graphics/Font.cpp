@@ -28,14 +28,20 @@
 #include <SFML3D/Graphics/Font.hpp>
 #include <SFML3D/Graphics/GLCheck.hpp>
 #include <SFML3D/System/InputStream.hpp>
+#include <SFML3D/System/Thread.hpp>
+#include <SFML3D/System/Mutex.hpp>
+#include <SFML3D/System/Lock.hpp>
 #include <SFML3D/System/Err.hpp>
 #include <ft2build.h>
 #include FT_FREETYPE_H
 #include FT_GLYPH_H
 #include FT_OUTLINE_H
 #include FT_BITMAP_H
+#include <algorithm>
+#include <set>
 #include <cstdlib>
 #include <cstring>
+#include <cmath>
 
 
 namespace
@@ -57,18 +63,263 @@ namespace
     void close(FT_Stream)
     {
     }
+
+    // FreeType faces are not thread-safe, and are used by the
+    // glyph loading thread as well as by the calling thread
+    sf3d::Mutex faceMutex;
+
+    // Character size distance field glyphs are rasterized at
+    const unsigned int distanceFieldSize = 48;
+
+    // Distance, in pixels at the distance field size, covered by the
+    // distance field on each side of the outline of a glyph
+    const int distanceFieldSpread = 6;
+
+    // 1D squared Euclidean distance transform (Felzenszwalb & Huttenlocher)
+    void distanceTransform(const float* f, float* d, int n, int* v, float* z)
+    {
+        const float infinity = 1e20f;
+        int k = 0;
+        v[0] = 0;
+        z[0] = -infinity;
+        z[1] = infinity;
+
+        for (int q = 1; q < n; ++q)
+        {
+            float s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
+            while (s <= z[k])
+            {
+                --k;
+                s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
+            }
+
+            ++k;
+            v[k] = q;
+            z[k] = s;
+            z[k + 1] = infinity;
+        }
+
+        k = 0;
+        for (int q = 0; q < n; ++q)
+        {
+            while (z[k + 1] < q)
+                ++k;
+
+            d[q] = (q - v[k]) * (q - v[k]) + f[v[k]];
+        }
+    }
+
+    // 2D squared distance from every pixel to the nearest pixel where grid is 0
+    void distanceTransform(std::vector<float>& grid, int width, int height)
+    {
+        int size = std::max(width, height);
+        std::vector<float> f(size);
+        std::vector<float> d(size);
+        std::vector<float> z(size + 1);
+        std::vector<int> v(size);
+
+        // Columns
+        for (int x = 0; x < width; ++x)
+        {
+            for (int y = 0; y < height; ++y)
+                f[y] = grid[y * width + x];
+
+            distanceTransform(&f[0], &d[0], height, &v[0], &z[0]);
+
+            for (int y = 0; y < height; ++y)
+                grid[y * width + x] = d[y];
+        }
+
+        // Rows
+        for (int y = 0; y < height; ++y)
+        {
+            distanceTransform(&grid[y * width], &d[0], width, &v[0], &z[0]);
+            std::copy(d.begin(), d.begin() + width, grid.begin() + y * width);
+        }
+    }
+
+    // Convert the alpha channel of a RGBA glyph bitmap, whose border of
+    // distanceFieldSpread pixels is empty, into a signed distance field
+    void computeDistanceField(std::vector<sf3d::Uint8>& pixels, int width, int height)
+    {
+        const float infinity = 1e20f;
+        std::vector<float> toInside(width * height);
+        std::vector<float> toOutside(width * height);
+
+        for (int i = 0; i < width * height; ++i)
+        {
+            bool inside = pixels[i * 4 + 3] >= 128;
+            toInside[i] = inside ? 0.f : infinity;
+            toOutside[i] = inside ? infinity : 0.f;
+        }
+
+        distanceTransform(toInside, width, height);
+        distanceTransform(toOutside, width, height);
+
+        for (int i = 0; i < width * height; ++i)
+        {
+            // Signed distance to the outline, positive inside, measured from pixel boundaries
+            float distance = (toInside[i] == 0.f) ? std::sqrt(toOutside[i]) - 0.5f : 0.5f - std::sqrt(toInside[i]);
+            float value = 0.5f + distance / (2.f * distanceFieldSpread);
+
+            pixels[i * 4 + 3] = static_cast<sf3d::Uint8>(std::max(0.f, std::min(value, 1.f)) * 255.f + 0.5f);
+        }
+    }
 }
 
 
 namespace sf3d
 {
+////////////////////////////////////////////////////////////
+struct Font::Bitmap
+{
+    Bitmap() : key(0), characterSize(0), distanceField(false) {}
+
+    // Sort the bitmaps by page, then from the tallest to the shortest
+    static bool compare(const Bitmap* left, const Bitmap* right)
+    {
+        if (left->distanceField != right->distanceField)
+            return left->distanceField < right->distanceField;
+        if (left->characterSize != right->characterSize)
+            return left->characterSize < right->characterSize;
+        return left->glyph.textureRect.height > right->glyph.textureRect.height;
+    }
+
+    Uint32             key;           // Code point combined with the bold flag
+    unsigned int       characterSize; // Character size of the glyph's page
+    bool               distanceField; // Does the glyph belong to the distance field pages?
+    Glyph              glyph;         // Metrics; the texture rect only holds the size
+    std::vector<Uint8> pixels;        // RGBA pixels, padding included
+};
+
+
+////////////////////////////////////////////////////////////
+struct Font::Loader
+{
+    struct Request
+    {
+        Uint32       codePoint;
+        unsigned int characterSize;
+        bool         bold;
+        bool         distanceField;
+    };
+
+    typedef std::pair<std::pair<unsigned int, bool>, Uint32> RequestKey;
+
+    Loader(const Font& theFont) :
+    thread  (&Loader::run, this),
+    font    (theFont),
+    working (false),
+    workDone(false)
+    {
+    }
+
+    ~Loader()
+    {
+        thread.wait();
+    }
+
+    static RequestKey makeKey(Uint32 key, unsigned int characterSize, bool distanceField)
+    {
+        return std::make_pair(std::make_pair(characterSize, distanceField), key);
+    }
+
+    // Worker thread: rasterize the active requests
+    void run()
+    {
+        done.resize(active.size());
+        for (std::size_t i = 0; i < active.size(); ++i)
+        {
+            const Request& request = active[i];
+            font.rasterizeGlyph(request.codePoint, request.characterSize, request.bold, request.distanceField, done[i]);
+        }
+
+        Lock lock(mutex);
+        workDone = true;
+    }
+
+    bool isQueued(Uint32 key, unsigned int characterSize, bool distanceField) const
+    {
+        return queued.find(makeKey(key, characterSize, distanceField)) != queued.end();
+    }
+
+    void queue(Uint32 codePoint, unsigned int characterSize, bool bold, bool distanceField)
+    {
+        Uint32 key = ((bold ? 1 : 0) << 31) | codePoint;
+        if (queued.insert(makeKey(key, characterSize, distanceField)).second)
+        {
+            Request request = {codePoint, characterSize, bold, distanceField};
+            pending.push_back(request);
+        }
+    }
+
+    // Hand the pending requests to the worker thread if it's idle
+    void start()
+    {
+        if (!working && !pending.empty())
+        {
+            active.swap(pending);
+            pending.clear();
+            working = true;
+            workDone = false;
+            thread.launch();
+        }
+    }
+
+    // Wait for the worker thread; on success the glyphs are in done
+    bool finish(bool wait)
+    {
+        if (!working)
+            return false;
+
+        if (!wait)
+        {
+            Lock lock(mutex);
+            if (!workDone)
+                return false;
+        }
+
+        thread.wait();
+        working = false;
+
+        for (std::size_t i = 0; i < active.size(); ++i)
+            queued.erase(makeKey(done[i].key, active[i].characterSize, active[i].distanceField));
+        active.clear();
+
+        return true;
+    }
+
+    // Get the glyph drawn while the actual one is being loaded
+    const Glyph& getPlaceholder(unsigned int characterSize)
+    {
+        Glyph& placeholder = placeholders[characterSize];
+        placeholder.advance = characterSize / 2;
+        return placeholder;
+    }
+
+    Thread                          thread;       // Worker thread rasterizing the glyphs
+    Mutex                           mutex;        // Mutex protecting workDone
+    const Font&                     font;         // Font owning the loader
+    std::vector<Request>            pending;      // Requests waiting for the worker thread
+    std::vector<Request>            active;       // Requests processed by the worker thread
+    std::vector<Bitmap>             done;         // Glyphs rasterized by the worker thread
+    std::set<RequestKey>            queued;       // Glyphs either pending or active
+    std::map<unsigned int, Glyph>   placeholders; // Placeholder glyph of each character size
+    bool                            working;      // Whether the worker thread was launched
+    bool                            workDone;     // Whether the worker thread is finished
+};
+
+
 ////////////////////////////////////////////////////////////
 Font::Font() :
-m_library  (NULL),
-m_face     (NULL),
-m_streamRec(NULL),
-m_refCount (NULL),
-m_info     ()
+m_library     (NULL),
+m_face        (NULL),
+m_streamRec   (NULL),
+m_refCount    (NULL),
+m_info        (),
+m_loader      (NULL),
+m_asynchronous(false),
+m_revision    (0)
 {
 
 }
@@ -76,13 +327,17 @@ m_info     ()
 
 ////////////////////////////////////////////////////////////
 Font::Font(const Font& copy) :
-m_library    (copy.m_library),
-m_face       (copy.m_face),
-m_streamRec  (copy.m_streamRec),
-m_refCount   (copy.m_refCount),
-m_info       (copy.m_info),
-m_pages      (copy.m_pages),
-m_pixelBuffer(copy.m_pixelBuffer)
+m_library           (copy.m_library),
+m_face              (copy.m_face),
+m_streamRec         (copy.m_streamRec),
+m_refCount          (copy.m_refCount),
+m_info              (copy.m_info),
+m_pages             (copy.m_pages),
+m_distanceFieldPages(copy.m_distanceFieldPages),
+m_kerning           (copy.m_kerning),
+m_loader            (NULL),
+m_asynchronous      (copy.m_asynchronous),
+m_revision          (0)
 {
     // Note: as FreeType doesn't provide functions for copying/cloning,
     // we must share all the FreeType pointers
@@ -263,25 +518,7 @@ const Font::Info& Font::getInfo() const
 ////////////////////////////////////////////////////////////
 const Glyph& Font::getGlyph(Uint32 codePoint, unsigned int characterSize, bool bold) const
 {
-    // Get the page corresponding to the character size
-    GlyphTable& glyphs = m_pages[characterSize].glyphs;
-
-    // Build the key by combining the code point and the bold flag
-    Uint32 key = ((bold ? 1 : 0) << 31) | codePoint;
-
-    // Search the glyph into the cache
-    GlyphTable::const_iterator it = glyphs.find(key);
-    if (it != glyphs.end())
-    {
-        // Found: just return it
-        return it->second;
-    }
-    else
-    {
-        // Not found: we have to load it
-        Glyph glyph = loadGlyph(codePoint, characterSize, bold);
-        return glyphs.insert(std::make_pair(key, glyph)).first->second;
-    }
+    return findGlyph(codePoint, characterSize, bold, false);
 }
 
 
@@ -294,8 +531,19 @@ int Font::getKerning(Uint32 first, Uint32 second, unsigned int characterSize) co
 
     FT_Face face = static_cast<FT_Face>(m_face);
 
-    if (face && FT_HAS_KERNING(face) && setCurrentSize(characterSize))
+    if (face && FT_HAS_KERNING(face))
     {
+        // Search the pair into the cache
+        KerningTable& table = m_kerning[characterSize];
+        std::pair<Uint32, Uint32> pair(first, second);
+        KerningTable::const_iterator it = table.find(pair);
+        if (it != table.end())
+            return it->second;
+
+        Lock lock(faceMutex);
+        if (!setCurrentSize(characterSize))
+            return 0;
+
         // Convert the characters to indices
         FT_UInt index1 = FT_Get_Char_Index(face, first);
         FT_UInt index2 = FT_Get_Char_Index(face, second);
@@ -305,7 +553,7 @@ int Font::getKerning(Uint32 first, Uint32 second, unsigned int characterSize) co
         FT_Get_Kerning(face, index1, index2, FT_KERNING_DEFAULT, &kerning);
 
         // Return the X advance
-        return kerning.x >> 6;
+        return table[pair] = kerning.x >> 6;
     }
     else
     {
@@ -319,6 +567,7 @@ int Font::getKerning(Uint32 first, Uint32 second, unsigned int characterSize) co
 int Font::getLineSpacing(unsigned int characterSize) const
 {
     FT_Face face = static_cast<FT_Face>(m_face);
+    Lock lock(faceMutex);
 
     if (face && setCurrentSize(characterSize))
     {
@@ -338,18 +587,96 @@ const Texture& Font::getTexture(unsigned int characterSize) const
 }
 
 
+////////////////////////////////////////////////////////////
+const Glyph& Font::getDistanceFieldGlyph(Uint32 codePoint, bool bold) const
+{
+    // All the distance field glyphs live in a single page
+    return findGlyph(codePoint, distanceFieldSize, bold, true);
+}
+
+
+////////////////////////////////////////////////////////////
+const Texture& Font::getDistanceFieldTexture() const
+{
+    return m_distanceFieldPages[distanceFieldSize].texture;
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int Font::getDistanceFieldSize()
+{
+    return distanceFieldSize;
+}
+
+
+////////////////////////////////////////////////////////////
+void Font::preload(const String& characters, unsigned int characterSize, bool bold) const
+{
+    if (!m_face)
+        return;
+
+    if (!m_loader)
+        m_loader = new Loader(*this);
+
+    const GlyphTable& glyphs = m_pages[characterSize].glyphs;
+    for (std::size_t i = 0; i < characters.getSize(); ++i)
+    {
+        Uint32 key = ((bold ? 1 : 0) << 31) | characters[i];
+        if (glyphs.find(key) == glyphs.end())
+            m_loader->queue(characters[i], characterSize, bold, false);
+    }
+
+    m_loader->start();
+}
+
+
+////////////////////////////////////////////////////////////
+void Font::setAsynchronousLoading(bool asynchronous)
+{
+    m_asynchronous = asynchronous;
+}
+
+
+////////////////////////////////////////////////////////////
+bool Font::isAsynchronousLoading() const
+{
+    return m_asynchronous;
+}
+
+
+////////////////////////////////////////////////////////////
+void Font::update() const
+{
+    collectGlyphs(false);
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int Font::getRevision() const
+{
+    return m_revision;
+}
+
+
 ////////////////////////////////////////////////////////////
 Font& Font::operator =(const Font& right)
 {
     Font temp(right);
 
-    std::swap(m_library,     temp.m_library);
-    std::swap(m_face,        temp.m_face);
-    std::swap(m_streamRec,   temp.m_streamRec);
-    std::swap(m_refCount,    temp.m_refCount);
-    std::swap(m_info,        temp.m_info);
-    std::swap(m_pages,       temp.m_pages);
-    std::swap(m_pixelBuffer, temp.m_pixelBuffer);
+    // The worker thread uses our face, stop it before giving the face away
+    delete m_loader;
+    m_loader = NULL;
+
+    std::swap(m_library,            temp.m_library);
+    std::swap(m_face,               temp.m_face);
+    std::swap(m_streamRec,          temp.m_streamRec);
+    std::swap(m_refCount,           temp.m_refCount);
+    std::swap(m_info,               temp.m_info);
+    std::swap(m_pages,              temp.m_pages);
+    std::swap(m_distanceFieldPages, temp.m_distanceFieldPages);
+    std::swap(m_kerning,            temp.m_kerning);
+    std::swap(m_asynchronous,       temp.m_asynchronous);
+    m_revision++;
 
     return *this;
 }
@@ -358,6 +685,10 @@ Font& Font::operator =(const Font& right)
 ////////////////////////////////////////////////////////////
 void Font::cleanup()
 {
+    // Stop the worker thread, it may be using the face
+    delete m_loader;
+    m_loader = NULL;
+
     // Check if we must destroy the FreeType pointers
     if (m_refCount)
     {
@@ -390,199 +721,459 @@ void Font::cleanup()
     m_streamRec = NULL;
     m_refCount  = NULL;
     m_pages.clear();
-    m_pixelBuffer.clear();
+    m_distanceFieldPages.clear();
+    m_kerning.clear();
+    m_revision++;
 }
 
 
 ////////////////////////////////////////////////////////////
-Glyph Font::loadGlyph(Uint32 codePoint, unsigned int characterSize, bool bold) const
+Glyph Font::loadGlyph(Uint32 codePoint, unsigned int characterSize, bool bold, bool distanceField) const
 {
-    // The glyph to return
-    Glyph glyph;
+    // Rasterize the glyph
+    Bitmap bitmap;
+    rasterizeGlyph(codePoint, characterSize, bold, distanceField, bitmap);
 
-    // First, transform our ugly void* to a FT_Face
-    FT_Face face = static_cast<FT_Face>(m_face);
-    if (!face)
-        return glyph;
+    Glyph& glyph = bitmap.glyph;
+    int width  = glyph.textureRect.width;
+    int height = glyph.textureRect.height;
+    if ((width > 0) && (height > 0))
+    {
+        // Get the glyphs page corresponding to the character size
+        Page& page = distanceField ? m_distanceFieldPages[characterSize] : m_pages[characterSize];
 
-    // Set the character size
-    if (!setCurrentSize(characterSize))
-        return glyph;
+        // Find a good position for the new glyph into the texture
+        glyph.textureRect = findGlyphRect(page, width, height);
+
+        // Write the pixels to the texture
+        if ((glyph.textureRect.width == width) && (glyph.textureRect.height == height))
+            page.texture.update(&bitmap.pixels[0], width, height, glyph.textureRect.left, glyph.textureRect.top);
+
+        // Force an OpenGL flush, so that the font's texture will appear updated
+        // in all contexts immediately (solves problems in multi-threaded apps)
+        glCheck(glFlush());
+    }
+
+    // Done :)
+    return glyph;
+}
 
-    // Load the glyph corresponding to the code point
-    if (FT_Load_Char(face, codePoint, FT_LOAD_TARGET_NORMAL | FT_LOAD_FORCE_AUTOHINT) != 0)
-        return glyph;
 
-    // Retrieve the glyph
-    FT_Glyph glyphDesc;
-    if (FT_Get_Glyph(face->glyph, &glyphDesc) != 0)
-        return glyph;
+////////////////////////////////////////////////////////////
+const Glyph& Font::findGlyph(Uint32 codePoint, unsigned int characterSize, bool bold, bool distanceField) const
+{
+    // Get the page corresponding to the character size
+    GlyphTable& glyphs = (distanceField ? m_distanceFieldPages : m_pages)[characterSize].glyphs;
 
-    // Apply bold if necessary -- first technique using outline (highest quality)
-    FT_Pos weight = 1 << 6;
-    bool outline = (glyphDesc->format == FT_GLYPH_FORMAT_OUTLINE);
-    if (bold && outline)
+    // Build the key by combining the code point and the bold flag
+    Uint32 key = ((bold ? 1 : 0) << 31) | codePoint;
+
+    // Search the glyph into the cache
+    GlyphTable::const_iterator it = glyphs.find(key);
+    if (it != glyphs.end())
     {
-        FT_OutlineGlyph outlineGlyph = (FT_OutlineGlyph)glyphDesc;
-        FT_Outline_Embolden(&outlineGlyph->outline, weight);
+        // Found: just return it
+        return it->second;
     }
 
-    // Convert the glyph to a bitmap (i.e. rasterize it)
-    FT_Glyph_To_Bitmap(&glyphDesc, FT_RENDER_MODE_NORMAL, 0, 1);
-    FT_BitmapGlyph bitmapGlyph = (FT_BitmapGlyph)glyphDesc;
-    FT_Bitmap& bitmap = bitmapGlyph->bitmap;
+    if (m_asynchronous && m_face)
+    {
+        // Let the worker thread load it, and use a placeholder meanwhile
+        if (!m_loader)
+            m_loader = new Loader(*this);
 
-    // Apply bold if necessary -- fallback technique using bitmap (lower quality)
-    if (bold && !outline)
+        m_loader->queue(codePoint, characterSize, bold, distanceField);
+        m_loader->start();
+
+        return m_loader->getPlaceholder(characterSize);
+    }
+
+    if (m_loader && m_loader->isQueued(key, characterSize, distanceField))
     {
-        FT_Bitmap_Embolden(static_cast<FT_Library>(m_library), &bitmap, weight, weight);
+        // The worker thread may already be loading it: wait for it
+        collectGlyphs(true);
+
+        it = glyphs.find(key);
+        if (it != glyphs.end())
+            return it->second;
     }
 
-    // Compute the glyph's advance offset
-    glyph.advance = glyphDesc->advance.x >> 16;
-    if (bold)
-        glyph.advance += weight >> 6;
+    // Not found: we have to load it
+    Glyph glyph = loadGlyph(codePoint, characterSize, bold, distanceField);
+    return glyphs.insert(std::make_pair(key, glyph)).first->second;
+}
+
+
+////////////////////////////////////////////////////////////
+void Font::rasterizeGlyph(Uint32 codePoint, unsigned int characterSize, bool bold, bool distanceField, Bitmap& bitmap) const
+{
+    bitmap.key           = ((bold ? 1 : 0) << 31) | codePoint;
+    bitmap.characterSize = characterSize;
+    bitmap.distanceField = distanceField;
+    bitmap.glyph         = Glyph();
+    bitmap.pixels.clear();
+
+    // The glyph to fill
+    Glyph& glyph = bitmap.glyph;
+
+    // Leave a small padding around characters, so that filtering doesn't
+    // pollute them with pixels from neighbours; distance fields need
+    // enough room around the outline to store the distance
+    const int padding = distanceField ? distanceFieldSpread : 1;
+
+    int width  = 0;
+    int height = 0;
 
-    int width  = bitmap.width;
-    int height = bitmap.rows;
-    if ((width > 0) && (height > 0))
     {
-        // Leave a small padding around characters, so that filtering doesn't
-        // pollute them with pixels from neighbours
-        const unsigned int padding = 1;
+        Lock lock(faceMutex);
+
+        // First, transform our ugly void* to a FT_Face
+        FT_Face face = static_cast<FT_Face>(m_face);
+        if (!face)
+            return;
+
+        // Set the character size
+        if (!setCurrentSize(characterSize))
+            return;
+
+        // Load the glyph corresponding to the code point
+        if (FT_Load_Char(face, codePoint, FT_LOAD_TARGET_NORMAL | FT_LOAD_FORCE_AUTOHINT) != 0)
+            return;
+
+        // Retrieve the glyph
+        FT_Glyph glyphDesc;
+        if (FT_Get_Glyph(face->glyph, &glyphDesc) != 0)
+            return;
+
+        // Apply bold if necessary -- first technique using outline (highest quality)
+        FT_Pos weight = 1 << 6;
+        bool outline = (glyphDesc->format == FT_GLYPH_FORMAT_OUTLINE);
+        if (bold && outline)
+        {
+            FT_OutlineGlyph outlineGlyph = (FT_OutlineGlyph)glyphDesc;
+            FT_Outline_Embolden(&outlineGlyph->outline, weight);
+        }
 
-        // Get the glyphs page corresponding to the character size
-        Page& page = m_pages[characterSize];
+        // Convert the glyph to a bitmap (i.e. rasterize it)
+        FT_Glyph_To_Bitmap(&glyphDesc, FT_RENDER_MODE_NORMAL, 0, 1);
+        FT_BitmapGlyph bitmapGlyph = (FT_BitmapGlyph)glyphDesc;
+        FT_Bitmap& ftBitmap = bitmapGlyph->bitmap;
 
-        // Find a good position for the new glyph into the texture
-        glyph.textureRect = findGlyphRect(page, width + 2 * padding, height + 2 * padding);
-
-        // Compute the glyph's bounding box
-        glyph.bounds.left   = bitmapGlyph->left - padding;
-        glyph.bounds.top    = -bitmapGlyph->top - padding;
-        glyph.bounds.width  = width + 2 * padding;
-        glyph.bounds.height = height + 2 * padding;
-
-        // Extract the glyph's pixels from the bitmap
-        m_pixelBuffer.resize(width * height * 4, 255);
-        const Uint8* pixels = bitmap.buffer;
-        if (bitmap.pixel_mode == FT_PIXEL_MODE_MONO)
+        // Apply bold if necessary -- fallback technique using bitmap (lower quality)
+        if (bold && !outline)
         {
-            // Pixels are 1 bit monochrome values
-            for (int y = 0; y < height; ++y)
+            FT_Bitmap_Embolden(static_cast<FT_Library>(m_library), &ftBitmap, weight, weight);
+        }
+
+        // Compute the glyph's advance offset
+        glyph.advance = glyphDesc->advance.x >> 16;
+        if (bold)
+            glyph.advance += weight >> 6;
+
+        width  = ftBitmap.width;
+        height = ftBitmap.rows;
+        if ((width > 0) && (height > 0))
+        {
+            // Compute the glyph's bounding box
+            glyph.bounds.left   = bitmapGlyph->left - padding;
+            glyph.bounds.top    = -bitmapGlyph->top - padding;
+            glyph.bounds.width  = width + 2 * padding;
+            glyph.bounds.height = height + 2 * padding;
+
+            // The texture rect only holds the size until the glyph is placed in a page
+            glyph.textureRect.width  = width + 2 * padding;
+            glyph.textureRect.height = height + 2 * padding;
+
+            // Extract the glyph's pixels from the bitmap, the padding is left transparent
+            int bufferWidth = width + 2 * padding;
+            bitmap.pixels.assign(bufferWidth * (height + 2 * padding) * 4, 255);
+            for (std::size_t i = 3; i < bitmap.pixels.size(); i += 4)
+                bitmap.pixels[i] = 0;
+
+            const Uint8* pixels = ftBitmap.buffer;
+            if (ftBitmap.pixel_mode == FT_PIXEL_MODE_MONO)
             {
-                for (int x = 0; x < width; ++x)
+                // Pixels are 1 bit monochrome values
+                for (int y = 0; y < height; ++y)
                 {
-                    // The color channels remain white, just fill the alpha channel
-                    std::size_t index = (x + y * width) * 4 + 3;
-                    m_pixelBuffer[index] = ((pixels[x / 8]) & (1 << (7 - (x % 8)))) ? 255 : 0;
+                    for (int x = 0; x < width; ++x)
+                    {
+                        // The color channels remain white, just fill the alpha channel
+                        std::size_t index = (x + padding + (y + padding) * bufferWidth) * 4 + 3;
+                        bitmap.pixels[index] = ((pixels[x / 8]) & (1 << (7 - (x % 8)))) ? 255 : 0;
+                    }
+                    pixels += ftBitmap.pitch;
+                }
+            }
+            else
+            {
+                // Pixels are 8 bits gray levels
+                for (int y = 0; y < height; ++y)
+                {
+                    for (int x = 0; x < width; ++x)
+                    {
+                        // The color channels remain white, just fill the alpha channel
+                        std::size_t index = (x + padding + (y + padding) * bufferWidth) * 4 + 3;
+                        bitmap.pixels[index] = pixels[x];
+                    }
+                    pixels += ftBitmap.pitch;
                 }
-                pixels += bitmap.pitch;
             }
         }
-        else
+
+        // Delete the FT glyph
+        FT_Done_Glyph(glyphDesc);
+    }
+
+    // The distance field doesn't need the face anymore
+    if (distanceField && !bitmap.pixels.empty())
+        computeDistanceField(bitmap.pixels, width + 2 * padding, height + 2 * padding);
+}
+
+
+////////////////////////////////////////////////////////////
+void Font::commitGlyphs(std::vector<Bitmap>& bitmaps) const
+{
+    // Sort the glyphs by page and height, so that the shelves waste little space
+    std::vector<Bitmap*> sorted;
+    sorted.reserve(bitmaps.size());
+    for (std::size_t i = 0; i < bitmaps.size(); ++i)
+        sorted.push_back(&bitmaps[i]);
+    std::sort(sorted.begin(), sorted.end(), &Bitmap::compare);
+
+    std::vector<Uint8> staging;
+    std::size_t first = 0;
+    while (first < sorted.size())
+    {
+        Bitmap& head = *sorted[first];
+        Page& page = head.distanceField ? m_distanceFieldPages[head.characterSize] : m_pages[head.characterSize];
+
+        // Fill a shelf with the next glyphs of the same page, as wide as the texture
+        unsigned int shelfWidth = 0;
+        unsigned int shelfHeight = 0;
+        std::size_t last = first;
+        for (; last < sorted.size(); ++last)
         {
-            // Pixels are 8 bits gray levels
-            for (int y = 0; y < height; ++y)
+            Bitmap& bitmap = *sorted[last];
+            if ((bitmap.distanceField != head.distanceField) || (bitmap.characterSize != head.characterSize))
+                break;
+
+            // Skip the glyphs loaded meanwhile, and the empty ones
+            if (page.glyphs.find(bitmap.key) != page.glyphs.end())
+                continue;
+            if (bitmap.pixels.empty())
+                continue;
+
+            unsigned int width = bitmap.glyph.textureRect.width;
+            if ((shelfWidth > 0) && (shelfWidth + width > page.texture.getSize().x))
+                break;
+
+            bitmap.glyph.textureRect.left = shelfWidth;
+            shelfWidth += width;
+            shelfHeight = std::max<unsigned int>(shelfHeight, bitmap.glyph.textureRect.height);
+        }
+
+        // Copy the glyphs to the staging buffer, and upload the whole shelf at once
+        IntRect shelf;
+        if (shelfWidth > 0)
+        {
+            staging.assign(shelfWidth * shelfHeight * 4, 255);
+            for (std::size_t i = 3; i < staging.size(); i += 4)
+                staging[i] = 0;
+
+            for (std::size_t i = first; i < last; ++i)
+            {
+                const Bitmap& bitmap = *sorted[i];
+                if (bitmap.pixels.empty() || (page.glyphs.find(bitmap.key) != page.glyphs.end()))
+                    continue;
+
+                const IntRect& rect = bitmap.glyph.textureRect;
+                for (int y = 0; y < rect.height; ++y)
+                    std::memcpy(&staging[(y * shelfWidth + rect.left) * 4], &bitmap.pixels[y * rect.width * 4], rect.width * 4);
+            }
+
+            shelf = findGlyphRect(page, shelfWidth, shelfHeight);
+            if ((shelf.width == static_cast<int>(shelfWidth)) && (shelf.height == static_cast<int>(shelfHeight)))
+                page.texture.update(&staging[0], shelfWidth, shelfHeight, shelf.left, shelf.top);
+        }
+
+        // Add the glyphs to the page
+        for (std::size_t i = first; i < last; ++i)
+        {
+            Bitmap& bitmap = *sorted[i];
+            if (page.glyphs.find(bitmap.key) != page.glyphs.end())
+                continue;
+
+            if (!bitmap.pixels.empty())
             {
-                for (int x = 0; x < width; ++x)
+                if (shelf.width == static_cast<int>(shelfWidth))
                 {
-                    // The color channels remain white, just fill the alpha channel
-                    std::size_t index = (x + y * width) * 4 + 3;
-                    m_pixelBuffer[index] = pixels[x];
+                    bitmap.glyph.textureRect.left += shelf.left;
+                    bitmap.glyph.textureRect.top = shelf.top;
+                }
+                else
+                {
+                    // The shelf didn't fit in the texture
+                    bitmap.glyph.textureRect = shelf;
                 }
-                pixels += bitmap.pitch;
             }
+
+            page.glyphs.insert(std::make_pair(bitmap.key, bitmap.glyph));
         }
 
-        // Write the pixels to the texture
-        unsigned int x = glyph.textureRect.left + padding;
-        unsigned int y = glyph.textureRect.top + padding;
-        unsigned int w = glyph.textureRect.width - 2 * padding;
-        unsigned int h = glyph.textureRect.height - 2 * padding;
-        page.texture.update(&m_pixelBuffer[0], w, h, x, y);
+        first = last;
     }
 
-    // Delete the FT glyph
-    FT_Done_Glyph(glyphDesc);
-
     // Force an OpenGL flush, so that the font's texture will appear updated
     // in all contexts immediately (solves problems in multi-threaded apps)
     glCheck(glFlush());
-
-    // Done :)
-    return glyph;
 }
 
 
 ////////////////////////////////////////////////////////////
-IntRect Font::findGlyphRect(Page& page, unsigned int width, unsigned int height) const
+void Font::collectGlyphs(bool wait) const
 {
-    // Find the line that fits well the glyph
-    Row* row = NULL;
-    float bestRatio = 0;
-    for (std::vector<Row>::iterator it = page.rows.begin(); it != page.rows.end() && !row; ++it)
-    {
-        float ratio = static_cast<float>(height) / it->height;
+    if (!m_loader || !m_loader->finish(wait))
+        return;
 
-        // Ignore rows that are either too small or too high
-        if ((ratio < 0.7f) || (ratio > 1.f))
-            continue;
+    if (!m_loader->done.empty())
+    {
+        commitGlyphs(m_loader->done);
+        m_loader->done.clear();
+        m_revision++;
+    }
 
-        // Check if there's enough horizontal space left in the row
-        if (width > page.texture.getSize().x - it->width)
-            continue;
+    // Start the glyphs queued meanwhile
+    m_loader->start();
+}
 
-        // Make sure that this new row is the best found so far
-        if (ratio < bestRatio)
-            continue;
 
-        // The current row passed all the tests: we can select it
-        row = &*it;
-        bestRatio = ratio;
-    }
-
-    // If we didn't find a matching row, create a new one (10% taller than the glyph)
-    if (!row)
+////////////////////////////////////////////////////////////
+IntRect Font::findGlyphRect(Page& page, unsigned int width, unsigned int height) const
+{
+    // Bottom-left skyline packing: place the glyph where its bottom edge is
+    // the lowest, preferring the narrowest segment to limit wasted space
+    std::size_t best = 0;
+    unsigned int bestY = 0;
+    unsigned int bestBottom = 0;
+    unsigned int bestWidth = 0;
+    bool found = false;
+
+    while (!found)
     {
-        int rowHeight = height + height / 10;
-        while (page.nextRow + rowHeight >= page.texture.getSize().y)
+        unsigned int textureWidth  = page.texture.getSize().x;
+        unsigned int textureHeight = page.texture.getSize().y;
+
+        for (std::size_t i = 0; i < page.skyline.size(); ++i)
         {
-            // Not enough space: resize the texture if possible
-            unsigned int textureWidth  = page.texture.getSize().x;
-            unsigned int textureHeight = page.texture.getSize().y;
-            if ((textureWidth * 2 <= Texture::getMaximumSize()) && (textureHeight * 2 <= Texture::getMaximumSize()))
+            const SkylineNode& node = page.skyline[i];
+            if (node.x + width > textureWidth)
+                break;
+
+            // The glyph rests on the highest segment it spans
+            unsigned int y = 0;
+            unsigned int remaining = width;
+            for (std::size_t j = i; remaining > 0; ++j)
             {
-                // Make the texture 2 times bigger
-                Image newImage;
-                newImage.create(textureWidth * 2, textureHeight * 2, Color(255, 255, 255, 0));
-                newImage.copy(page.texture.copyToImage(), 0, 0);
-                page.texture.loadFromImage(newImage);
+                y = std::max(y, page.skyline[j].y);
+                remaining -= std::min(remaining, page.skyline[j].width);
             }
-            else
+
+            if (y + height > textureHeight)
+                continue;
+
+            unsigned int bottom = y + height;
+            if (!found || (bottom < bestBottom) || ((bottom == bestBottom) && (node.width < bestWidth)))
             {
-                // Oops, we've reached the maximum texture size...
-                err() << "Failed to add a new character to the font: the maximum texture size has been reached" << std::endl;
-                return IntRect(0, 0, 2, 2);
+                best = i;
+                bestY = y;
+                bestBottom = bottom;
+                bestWidth = node.width;
+                found = true;
             }
         }
 
-        // We can now create the new row
-        page.rows.push_back(Row(page.nextRow, rowHeight));
-        page.nextRow += rowHeight;
-        row = &page.rows.back();
+        // Not enough space: grow the texture if possible
+        if (!found && !growPage(page))
+        {
+            // Oops, we've reached the maximum texture size...
+            err() << "Failed to add a new character to the font: the maximum texture size has been reached" << std::endl;
+            return IntRect(0, 0, 2, 2);
+        }
     }
 
-    // Find the glyph's rectangle on the selected row
-    IntRect rect(row->width, row->top, width, height);
+    IntRect rect(page.skyline[best].x, bestY, width, height);
+
+    // Insert the top of the glyph into the skyline
+    page.skyline.insert(page.skyline.begin() + best, SkylineNode(rect.left, bestY + height, width));
 
-    // Update the row informations
-    row->width += width;
+    // Shrink or remove the segments now hidden by the glyph
+    unsigned int right = rect.left + width;
+    std::size_t next = best + 1;
+    while ((next < page.skyline.size()) && (page.skyline[next].x < right))
+    {
+        SkylineNode& node = page.skyline[next];
+        if (node.x + node.width <= right)
+        {
+            page.skyline.erase(page.skyline.begin() + next);
+        }
+        else
+        {
+            node.width -= right - node.x;
+            node.x = right;
+            break;
+        }
+    }
+
+    // Merge the neighbour segments that have the same height
+    for (std::size_t i = 0; i + 1 < page.skyline.size();)
+    {
+        if (page.skyline[i].y == page.skyline[i + 1].y)
+        {
+            page.skyline[i].width += page.skyline[i + 1].width;
+            page.skyline.erase(page.skyline.begin() + i + 1);
+        }
+        else
+        {
+            ++i;
+        }
+    }
 
     return rect;
 }
 
 
+////////////////////////////////////////////////////////////
+bool Font::growPage(Page& page) const
+{
+    unsigned int textureWidth  = page.texture.getSize().x;
+    unsigned int textureHeight = page.texture.getSize().y;
+    if ((textureWidth * 2 > Texture::getMaximumSize()) || (textureHeight * 2 > Texture::getMaximumSize()))
+        return false;
+
+    // Make the texture 2 times bigger
+    Texture texture;
+    if (!texture.create(textureWidth * 2, textureHeight * 2))
+        return false;
+    texture.setSmooth(page.texture.isSmooth());
+
+    // Clear the new area to transparent white, it is the only part uploaded
+    // from system memory; the existing glyphs are copied on the graphics card
+    std::vector<Uint8> pixels(textureWidth * textureHeight * 2 * 4, 255);
+    for (std::size_t i = 3; i < pixels.size(); i += 4)
+        pixels[i] = 0;
+    texture.update(&pixels[0], textureWidth, textureHeight * 2, textureWidth, 0);
+    texture.update(&pixels[0], textureWidth, textureHeight, 0, textureHeight);
+    texture.update(page.texture);
+    page.texture.swap(texture);
+
+    // The new columns are empty down to the top of the texture
+    page.skyline.push_back(SkylineNode(textureWidth, 0, textureWidth));
+
+    return true;
+}
+
+
 ////////////////////////////////////////////////////////////
 bool Font::setCurrentSize(unsigned int characterSize) const
 {
@@ -604,8 +1195,7 @@ bool Font::setCurrentSize(unsigned int characterSize) const
 
 
 ////////////////////////////////////////////////////////////
-Font::Page::Page() :
-nextRow(3)
+Font::Page::Page()
 {
     // Make sure that the texture is initialized by default
     sf3d::Image image;
@@ -619,6 +1209,10 @@ nextRow(3)
     // Create the texture
     texture.loadFromImage(image);
     texture.setSmooth(true);
+
+    // The skyline starts above the square and its padding
+    skyline.push_back(SkylineNode(0, 3, 3));
+    skyline.push_back(SkylineNode(3, 0, image.getSize().x - 3));
 }
 
 } // namespace sf3d
@@ -27,11 +27,38 @@
 ////////////////////////////////////////////////////////////
 #include <SFML3D/Graphics/Image.hpp>
 #include <SFML3D/Graphics/ImageLoader.hpp>
+#include <SFML3D/Graphics/ImageKernels.hpp>
+#include <SFML3D/Graphics/Parallel.hpp>
 #include <SFML3D/System/Err.hpp>
 #include <algorithm>
 #include <cstring>
 
 
+namespace
+{
+    // Decode a range of image files
+    struct LoadTask : sf3d::priv::ParallelTask
+    {
+        LoadTask(const std::vector<std::string>& theFilenames, std::vector<sf3d::Image>& theImages) :
+        filenames(theFilenames),
+        images   (theImages),
+        results  (theFilenames.size(), 0)
+        {
+        }
+
+        virtual void run(std::size_t begin, std::size_t end)
+        {
+            for (std::size_t i = begin; i < end; ++i)
+                results[i] = images[i].loadFromFile(filenames[i]) ? 1 : 0;
+        }
+
+        const std::vector<std::string>& filenames;
+        std::vector<sf3d::Image>&       images;
+        std::vector<char>               results;
+    };
+}
+
+
 namespace sf3d
 {
 ////////////////////////////////////////////////////////////
@@ -106,6 +133,23 @@ bool Image::loadFromFile(const std::string& filename)
 }
 
 
+////////////////////////////////////////////////////////////
+std::size_t Image::loadMany(const std::vector<std::string>& filenames, std::vector<Image>& images, unsigned int threadCount)
+{
+    images.clear();
+    images.resize(filenames.size());
+
+    // Make sure the loader exists before the threads use it
+    priv::ImageLoader::getInstance();
+
+    // Each thread decodes whole files, one at a time
+    LoadTask task(filenames, images);
+    priv::parallelFor(task, filenames.size(), 1, threadCount);
+
+    return static_cast<std::size_t>(std::count(task.results.begin(), task.results.end(), 1));
+}
+
+
 ////////////////////////////////////////////////////////////
 bool Image::loadFromMemory(const void* data, std::size_t size)
 {
@@ -141,14 +185,8 @@ void Image::createMaskFromColor(const Color& color, Uint8 alpha)
     if (!m_pixels.empty())
     {
         // Replace the alpha of the pixels that match the transparent color
-        Uint8* ptr = &m_pixels[0];
-        Uint8* end = ptr + m_pixels.size();
-        while (ptr < end)
-        {
-            if ((ptr[0] == color.r) && (ptr[1] == color.g) && (ptr[2] == color.b) && (ptr[3] == color.a))
-                ptr[3] = alpha;
-            ptr += 4;
-        }
+        const Uint8 key[4] = {color.r, color.g, color.b, color.a};
+        priv::maskColor(&m_pixels[0], m_pixels.size() / 4, key, alpha);
     }
 }
 
@@ -198,23 +236,10 @@ void Image::copy(const Image& source, unsigned int destX, unsigned int destY, co
     // Copy the pixels
     if (applyAlpha)
     {
-        // Interpolation using alpha values, pixel by pixel (slower)
+        // Interpolation using alpha values, row by row (slower)
         for (int i = 0; i < rows; ++i)
         {
-            for (int j = 0; j < width; ++j)
-            {
-                // Get a direct pointer to the components of the current pixel
-                const Uint8* src = srcPixels + j * 4;
-                Uint8*       dst = dstPixels + j * 4;
-
-                // Interpolate RGBA components using the alpha value of the source pixel
-                Uint8 alpha = src[3];
-                dst[0] = (src[0] * alpha + dst[0] * (255 - alpha)) / 255;
-                dst[1] = (src[1] * alpha + dst[1] * (255 - alpha)) / 255;
-                dst[2] = (src[2] * alpha + dst[2] * (255 - alpha)) / 255;
-                dst[3] = alpha + dst[3] * (255 - alpha) / 255;
-            }
-
+            priv::blendPixels(srcPixels, dstPixels, width);
             srcPixels += srcStride;
             dstPixels += dstStride;
         }
@@ -274,18 +299,7 @@ void Image::flipHorizontally()
         std::size_t rowSize = m_size.x * 4;
 
         for (std::size_t y = 0; y < m_size.y; ++y)
-        {
-            std::vector<Uint8>::iterator left = m_pixels.begin() + y * rowSize;
-            std::vector<Uint8>::iterator right = m_pixels.begin() + (y + 1) * rowSize - 4;
-
-            for (std::size_t x = 0; x < m_size.x / 2; ++x)
-            {
-                std::swap_ranges(left, left + 4, right);
-
-                left += 4;
-                right -= 4;
-            }
-        }
+            priv::reversePixels(&m_pixels[y * rowSize], m_size.x);
     }
 }
 
@@ -297,12 +311,12 @@ void Image::flipVertically()
     {
         std::size_t rowSize = m_size.x * 4;
 
-        std::vector<Uint8>::iterator top = m_pixels.begin();
-        std::vector<Uint8>::iterator bottom = m_pixels.end() - rowSize;
+        Uint8* top = &m_pixels[0];
+        Uint8* bottom = &m_pixels[0] + m_pixels.size() - rowSize;
 
         for (std::size_t y = 0; y < m_size.y / 2; ++y)
         {
-            std::swap_ranges(top, top + rowSize, bottom);
+            priv::swapPixels(top, bottom, m_size.x);
 
             top += rowSize;
             bottom -= rowSize;
@@ -310,4 +324,64 @@ void Image::flipVertically()
     }
 }
 
+
+////////////////////////////////////////////////////////////
+void Image::premultiplyAlpha()
+{
+    if (!m_pixels.empty())
+        priv::premultiplyAlpha(&m_pixels[0], m_pixels.size() / 4);
+}
+
+
+////////////////////////////////////////////////////////////
+void Image::resize(unsigned int width, unsigned int height, ResizeFilter filter)
+{
+    if (m_pixels.empty() || !width || !height)
+    {
+        // Resizing to or from nothing gives an empty image
+        m_size = Vector2u(0, 0);
+        m_pixels.clear();
+        return;
+    }
+
+    if ((width == m_size.x) && (height == m_size.y))
+        return;
+
+    std::vector<Uint8> pixels(width * height * 4);
+    if (filter == Box)
+        priv::resizeBox(&m_pixels[0], m_size.x, m_size.y, &pixels[0], width, height);
+    else
+        priv::resizeBilinear(&m_pixels[0], m_size.x, m_size.y, &pixels[0], width, height);
+
+    m_size = Vector2u(width, height);
+    m_pixels.swap(pixels);
+}
+
+
+////////////////////////////////////////////////////////////
+void Image::createMipmaps(std::vector<Image>& levels) const
+{
+    levels.clear();
+
+    // Reserve all the levels up front, so that they don't move while the chain is built
+    std::size_t count = 0;
+    for (unsigned int size = std::max(m_size.x, m_size.y); size > 1; size /= 2)
+        ++count;
+    levels.reserve(count);
+
+    const Image* previous = this;
+    while ((previous->m_size.x > 1) || (previous->m_size.y > 1))
+    {
+        Vector2u size(std::max(previous->m_size.x / 2, 1u), std::max(previous->m_size.y / 2, 1u));
+
+        levels.push_back(Image());
+        Image& level = levels.back();
+        level.m_size = size;
+        level.m_pixels.resize(size.x * size.y * 4);
+        priv::downsampleBox(&previous->m_pixels[0], previous->m_size.x, previous->m_size.y, &level.m_pixels[0]);
+
+        previous = &level;
+    }
+}
+
 } // namespace sf3d
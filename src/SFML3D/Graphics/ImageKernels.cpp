@@ -0,0 +1,584 @@
+////////////////////////////////////////////////////////////
+//
+// SFML3D - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2014 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/Graphics/ImageKernels.hpp>
+#include <SFML3D/Graphics/Simd.hpp>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+
+namespace
+{
+    // Whether the kernels use their SIMD paths, see setSimdEnabled
+    bool simdEnabled = true;
+
+    // Blend one pixel over another, see blendPixels
+    inline void blendPixel(const sf3d::Uint8* source, sf3d::Uint8* destination)
+    {
+        unsigned int alpha = source[3];
+        unsigned int inverse = 255 - alpha;
+        destination[0] = static_cast<sf3d::Uint8>((source[0] * alpha + destination[0] * inverse) / 255);
+        destination[1] = static_cast<sf3d::Uint8>((source[1] * alpha + destination[1] * inverse) / 255);
+        destination[2] = static_cast<sf3d::Uint8>((source[2] * alpha + destination[2] * inverse) / 255);
+        destination[3] = static_cast<sf3d::Uint8>(alpha + destination[3] * inverse / 255);
+    }
+
+    // Multiply the color of one pixel by its alpha, see premultiplyAlpha
+    inline void premultiplyPixel(sf3d::Uint8* pixel)
+    {
+        unsigned int alpha = pixel[3];
+        pixel[0] = static_cast<sf3d::Uint8>((pixel[0] * alpha + 127) / 255);
+        pixel[1] = static_cast<sf3d::Uint8>((pixel[1] * alpha + 127) / 255);
+        pixel[2] = static_cast<sf3d::Uint8>((pixel[2] * alpha + 127) / 255);
+    }
+
+#if defined(SFML3D_SIMD_SSE2)
+
+    // Load a single pixel in the low 32 bits of a register
+    inline __m128i loadPixel(const sf3d::Uint8* pixel)
+    {
+        int value;
+        std::memcpy(&value, pixel, 4);
+        return _mm_cvtsi32_si128(value);
+    }
+
+#endif
+
+    // Source coordinate and weight of a destination column or row, for bilinear filtering
+    struct BilinearTap
+    {
+        unsigned int first;  // First source pixel
+        unsigned int second; // Second source pixel
+        unsigned int weight; // Weight of the second pixel, in range [0, 256)
+    };
+
+    // Compute the bilinear taps of every destination column or row
+    void computeBilinearTaps(unsigned int sourceSize, unsigned int destinationSize, std::vector<BilinearTap>& taps)
+    {
+        taps.resize(destinationSize);
+        for (unsigned int i = 0; i < destinationSize; ++i)
+        {
+            // Align the pixel centers, in 24.8 fixed point
+            sf3d::Int64 position = (static_cast<sf3d::Int64>(2 * i + 1) * sourceSize * 256) / (2 * destinationSize) - 128;
+            if (position < 0)
+                position = 0;
+
+            taps[i].first = std::min(static_cast<unsigned int>(position >> 8), sourceSize - 1);
+            taps[i].second = std::min(taps[i].first + 1, sourceSize - 1);
+            taps[i].weight = static_cast<unsigned int>(position & 255);
+        }
+    }
+
+    // Compute the range of source pixels averaged by every destination column or row
+    void computeBoxRanges(unsigned int sourceSize, unsigned int destinationSize, std::vector<unsigned int>& begins, std::vector<unsigned int>& ends)
+    {
+        begins.resize(destinationSize);
+        ends.resize(destinationSize);
+        for (unsigned int i = 0; i < destinationSize; ++i)
+        {
+            // Source pixels whose center is in [i, i + 1) in destination coordinates
+            sf3d::Int64 scale = 2 * static_cast<sf3d::Int64>(destinationSize);
+            sf3d::Int64 low = 2 * static_cast<sf3d::Int64>(i) * sourceSize - destinationSize;
+            sf3d::Int64 high = 2 * static_cast<sf3d::Int64>(i + 1) * sourceSize - destinationSize;
+            unsigned int begin = low <= 0 ? 0 : static_cast<unsigned int>((low + scale - 1) / scale);
+            unsigned int end = high <= 0 ? 0 : static_cast<unsigned int>((high + scale - 1) / scale);
+            end = std::min(end, sourceSize);
+
+            // Magnification: no center inside, take the nearest pixel
+            if (end <= begin)
+            {
+                begin = std::min(static_cast<unsigned int>((static_cast<sf3d::Int64>(2 * i + 1) * sourceSize) / scale), sourceSize - 1);
+                end = begin + 1;
+            }
+
+            begins[i] = begin;
+            ends[i] = end;
+        }
+    }
+
+    // Interpolate one pixel between 4 source pixels, see resizeBilinear
+    void interpolatePixel(const sf3d::Uint8* row0, const sf3d::Uint8* row1, const BilinearTap& column, unsigned int weightY, sf3d::Uint8* output)
+    {
+#if defined(SFML3D_SIMD_SSE2)
+
+        if (simdEnabled)
+        {
+            // Lanes 0-3 hold the first pixel, lanes 4-7 the second one
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i round = _mm_set1_epi16(128);
+            __m128i weightsX = _mm_set_epi16(static_cast<short>(column.weight), static_cast<short>(column.weight),
+                                             static_cast<short>(column.weight), static_cast<short>(column.weight),
+                                             static_cast<short>(256 - column.weight), static_cast<short>(256 - column.weight),
+                                             static_cast<short>(256 - column.weight), static_cast<short>(256 - column.weight));
+            __m128i top = _mm_unpacklo_epi8(_mm_unpacklo_epi32(loadPixel(row0 + column.first * 4),
+                                                               loadPixel(row0 + column.second * 4)), zero);
+            __m128i bottom = _mm_unpacklo_epi8(_mm_unpacklo_epi32(loadPixel(row1 + column.first * 4),
+                                                                  loadPixel(row1 + column.second * 4)), zero);
+
+            // Horizontal interpolation, rounded to 8 bits
+            top = _mm_mullo_epi16(top, weightsX);
+            bottom = _mm_mullo_epi16(bottom, weightsX);
+            top = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(top, _mm_srli_si128(top, 8)), round), 8);
+            bottom = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(bottom, _mm_srli_si128(bottom, 8)), round), 8);
+
+            // Vertical interpolation
+            __m128i value = _mm_add_epi16(_mm_mullo_epi16(top, _mm_set1_epi16(static_cast<short>(256 - weightY))),
+                                          _mm_mullo_epi16(bottom, _mm_set1_epi16(static_cast<short>(weightY))));
+            value = _mm_srli_epi16(_mm_add_epi16(value, round), 8);
+            int pixel = _mm_cvtsi128_si32(_mm_packus_epi16(value, zero));
+            std::memcpy(output, &pixel, 4);
+            return;
+        }
+
+#endif
+
+        const sf3d::Uint8* p00 = row0 + column.first * 4;
+        const sf3d::Uint8* p01 = row0 + column.second * 4;
+        const sf3d::Uint8* p10 = row1 + column.first * 4;
+        const sf3d::Uint8* p11 = row1 + column.second * 4;
+        for (int i = 0; i < 4; ++i)
+        {
+            unsigned int top = (p00[i] * (256 - column.weight) + p01[i] * column.weight + 128) >> 8;
+            unsigned int bottom = (p10[i] * (256 - column.weight) + p11[i] * column.weight + 128) >> 8;
+            output[i] = static_cast<sf3d::Uint8>((top * (256 - weightY) + bottom * weightY + 128) >> 8);
+        }
+    }
+
+    // Sum the channels of a rectangle of source pixels, see resizeBox
+    void sumPixels(const sf3d::Uint8* source, unsigned int sourceWidth, unsigned int left, unsigned int right,
+                   unsigned int top, unsigned int bottom, sf3d::Uint32* sums)
+    {
+#if defined(SFML3D_SIMD_SSE2)
+
+        if (simdEnabled)
+        {
+            // Accumulate the 4 channels in 32 bits lanes
+            const __m128i zero = _mm_setzero_si128();
+            __m128i sum = zero;
+            for (unsigned int y = top; y < bottom; ++y)
+            {
+                const sf3d::Uint8* row = source + y * sourceWidth * 4;
+                for (unsigned int x = left; x < right; ++x)
+                {
+                    __m128i pixel = loadPixel(row + x * 4);
+                    sum = _mm_add_epi32(sum, _mm_unpacklo_epi16(_mm_unpacklo_epi8(pixel, zero), zero));
+                }
+            }
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(sums), sum);
+            return;
+        }
+
+#endif
+
+        sums[0] = sums[1] = sums[2] = sums[3] = 0;
+        for (unsigned int y = top; y < bottom; ++y)
+        {
+            const sf3d::Uint8* row = source + y * sourceWidth * 4;
+            for (unsigned int x = left; x < right; ++x)
+            {
+                for (int i = 0; i < 4; ++i)
+                    sums[i] += row[x * 4 + i];
+            }
+        }
+    }
+}
+
+
+namespace sf3d
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+void setSimdEnabled(bool enabled)
+{
+    simdEnabled = enabled;
+}
+
+
+////////////////////////////////////////////////////////////
+void downsampleBox(const Uint8* source, unsigned int width, unsigned int height, Uint8* destination)
+{
+    unsigned int destinationWidth = width > 1 ? width / 2 : 1;
+    unsigned int destinationHeight = height > 1 ? height / 2 : 1;
+
+    for (unsigned int y = 0; y < destinationHeight; ++y)
+    {
+        const Uint8* row0 = source + (y * 2) * width * 4;
+        const Uint8* row1 = height > 1 ? row0 + width * 4 : row0;
+        Uint8* output = destination + y * destinationWidth * 4;
+        unsigned int x = 0;
+
+        if (width > 1)
+        {
+#if defined(SFML3D_SIMD_SSE2)
+
+            // Two destination pixels per iteration: load 4 source pixels
+            // of each row, widen them to 16 bits and add them together
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i two = _mm_set1_epi16(2);
+            for (; simdEnabled && (x + 2 <= destinationWidth); x += 2)
+            {
+                __m128i top = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + x * 8));
+                __m128i bottom = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + x * 8));
+                __m128i low = _mm_add_epi16(_mm_unpacklo_epi8(top, zero), _mm_unpacklo_epi8(bottom, zero));
+                __m128i high = _mm_add_epi16(_mm_unpackhi_epi8(top, zero), _mm_unpackhi_epi8(bottom, zero));
+
+                // Add horizontally neighbouring pixels, then round and pack
+                __m128i sum = _mm_add_epi16(_mm_unpacklo_epi64(low, high), _mm_unpackhi_epi64(low, high));
+                sum = _mm_srli_epi16(_mm_add_epi16(sum, two), 2);
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(output + x * 4), _mm_packus_epi16(sum, zero));
+            }
+
+#endif
+
+            for (; x < destinationWidth; ++x)
+            {
+                const Uint8* p0 = row0 + x * 8;
+                const Uint8* p1 = row1 + x * 8;
+                for (int i = 0; i < 4; ++i)
+                    output[x * 4 + i] = static_cast<Uint8>((p0[i] + p0[i + 4] + p1[i] + p1[i + 4] + 2) >> 2);
+            }
+        }
+        else
+        {
+            // Single column: only average vertically
+            for (int i = 0; i < 4; ++i)
+                output[i] = static_cast<Uint8>((row0[i] + row1[i] + 1) >> 1);
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void downsampleBox(const Uint8* source, unsigned int width, unsigned int height, unsigned int depth, Uint8* destination)
+{
+    unsigned int destinationWidth = width > 1 ? width / 2 : 1;
+    unsigned int destinationHeight = height > 1 ? height / 2 : 1;
+    unsigned int destinationDepth = depth > 1 ? depth / 2 : 1;
+    std::size_t sliceSize = static_cast<std::size_t>(width) * height * 4;
+
+    for (unsigned int z = 0; z < destinationDepth; ++z)
+    {
+        const Uint8* slice0 = source + (z * 2) * sliceSize;
+        const Uint8* slice1 = depth > 1 ? slice0 + sliceSize : slice0;
+
+        for (unsigned int y = 0; y < destinationHeight; ++y)
+        {
+            // Missing rows, columns and slices repeat the existing ones,
+            // so that every destination pixel averages 8 source pixels
+            std::size_t rowOffset = static_cast<std::size_t>(y * 2) * width * 4;
+            std::size_t nextRow = height > 1 ? width * 4 : 0;
+            const Uint8* rows[4] = {slice0 + rowOffset, slice0 + rowOffset + nextRow,
+                                    slice1 + rowOffset, slice1 + rowOffset + nextRow};
+            Uint8* output = destination + (static_cast<std::size_t>(z) * destinationHeight + y) * destinationWidth * 4;
+            unsigned int x = 0;
+            unsigned int nextColumn = width > 1 ? 4 : 0;
+
+#if defined(SFML3D_SIMD_SSE2)
+
+            // Two destination pixels per iteration, as in the 2D version
+            if (simdEnabled && (width > 1))
+            {
+                const __m128i zero = _mm_setzero_si128();
+                const __m128i four = _mm_set1_epi16(4);
+                for (; x + 2 <= destinationWidth; x += 2)
+                {
+                    __m128i low = zero;
+                    __m128i high = zero;
+                    for (int i = 0; i < 4; ++i)
+                    {
+                        __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[i] + x * 8));
+                        low = _mm_add_epi16(low, _mm_unpacklo_epi8(pixels, zero));
+                        high = _mm_add_epi16(high, _mm_unpackhi_epi8(pixels, zero));
+                    }
+
+                    __m128i sum = _mm_add_epi16(_mm_unpacklo_epi64(low, high), _mm_unpackhi_epi64(low, high));
+                    sum = _mm_srli_epi16(_mm_add_epi16(sum, four), 3);
+                    _mm_storel_epi64(reinterpret_cast<__m128i*>(output + x * 4), _mm_packus_epi16(sum, zero));
+                }
+            }
+
+#endif
+
+            for (; x < destinationWidth; ++x)
+            {
+                std::size_t offset = x * 2 * 4;
+                for (int i = 0; i < 4; ++i)
+                {
+                    unsigned int sum = 4;
+                    for (int j = 0; j < 4; ++j)
+                        sum += rows[j][offset + i] + rows[j][offset + nextColumn + i];
+                    output[x * 4 + i] = static_cast<Uint8>(sum >> 3);
+                }
+            }
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void maskColor(Uint8* pixels, std::size_t count, const Uint8* color, Uint8 alpha)
+{
+    std::size_t i = 0;
+
+#if defined(SFML3D_SIMD_AVX2) || defined(SFML3D_SIMD_SSE2)
+
+    Int32 key;
+    std::memcpy(&key, color, 4);
+    const Uint8 alphaBytes[4] = {0, 0, 0, alpha};
+    Int32 alphaKey;
+    std::memcpy(&alphaKey, alphaBytes, 4);
+    const Uint8 maskBytes[4] = {0, 0, 0, 255};
+    Int32 alphaMask;
+    std::memcpy(&alphaMask, maskBytes, 4);
+
+#endif
+
+#if defined(SFML3D_SIMD_AVX2)
+
+    // Compare 8 pixels at once, and replace the alpha byte of the equal ones
+    const __m256i key8 = _mm256_set1_epi32(key);
+    const __m256i alpha8 = _mm256_set1_epi32(alphaKey);
+    const __m256i mask8 = _mm256_set1_epi32(alphaMask);
+    for (; simdEnabled && (i + 8 <= count); i += 8)
+    {
+        __m256i* pointer = reinterpret_cast<__m256i*>(pixels + i * 4);
+        __m256i values = _mm256_loadu_si256(pointer);
+        __m256i replace = _mm256_and_si256(_mm256_cmpeq_epi32(values, key8), mask8);
+        values = _mm256_or_si256(_mm256_andnot_si256(replace, values), _mm256_and_si256(replace, alpha8));
+        _mm256_storeu_si256(pointer, values);
+    }
+
+#endif
+
+#if defined(SFML3D_SIMD_SSE2)
+
+    // Compare 4 pixels at once, and replace the alpha byte of the equal ones
+    const __m128i key4 = _mm_set1_epi32(key);
+    const __m128i alpha4 = _mm_set1_epi32(alphaKey);
+    const __m128i mask4 = _mm_set1_epi32(alphaMask);
+    for (; simdEnabled && (i + 4 <= count); i += 4)
+    {
+        __m128i* pointer = reinterpret_cast<__m128i*>(pixels + i * 4);
+        __m128i values = _mm_loadu_si128(pointer);
+        __m128i replace = _mm_and_si128(_mm_cmpeq_epi32(values, key4), mask4);
+        values = _mm_or_si128(_mm_andnot_si128(replace, values), _mm_and_si128(replace, alpha4));
+        _mm_storeu_si128(pointer, values);
+    }
+
+#endif
+
+    for (; i < count; ++i)
+    {
+        Uint8* pixel = pixels + i * 4;
+        if ((pixel[0] == color[0]) && (pixel[1] == color[1]) && (pixel[2] == color[2]) && (pixel[3] == color[3]))
+            pixel[3] = alpha;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void blendPixels(const Uint8* source, Uint8* destination, std::size_t count)
+{
+    std::size_t i = 0;
+
+#if defined(SFML3D_SIMD_SSE2)
+
+    // Two pixels per iteration, in 16 bits lanes; x / 255 is computed
+    // exactly for any 16 bits x as (x * 0x8081) >> 23
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i full = _mm_set1_epi16(255);
+    const __m128i reciprocal = _mm_set1_epi16(static_cast<short>(0x8081));
+    const __m128i alphaLanes = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+    for (; simdEnabled && (i + 2 <= count); i += 2)
+    {
+        __m128i sourcePixels = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(source + i * 4)), zero);
+        __m128i destinationPixels = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(destination + i * 4)), zero);
+
+        // Broadcast the alpha of each source pixel to its 4 lanes
+        __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(sourcePixels, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+        __m128i inverse = _mm_sub_epi16(full, alpha);
+
+        // Colors: (s * a + d * (255 - a)) / 255
+        __m128i weighted = _mm_mullo_epi16(destinationPixels, inverse);
+        __m128i color = _mm_add_epi16(_mm_mullo_epi16(sourcePixels, alpha), weighted);
+        color = _mm_srli_epi16(_mm_mulhi_epu16(color, reciprocal), 7);
+
+        // Alpha: a + d * (255 - a) / 255
+        __m128i coverage = _mm_add_epi16(alpha, _mm_srli_epi16(_mm_mulhi_epu16(weighted, reciprocal), 7));
+
+        __m128i result = _mm_or_si128(_mm_andnot_si128(alphaLanes, color), _mm_and_si128(alphaLanes, coverage));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(destination + i * 4), _mm_packus_epi16(result, zero));
+    }
+
+#endif
+
+    for (; i < count; ++i)
+        blendPixel(source + i * 4, destination + i * 4);
+}
+
+
+////////////////////////////////////////////////////////////
+void reversePixels(Uint8* pixels, std::size_t count)
+{
+    Uint8* left = pixels;
+    Uint8* right = pixels + count * 4;
+
+#if defined(SFML3D_SIMD_SSE2)
+
+    // Exchange blocks of 4 pixels from both ends, reversing each of them
+    while (simdEnabled && (right - left >= 32))
+    {
+        right -= 16;
+        __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(left));
+        __m128i last = _mm_loadu_si128(reinterpret_cast<const __m128i*>(right));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(left), _mm_shuffle_epi32(last, _MM_SHUFFLE(0, 1, 2, 3)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(right), _mm_shuffle_epi32(first, _MM_SHUFFLE(0, 1, 2, 3)));
+        left += 16;
+    }
+
+#endif
+
+    while (right - left >= 8)
+    {
+        right -= 4;
+        Uint8 pixel[4];
+        std::memcpy(pixel, left, 4);
+        std::memcpy(left, right, 4);
+        std::memcpy(right, pixel, 4);
+        left += 4;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void swapPixels(Uint8* first, Uint8* second, std::size_t count)
+{
+    std::size_t size = count * 4;
+    std::size_t i = 0;
+
+#if defined(SFML3D_SIMD_SSE2)
+
+    for (; simdEnabled && (i + 16 <= size); i += 16)
+    {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(second + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(first + i), b);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(second + i), a);
+    }
+
+#endif
+
+    for (; i < size; ++i)
+        std::swap(first[i], second[i]);
+}
+
+
+////////////////////////////////////////////////////////////
+void premultiplyAlpha(Uint8* pixels, std::size_t count)
+{
+    std::size_t i = 0;
+
+#if defined(SFML3D_SIMD_SSE2)
+
+    // Two pixels per iteration, same exact division as blendPixels
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i half = _mm_set_epi16(0, 127, 127, 127, 0, 127, 127, 127);
+    const __m128i reciprocal = _mm_set1_epi16(static_cast<short>(0x8081));
+    const __m128i alphaLanes = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+    for (; simdEnabled && (i + 2 <= count); i += 2)
+    {
+        __m128i values = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(pixels + i * 4)), zero);
+        __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(values, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+        alpha = _mm_andnot_si128(alphaLanes, alpha);
+        alpha = _mm_or_si128(alpha, _mm_and_si128(alphaLanes, _mm_set1_epi16(255)));
+
+        // The alpha lanes are multiplied by 255 and divided back, which leaves them unchanged
+        __m128i product = _mm_add_epi16(_mm_mullo_epi16(values, alpha), half);
+        __m128i result = _mm_srli_epi16(_mm_mulhi_epu16(product, reciprocal), 7);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(pixels + i * 4), _mm_packus_epi16(result, zero));
+    }
+
+#endif
+
+    for (; i < count; ++i)
+        premultiplyPixel(pixels + i * 4);
+}
+
+
+////////////////////////////////////////////////////////////
+void resizeBilinear(const Uint8* source, unsigned int sourceWidth, unsigned int sourceHeight,
+                    Uint8* destination, unsigned int destinationWidth, unsigned int destinationHeight)
+{
+    std::vector<BilinearTap> columns;
+    std::vector<BilinearTap> rows;
+    computeBilinearTaps(sourceWidth, destinationWidth, columns);
+    computeBilinearTaps(sourceHeight, destinationHeight, rows);
+
+    for (unsigned int y = 0; y < destinationHeight; ++y)
+    {
+        const Uint8* row0 = source + rows[y].first * sourceWidth * 4;
+        const Uint8* row1 = source + rows[y].second * sourceWidth * 4;
+        unsigned int weightY = rows[y].weight;
+        Uint8* output = destination + y * destinationWidth * 4;
+
+        for (unsigned int x = 0; x < destinationWidth; ++x)
+            interpolatePixel(row0, row1, columns[x], weightY, output + x * 4);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void resizeBox(const Uint8* source, unsigned int sourceWidth, unsigned int sourceHeight,
+               Uint8* destination, unsigned int destinationWidth, unsigned int destinationHeight)
+{
+    std::vector<unsigned int> columnBegins, columnEnds, rowBegins, rowEnds;
+    computeBoxRanges(sourceWidth, destinationWidth, columnBegins, columnEnds);
+    computeBoxRanges(sourceHeight, destinationHeight, rowBegins, rowEnds);
+
+    for (unsigned int y = 0; y < destinationHeight; ++y)
+    {
+        Uint8* output = destination + y * destinationWidth * 4;
+        for (unsigned int x = 0; x < destinationWidth; ++x)
+        {
+            unsigned int count = (columnEnds[x] - columnBegins[x]) * (rowEnds[y] - rowBegins[y]);
+
+            Uint32 sums[4];
+            sumPixels(source, sourceWidth, columnBegins[x], columnEnds[x], rowBegins[y], rowEnds[y], sums);
+
+            for (int i = 0; i < 4; ++i)
+                output[x * 4 + i] = static_cast<Uint8>((sums[i] + count / 2) / count);
+        }
+    }
+}
+
+} // namespace priv
+
+} // namespace sf3d
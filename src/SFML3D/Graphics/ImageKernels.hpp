@@ -0,0 +1,181 @@
+////////////////////////////////////////////////////////////
+//
+// SFML3D - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2014 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef SFML3D_IMAGEKERNELS_HPP
+#define SFML3D_IMAGEKERNELS_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/Config.hpp>
+#include <cstddef>
+
+
+namespace sf3d
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+/// \brief Enable or disable the SIMD paths of the kernels
+///
+/// When disabled, every kernel uses its scalar fallback, which
+/// gives the exact same results. This is meant for testing and
+/// benchmarking the two paths in the same build; it must not
+/// be called while kernels are running on other threads.
+///
+/// \param enabled True to use SIMD instructions when available
+///
+////////////////////////////////////////////////////////////
+void setSimdEnabled(bool enabled);
+
+////////////////////////////////////////////////////////////
+/// \brief Halve an RGBA image with a 2x2 box filter
+///
+/// The destination has a size of max(width / 2, 1) by
+/// max(height / 2, 1) pixels. When a dimension is odd, the
+/// last row or column of the source is ignored, like most
+/// OpenGL implementations do; when it is 1, it is kept as is.
+/// Every channel is rounded to the nearest value, so that the
+/// SIMD and scalar paths give the exact same result.
+///
+/// \param source      Source pixels, row by row
+/// \param width       Width of the source, in pixels
+/// \param height      Height of the source, in pixels
+/// \param destination Array receiving the downsampled pixels
+///
+////////////////////////////////////////////////////////////
+void downsampleBox(const Uint8* source, unsigned int width, unsigned int height, Uint8* destination);
+
+////////////////////////////////////////////////////////////
+/// \brief Halve an RGBA volume with a 2x2x2 box filter
+///
+/// Works like downsampleBox, on the three dimensions: each
+/// destination pixel is the rounded average of 8 source
+/// pixels, and dimensions of 1 are kept as is.
+///
+/// \param source      Source pixels, slice by slice and row by row
+/// \param width       Width of the source, in pixels
+/// \param height      Height of the source, in pixels
+/// \param depth       Depth of the source, in pixels
+/// \param destination Array receiving the downsampled pixels
+///
+////////////////////////////////////////////////////////////
+void downsampleBox(const Uint8* source, unsigned int width, unsigned int height, unsigned int depth, Uint8* destination);
+
+////////////////////////////////////////////////////////////
+/// \brief Set the alpha of the pixels matching a color
+///
+/// \param pixels Array of RGBA pixels
+/// \param count  Number of pixels
+/// \param color  RGBA components of the color to match
+/// \param alpha  Alpha to give to the matching pixels
+///
+////////////////////////////////////////////////////////////
+void maskColor(Uint8* pixels, std::size_t count, const Uint8* color, Uint8 alpha);
+
+////////////////////////////////////////////////////////////
+/// \brief Blend pixels over others, using the source alpha
+///
+/// The color components become (s * a + d * (255 - a)) / 255
+/// and the alpha becomes a + d * (255 - a) / 255, with
+/// divisions rounded down.
+///
+/// \param source      Pixels to blend
+/// \param destination Pixels to blend over, receiving the result
+/// \param count       Number of pixels
+///
+////////////////////////////////////////////////////////////
+void blendPixels(const Uint8* source, Uint8* destination, std::size_t count);
+
+////////////////////////////////////////////////////////////
+/// \brief Reverse the order of pixels in place
+///
+/// \param pixels Array of RGBA pixels
+/// \param count  Number of pixels
+///
+////////////////////////////////////////////////////////////
+void reversePixels(Uint8* pixels, std::size_t count);
+
+////////////////////////////////////////////////////////////
+/// \brief Exchange the contents of two arrays of pixels
+///
+/// \param first  First array of RGBA pixels
+/// \param second Second array of RGBA pixels
+/// \param count  Number of pixels
+///
+////////////////////////////////////////////////////////////
+void swapPixels(Uint8* first, Uint8* second, std::size_t count);
+
+////////////////////////////////////////////////////////////
+/// \brief Multiply the color components of pixels by their alpha
+///
+/// Every color component becomes (c * a + 127) / 255.
+///
+/// \param pixels Array of RGBA pixels
+/// \param count  Number of pixels
+///
+////////////////////////////////////////////////////////////
+void premultiplyAlpha(Uint8* pixels, std::size_t count);
+
+////////////////////////////////////////////////////////////
+/// \brief Resize an image with bilinear interpolation
+///
+/// The weights have 8 bits of precision, and the horizontal
+/// interpolation is rounded to 8 bits before the vertical one.
+///
+/// \param source            Source pixels, row by row
+/// \param sourceWidth       Width of the source
+/// \param sourceHeight      Height of the source
+/// \param destination       Array receiving the resized pixels
+/// \param destinationWidth  Width of the destination
+/// \param destinationHeight Height of the destination
+///
+////////////////////////////////////////////////////////////
+void resizeBilinear(const Uint8* source, unsigned int sourceWidth, unsigned int sourceHeight,
+                    Uint8* destination, unsigned int destinationWidth, unsigned int destinationHeight);
+
+////////////////////////////////////////////////////////////
+/// \brief Resize an image by averaging the pixels covered by each destination pixel
+///
+/// Every destination pixel is the rounded average of the
+/// source pixels whose center falls inside it (at least one).
+///
+/// \param source            Source pixels, row by row
+/// \param sourceWidth       Width of the source
+/// \param sourceHeight      Height of the source
+/// \param destination       Array receiving the resized pixels
+/// \param destinationWidth  Width of the destination
+/// \param destinationHeight Height of the destination
+///
+////////////////////////////////////////////////////////////
+void resizeBox(const Uint8* source, unsigned int sourceWidth, unsigned int sourceHeight,
+               Uint8* destination, unsigned int destinationWidth, unsigned int destinationHeight);
+
+} // namespace priv
+
+} // namespace sf3d
+
+
+#endif // SFML3D_IMAGEKERNELS_HPP
@@ -28,6 +28,8 @@
 #include <SFML3D/Graphics/ImageLoader.hpp>
 #include <SFML3D/System/InputStream.hpp>
 #include <SFML3D/System/Err.hpp>
+#include <SFML3D/System/Mutex.hpp>
+#include <SFML3D/System/Lock.hpp>
 #include <SFML3D/Graphics/stb_image/stb_image.h>
 #define STB_IMAGE_WRITE_IMPLEMENTATION
 #include <SFML3D/Graphics/stb_image/stb_image_write.h>
@@ -41,6 +43,9 @@ extern "C"
 
 namespace
 {
+    // Serializes the error reports of images decoded concurrently (see Image::loadMany)
+    sf3d::Mutex errorMutex;
+
     // Convert a string to lower case
     std::string toLower(std::string str)
     {
@@ -84,7 +89,9 @@ ImageLoader& ImageLoader::getInstance()
 ////////////////////////////////////////////////////////////
 ImageLoader::ImageLoader()
 {
-    // Nothing to do
+    // stb_image builds its fixed zlib tables on first use, build them
+    // now so that images can be decoded from several threads at once
+    init_defaults();
 }
 
 
@@ -111,9 +118,8 @@ bool ImageLoader::loadImageFromFile(const std::string& filename, std::vector<Uin
         size.x = width;
         size.y = height;
 
-        // Copy the loaded pixels to the pixel buffer
-        pixels.resize(width * height * 4);
-        memcpy(&pixels[0], ptr, pixels.size());
+        // Copy the loaded pixels to the pixel buffer, in a single pass
+        pixels.assign(ptr, ptr + width * height * 4);
 
         // Free the loaded pixels (they are now in our own pixel buffer)
         stbi_image_free(ptr);
@@ -122,7 +128,9 @@ bool ImageLoader::loadImageFromFile(const std::string& filename, std::vector<Uin
     }
     else
     {
-        // Error, failed to load the image
+        // Error, failed to load the image; stb_image keeps a single failure
+        // reason, which may come from another file decoded at the same time
+        Lock lock(errorMutex);
         err() << "Failed to load image \"" << filename << "\". Reason : " << stbi_failure_reason() << std::endl;
 
         return false;
@@ -150,9 +158,8 @@ bool ImageLoader::loadImageFromMemory(const void* data, std::size_t dataSize, st
             size.x = width;
             size.y = height;
 
-            // Copy the loaded pixels to the pixel buffer
-            pixels.resize(width * height * 4);
-            memcpy(&pixels[0], ptr, pixels.size());
+            // Copy the loaded pixels to the pixel buffer, in a single pass
+            pixels.assign(ptr, ptr + width * height * 4);
 
             // Free the loaded pixels (they are now in our own pixel buffer)
             stbi_image_free(ptr);
@@ -161,7 +168,9 @@ bool ImageLoader::loadImageFromMemory(const void* data, std::size_t dataSize, st
         }
         else
         {
-            // Error, failed to load the image
+            // Error, failed to load the image; stb_image keeps a single failure
+            // reason, which may come from another file decoded at the same time
+            Lock lock(errorMutex);
             err() << "Failed to load image from memory. Reason : " << stbi_failure_reason() << std::endl;
 
             return false;
@@ -200,9 +209,8 @@ bool ImageLoader::loadImageFromStream(InputStream& stream, std::vector<Uint8>& p
         size.x = width;
         size.y = height;
 
-        // Copy the loaded pixels to the pixel buffer
-        pixels.resize(width * height * 4);
-        memcpy(&pixels[0], ptr, pixels.size());
+        // Copy the loaded pixels to the pixel buffer, in a single pass
+        pixels.assign(ptr, ptr + width * height * 4);
 
         // Free the loaded pixels (they are now in our own pixel buffer)
         stbi_image_free(ptr);
@@ -211,7 +219,9 @@ bool ImageLoader::loadImageFromStream(InputStream& stream, std::vector<Uint8>& p
     }
     else
     {
-        // Error, failed to load the image
+        // Error, failed to load the image; stb_image keeps a single failure
+        // reason, which may come from another file decoded at the same time
+        Lock lock(errorMutex);
         err() << "Failed to load image from stream. Reason : " << stbi_failure_reason() << std::endl;
 
         return false;
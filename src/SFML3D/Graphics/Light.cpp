@@ -4,6 +4,7 @@
 ////////////////////////////////////////////////////////////
 #include <SFML3D/Graphics/Light.hpp>
 #include <SFML3D/Graphics/Shader.hpp>
+#include <SFML3D/Graphics/ShadowMap.hpp>
 #include <SFML3D/Graphics/VertexBuffer.hpp>
 #include <SFML3D/Graphics/GLCheck.hpp>
 #include <SFML3D/System/Mutex.hpp>
@@ -42,7 +43,8 @@ m_specularIntensity   (1.f),
 m_constantAttenuation (1.f),
 m_linearAttenuation   (0.f),
 m_quadraticAttenuation(0.f),
-m_enabled             (false)
+m_enabled             (false),
+m_shadowMap           (NULL)
 {
     getId();
 
@@ -86,7 +88,8 @@ m_specularIntensity   (copy.m_specularIntensity),
 m_constantAttenuation (copy.m_constantAttenuation),
 m_linearAttenuation   (copy.m_linearAttenuation),
 m_quadraticAttenuation(copy.m_quadraticAttenuation),
-m_enabled             (false)
+m_enabled             (false),
+m_shadowMap           (NULL)
 {
     getId();
 
@@ -140,6 +143,10 @@ Light::~Light()
 {
     disable();
 
+    // Detach the shadow map, it can't be used without its light anymore
+    if (m_shadowMap)
+        m_shadowMap->m_light = NULL;
+
     if (m_light >= 0)
     {
         Lock lock(mutex);
@@ -715,7 +722,7 @@ void Light::addLightsToShader(const Shader& shader)
             shader.setParameter(light.m_shaderElement + ".attenuation", light.m_constantAttenuation,
                                                                         light.m_linearAttenuation,
                                                                         light.m_quadraticAttenuation,
-                                                                        1.f);
+                                                                        light.m_shadowMap ? static_cast<float>(light.m_shadowMap->getShaderSlot()) : -1.f);
         }
     }
     else if (lightUniformBuffer)
@@ -757,7 +764,7 @@ void Light::addLightsToShader(const Shader& shader)
                     dataPointer[index * 20 + 16] = light.m_constantAttenuation;
                     dataPointer[index * 20 + 17] = light.m_linearAttenuation;
                     dataPointer[index * 20 + 18] = light.m_quadraticAttenuation;
-                    dataPointer[index * 20 + 19] = 1.f;
+                    dataPointer[index * 20 + 19] = light.m_shadowMap ? static_cast<float>(light.m_shadowMap->getShaderSlot()) : -1.f;
                 }
             }
         }
@@ -766,6 +773,8 @@ void Light::addLightsToShader(const Shader& shader)
     }
 
     shader.setParameter("sf_LightCount", static_cast<int>(enabledLights.size()));
+
+    ShadowMap::addShadowMapsToShader(shader);
 }
 
 
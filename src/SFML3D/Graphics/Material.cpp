@@ -0,0 +1,317 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/Graphics/Material.hpp>
+#include <SFML3D/Graphics/Shader.hpp>
+#include <SFML3D/Graphics/Light.hpp>
+#include <SFML3D/Graphics/ShadowMap.hpp>
+#include <SFML3D/Graphics/DefaultShader.hpp>
+#include <SFML3D/System/Mutex.hpp>
+#include <SFML3D/System/Lock.hpp>
+#include <SFML3D/System/Err.hpp>
+#include <map>
+
+
+namespace
+{
+    // Bits of a permutation key, in addition to the material flags
+    const sf3d::Uint32 texturedPermutation = 1 << 3;
+    const sf3d::Uint32 shadowedPermutation = 1 << 4;
+
+    // Shader permutations, shared by all the materials and kept alive by the render targets
+    typedef std::map<sf3d::Uint32, sf3d::Shader*> PermutationTable;
+    sf3d::Mutex      mutex;
+    unsigned int     count = 0;
+    PermutationTable permutations;
+
+    // Thread-safe unique identifier generator,
+    // is used for states cache (see RenderTarget)
+    sf3d::Uint64 getUniqueId()
+    {
+        static sf3d::Uint64 id = 1; // start at 1, zero is "no material"
+        static sf3d::Mutex idMutex;
+
+        sf3d::Lock lock(idMutex);
+        return id++;
+    }
+
+    // Get the shader of a permutation, compiling it on first use
+    const sf3d::Shader* getPermutation(sf3d::Uint32 key)
+    {
+        sf3d::Lock lock(mutex);
+
+        // Failed compilations are stored as NULL, so that they are not attempted again
+        PermutationTable::const_iterator it = permutations.find(key);
+        if (it != permutations.end())
+            return it->second;
+
+        // The features are constants, the compiler strips the unused branches of the default shader
+        std::string defines = "#define SF_MATERIAL\n";
+        defines += (key & texturedPermutation)          ? "#define SF_TEXTURE_ENABLED true\n"  : "#define SF_TEXTURE_ENABLED false\n";
+        defines += (key & sf3d::Material::Lighting)     ? "#define SF_LIGHTING_ENABLED true\n" : "#define SF_LIGHTING_ENABLED false\n";
+        defines += (key & sf3d::Material::VertexColors) ? "#define SF_VERTEX_COLORS true\n"    : "#define SF_VERTEX_COLORS false\n";
+        if (key & sf3d::Material::AlphaTest)
+            defines += "#define SF_ALPHA_TEST\n";
+        if (key & shadowedPermutation)
+            defines += "#define SF_SHADOWS\n";
+
+        sf3d::Shader* shader = new sf3d::Shader;
+        if (shader->loadFromMemory(sf3d::priv::getDefaultVertexShaderSource(defines),
+                                   sf3d::priv::getDefaultFragmentShaderSource(defines)))
+        {
+            // Uniforms of the disabled features are optimized out, setting them is not an error
+            shader->warnMissing(false);
+        }
+        else
+        {
+            sf3d::err() << "Compiling material shader failed. Falling back to the default shader..." << std::endl;
+            delete shader;
+            shader = NULL;
+        }
+
+        permutations[key] = shader;
+        return shader;
+    }
+
+    // Release a reference to the permutations, destroying them with the last one
+    void releasePermutations()
+    {
+        sf3d::Lock lock(mutex);
+        count--;
+
+        if (!count)
+        {
+            for (PermutationTable::iterator it = permutations.begin(); it != permutations.end(); ++it)
+                delete it->second;
+
+            permutations.clear();
+        }
+    }
+}
+
+
+namespace sf3d
+{
+////////////////////////////////////////////////////////////
+Material::Material() :
+m_diffuseColor  (Color::White),
+m_specularColor (Color::Black),
+m_shininess     (1.f),
+m_alphaThreshold(0.5f),
+m_texture       (NULL),
+m_flags         (Default),
+m_cacheId       (getUniqueId())
+{
+    Lock lock(mutex);
+    count++;
+}
+
+
+////////////////////////////////////////////////////////////
+Material::Material(const Material& copy) :
+m_diffuseColor  (copy.m_diffuseColor),
+m_specularColor (copy.m_specularColor),
+m_shininess     (copy.m_shininess),
+m_alphaThreshold(copy.m_alphaThreshold),
+m_texture       (copy.m_texture),
+m_flags         (copy.m_flags),
+m_cacheId       (getUniqueId())
+{
+    Lock lock(mutex);
+    count++;
+}
+
+
+////////////////////////////////////////////////////////////
+Material::~Material()
+{
+    releasePermutations();
+}
+
+
+////////////////////////////////////////////////////////////
+Material& Material::operator =(const Material& right)
+{
+    m_diffuseColor   = right.m_diffuseColor;
+    m_specularColor  = right.m_specularColor;
+    m_shininess      = right.m_shininess;
+    m_alphaThreshold = right.m_alphaThreshold;
+    m_texture        = right.m_texture;
+    m_flags          = right.m_flags;
+    m_cacheId        = getUniqueId();
+
+    return *this;
+}
+
+
+////////////////////////////////////////////////////////////
+void Material::setDiffuseColor(const Color& color)
+{
+    m_diffuseColor = color;
+    m_cacheId = getUniqueId();
+}
+
+
+////////////////////////////////////////////////////////////
+const Color& Material::getDiffuseColor() const
+{
+    return m_diffuseColor;
+}
+
+
+////////////////////////////////////////////////////////////
+void Material::setSpecularColor(const Color& color)
+{
+    m_specularColor = color;
+    m_cacheId = getUniqueId();
+}
+
+
+////////////////////////////////////////////////////////////
+const Color& Material::getSpecularColor() const
+{
+    return m_specularColor;
+}
+
+
+////////////////////////////////////////////////////////////
+void Material::setShininess(float shininess)
+{
+    m_shininess = shininess;
+    m_cacheId = getUniqueId();
+}
+
+
+////////////////////////////////////////////////////////////
+float Material::getShininess() const
+{
+    return m_shininess;
+}
+
+
+////////////////////////////////////////////////////////////
+void Material::setAlphaThreshold(float threshold)
+{
+    m_alphaThreshold = threshold;
+    m_cacheId = getUniqueId();
+}
+
+
+////////////////////////////////////////////////////////////
+float Material::getAlphaThreshold() const
+{
+    return m_alphaThreshold;
+}
+
+
+////////////////////////////////////////////////////////////
+void Material::setTexture(const Texture* texture)
+{
+    m_texture = texture;
+    m_cacheId = getUniqueId();
+}
+
+
+////////////////////////////////////////////////////////////
+const Texture* Material::getTexture() const
+{
+    return m_texture;
+}
+
+
+////////////////////////////////////////////////////////////
+void Material::setFlags(Uint32 flags)
+{
+    m_flags = flags & (Lighting | VertexColors | AlphaTest);
+    m_cacheId = getUniqueId();
+}
+
+
+////////////////////////////////////////////////////////////
+Uint32 Material::getFlags() const
+{
+    return m_flags;
+}
+
+
+////////////////////////////////////////////////////////////
+bool Material::precompile() const
+{
+    if (!Light::hasShaderLighting())
+        return false;
+
+    // Lighting can be toggled globally, and a material without texture can get one from the render states
+    bool success = true;
+    for (Uint32 textured = m_texture ? 1 : 0; textured < 2; ++textured)
+    {
+        Uint32 key = m_flags | (textured ? texturedPermutation : 0);
+
+        success = getPermutation(key) && success;
+        if (m_flags & Lighting)
+        {
+            success = getPermutation(key & ~static_cast<Uint32>(Lighting)) && success;
+            if (ShadowMap::hasShadowMaps())
+                success = getPermutation(key | shadowedPermutation) && success;
+        }
+    }
+
+    return success;
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int Material::getPermutationCount()
+{
+    Lock lock(mutex);
+
+    unsigned int compiled = 0;
+    for (PermutationTable::const_iterator it = permutations.begin(); it != permutations.end(); ++it)
+    {
+        if (it->second)
+            compiled++;
+    }
+
+    return compiled;
+}
+
+
+////////////////////////////////////////////////////////////
+const Shader* Material::getShader(bool textured) const
+{
+    Uint32 key = m_flags;
+
+    // Only lit permutations sample the shadow maps, and only while there are some
+    if (!isLit())
+        key &= ~static_cast<Uint32>(Lighting);
+    else if (ShadowMap::hasShadowMaps())
+        key |= shadowedPermutation;
+
+    if (textured)
+        key |= texturedPermutation;
+
+    return getPermutation(key);
+}
+
+
+////////////////////////////////////////////////////////////
+bool Material::isLit() const
+{
+    return (m_flags & Lighting) && Light::isLightingEnabled();
+}
+
+
+////////////////////////////////////////////////////////////
+void Material::increasePermutationReferences()
+{
+    Lock lock(mutex);
+    count++;
+}
+
+
+////////////////////////////////////////////////////////////
+void Material::decreasePermutationReferences()
+{
+    releasePermutations();
+}
+
+} // namespace sf3d
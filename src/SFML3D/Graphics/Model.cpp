@@ -30,6 +30,23 @@ Polyhedron::Face Model::getFace(unsigned int index) const
 }
 
 
+////////////////////////////////////////////////////////////
+void Model::getFaces(Vertex* vertices, unsigned int first, unsigned int count) const
+{
+    if (!count)
+        return;
+
+    const FaceIndices* faces = &m_faces[first];
+
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        vertices[i * 3 + 0] = m_vertices[faces[i].index0];
+        vertices[i * 3 + 1] = m_vertices[faces[i].index1];
+        vertices[i * 3 + 2] = m_vertices[faces[i].index2];
+    }
+}
+
+
 ////////////////////////////////////////////////////////////
 Model::Model()
 {
@@ -78,4 +95,13 @@ void Model::clearFaces()
     m_faces.clear();
 }
 
+
+////////////////////////////////////////////////////////////
+void Model::getFaceIndices(unsigned int index, unsigned int& index0, unsigned int& index1, unsigned int& index2) const
+{
+    index0 = m_faces[index].index0;
+    index1 = m_faces[index].index1;
+    index2 = m_faces[index].index2;
+}
+
 } // namespace sf3d
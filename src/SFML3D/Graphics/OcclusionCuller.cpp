@@ -0,0 +1,668 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/Graphics/OcclusionCuller.hpp>
+#include <SFML3D/Graphics/Polyhedron.hpp>
+#include <SFML3D/Graphics/RenderTarget.hpp>
+#include <SFML3D/Graphics/View.hpp>
+#include <SFML3D/Graphics/GLCheck.hpp>
+#include <SFML3D/Graphics/Parallel.hpp>
+#include <SFML3D/Graphics/Simd.hpp>
+#include <SFML3D/System/Clock.hpp>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+
+namespace
+{
+    // Size of the tiles the depth buffer is split into, a multiple of 4
+    const unsigned int tileSize = 32;
+
+    // Minimum number of tiles rasterized by a thread
+    const std::size_t rasterGrain = 4;
+
+    // Triangles smaller than this, in square pixels, cover no pixel center
+    const float minArea = 1e-6f;
+
+    // Corners of a box, as offsets along its width, height and depth
+    const float boxCorners[8][3] =
+    {
+        {0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0},
+        {0, 0, 1}, {1, 0, 1}, {1, 1, 1}, {0, 1, 1}
+    };
+
+    // Triangles of a box, as indices of its corners
+    const unsigned int boxIndices[36] =
+    {
+        0, 2, 1, 0, 3, 2, // front
+        4, 5, 6, 4, 6, 7, // back
+        0, 4, 7, 0, 7, 3, // left
+        1, 2, 6, 1, 6, 5, // right
+        0, 1, 5, 0, 5, 4, // bottom
+        3, 7, 6, 3, 6, 2  // top
+    };
+
+    // Transform a point to clip space, with a column-major matrix
+    void transformToClip(const float* m, float x, float y, float z, float* clip)
+    {
+        clip[0] = m[0] * x + m[4] * y + m[8]  * z + m[12];
+        clip[1] = m[1] * x + m[5] * y + m[9]  * z + m[13];
+        clip[2] = m[2] * x + m[6] * y + m[10] * z + m[14];
+        clip[3] = m[3] * x + m[7] * y + m[11] * z + m[15];
+    }
+}
+
+
+namespace sf3d
+{
+////////////////////////////////////////////////////////////
+struct OcclusionCuller::RasterTask : priv::ParallelTask
+{
+    RasterTask(OcclusionCuller& theCuller) : culler(theCuller) {}
+
+    virtual void run(std::size_t begin, std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; ++i)
+            culler.rasterizeTile(i);
+    }
+
+    OcclusionCuller& culler;
+};
+
+
+////////////////////////////////////////////////////////////
+OcclusionCuller::OcclusionCuller() :
+m_width        (0),
+m_height       (0),
+m_threadCount  (0),
+m_gpuQueries   (false),
+m_queryTarget  (NULL),
+m_nextQuery    (0),
+m_triangleCount(0),
+m_updateTime   (Time::Zero),
+m_tested       (0),
+m_culled       (0)
+{
+    std::copy(Transform::Identity.getMatrix(), Transform::Identity.getMatrix() + 16, m_matrix);
+
+    setResolution(256, 128);
+}
+
+
+////////////////////////////////////////////////////////////
+OcclusionCuller::~OcclusionCuller()
+{
+    releaseQueries();
+}
+
+
+////////////////////////////////////////////////////////////
+void OcclusionCuller::setResolution(unsigned int width, unsigned int height)
+{
+    // Rows are processed 4 pixels at a time
+    m_width  = std::max((width + 3) & ~3u, 4u);
+    m_height = std::max(height, 1u);
+
+    m_depth.assign(m_width * m_height, 1.f);
+
+    unsigned int tilesX = (m_width + tileSize - 1) / tileSize;
+    unsigned int tilesY = (m_height + tileSize - 1) / tileSize;
+    m_bins.clear();
+    m_bins.resize(tilesX * tilesY);
+}
+
+
+////////////////////////////////////////////////////////////
+Vector2u OcclusionCuller::getResolution() const
+{
+    return Vector2u(m_width, m_height);
+}
+
+
+////////////////////////////////////////////////////////////
+void OcclusionCuller::setThreadCount(unsigned int count)
+{
+    m_threadCount = count;
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int OcclusionCuller::getThreadCount() const
+{
+    return m_threadCount;
+}
+
+
+////////////////////////////////////////////////////////////
+void OcclusionCuller::addOccluder(const Polyhedron& occluder)
+{
+    if (std::find(m_occluders.begin(), m_occluders.end(), &occluder) == m_occluders.end())
+        m_occluders.push_back(&occluder);
+}
+
+
+////////////////////////////////////////////////////////////
+void OcclusionCuller::removeOccluder(const Polyhedron& occluder)
+{
+    m_occluders.erase(std::remove(m_occluders.begin(), m_occluders.end(), &occluder), m_occluders.end());
+}
+
+
+////////////////////////////////////////////////////////////
+void OcclusionCuller::clearOccluders()
+{
+    m_occluders.clear();
+}
+
+
+////////////////////////////////////////////////////////////
+void OcclusionCuller::update(const View& view)
+{
+    Clock clock;
+
+    Transform viewProjection = view.getTransform() * view.getViewTransform();
+    std::copy(viewProjection.getMatrix(), viewProjection.getMatrix() + 16, m_matrix);
+
+    m_triangles.clear();
+    for (std::size_t i = 0; i < m_bins.size(); ++i)
+        m_bins[i].clear();
+
+    // Transform the faces of the occluders to clip space, and bin them into tiles
+    for (std::size_t i = 0; i < m_occluders.size(); ++i)
+    {
+        const Polyhedron& occluder = *m_occluders[i];
+
+        unsigned int faceCount = occluder.getFaceCount();
+        if (!faceCount)
+            continue;
+
+        m_faces.resize(faceCount * 3);
+        occluder.getFaces(&m_faces[0], 0, faceCount);
+
+        Transform transform = viewProjection * occluder.getTransform();
+        const float* matrix = transform.getMatrix();
+
+        for (std::size_t j = 0; j < m_faces.size(); j += 3)
+        {
+            float clip[12];
+            for (std::size_t k = 0; k < 3; ++k)
+            {
+                const Vector3f& position = m_faces[j + k].position;
+                transformToClip(matrix, position.x, position.y, position.z, clip + k * 4);
+            }
+
+            addTriangle(clip);
+        }
+    }
+
+    m_triangleCount = static_cast<unsigned int>(m_triangles.size() / 9);
+
+    // Tiles don't overlap, they are rasterized in parallel
+    std::fill(m_depth.begin(), m_depth.end(), 1.f);
+
+    RasterTask task(*this);
+    priv::parallelFor(task, m_bins.size(), rasterGrain, m_threadCount);
+
+    m_updateTime = clock.getElapsedTime();
+    m_nextQuery = 0;
+    m_tested = 0;
+    m_culled = 0;
+}
+
+
+////////////////////////////////////////////////////////////
+bool OcclusionCuller::isVisible(const FloatBox& bounds) const
+{
+    m_tested++;
+
+    bool nearPlane = false;
+    if (testBounds(bounds, nearPlane))
+        return true;
+
+    m_culled++;
+    return false;
+}
+
+
+////////////////////////////////////////////////////////////
+bool OcclusionCuller::draw(RenderTarget& target, const Drawable& occludee, const FloatBox& bounds, const RenderStates& states)
+{
+    m_tested++;
+
+    bool nearPlane = false;
+    if (!testBounds(bounds, nearPlane))
+    {
+        m_culled++;
+        return false;
+    }
+
+    // Query objects are not shared between contexts, release the ones of the previous target
+    if (m_queryTarget && (m_queryTarget != &target))
+        releaseQueries();
+
+    // The box can't be tested when the camera is inside it
+    if (!m_gpuQueries || nearPlane || !isGpuQueryAvailable() || !target.activate(true))
+    {
+        target.draw(occludee, states);
+        return true;
+    }
+
+    // Queries of the previous frames are reused, their results are not needed anymore
+    if (m_nextQuery == m_queries.size())
+    {
+        GLuint query;
+        glCheck(glGenQueriesARB(1, &query));
+        m_queries.push_back(static_cast<unsigned int>(query));
+        m_queryTarget = &target;
+    }
+
+    GLuint query = static_cast<GLuint>(m_queries[m_nextQuery++]);
+
+    Vertex box[36];
+    for (std::size_t i = 0; i < 36; ++i)
+    {
+        const float* corner = boxCorners[boxIndices[i]];
+        box[i].position = Vector3f(bounds.left  + corner[0] * bounds.width,
+                                   bounds.top   + corner[1] * bounds.height,
+                                   bounds.front + corner[2] * bounds.depth);
+    }
+
+    // Count the samples of the box passing the depth test, without writing anything
+    glCheck(glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE));
+    glCheck(glDepthMask(GL_FALSE));
+    glCheck(glDisable(GL_CULL_FACE));
+
+    glCheck(glBeginQueryARB(GL_SAMPLES_PASSED_ARB, query));
+    target.draw(box, 36, Triangles);
+    glCheck(glEndQueryARB(GL_SAMPLES_PASSED_ARB));
+
+    glCheck(glEnable(GL_CULL_FACE));
+    glCheck(glDepthMask(GL_TRUE));
+    glCheck(glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE));
+
+    // The GPU discards the drawing if no sample passed, without stalling the CPU
+    if (GLEW_VERSION_3_0)
+        glCheck(glBeginConditionalRender(query, GL_QUERY_WAIT));
+    else
+        glCheck(glBeginConditionalRenderNV(query, GL_QUERY_WAIT_NV));
+
+    target.draw(occludee, states);
+
+    if (GLEW_VERSION_3_0)
+        glCheck(glEndConditionalRender());
+    else
+        glCheck(glEndConditionalRenderNV());
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+void OcclusionCuller::setGpuQueriesEnabled(bool enabled)
+{
+    m_gpuQueries = enabled;
+
+    if (!enabled)
+        releaseQueries();
+}
+
+
+////////////////////////////////////////////////////////////
+bool OcclusionCuller::areGpuQueriesEnabled() const
+{
+    return m_gpuQueries;
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int OcclusionCuller::getTriangleCount() const
+{
+    return m_triangleCount;
+}
+
+
+////////////////////////////////////////////////////////////
+Time OcclusionCuller::getUpdateTime() const
+{
+    return m_updateTime;
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int OcclusionCuller::getTestedCount() const
+{
+    return m_tested;
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int OcclusionCuller::getCulledCount() const
+{
+    return m_culled;
+}
+
+
+////////////////////////////////////////////////////////////
+Image OcclusionCuller::copyToImage() const
+{
+    Image image;
+    image.create(m_width, m_height, Color::Black);
+
+    for (unsigned int y = 0; y < m_height; ++y)
+    {
+        for (unsigned int x = 0; x < m_width; ++x)
+        {
+            // Normalized device depth goes from -1 (near) to 1 (far)
+            float depth = std::min(std::max(m_depth[y * m_width + x], -1.f), 1.f);
+            Uint8 value = static_cast<Uint8>((1.f - depth) * 127.5f);
+            image.setPixel(x, y, Color(value, value, value));
+        }
+    }
+
+    return image;
+}
+
+
+////////////////////////////////////////////////////////////
+bool OcclusionCuller::isGpuQueryAvailable()
+{
+    static bool checked = false;
+    static bool queriesSupported = false;
+    if (!checked)
+    {
+        checked = true;
+
+        ensureGlContext();
+
+        // Make sure that GLEW is initialized
+        priv::ensureGlewInit();
+
+        queriesSupported = GLEW_ARB_occlusion_query && (GLEW_VERSION_3_0 || GLEW_NV_conditional_render);
+    }
+
+    return queriesSupported;
+}
+
+
+////////////////////////////////////////////////////////////
+void OcclusionCuller::releaseQueries()
+{
+    // Delete the queries in the context that created them, never in another one
+    if (!m_queries.empty() && m_queryTarget->activate(true))
+    {
+        GLuint* queries = static_cast<GLuint*>(&m_queries[0]);
+        glCheck(glDeleteQueriesARB(static_cast<GLsizei>(m_queries.size()), queries));
+    }
+
+    m_queries.clear();
+    m_queryTarget = NULL;
+    m_nextQuery = 0;
+}
+
+
+////////////////////////////////////////////////////////////
+void OcclusionCuller::addTriangle(const float* clip)
+{
+    // Reject the triangles entirely outside one of the planes of the frustum
+    for (std::size_t axis = 0; axis < 3; ++axis)
+    {
+        bool allBelow = true;
+        bool allAbove = true;
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            const float* v = clip + i * 4;
+            allBelow = allBelow && (v[axis] < -v[3]);
+            allAbove = allAbove && (v[axis] > v[3]);
+        }
+
+        if (allAbove || allBelow)
+            return;
+    }
+
+    // Clip against the near plane (z >= -w), which leaves a polygon of up to 4 vertices
+    float polygon[4][4];
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        const float* a = clip + i * 4;
+        const float* b = clip + ((i + 1) % 3) * 4;
+        float da = a[2] + a[3];
+        float db = b[2] + b[3];
+
+        if (da >= 0.f)
+            std::copy(a, a + 4, polygon[count++]);
+
+        if ((da >= 0.f) != (db >= 0.f))
+        {
+            float t = da / (da - db);
+            for (std::size_t k = 0; k < 4; ++k)
+                polygon[count][k] = a[k] + (b[k] - a[k]) * t;
+            count++;
+        }
+    }
+
+    if (count < 3)
+        return;
+
+    // Project the vertices to the pixels of the depth buffer
+    float screen[4][3];
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        float invW = 1.f / polygon[i][3];
+        screen[i][0] = (polygon[i][0] * invW * 0.5f + 0.5f) * m_width;
+        screen[i][1] = (0.5f - polygon[i][1] * invW * 0.5f) * m_height;
+        screen[i][2] = polygon[i][2] * invW;
+    }
+
+    unsigned int tilesX = (m_width + tileSize - 1) / tileSize;
+    unsigned int tilesY = (m_height + tileSize - 1) / tileSize;
+
+    for (std::size_t i = 1; i + 1 < count; ++i)
+    {
+        const float* v0 = screen[0];
+        const float* v1 = screen[i];
+        const float* v2 = screen[i + 1];
+
+        // Both sides of the occluders hide what is behind them, make all the triangles counter-clockwise
+        float area = (v1[0] - v0[0]) * (v2[1] - v0[1]) - (v1[1] - v0[1]) * (v2[0] - v0[0]);
+        if (std::fabs(area) < minArea)
+            continue;
+
+        if (area < 0.f)
+            std::swap(v1, v2);
+
+        float minX = std::min(v0[0], std::min(v1[0], v2[0]));
+        float maxX = std::max(v0[0], std::max(v1[0], v2[0]));
+        float minY = std::min(v0[1], std::min(v1[1], v2[1]));
+        float maxY = std::max(v0[1], std::max(v1[1], v2[1]));
+
+        if ((maxX < 0.f) || (maxY < 0.f) || (minX >= m_width) || (minY >= m_height))
+            continue;
+
+        Uint32 index = static_cast<Uint32>(m_triangles.size() / 9);
+        m_triangles.insert(m_triangles.end(), v0, v0 + 3);
+        m_triangles.insert(m_triangles.end(), v1, v1 + 3);
+        m_triangles.insert(m_triangles.end(), v2, v2 + 3);
+
+        unsigned int firstX = static_cast<unsigned int>(std::max(minX, 0.f)) / tileSize;
+        unsigned int firstY = static_cast<unsigned int>(std::max(minY, 0.f)) / tileSize;
+        unsigned int lastX  = std::min(static_cast<unsigned int>(std::min(maxX, static_cast<float>(m_width))) / tileSize, tilesX - 1);
+        unsigned int lastY  = std::min(static_cast<unsigned int>(std::min(maxY, static_cast<float>(m_height))) / tileSize, tilesY - 1);
+
+        for (unsigned int y = firstY; y <= lastY; ++y)
+            for (unsigned int x = firstX; x <= lastX; ++x)
+                m_bins[y * tilesX + x].push_back(index);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void OcclusionCuller::rasterizeTile(std::size_t tile)
+{
+    unsigned int tilesX = (m_width + tileSize - 1) / tileSize;
+    unsigned int tileLeft   = static_cast<unsigned int>(tile % tilesX) * tileSize;
+    unsigned int tileTop    = static_cast<unsigned int>(tile / tilesX) * tileSize;
+    unsigned int tileRight  = std::min(tileLeft + tileSize, m_width);
+    unsigned int tileBottom = std::min(tileTop + tileSize, m_height);
+
+    const std::vector<Uint32>& bin = m_bins[tile];
+    for (std::size_t i = 0; i < bin.size(); ++i)
+    {
+        const float* v0 = &m_triangles[bin[i] * 9];
+        const float* v1 = v0 + 3;
+        const float* v2 = v0 + 6;
+
+        // Edge functions, positive inside the triangle: e = a * x + b * y + c
+        float a0 = v1[1] - v2[1], b0 = v2[0] - v1[0], c0 = v1[0] * v2[1] - v1[1] * v2[0];
+        float a1 = v2[1] - v0[1], b1 = v0[0] - v2[0], c1 = v2[0] * v0[1] - v2[1] * v0[0];
+        float a2 = v0[1] - v1[1], b2 = v1[0] - v0[0], c2 = v0[0] * v1[1] - v0[1] * v1[0];
+
+        // The depth is linear in screen space, interpolate it from the barycentric coordinates
+        float invArea = 1.f / (c0 + c1 + c2);
+        float za = (a0 * v0[2] + a1 * v1[2] + a2 * v2[2]) * invArea;
+        float zb = (b0 * v0[2] + b1 * v1[2] + b2 * v2[2]) * invArea;
+        float zc = (c0 * v0[2] + c1 * v1[2] + c2 * v2[2]) * invArea;
+
+        float minX = std::min(v0[0], std::min(v1[0], v2[0]));
+        float maxX = std::max(v0[0], std::max(v1[0], v2[0]));
+        float minY = std::min(v0[1], std::min(v1[1], v2[1]));
+        float maxY = std::max(v0[1], std::max(v1[1], v2[1]));
+
+        // Start on a multiple of 4 pixels, so that the vectors never cross the tile
+        unsigned int left   = std::max(static_cast<unsigned int>(std::max(minX, 0.f)) & ~3u, tileLeft);
+        unsigned int top    = std::max(static_cast<unsigned int>(std::max(minY, 0.f)), tileTop);
+        unsigned int right  = static_cast<unsigned int>(std::min(std::max(maxX + 1.f, 0.f), static_cast<float>(tileRight)));
+        unsigned int bottom = static_cast<unsigned int>(std::min(std::max(maxY + 1.f, 0.f), static_cast<float>(tileBottom)));
+
+        for (unsigned int y = top; y < bottom; ++y)
+        {
+            float py = y + 0.5f;
+            float e0Row = b0 * py + c0;
+            float e1Row = b1 * py + c1;
+            float e2Row = b2 * py + c2;
+            float zRow  = zb * py + zc;
+            float* depth = &m_depth[y * m_width];
+            unsigned int x = left;
+
+#if defined(SFML3D_SIMD_SSE2)
+
+            __m128 offsets = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+            __m128 zero = _mm_setzero_ps();
+            __m128 va0 = _mm_set1_ps(a0);
+            __m128 va1 = _mm_set1_ps(a1);
+            __m128 va2 = _mm_set1_ps(a2);
+            __m128 vza = _mm_set1_ps(za);
+            __m128 ve0 = _mm_set1_ps(e0Row);
+            __m128 ve1 = _mm_set1_ps(e1Row);
+            __m128 ve2 = _mm_set1_ps(e2Row);
+            __m128 vz  = _mm_set1_ps(zRow);
+
+            for (; x + 4 <= right; x += 4)
+            {
+                __m128 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), offsets);
+
+                __m128 inside = _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(va0, px), ve0), zero);
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(va1, px), ve1), zero));
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(va2, px), ve2), zero));
+
+                if (!_mm_movemask_ps(inside))
+                    continue;
+
+                __m128 previous = _mm_loadu_ps(depth + x);
+                __m128 nearest = _mm_min_ps(previous, _mm_add_ps(_mm_mul_ps(vza, px), vz));
+                _mm_storeu_ps(depth + x, _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, previous)));
+            }
+
+#endif
+
+            for (; x < right; ++x)
+            {
+                float px = x + 0.5f;
+                if ((a0 * px + e0Row >= 0.f) && (a1 * px + e1Row >= 0.f) && (a2 * px + e2Row >= 0.f))
+                    depth[x] = std::min(depth[x], za * px + zRow);
+            }
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+bool OcclusionCuller::testBounds(const FloatBox& bounds, bool& nearPlane) const
+{
+    float minX = std::numeric_limits<float>::max(), maxX = -minX;
+    float minY = minX, maxY = maxX;
+    float minZ = 1.f;
+    bool allLeft = true, allRight = true;
+    bool allBelow = true, allAbove = true;
+    bool allFar = true;
+
+    for (std::size_t i = 0; i < 8; ++i)
+    {
+        float clip[4];
+        transformToClip(m_matrix,
+                        bounds.left  + boxCorners[i][0] * bounds.width,
+                        bounds.top   + boxCorners[i][1] * bounds.height,
+                        bounds.front + boxCorners[i][2] * bounds.depth,
+                        clip);
+
+        // The projection of a box crossing the near plane is unbounded, assume it is visible
+        if (clip[2] < -clip[3])
+        {
+            nearPlane = true;
+            return true;
+        }
+
+        allLeft  = allLeft  && (clip[0] < -clip[3]);
+        allRight = allRight && (clip[0] >  clip[3]);
+        allBelow = allBelow && (clip[1] < -clip[3]);
+        allAbove = allAbove && (clip[1] >  clip[3]);
+        allFar   = allFar   && (clip[2] >  clip[3]);
+
+        float invW = 1.f / clip[3];
+        float x = (clip[0] * invW * 0.5f + 0.5f) * m_width;
+        float y = (0.5f - clip[1] * invW * 0.5f) * m_height;
+        minX = std::min(minX, x);
+        maxX = std::max(maxX, x);
+        minY = std::min(minY, y);
+        maxY = std::max(maxY, y);
+        minZ = std::min(minZ, clip[2] * invW);
+    }
+
+    if (allLeft || allRight || allBelow || allAbove || allFar)
+        return false;
+
+    // Grow the area by a pixel, the occluders are only rasterized where they cover pixel centers
+    unsigned int left   = static_cast<unsigned int>(std::max(std::floor(minX) - 1.f, 0.f));
+    unsigned int top    = static_cast<unsigned int>(std::max(std::floor(minY) - 1.f, 0.f));
+    unsigned int right  = static_cast<unsigned int>(std::max(std::min(std::ceil(maxX) + 1.f, static_cast<float>(m_width)), 0.f));
+    unsigned int bottom = static_cast<unsigned int>(std::max(std::min(std::ceil(maxY) + 1.f, static_cast<float>(m_height)), 0.f));
+
+    // The box is hidden if every pixel of its area has an occluder in front of its nearest point
+    for (unsigned int y = top; y < bottom; ++y)
+    {
+        const float* depth = &m_depth[y * m_width];
+        unsigned int x = left;
+
+#if defined(SFML3D_SIMD_SSE2)
+
+        __m128 z = _mm_set1_ps(minZ);
+        for (; x + 4 <= right; x += 4)
+        {
+            if (_mm_movemask_ps(_mm_cmpge_ps(_mm_loadu_ps(depth + x), z)))
+                return true;
+        }
+
+#endif
+
+        for (; x < right; ++x)
+        {
+            if (depth[x] >= minZ)
+                return true;
+        }
+    }
+
+    return false;
+}
+
+} // namespace sf3d
@@ -0,0 +1,137 @@
+////////////////////////////////////////////////////////////
+//
+// SFML3D - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2014 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/Graphics/Parallel.hpp>
+#include <SFML3D/System/Thread.hpp>
+#include <vector>
+#if defined(SFML3D_SYSTEM_WINDOWS)
+    #include <windows.h>
+#else
+    #include <unistd.h>
+#endif
+
+
+namespace
+{
+    // Chunk of a parallel task, executed by one thread
+    struct Chunk
+    {
+        sf3d::priv::ParallelTask* task;
+        std::size_t               begin;
+        std::size_t               end;
+    };
+
+    // Thread entry point
+    void runChunk(Chunk* chunk)
+    {
+        chunk->task->run(chunk->begin, chunk->end);
+    }
+}
+
+
+namespace sf3d
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+unsigned int getProcessorCount()
+{
+    static unsigned int count = 0;
+
+    if (!count)
+    {
+#if defined(SFML3D_SYSTEM_WINDOWS)
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        long processors = static_cast<long>(info.dwNumberOfProcessors);
+#else
+        long processors = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+        count = (processors > 0) ? static_cast<unsigned int>(processors) : 1;
+    }
+
+    return count;
+}
+
+
+////////////////////////////////////////////////////////////
+void parallelFor(ParallelTask& task, std::size_t count, std::size_t grain, unsigned int threadCount)
+{
+    if (!count)
+        return;
+
+    if (!threadCount)
+        threadCount = getProcessorCount();
+
+    if (!grain)
+        grain = 1;
+
+    // Don't create more chunks than there is work for
+    std::size_t chunkCount = (count + grain - 1) / grain;
+    if (chunkCount > threadCount)
+        chunkCount = threadCount;
+
+    if (chunkCount <= 1)
+    {
+        task.run(0, count);
+        return;
+    }
+
+    std::vector<Chunk> chunks(chunkCount);
+    std::size_t chunkSize = count / chunkCount;
+    std::size_t remainder = count % chunkCount;
+    std::size_t begin = 0;
+
+    for (std::size_t i = 0; i < chunkCount; ++i)
+    {
+        chunks[i].task  = &task;
+        chunks[i].begin = begin;
+        chunks[i].end   = begin + chunkSize + (i < remainder ? 1 : 0);
+        begin = chunks[i].end;
+    }
+
+    // Launch the worker threads, the first chunk is processed by the calling thread
+    std::vector<Thread*> threads;
+    threads.reserve(chunkCount - 1);
+    for (std::size_t i = 1; i < chunkCount; ++i)
+    {
+        threads.push_back(new Thread(&runChunk, &chunks[i]));
+        threads.back()->launch();
+    }
+
+    runChunk(&chunks[0]);
+
+    for (std::size_t i = 0; i < threads.size(); ++i)
+    {
+        threads[i]->wait();
+        delete threads[i];
+    }
+}
+
+} // namespace priv
+
+} // namespace sf3d
@@ -0,0 +1,96 @@
+////////////////////////////////////////////////////////////
+//
+// SFML3D - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2014 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+#ifndef SFML3D_PARALLEL_HPP
+#define SFML3D_PARALLEL_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/Config.hpp>
+#include <cstddef>
+
+
+namespace sf3d
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+/// \brief Abstract range of work that can be split across threads
+///
+////////////////////////////////////////////////////////////
+class ParallelTask
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Virtual destructor
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual ~ParallelTask() {}
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Process the elements in range [begin, end)
+    ///
+    /// This function is called concurrently from several threads
+    /// with disjoint ranges, it must not modify shared state
+    /// outside of its range without synchronization.
+    ///
+    /// \param begin Index of the first element to process
+    /// \param end   Index one past the last element to process
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void run(std::size_t begin, std::size_t end) = 0;
+};
+
+////////////////////////////////////////////////////////////
+/// \brief Get the number of processors available to the process
+///
+/// \return Number of logical processors, at least 1
+///
+////////////////////////////////////////////////////////////
+unsigned int getProcessorCount();
+
+////////////////////////////////////////////////////////////
+/// \brief Run a task over [0, count), split across threads
+///
+/// The range is split into contiguous chunks of at least
+/// \a grain elements. The calling thread processes the first
+/// chunk itself, so that small workloads never spawn threads.
+/// The function returns once every chunk has been processed.
+///
+/// \param task        Task to run
+/// \param count       Number of elements to process
+/// \param grain       Minimum number of elements per chunk
+/// \param threadCount Maximum number of threads to use, 0 for one per processor
+///
+////////////////////////////////////////////////////////////
+void parallelFor(ParallelTask& task, std::size_t count, std::size_t grain, unsigned int threadCount = 0);
+
+} // namespace priv
+
+} // namespace sf3d
+
+
+#endif // SFML3D_PARALLEL_HPP
@@ -0,0 +1,454 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/Graphics/ParticleSystem.hpp>
+#include <SFML3D/Graphics/Camera.hpp>
+#include <SFML3D/Graphics/Texture.hpp>
+#include <SFML3D/Graphics/VertexBuffer.hpp>
+#include <SFML3D/Graphics/RenderTarget.hpp>
+#include <SFML3D/Graphics/BillboardAxes.hpp>
+#include <SFML3D/Graphics/Parallel.hpp>
+#include <SFML3D/Graphics/Simd.hpp>
+#include <cmath>
+
+
+namespace
+{
+    // Minimum number of particles processed by a thread
+    const std::size_t updateGrain = 16384;
+    const std::size_t emitGrain = 4096;
+}
+
+
+namespace sf3d
+{
+////////////////////////////////////////////////////////////
+struct ParticleSystem::UpdateTask : priv::ParallelTask
+{
+    UpdateTask(ParticleSystem& theSystem, float theSeconds) : system(theSystem), seconds(theSeconds) {}
+
+    virtual void run(std::size_t begin, std::size_t end)
+    {
+        system.updateParticles(begin, end, seconds);
+    }
+
+    ParticleSystem& system;
+    float           seconds;
+};
+
+
+////////////////////////////////////////////////////////////
+struct ParticleSystem::EmitTask : priv::ParallelTask
+{
+    EmitTask(const ParticleSystem& theSystem, const Vector3f& theViewer, Vertex* theVertices) :
+    system  (theSystem),
+    viewer  (theViewer),
+    vertices(theVertices)
+    {
+    }
+
+    virtual void run(std::size_t begin, std::size_t end)
+    {
+        system.emitQuads(begin, end, viewer, vertices);
+    }
+
+    const ParticleSystem& system;
+    Vector3f              viewer;
+    Vertex*               vertices;
+};
+
+
+////////////////////////////////////////////////////////////
+ParticleSystem::Particle::Particle() :
+position(0.f, 0.f, 0.f),
+velocity(0.f, 0.f, 0.f),
+color   (Color::White),
+size    (1.f),
+lifetime(seconds(1.f))
+{
+}
+
+
+////////////////////////////////////////////////////////////
+ParticleSystem::ParticleSystem() :
+m_acceleration(0.f, 0.f, 0.f),
+m_camera      (NULL),
+m_texture     (NULL),
+m_textureRect (),
+m_threadCount (0),
+m_buffer      (NULL)
+{
+    if (VertexBuffer::isAvailable())
+        m_buffer = new VertexBuffer(Triangles);
+}
+
+
+////////////////////////////////////////////////////////////
+ParticleSystem::~ParticleSystem()
+{
+    delete m_buffer;
+}
+
+
+////////////////////////////////////////////////////////////
+void ParticleSystem::emit(const Particle& particle)
+{
+    m_positionsX.push_back(particle.position.x);
+    m_positionsY.push_back(particle.position.y);
+    m_positionsZ.push_back(particle.position.z);
+    m_velocitiesX.push_back(particle.velocity.x);
+    m_velocitiesY.push_back(particle.velocity.y);
+    m_velocitiesZ.push_back(particle.velocity.z);
+    m_sizes.push_back(particle.size);
+    m_lifetimes.push_back(particle.lifetime.asSeconds());
+    m_colors.push_back(particle.color);
+}
+
+
+////////////////////////////////////////////////////////////
+void ParticleSystem::clear()
+{
+    m_positionsX.clear();
+    m_positionsY.clear();
+    m_positionsZ.clear();
+    m_velocitiesX.clear();
+    m_velocitiesY.clear();
+    m_velocitiesZ.clear();
+    m_sizes.clear();
+    m_lifetimes.clear();
+    m_colors.clear();
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int ParticleSystem::getParticleCount() const
+{
+    return static_cast<unsigned int>(m_lifetimes.size());
+}
+
+
+////////////////////////////////////////////////////////////
+void ParticleSystem::setAcceleration(const Vector3f& acceleration)
+{
+    m_acceleration = acceleration;
+}
+
+
+////////////////////////////////////////////////////////////
+const Vector3f& ParticleSystem::getAcceleration() const
+{
+    return m_acceleration;
+}
+
+
+////////////////////////////////////////////////////////////
+void ParticleSystem::setCamera(const Camera& camera)
+{
+    m_camera = &camera;
+}
+
+
+////////////////////////////////////////////////////////////
+const Camera* ParticleSystem::getCamera() const
+{
+    return m_camera;
+}
+
+
+////////////////////////////////////////////////////////////
+void ParticleSystem::setTexture(const Texture* texture, bool resetRect)
+{
+    // Recompute the texture area if requested, or if there was no valid texture & rect before
+    if (texture && (resetRect || (!m_texture && (m_textureRect == IntRect()))))
+        m_textureRect = IntRect(0, 0, texture->getSize().x, texture->getSize().y);
+
+    m_texture = texture;
+}
+
+
+////////////////////////////////////////////////////////////
+const Texture* ParticleSystem::getTexture() const
+{
+    return m_texture;
+}
+
+
+////////////////////////////////////////////////////////////
+void ParticleSystem::setTextureRect(const IntRect& rectangle)
+{
+    m_textureRect = rectangle;
+}
+
+
+////////////////////////////////////////////////////////////
+const IntRect& ParticleSystem::getTextureRect() const
+{
+    return m_textureRect;
+}
+
+
+////////////////////////////////////////////////////////////
+void ParticleSystem::setThreadCount(unsigned int count)
+{
+    m_threadCount = count;
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int ParticleSystem::getThreadCount() const
+{
+    return m_threadCount;
+}
+
+
+////////////////////////////////////////////////////////////
+void ParticleSystem::update(Time elapsed)
+{
+    UpdateTask task(*this, elapsed.asSeconds());
+    priv::parallelFor(task, m_lifetimes.size(), updateGrain, m_threadCount);
+
+    // Remove the dead particles, iterating backwards so that
+    // the particles moved into the holes were already checked
+    for (std::size_t i = m_lifetimes.size(); i > 0; --i)
+    {
+        if (m_lifetimes[i - 1] <= 0.f)
+            removeParticle(i - 1);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void ParticleSystem::draw(RenderTarget& target, RenderStates states) const
+{
+    std::size_t count = m_lifetimes.size();
+    if (!count)
+        return;
+
+    // The particles face the camera, expressed in the system's local coordinates
+    Vector3f viewer(0.f, 0.f, 0.f);
+    if (m_camera)
+        viewer = getInverseTransform().transformPoint(m_camera->getPosition());
+
+    Vertex* vertices;
+    if (m_buffer)
+    {
+        m_buffer->resize(static_cast<unsigned int>(count * 6));
+        vertices = static_cast<Vertex*>(m_buffer->getPointer());
+    }
+    else
+    {
+        m_vertices.resize(count * 6);
+        vertices = &m_vertices[0];
+    }
+
+    EmitTask task(*this, viewer, vertices);
+    priv::parallelFor(task, count, emitGrain, m_threadCount);
+
+    states.transform *= getTransform();
+    states.texture = m_texture;
+
+    if (m_buffer)
+        target.draw(*m_buffer, states);
+    else
+        target.draw(&m_vertices[0], static_cast<unsigned int>(m_vertices.size()), Triangles, states);
+}
+
+
+////////////////////////////////////////////////////////////
+void ParticleSystem::updateParticles(std::size_t begin, std::size_t end, float seconds)
+{
+    float* px = &m_positionsX[0];
+    float* py = &m_positionsY[0];
+    float* pz = &m_positionsZ[0];
+    float* vx = &m_velocitiesX[0];
+    float* vy = &m_velocitiesY[0];
+    float* vz = &m_velocitiesZ[0];
+    float* life = &m_lifetimes[0];
+
+    float ax = m_acceleration.x * seconds;
+    float ay = m_acceleration.y * seconds;
+    float az = m_acceleration.z * seconds;
+
+    std::size_t i = begin;
+
+#if defined(SFML3D_SIMD_SSE2)
+
+    __m128 dt = _mm_set1_ps(seconds);
+    __m128 dvx = _mm_set1_ps(ax);
+    __m128 dvy = _mm_set1_ps(ay);
+    __m128 dvz = _mm_set1_ps(az);
+
+    for (; i + 4 <= end; i += 4)
+    {
+        __m128 velocityX = _mm_add_ps(_mm_loadu_ps(vx + i), dvx);
+        __m128 velocityY = _mm_add_ps(_mm_loadu_ps(vy + i), dvy);
+        __m128 velocityZ = _mm_add_ps(_mm_loadu_ps(vz + i), dvz);
+
+        _mm_storeu_ps(vx + i, velocityX);
+        _mm_storeu_ps(vy + i, velocityY);
+        _mm_storeu_ps(vz + i, velocityZ);
+
+        _mm_storeu_ps(px + i, _mm_add_ps(_mm_loadu_ps(px + i), _mm_mul_ps(velocityX, dt)));
+        _mm_storeu_ps(py + i, _mm_add_ps(_mm_loadu_ps(py + i), _mm_mul_ps(velocityY, dt)));
+        _mm_storeu_ps(pz + i, _mm_add_ps(_mm_loadu_ps(pz + i), _mm_mul_ps(velocityZ, dt)));
+
+        _mm_storeu_ps(life + i, _mm_sub_ps(_mm_loadu_ps(life + i), dt));
+    }
+
+#endif
+
+    // Remaining particles (or all of them without SIMD support)
+    for (; i < end; ++i)
+    {
+        vx[i] += ax;
+        vy[i] += ay;
+        vz[i] += az;
+
+        px[i] += vx[i] * seconds;
+        py[i] += vy[i] * seconds;
+        pz[i] += vz[i] * seconds;
+
+        life[i] -= seconds;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void ParticleSystem::emitQuads(std::size_t begin, std::size_t end, const Vector3f& viewer, Vertex* vertices) const
+{
+    float left   = static_cast<float>(m_textureRect.left);
+    float right  = left + m_textureRect.width;
+    float top    = static_cast<float>(m_textureRect.top);
+    float bottom = top + m_textureRect.height;
+
+    const Vector2f texCoords[6] =
+    {
+        Vector2f(left, top), Vector2f(left, bottom), Vector2f(right, bottom),
+        Vector2f(left, top), Vector2f(right, bottom), Vector2f(right, top)
+    };
+
+    // Corners of the quad in units of the half size, along the X and Y axes
+    static const float cornersX[6] = {-1.f, -1.f,  1.f, -1.f,  1.f, 1.f};
+    static const float cornersY[6] = { 1.f, -1.f, -1.f,  1.f, -1.f, 1.f};
+
+    std::size_t i = begin;
+
+#if defined(SFML3D_SIMD_SSE2)
+
+    if (m_camera)
+    {
+        // Same basis as sf3d::Billboard, computed for 4 particles at a time
+        __m128 cameraX = _mm_set1_ps(viewer.x);
+        __m128 cameraY = _mm_set1_ps(viewer.y);
+        __m128 cameraZ = _mm_set1_ps(viewer.z);
+        __m128 zero = _mm_setzero_ps();
+        __m128 half = _mm_set1_ps(0.5f);
+
+        for (; i + 4 <= end; i += 4)
+        {
+            __m128 posX = _mm_loadu_ps(&m_positionsX[i]);
+            __m128 posY = _mm_loadu_ps(&m_positionsY[i]);
+            __m128 posZ = _mm_loadu_ps(&m_positionsZ[i]);
+
+            // Z axis towards the camera
+            __m128 zX = _mm_sub_ps(cameraX, posX);
+            __m128 zY = _mm_sub_ps(cameraY, posY);
+            __m128 zZ = _mm_sub_ps(cameraZ, posZ);
+            __m128 zNorm = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(zX, zX), _mm_mul_ps(zY, zY)), _mm_mul_ps(zZ, zZ)));
+            __m128 zValid = _mm_cmpneq_ps(zNorm, zero);
+            __m128 zScale = _mm_and_ps(_mm_div_ps(_mm_set1_ps(1.f), zNorm), zValid);
+            zX = _mm_mul_ps(zX, zScale);
+            zY = _mm_mul_ps(zY, zScale);
+            zZ = _mm_mul_ps(zZ, zScale);
+
+            // Horizontal X axis, falls back to (1, 0, 0) right above or below the camera
+            __m128 xNorm = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(zZ, zZ), _mm_mul_ps(zX, zX)));
+            __m128 xValid = _mm_cmpneq_ps(xNorm, zero);
+            __m128 xScale = _mm_and_ps(_mm_div_ps(_mm_set1_ps(1.f), xNorm), xValid);
+            __m128 xX = _mm_or_ps(_mm_and_ps(xValid, _mm_mul_ps(zZ, xScale)), _mm_andnot_ps(xValid, _mm_set1_ps(1.f)));
+            __m128 xZ = _mm_mul_ps(_mm_sub_ps(zero, zX), xScale);
+
+            // Y axis = Z x X, with X.y == 0
+            __m128 yX = _mm_mul_ps(zY, xZ);
+            __m128 yY = _mm_sub_ps(_mm_mul_ps(zZ, xX), _mm_mul_ps(zX, xZ));
+            __m128 yZ = _mm_sub_ps(zero, _mm_mul_ps(zY, xX));
+
+            // Scale the axes by the half size of the particles
+            __m128 extent = _mm_mul_ps(_mm_loadu_ps(&m_sizes[i]), half);
+
+            float axes[9][4];
+            _mm_storeu_ps(axes[0], _mm_mul_ps(xX, extent));
+            _mm_storeu_ps(axes[1], zero);
+            _mm_storeu_ps(axes[2], _mm_mul_ps(xZ, extent));
+            _mm_storeu_ps(axes[3], _mm_mul_ps(yX, extent));
+            _mm_storeu_ps(axes[4], _mm_mul_ps(yY, extent));
+            _mm_storeu_ps(axes[5], _mm_mul_ps(yZ, extent));
+            _mm_storeu_ps(axes[6], zX);
+            _mm_storeu_ps(axes[7], zY);
+            _mm_storeu_ps(axes[8], zZ);
+
+            for (int k = 0; k < 4; ++k)
+            {
+                Vector3f position(m_positionsX[i + k], m_positionsY[i + k], m_positionsZ[i + k]);
+                Vector3f xAxis(axes[0][k], axes[1][k], axes[2][k]);
+                Vector3f yAxis(axes[3][k], axes[4][k], axes[5][k]);
+                Vector3f normal(axes[6][k], axes[7][k], axes[8][k]);
+                Vertex* quad = vertices + (i + k) * 6;
+
+                for (int c = 0; c < 6; ++c)
+                    quad[c] = Vertex(position + xAxis * cornersX[c] + yAxis * cornersY[c], m_colors[i + k], texCoords[c], normal);
+            }
+        }
+    }
+
+#endif
+
+    // Remaining particles (or all of them without SIMD support or camera)
+    for (; i < end; ++i)
+    {
+        Vector3f position(m_positionsX[i], m_positionsY[i], m_positionsZ[i]);
+        Vector3f xAxis(1.f, 0.f, 0.f);
+        Vector3f yAxis(0.f, 1.f, 0.f);
+        Vector3f zAxis(0.f, 0.f, 1.f);
+
+        if (m_camera)
+            priv::computeBillboardAxes(position, viewer, xAxis, yAxis, zAxis);
+
+        float extent = m_sizes[i] / 2.f;
+        xAxis *= extent;
+        yAxis *= extent;
+
+        Vertex* quad = vertices + i * 6;
+        for (int c = 0; c < 6; ++c)
+            quad[c] = Vertex(position + xAxis * cornersX[c] + yAxis * cornersY[c], m_colors[i], texCoords[c], zAxis);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void ParticleSystem::removeParticle(std::size_t index)
+{
+    std::size_t last = m_lifetimes.size() - 1;
+
+    m_positionsX[index]  = m_positionsX[last];
+    m_positionsY[index]  = m_positionsY[last];
+    m_positionsZ[index]  = m_positionsZ[last];
+    m_velocitiesX[index] = m_velocitiesX[last];
+    m_velocitiesY[index] = m_velocitiesY[last];
+    m_velocitiesZ[index] = m_velocitiesZ[last];
+    m_sizes[index]       = m_sizes[last];
+    m_lifetimes[index]   = m_lifetimes[last];
+    m_colors[index]      = m_colors[last];
+
+    m_positionsX.pop_back();
+    m_positionsY.pop_back();
+    m_positionsZ.pop_back();
+    m_velocitiesX.pop_back();
+    m_velocitiesY.pop_back();
+    m_velocitiesZ.pop_back();
+    m_sizes.pop_back();
+    m_lifetimes.pop_back();
+    m_colors.pop_back();
+}
+
+} // namespace sf3d
@@ -0,0 +1,298 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/Graphics/PixelReader.hpp>
+#include <SFML3D/Graphics/Texture.hpp>
+#include <SFML3D/Graphics/Image.hpp>
+#include <SFML3D/Graphics/GLCheck.hpp>
+#include <SFML3D/Graphics/TextureSaver.hpp>
+#include <SFML3D/Window/Window.hpp>
+#include <cstring>
+
+
+namespace sf3d
+{
+////////////////////////////////////////////////////////////
+struct PixelReader::Request
+{
+    Request() :
+    buffer    (0),
+    bufferSize(0),
+    fence     (0),
+    size      (0, 0),
+    pitch     (0),
+    flipped   (false)
+    {
+    }
+
+    GLuint       buffer;     ///< Pixel buffer object receiving the copy
+    std::size_t  bufferSize; ///< Allocated size of the buffer, in bytes
+    GLsync       fence;      ///< Signaled when the copy has completed
+    Vector2u     size;       ///< Size of the copied area, in pixels
+    unsigned int pitch;      ///< Length of a row in the buffer, in pixels
+    bool         flipped;    ///< Are the rows stored bottom to top?
+    Image        image;      ///< Synchronous copy, when pixel buffers are not supported
+};
+
+
+////////////////////////////////////////////////////////////
+PixelReader::PixelReader(unsigned int bufferCount) :
+m_requests(bufferCount ? bufferCount : 1),
+m_first   (0),
+m_count   (0)
+{
+    for (std::size_t i = 0; i < m_requests.size(); ++i)
+        m_requests[i] = new Request;
+}
+
+
+////////////////////////////////////////////////////////////
+PixelReader::~PixelReader()
+{
+    ensureGlContext();
+
+    for (std::size_t i = 0; i < m_requests.size(); ++i)
+    {
+        if (m_requests[i]->fence)
+            glCheck(glDeleteSync(m_requests[i]->fence));
+
+        if (m_requests[i]->buffer)
+            glCheck(glDeleteBuffersARB(1, &m_requests[i]->buffer));
+
+        delete m_requests[i];
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+bool PixelReader::requestCopy(const Texture& texture)
+{
+    if (!texture.m_texture || !texture.m_size.y || texture.m_size.z)
+        return false;
+
+    Request* request = getFreeRequest();
+    if (!request)
+        return false;
+
+    if (!isAvailable())
+    {
+        request->image = texture.copyToImage();
+        submit(*request);
+        return true;
+    }
+
+    request->flipped = texture.m_pixelsFlipped;
+    request->size = texture.getSize();
+
+    GLint previousFrameBuffer = 0;
+    GLuint frameBuffer = 0;
+    if (GLEW_EXT_framebuffer_object)
+    {
+        // Read exactly the visible area, through a temporary framebuffer
+        glCheck(glGetIntegerv(GL_FRAMEBUFFER_BINDING_EXT, &previousFrameBuffer));
+        glCheck(glGenFramebuffersEXT(1, &frameBuffer));
+        glCheck(glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, frameBuffer));
+        glCheck(glFramebufferTexture2DEXT(GL_FRAMEBUFFER_EXT, GL_COLOR_ATTACHMENT0_EXT, GL_TEXTURE_2D, texture.m_texture, 0));
+
+        if (glCheckFramebufferStatusEXT(GL_FRAMEBUFFER_EXT) == GL_FRAMEBUFFER_COMPLETE_EXT)
+        {
+            request->pitch = request->size.x;
+            prepareBuffer(*request, request->size.x * request->size.y * 4);
+            glCheck(glReadPixels(0, 0, request->size.x, request->size.y, GL_RGBA, GL_UNSIGNED_BYTE, NULL));
+        }
+        else
+        {
+            glCheck(glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, previousFrameBuffer));
+            glCheck(glDeleteFramebuffersEXT(1, &frameBuffer));
+            frameBuffer = 0;
+        }
+    }
+
+    if (!frameBuffer)
+    {
+        // Read the whole texture, padding included
+        priv::TextureSaver save;
+
+        request->pitch = texture.m_actualSize.x;
+        prepareBuffer(*request, texture.m_actualSize.x * texture.m_actualSize.y * 4);
+        glCheck(glBindTexture(GL_TEXTURE_2D, texture.m_texture));
+        glCheck(glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL));
+    }
+    else
+    {
+        glCheck(glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, previousFrameBuffer));
+        glCheck(glDeleteFramebuffersEXT(1, &frameBuffer));
+    }
+
+    glCheck(glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, 0));
+    submit(*request);
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool PixelReader::requestCopy(const Window& window)
+{
+    Request* request = getFreeRequest();
+    if (!request || !window.setActive(true))
+        return false;
+
+    if (!isAvailable())
+    {
+        // Synchronous copy, with a single read of the back buffer
+        Vector2u size = window.getSize();
+        std::vector<Uint8> pixels(size.x * size.y * 4);
+        glCheck(glReadPixels(0, 0, size.x, size.y, GL_RGBA, GL_UNSIGNED_BYTE, &pixels[0]));
+        request->image.create(size.x, size.y, &pixels[0]);
+        request->image.flipVertically();
+        submit(*request);
+        return true;
+    }
+
+    // OpenGL's origin is the bottom left corner
+    request->flipped = true;
+    request->size = window.getSize();
+    request->pitch = request->size.x;
+    prepareBuffer(*request, request->size.x * request->size.y * 4);
+    glCheck(glReadPixels(0, 0, request->size.x, request->size.y, GL_RGBA, GL_UNSIGNED_BYTE, NULL));
+    glCheck(glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, 0));
+    submit(*request);
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool PixelReader::isReady() const
+{
+    if (!m_count)
+        return false;
+
+    const Request& request = *m_requests[m_first];
+    if (!request.fence)
+        return true;
+
+    ensureGlContext();
+
+    // Poll the fence, flushing the commands so that it gets signaled eventually
+    GLenum status = glClientWaitSync(request.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+    return (status == GL_ALREADY_SIGNALED) || (status == GL_CONDITION_SATISFIED);
+}
+
+
+////////////////////////////////////////////////////////////
+bool PixelReader::fetch(Image& image, bool wait)
+{
+    if (!m_count || (!wait && !isReady()))
+        return false;
+
+    Request& request = *m_requests[m_first];
+    m_first = (m_first + 1) % m_requests.size();
+    --m_count;
+
+    if (!request.buffer)
+    {
+        // Synchronous copy
+        image = request.image;
+        request.image = Image();
+        return true;
+    }
+
+    ensureGlContext();
+
+    if (request.fence)
+    {
+        glCheck(glDeleteSync(request.fence));
+        request.fence = 0;
+    }
+
+    // Mapping the buffer waits for the copy if it is still running
+    glCheck(glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, request.buffer));
+    const Uint8* data = static_cast<const Uint8*>(glMapBufferARB(GL_PIXEL_PACK_BUFFER_ARB, GL_READ_ONLY_ARB));
+    if (data)
+    {
+        std::vector<Uint8> pixels(request.size.x * request.size.y * 4);
+        std::size_t rowSize = request.size.x * 4;
+        for (unsigned int y = 0; y < request.size.y; ++y)
+        {
+            unsigned int row = request.flipped ? request.size.y - 1 - y : y;
+            std::memcpy(&pixels[y * rowSize], data + row * request.pitch * 4, rowSize);
+        }
+
+        glCheck(glUnmapBufferARB(GL_PIXEL_PACK_BUFFER_ARB));
+        image.create(request.size.x, request.size.y, &pixels[0]);
+    }
+    glCheck(glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, 0));
+
+    return data != NULL;
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int PixelReader::getPendingCount() const
+{
+    return static_cast<unsigned int>(m_count);
+}
+
+
+////////////////////////////////////////////////////////////
+bool PixelReader::isAvailable()
+{
+    static bool checked = false;
+    static bool pixelBuffersSupported = false;
+    if (!checked)
+    {
+        checked = true;
+
+        ensureGlContext();
+
+        // Make sure that GLEW is initialized
+        priv::ensureGlewInit();
+
+        pixelBuffersSupported = (GLEW_ARB_pixel_buffer_object != 0);
+    }
+
+    return pixelBuffersSupported;
+}
+
+
+////////////////////////////////////////////////////////////
+PixelReader::Request* PixelReader::getFreeRequest()
+{
+    if (m_count == m_requests.size())
+        return NULL;
+
+    ensureGlContext();
+
+    return m_requests[(m_first + m_count) % m_requests.size()];
+}
+
+
+////////////////////////////////////////////////////////////
+void PixelReader::prepareBuffer(Request& request, std::size_t size)
+{
+    if (!request.buffer)
+        glCheck(glGenBuffersARB(1, &request.buffer));
+
+    glCheck(glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, request.buffer));
+
+    // Only reallocate the storage when the size changes
+    if (request.bufferSize != size)
+    {
+        glCheck(glBufferDataARB(GL_PIXEL_PACK_BUFFER_ARB, size, NULL, GL_STREAM_READ_ARB));
+        request.bufferSize = size;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void PixelReader::submit(Request& request)
+{
+    if (request.buffer && GLEW_ARB_sync)
+        request.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    ++m_count;
+}
+
+} // namespace sf3d
@@ -0,0 +1,176 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/Graphics/PixelWriter.hpp>
+#include <SFML3D/Graphics/Texture.hpp>
+#include <SFML3D/Graphics/Image.hpp>
+#include <SFML3D/Graphics/GLCheck.hpp>
+#include <SFML3D/System/Err.hpp>
+#include <algorithm>
+#include <cstring>
+
+
+namespace sf3d
+{
+////////////////////////////////////////////////////////////
+PixelWriter::PixelWriter(unsigned int bufferCount) :
+m_buffers   (bufferCount ? bufferCount : 1, 0),
+m_sizes     (m_buffers.size(), 0),
+m_current   (0),
+m_mappedSize(0, 0),
+m_pixels    ()
+{
+}
+
+
+////////////////////////////////////////////////////////////
+PixelWriter::~PixelWriter()
+{
+    ensureGlContext();
+
+    if (m_mappedSize.x)
+    {
+        glCheck(glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, m_buffers[m_current]));
+        glCheck(glUnmapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB));
+        glCheck(glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0));
+    }
+
+    for (std::size_t i = 0; i < m_buffers.size(); ++i)
+    {
+        if (m_buffers[i])
+        {
+            GLuint buffer = static_cast<GLuint>(m_buffers[i]);
+            glCheck(glDeleteBuffersARB(1, &buffer));
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+Uint8* PixelWriter::map(unsigned int width, unsigned int height)
+{
+    if (!width || !height)
+        return NULL;
+
+    if (m_mappedSize.x)
+    {
+        err() << "Failed to map pixel writer, the previous pixels were not uploaded" << std::endl;
+        return NULL;
+    }
+
+    std::size_t size = width * height * 4;
+
+    if (!isAvailable())
+    {
+        m_pixels.resize(size);
+        m_mappedSize = Vector2u(width, height);
+        return &m_pixels[0];
+    }
+
+    ensureGlContext();
+
+    if (!m_buffers[m_current])
+    {
+        GLuint buffer;
+        glCheck(glGenBuffersARB(1, &buffer));
+        m_buffers[m_current] = static_cast<unsigned int>(buffer);
+    }
+
+    // Orphan the previous storage of the buffer, so that mapping it never
+    // waits for the graphics card to finish an upload still reading from it
+    glCheck(glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, m_buffers[m_current]));
+    glCheck(glBufferDataARB(GL_PIXEL_UNPACK_BUFFER_ARB, std::max(size, m_sizes[m_current]), NULL, GL_STREAM_DRAW_ARB));
+    m_sizes[m_current] = std::max(size, m_sizes[m_current]);
+
+    Uint8* pixels = static_cast<Uint8*>(glMapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, GL_WRITE_ONLY_ARB));
+    glCheck(glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0));
+
+    if (pixels)
+        m_mappedSize = Vector2u(width, height);
+
+    return pixels;
+}
+
+
+////////////////////////////////////////////////////////////
+bool PixelWriter::upload(Texture& texture, unsigned int x, unsigned int y)
+{
+    if (!m_mappedSize.x)
+        return false;
+
+    Vector2u size = m_mappedSize;
+    m_mappedSize = Vector2u(0, 0);
+
+    Vector2u textureSize = texture.getSize();
+    bool fits = texture.m_texture && textureSize.y && !texture.m_size.z &&
+                (x + size.x <= textureSize.x) && (y + size.y <= textureSize.y);
+
+    if (!isAvailable())
+    {
+        if (fits)
+            texture.update(&m_pixels[0], size.x, size.y, x, y);
+        return fits;
+    }
+
+    ensureGlContext();
+
+    glCheck(glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, m_buffers[m_current]));
+    bool unmapped = glUnmapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB) == GL_TRUE;
+
+    // Copy from the buffer (offset 0) to the texture
+    if (fits && unmapped)
+        texture.updateFromPixelBuffer(size.x, size.y, x, y);
+
+    glCheck(glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0));
+
+    // Move on to the next buffer of the ring
+    m_current = (m_current + 1) % m_buffers.size();
+
+    return fits && unmapped;
+}
+
+
+////////////////////////////////////////////////////////////
+bool PixelWriter::update(Texture& texture, const Uint8* pixels, unsigned int width, unsigned int height, unsigned int x, unsigned int y)
+{
+    if (!pixels)
+        return false;
+
+    Uint8* destination = map(width, height);
+    if (!destination)
+        return false;
+
+    std::memcpy(destination, pixels, width * height * 4);
+
+    return upload(texture, x, y);
+}
+
+
+////////////////////////////////////////////////////////////
+bool PixelWriter::update(Texture& texture, const Image& image, unsigned int x, unsigned int y)
+{
+    return update(texture, image.getPixelsPtr(), image.getSize().x, image.getSize().y, x, y);
+}
+
+
+////////////////////////////////////////////////////////////
+bool PixelWriter::isAvailable()
+{
+    static bool checked = false;
+    static bool pixelBuffersSupported = false;
+    if (!checked)
+    {
+        checked = true;
+
+        ensureGlContext();
+
+        // Make sure that GLEW is initialized
+        priv::ensureGlewInit();
+
+        pixelBuffersSupported = (GLEW_ARB_pixel_buffer_object != 0);
+    }
+
+    return pixelBuffersSupported;
+}
+
+} // namespace sf3d
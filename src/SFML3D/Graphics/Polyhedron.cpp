@@ -4,7 +4,10 @@
 #include <SFML3D/Graphics/Polyhedron.hpp>
 #include <SFML3D/Graphics/RenderTarget.hpp>
 #include <SFML3D/Graphics/Texture.hpp>
+#include <SFML3D/Graphics/Parallel.hpp>
 #include <SFML3D/System/Err.hpp>
+#include <algorithm>
+#include <vector>
 #include <cmath>
 
 
@@ -23,6 +26,146 @@ namespace
             normal /= length;
         return normal;
     }
+
+    // Minimum number of vertices processed by a thread when generating normals
+    const std::size_t normalGrain = 16384;
+
+    // Compute the flat normal and the corner angles of a range of faces
+    struct FaceNormalTask : sf3d::priv::ParallelTask
+    {
+        virtual void run(std::size_t begin, std::size_t end)
+        {
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                const sf3d::Vector3f& p0 = vertices[i * 3 + 0].position;
+                const sf3d::Vector3f& p1 = vertices[i * 3 + 1].position;
+                const sf3d::Vector3f& p2 = vertices[i * 3 + 2].position;
+
+                (*normals)[i] = computeNormal(p2 - p1, p0 - p1);
+
+                (*angles)[i * 3 + 0] = cornerAngle(p1 - p0, p2 - p0);
+                (*angles)[i * 3 + 1] = cornerAngle(p2 - p1, p0 - p1);
+                (*angles)[i * 3 + 2] = cornerAngle(p0 - p2, p1 - p2);
+            }
+        }
+
+        static float cornerAngle(const sf3d::Vector3f& u, const sf3d::Vector3f& v)
+        {
+            float lengths = std::sqrt((u.x * u.x + u.y * u.y + u.z * u.z) * (v.x * v.x + v.y * v.y + v.z * v.z));
+            if (lengths == 0.f)
+                return 0.f;
+
+            float cosine = (u.x * v.x + u.y * v.y + u.z * v.z) / lengths;
+            return std::acos(std::max(-1.f, std::min(cosine, 1.f)));
+        }
+
+        const sf3d::Vertex*          vertices;
+        std::vector<sf3d::Vector3f>* normals;
+        std::vector<float>*          angles;
+    };
+
+    // Average the normals of the faces sharing each vertex of a range
+    struct SmoothNormalTask : sf3d::priv::ParallelTask
+    {
+        virtual void run(std::size_t begin, std::size_t end)
+        {
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                const sf3d::Vector3f& faceNormal = normals[i / 3];
+                sf3d::Vector3f normal;
+
+                // Walk the ring of vertices welded to this one
+                std::size_t j = i;
+                do
+                {
+                    const sf3d::Vector3f& other = normals[j / 3];
+                    if (faceNormal.x * other.x + faceNormal.y * other.y + faceNormal.z * other.z >= threshold)
+                        normal += other * angles[j];
+
+                    j = next[j];
+                }
+                while (j != i);
+
+                float length = std::sqrt(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+                vertices[i].normal = (length != 0.f) ? normal / length : faceNormal;
+            }
+        }
+
+        sf3d::Vertex*         vertices;
+        const sf3d::Vector3f* normals;
+        const float*          angles;
+        const std::size_t*    next;
+        float                 threshold;
+    };
+
+    // Link the vertices sharing the same position into rings,
+    // next[i] is the index of the following vertex in the ring of i
+    void weldVertices(const std::vector<sf3d::Vertex>& vertices, std::vector<std::size_t>& next)
+    {
+        std::size_t count = vertices.size();
+
+        // Quantize the positions relative to the bounds, so that
+        // nearly coincident vertices fall in the same cell
+        sf3d::Vector3f minimum = vertices[0].position;
+        sf3d::Vector3f maximum = vertices[0].position;
+        for (std::size_t i = 1; i < count; ++i)
+        {
+            const sf3d::Vector3f& p = vertices[i].position;
+            minimum.x = std::min(minimum.x, p.x); maximum.x = std::max(maximum.x, p.x);
+            minimum.y = std::min(minimum.y, p.y); maximum.y = std::max(maximum.y, p.y);
+            minimum.z = std::min(minimum.z, p.z); maximum.z = std::max(maximum.z, p.z);
+        }
+
+        float extent = std::max(maximum.x - minimum.x, std::max(maximum.y - minimum.y, maximum.z - minimum.z));
+        float scale = (extent > 0.f) ? 1000000.f / extent : 1.f;
+
+        std::vector<sf3d::Int32> keys(count * 3);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const sf3d::Vector3f& p = vertices[i].position;
+            keys[i * 3 + 0] = static_cast<sf3d::Int32>((p.x - minimum.x) * scale + 0.5f);
+            keys[i * 3 + 1] = static_cast<sf3d::Int32>((p.y - minimum.y) * scale + 0.5f);
+            keys[i * 3 + 2] = static_cast<sf3d::Int32>((p.z - minimum.z) * scale + 0.5f);
+        }
+
+        // Open addressing hash table storing the first vertex of each position
+        std::size_t tableSize = 1;
+        while (tableSize < count * 2)
+            tableSize <<= 1;
+
+        const std::size_t empty = static_cast<std::size_t>(-1);
+        std::vector<std::size_t> table(tableSize, empty);
+
+        next.resize(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const sf3d::Int32* key = &keys[i * 3];
+            sf3d::Uint32 hash = (static_cast<sf3d::Uint32>(key[0]) * 73856093u) ^
+                                (static_cast<sf3d::Uint32>(key[1]) * 19349663u) ^
+                                (static_cast<sf3d::Uint32>(key[2]) * 83492791u);
+
+            std::size_t slot = hash & (tableSize - 1);
+            while ((table[slot] != empty) &&
+                   ((keys[table[slot] * 3 + 0] != key[0]) ||
+                    (keys[table[slot] * 3 + 1] != key[1]) ||
+                    (keys[table[slot] * 3 + 2] != key[2])))
+                slot = (slot + 1) & (tableSize - 1);
+
+            if (table[slot] == empty)
+            {
+                // First vertex at this position, start a new ring
+                table[slot] = i;
+                next[i] = i;
+            }
+            else
+            {
+                // Insert the vertex in the existing ring
+                std::size_t first = table[slot];
+                next[i] = next[first];
+                next[first] = i;
+            }
+        }
+    }
 }
 
 
@@ -64,6 +207,20 @@ const Texture* Polyhedron::getTexture() const
 }
 
 
+////////////////////////////////////////////////////////////
+void Polyhedron::getFaces(Vertex* vertices, unsigned int first, unsigned int count) const
+{
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        Face face = getFace(first + i);
+
+        vertices[i * 3 + 0] = face.v0;
+        vertices[i * 3 + 1] = face.v1;
+        vertices[i * 3 + 2] = face.v2;
+    }
+}
+
+
 ////////////////////////////////////////////////////////////
 FloatBox Polyhedron::getLocalBounds() const
 {
@@ -99,17 +256,10 @@ void Polyhedron::update() const
         return;
     }
 
+    // Gather the vertices directly into the container, whose storage is contiguous
+    // and keeps its capacity when the face count doesn't change
     m_vertices.resize(count * 3);
-
-    // Vertices
-    for (unsigned int i = 0; i < count; ++i)
-    {
-        Face face = getFace(i);
-
-        m_vertices[i * 3 + 0] = face.v0;
-        m_vertices[i * 3 + 1] = face.v1;
-        m_vertices[i * 3 + 2] = face.v2;
-    }
+    getFaces(&m_vertices[0], 0, count);
 
     // Update the bounding rectangle
     m_insideBounds = m_vertices.getBounds();
@@ -146,6 +296,45 @@ void Polyhedron::generateNormals()
 }
 
 
+////////////////////////////////////////////////////////////
+void Polyhedron::generateSmoothNormals(float creaseAngle)
+{
+    std::size_t vertexCount = m_vertices.getVertexCount() / 3 * 3;
+    if (!vertexCount)
+        return;
+
+    const VertexContainer& source = m_vertices;
+    std::vector<Vertex> vertices(vertexCount);
+    for (std::size_t i = 0; i < vertexCount; ++i)
+        vertices[i] = source[static_cast<unsigned int>(i)];
+
+    // Flat normals and corner angles of every face
+    std::vector<Vector3f> normals(vertexCount / 3);
+    std::vector<float> angles(vertexCount);
+
+    FaceNormalTask faceTask;
+    faceTask.vertices = &vertices[0];
+    faceTask.normals  = &normals;
+    faceTask.angles   = &angles;
+    priv::parallelFor(faceTask, normals.size(), normalGrain / 3);
+
+    // Find the vertices that share a position
+    std::vector<std::size_t> next;
+    weldVertices(vertices, next);
+
+    // Accumulate the angle-weighted normals of the neighbouring faces
+    SmoothNormalTask smoothTask;
+    smoothTask.vertices  = &vertices[0];
+    smoothTask.normals   = &normals[0];
+    smoothTask.angles    = &angles[0];
+    smoothTask.next      = &next[0];
+    smoothTask.threshold = (creaseAngle >= 180.f) ? -2.f : std::cos(creaseAngle * 3.141592654f / 180.f) - 0.0001f;
+    priv::parallelFor(smoothTask, vertexCount, normalGrain);
+
+    m_vertices.assign(&vertices[0], static_cast<unsigned int>(vertexCount));
+}
+
+
 ////////////////////////////////////////////////////////////
 void Polyhedron::updateColors()
 {
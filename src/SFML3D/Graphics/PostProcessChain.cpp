@@ -0,0 +1,257 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/Graphics/PostProcessChain.hpp>
+#include <SFML3D/Graphics/Shader.hpp>
+#include <SFML3D/Graphics/Vertex.hpp>
+#include <SFML3D/Graphics/GLCheck.hpp>
+#include <SFML3D/System/Clock.hpp>
+#include <SFML3D/System/Err.hpp>
+#include <algorithm>
+#include <cassert>
+
+
+namespace
+{
+    // Size of a pixel in each render texture format, in bytes
+    const std::size_t pixelSizes[] = {4, 8, 16, 4, 4};
+}
+
+
+namespace sf3d
+{
+////////////////////////////////////////////////////////////
+struct PostProcessChain::Pass
+{
+    const Shader* shader; ///< Shader drawing the pass
+    float         scale;  ///< Size of the output, relative to the source
+    Time          time;   ///< Duration of the pass during the last apply
+};
+
+
+////////////////////////////////////////////////////////////
+struct PostProcessChain::Target
+{
+    RenderTexture texture; ///< Render texture of the pool
+    bool          inUse;   ///< Is the texture holding the input or output of a pass?
+    bool          used;    ///< Was the texture needed by the current apply?
+};
+
+
+////////////////////////////////////////////////////////////
+PostProcessChain::PostProcessChain() :
+m_format   (RenderTexture::Rgba8),
+m_profiling(false)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+PostProcessChain::~PostProcessChain()
+{
+    clearPasses();
+    releaseTextures();
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t PostProcessChain::addPass(const Shader& shader, float scale)
+{
+    Pass* pass = new Pass;
+    pass->shader = &shader;
+    pass->scale = scale;
+    m_passes.push_back(pass);
+
+    return m_passes.size() - 1;
+}
+
+
+////////////////////////////////////////////////////////////
+void PostProcessChain::clearPasses()
+{
+    for (std::size_t i = 0; i < m_passes.size(); ++i)
+        delete m_passes[i];
+
+    m_passes.clear();
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t PostProcessChain::getPassCount() const
+{
+    return m_passes.size();
+}
+
+
+////////////////////////////////////////////////////////////
+void PostProcessChain::setFormat(RenderTexture::Format format)
+{
+    if (format != m_format)
+    {
+        m_format = format;
+        releaseTextures();
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+RenderTexture::Format PostProcessChain::getFormat() const
+{
+    return m_format;
+}
+
+
+////////////////////////////////////////////////////////////
+void PostProcessChain::setProfilingEnabled(bool enabled)
+{
+    m_profiling = enabled;
+}
+
+
+////////////////////////////////////////////////////////////
+bool PostProcessChain::isProfilingEnabled() const
+{
+    return m_profiling;
+}
+
+
+////////////////////////////////////////////////////////////
+const Texture& PostProcessChain::apply(const Texture& source)
+{
+    for (std::size_t i = 0; i < m_targets.size(); ++i)
+    {
+        m_targets[i]->inUse = false;
+        m_targets[i]->used = false;
+    }
+
+    Vector2u sourceSize = source.getSize();
+    const Texture* input = &source;
+    Target* inputTarget = NULL;
+    Clock clock;
+
+    for (std::size_t i = 0; i < m_passes.size(); ++i)
+    {
+        Pass& pass = *m_passes[i];
+
+        Vector2u size(std::max(static_cast<unsigned int>(sourceSize.x * pass.scale + 0.5f), 1u),
+                      std::max(static_cast<unsigned int>(sourceSize.y * pass.scale + 0.5f), 1u));
+        Target* output = acquireTarget(size);
+        if (!output)
+            return source;
+
+        // Draw a single triangle covering the whole output; the input is
+        // mapped so that its [0, size] area covers the output exactly
+        Vector2f outputSize(static_cast<float>(size.x), static_cast<float>(size.y));
+        Vector2f inputSize(static_cast<float>(input->getSize().x), static_cast<float>(input->getSize().y));
+        Vertex vertices[3] =
+        {
+            Vertex(Vector3f(0, 0, 0), Vector2f(0, 0)),
+            Vertex(Vector3f(outputSize.x * 2, 0, 0), Vector2f(inputSize.x * 2, 0)),
+            Vertex(Vector3f(0, outputSize.y * 2, 0), Vector2f(0, inputSize.y * 2))
+        };
+
+        RenderStates states(pass.shader);
+        states.texture = input;
+        states.blendMode = BlendNone;
+        output->texture.draw(vertices, 3, Triangles, states);
+        output->texture.display();
+
+        // Wait for the graphics card, so that the timing includes the execution of the pass
+        if (m_profiling)
+            glCheck(glFinish());
+
+        pass.time = clock.restart();
+
+        // The input has been consumed, it can be the output of the next pass
+        if (inputTarget)
+            inputTarget->inUse = false;
+
+        inputTarget = output;
+        input = &output->texture.getTexture();
+    }
+
+    // Release the render textures that this apply didn't need, the source size probably changed
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < m_targets.size(); ++i)
+    {
+        if (m_targets[i]->used)
+            m_targets[count++] = m_targets[i];
+        else
+            delete m_targets[i];
+    }
+    m_targets.resize(count);
+
+    return *input;
+}
+
+
+////////////////////////////////////////////////////////////
+Time PostProcessChain::getPassTime(std::size_t index) const
+{
+    assert(index < m_passes.size());
+
+    return m_passes[index]->time;
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t PostProcessChain::getMemoryUsage() const
+{
+    std::size_t size = 0;
+    for (std::size_t i = 0; i < m_targets.size(); ++i)
+    {
+        Vector2u targetSize = m_targets[i]->texture.getSize();
+        size += static_cast<std::size_t>(targetSize.x) * targetSize.y * pixelSizes[m_format];
+    }
+
+    return size;
+}
+
+
+////////////////////////////////////////////////////////////
+void PostProcessChain::releaseTextures()
+{
+    for (std::size_t i = 0; i < m_targets.size(); ++i)
+        delete m_targets[i];
+
+    m_targets.clear();
+}
+
+
+////////////////////////////////////////////////////////////
+PostProcessChain::Target* PostProcessChain::acquireTarget(const Vector2u& size)
+{
+    // Reuse a free render texture of the same size
+    for (std::size_t i = 0; i < m_targets.size(); ++i)
+    {
+        Target* target = m_targets[i];
+        if (!target->inUse && (target->texture.getSize() == size))
+        {
+            target->inUse = true;
+            target->used = true;
+            return target;
+        }
+    }
+
+    // None available: create a new one
+    RenderTexture::Settings settings;
+    settings.colorFormats[0] = m_format;
+
+    Target* target = new Target;
+    if (!target->texture.create(size.x, size.y, settings))
+    {
+        delete target;
+        err() << "Failed to apply post-processing chain (the render texture of a pass couldn't be created)" << std::endl;
+        return NULL;
+    }
+
+    // Smooth filtering gives bilinear taps when passes change resolution
+    target->texture.setSmooth(true);
+    target->inUse = true;
+    target->used = true;
+    m_targets.push_back(target);
+
+    return target;
+}
+
+} // namespace sf3d
@@ -0,0 +1,189 @@
+////////////////////////////////////////////////////////////
+//
+// SFML3D - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2014 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/Graphics/RectanglePacker.hpp>
+#include <algorithm>
+
+
+namespace
+{
+    // Check whether a rectangle is entirely inside another one
+    bool isContained(const sf3d::IntRect& inner, const sf3d::IntRect& outer)
+    {
+        return (inner.left >= outer.left) && (inner.top >= outer.top) &&
+               (inner.left + inner.width <= outer.left + outer.width) &&
+               (inner.top + inner.height <= outer.top + outer.height);
+    }
+}
+
+
+namespace sf3d
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+RectanglePacker::RectanglePacker() :
+m_width         (0),
+m_height        (0),
+m_freeRectangles(),
+m_usedArea      (0)
+{
+
+}
+
+
+////////////////////////////////////////////////////////////
+void RectanglePacker::reset(unsigned int width, unsigned int height)
+{
+    m_width = width;
+    m_height = height;
+    m_usedArea = 0;
+    m_freeRectangles.clear();
+    m_freeRectangles.push_back(IntRect(0, 0, width, height));
+}
+
+
+////////////////////////////////////////////////////////////
+bool RectanglePacker::insert(unsigned int width, unsigned int height, bool allowRotation, IntRect& rectangle, bool& rotated)
+{
+    if (!width || !height)
+        return false;
+
+    int w = static_cast<int>(width);
+    int h = static_cast<int>(height);
+
+    // Find the free rectangle leaving the shortest leftover side
+    int bestShortSide = -1;
+    int bestLongSide = 0;
+    for (std::vector<IntRect>::const_iterator it = m_freeRectangles.begin(); it != m_freeRectangles.end(); ++it)
+    {
+        for (int orientation = 0; orientation < (allowRotation ? 2 : 1); ++orientation)
+        {
+            int placedWidth = orientation ? h : w;
+            int placedHeight = orientation ? w : h;
+            if ((placedWidth > it->width) || (placedHeight > it->height))
+                continue;
+
+            int leftoverX = it->width - placedWidth;
+            int leftoverY = it->height - placedHeight;
+            int shortSide = std::min(leftoverX, leftoverY);
+            int longSide = std::max(leftoverX, leftoverY);
+            if ((bestShortSide < 0) || (shortSide < bestShortSide) || ((shortSide == bestShortSide) && (longSide < bestLongSide)))
+            {
+                bestShortSide = shortSide;
+                bestLongSide = longSide;
+                rectangle = IntRect(it->left, it->top, placedWidth, placedHeight);
+                rotated = orientation != 0;
+            }
+        }
+    }
+
+    if (bestShortSide < 0)
+        return false;
+
+    splitFreeRectangles(rectangle);
+    pruneFreeRectangles();
+    m_usedArea += width * height;
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+float RectanglePacker::getOccupancy() const
+{
+    if (!m_width || !m_height)
+        return 0.f;
+
+    return static_cast<float>(m_usedArea) / (static_cast<float>(m_width) * m_height);
+}
+
+
+////////////////////////////////////////////////////////////
+void RectanglePacker::splitFreeRectangles(const IntRect& used)
+{
+    std::vector<IntRect> rectangles;
+    rectangles.reserve(m_freeRectangles.size() + 4);
+
+    for (std::vector<IntRect>::const_iterator it = m_freeRectangles.begin(); it != m_freeRectangles.end(); ++it)
+    {
+        const IntRect& free = *it;
+        if (!free.intersects(used))
+        {
+            rectangles.push_back(free);
+            continue;
+        }
+
+        // Replace the free rectangle with the (overlapping) parts around the used one
+        if (used.left > free.left)
+            rectangles.push_back(IntRect(free.left, free.top, used.left - free.left, free.height));
+        if (used.left + used.width < free.left + free.width)
+            rectangles.push_back(IntRect(used.left + used.width, free.top, free.left + free.width - used.left - used.width, free.height));
+        if (used.top > free.top)
+            rectangles.push_back(IntRect(free.left, free.top, free.width, used.top - free.top));
+        if (used.top + used.height < free.top + free.height)
+            rectangles.push_back(IntRect(free.left, used.top + used.height, free.width, free.top + free.height - used.top - used.height));
+    }
+
+    m_freeRectangles.swap(rectangles);
+}
+
+
+////////////////////////////////////////////////////////////
+void RectanglePacker::pruneFreeRectangles()
+{
+    std::size_t i = 0;
+    while (i < m_freeRectangles.size())
+    {
+        bool removed = false;
+        for (std::size_t j = i + 1; j < m_freeRectangles.size(); )
+        {
+            if (isContained(m_freeRectangles[i], m_freeRectangles[j]))
+            {
+                m_freeRectangles.erase(m_freeRectangles.begin() + i);
+                removed = true;
+                break;
+            }
+            else if (isContained(m_freeRectangles[j], m_freeRectangles[i]))
+            {
+                m_freeRectangles.erase(m_freeRectangles.begin() + j);
+            }
+            else
+            {
+                ++j;
+            }
+        }
+
+        if (!removed)
+            ++i;
+    }
+}
+
+} // namespace priv
+
+} // namespace sf3d
@@ -0,0 +1,125 @@
+////////////////////////////////////////////////////////////
+//
+// SFML3D - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2014 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef SFML3D_RECTANGLEPACKER_HPP
+#define SFML3D_RECTANGLEPACKER_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/Graphics/Rect.hpp>
+#include <vector>
+
+
+namespace sf3d
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+/// \brief Packs rectangles into a fixed area with the MaxRects algorithm
+///
+/// The packer keeps the list of maximal free rectangles of the
+/// area, and places every new rectangle in the free rectangle
+/// that it fits the most tightly (best short side fit).
+///
+////////////////////////////////////////////////////////////
+class RectanglePacker
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// Creates a packer with an empty area.
+    ///
+    ////////////////////////////////////////////////////////////
+    RectanglePacker();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove all the rectangles and set the size of the area
+    ///
+    /// \param width  Width of the area
+    /// \param height Height of the area
+    ///
+    ////////////////////////////////////////////////////////////
+    void reset(unsigned int width, unsigned int height);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Find a place for a new rectangle
+    ///
+    /// When \a allowRotation is true, the rectangle may be
+    /// placed rotated by 90 degrees, in which case the returned
+    /// rectangle has its width and height swapped.
+    ///
+    /// \param width         Width of the rectangle
+    /// \param height        Height of the rectangle
+    /// \param allowRotation Can the rectangle be rotated?
+    /// \param rectangle     Receives the placed rectangle
+    /// \param rotated       Receives whether the rectangle was rotated
+    ///
+    /// \return True if the rectangle was placed, false if there is no room left
+    ///
+    ////////////////////////////////////////////////////////////
+    bool insert(unsigned int width, unsigned int height, bool allowRotation, IntRect& rectangle, bool& rotated);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the ratio of the area covered by rectangles
+    ///
+    /// \return Occupancy, in range [0, 1]
+    ///
+    ////////////////////////////////////////////////////////////
+    float getOccupancy() const;
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove a used rectangle from the free rectangles
+    ///
+    /// \param used Rectangle that was just placed
+    ///
+    ////////////////////////////////////////////////////////////
+    void splitFreeRectangles(const IntRect& used);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove the free rectangles contained in others
+    ///
+    ////////////////////////////////////////////////////////////
+    void pruneFreeRectangles();
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    unsigned int         m_width;          ///< Width of the area
+    unsigned int         m_height;         ///< Height of the area
+    std::vector<IntRect> m_freeRectangles; ///< Maximal free rectangles
+    std::size_t          m_usedArea;       ///< Area covered by the placed rectangles
+};
+
+} // namespace priv
+
+} // namespace sf3d
+
+
+#endif // SFML3D_RECTANGLEPACKER_HPP
@@ -40,7 +40,8 @@ RenderStates::RenderStates() :
 blendMode(BlendAlpha),
 transform(),
 texture  (NULL),
-shader   (NULL)
+shader   (NULL),
+material (NULL)
 {
 }
 
@@ -50,7 +51,8 @@ RenderStates::RenderStates(const Transform& theTransform) :
 blendMode(BlendAlpha),
 transform(theTransform),
 texture  (NULL),
-shader   (NULL)
+shader   (NULL),
+material (NULL)
 {
 }
 
@@ -60,7 +62,8 @@ RenderStates::RenderStates(BlendMode theBlendMode) :
 blendMode(theBlendMode),
 transform(),
 texture  (NULL),
-shader   (NULL)
+shader   (NULL),
+material (NULL)
 {
 }
 
@@ -70,7 +73,8 @@ RenderStates::RenderStates(const Texture* theTexture) :
 blendMode(BlendAlpha),
 transform(),
 texture  (theTexture),
-shader   (NULL)
+shader   (NULL),
+material (NULL)
 {
 }
 
@@ -80,7 +84,19 @@ RenderStates::RenderStates(const Shader* theShader) :
 blendMode(BlendAlpha),
 transform(),
 texture  (NULL),
-shader   (theShader)
+shader   (theShader),
+material (NULL)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+RenderStates::RenderStates(const Material* theMaterial) :
+blendMode(BlendAlpha),
+transform(),
+texture  (NULL),
+shader   (NULL),
+material (theMaterial)
 {
 }
 
@@ -91,7 +107,8 @@ RenderStates::RenderStates(BlendMode theBlendMode, const Transform& theTransform
 blendMode(theBlendMode),
 transform(theTransform),
 texture  (theTexture),
-shader   (theShader)
+shader   (theShader),
+material (NULL)
 {
 }
 
@@ -31,7 +31,10 @@
 #include <SFML3D/Graphics/Texture.hpp>
 #include <SFML3D/Graphics/VertexBuffer.hpp>
 #include <SFML3D/Graphics/Light.hpp>
+#include <SFML3D/Graphics/Material.hpp>
+#include <SFML3D/Graphics/ShadowMap.hpp>
 #include <SFML3D/Graphics/GLCheck.hpp>
+#include <SFML3D/Graphics/DefaultShader.hpp>
 #include <SFML3D/System/Mutex.hpp>
 #include <SFML3D/System/Lock.hpp>
 #include <SFML3D/System/Err.hpp>
@@ -51,6 +54,61 @@ namespace
         sf3d::Lock lock(mutex);
         return id++;
     }
+
+    // Default non-legacy shader, shared by all the render targets
+    // (their contexts share their objects, programs included)
+    sf3d::Mutex   defaultShaderMutex;
+    unsigned int  defaultShaderCount = 0;
+    sf3d::Shader* defaultShader = NULL;
+    bool          defaultShaderFailed = false;
+
+    // Variant of the default shader sampling the shadow maps, only used while some exist
+    sf3d::Shader* shadowShader = NULL;
+    bool          shadowShaderFailed = false;
+
+    // Get the shadow variant of the default shader, compiling it on first use
+    const sf3d::Shader* getShadowShader()
+    {
+        sf3d::Lock lock(defaultShaderMutex);
+
+        if (defaultShader && !shadowShader && !shadowShaderFailed)
+        {
+            shadowShader = new sf3d::Shader;
+            if (!shadowShader->loadFromMemory(sf3d::priv::getDefaultVertexShaderSource(),
+                                              sf3d::priv::getDefaultFragmentShaderSource("#define SF_SHADOWS\n")))
+            {
+                sf3d::err() << "Compiling shadow shader failed. Falling back to the default shader..." << std::endl;
+                delete shadowShader;
+                shadowShader = NULL;
+                shadowShaderFailed = true;
+            }
+        }
+
+        return shadowShader;
+    }
+
+    // Release a reference to the default shader
+    void releaseDefaultShader(sf3d::Shader*& shader)
+    {
+        if (!shader)
+            return;
+
+        sf3d::Lock lock(defaultShaderMutex);
+
+        shader = NULL;
+        defaultShaderCount--;
+
+        // The next render target compiles them again, maybe in a context that supports them
+        if (!defaultShaderCount)
+        {
+            delete defaultShader;
+            defaultShader = NULL;
+            defaultShaderFailed = false;
+            delete shadowShader;
+            shadowShader = NULL;
+            shadowShaderFailed = false;
+        }
+    }
 }
 
 
@@ -66,12 +124,16 @@ m_clearDepth            (false),
 m_defaultShader         (NULL),
 m_currentNonLegacyShader(NULL),
 m_lastNonLegacyShader   (NULL),
+m_currentMaterial       (NULL),
 m_id                    (getUniqueId()),
 m_previousViewport      (-1, -1, -1, -1),
 m_previousClearColor    (0, 0, 0, 0)
 {
     m_cache.glStatesSet = false;
     Light::increaseLightReferences();
+
+    // Keep the material permutations alive, the last drawn shader may be one of them
+    Material::increasePermutationReferences();
 }
 
 
@@ -79,7 +141,8 @@ m_previousClearColor    (0, 0, 0, 0)
 RenderTarget::~RenderTarget()
 {
     Light::decreaseLightReferences();
-    delete m_defaultShader;
+    Material::decreasePermutationReferences();
+    releaseDefaultShader(m_defaultShader);
     delete m_view;
 }
 
@@ -207,18 +270,51 @@ void RenderTarget::draw(const VertexBuffer& buffer, const RenderStates& states)
 
         bool previousShaderWarnSetting = true;
 
+        // Shaders still compiling in the background are replaced by the default shader until they are ready
+        const Shader* customShader = states.shader;
+        if (customShader && (customShader->getStatus() != Shader::Ready))
+            customShader = NULL;
+
+        // The texture of the material overrides the one of the states
+        const Texture* texture = states.texture;
+        if (states.material && states.material->getTexture())
+            texture = states.material->getTexture();
+
         if (m_defaultShader)
         {
             // Non-legacy rendering, need to set uniforms
-            if (states.shader)
+            if (customShader)
             {
-                m_currentNonLegacyShader = states.shader;
-                previousShaderWarnSetting = states.shader->warnMissing(false);
+                m_currentNonLegacyShader = customShader;
+                previousShaderWarnSetting = customShader->warnMissing(false);
             }
             else
+            {
                 m_currentNonLegacyShader = m_defaultShader;
 
-            shaderChanged = (m_currentNonLegacyShader != m_lastNonLegacyShader);
+                // Lit draws sample the shadow maps with a variant of the default shader
+                if (Light::isLightingEnabled() && ShadowMap::hasShadowMaps())
+                {
+                    const Shader* shader = getShadowShader();
+                    if (shader)
+                        m_currentNonLegacyShader = shader;
+                }
+
+                // Draw with the shader permutation compiled for the features of the material
+                if (states.material)
+                {
+                    const Shader* materialShader = states.material->getShader(texture != NULL);
+                    if (materialShader)
+                    {
+                        m_currentNonLegacyShader = materialShader;
+                        m_currentMaterial = states.material;
+                    }
+                }
+            }
+
+            // The shader may be shared with other render targets, which overwrite its uniforms
+            shaderChanged = (m_currentNonLegacyShader != m_lastNonLegacyShader) ||
+                            (m_currentNonLegacyShader->m_targetId != m_id);
 
             m_currentNonLegacyShader->beginParameterBlock();
         }
@@ -234,15 +330,19 @@ void RenderTarget::draw(const VertexBuffer& buffer, const RenderStates& states)
             applyBlendMode(states.blendMode);
 
         // Apply the texture
-        Uint64 textureId = states.texture ? states.texture->m_cacheId : 0;
+        Uint64 textureId = texture ? texture->m_cacheId : 0;
         if (shaderChanged || (textureId != m_cache.lastTextureId))
-            applyTexture(states.texture);
+            applyTexture(texture);
+
+        // Apply the material
+        if (m_currentMaterial && (shaderChanged || (m_currentMaterial->m_cacheId != m_cache.lastMaterialId)))
+            applyMaterial(*m_currentMaterial);
 
         // Apply the shader
-        if (states.shader)
-            applyShader(states.shader);
-        else if (m_defaultShader)
-            applyShader(m_defaultShader);
+        if (m_defaultShader)
+            applyShader(m_currentNonLegacyShader);
+        else if (customShader)
+            applyShader(customShader);
 
         // Find the OpenGL primitive type
         static const GLenum modes[] = {GL_POINTS, GL_LINES, GL_LINE_STRIP, GL_TRIANGLES,
@@ -267,7 +367,9 @@ void RenderTarget::draw(const VertexBuffer& buffer, const RenderStates& states)
         }
         else
         {
-            Light::addLightsToShader(*m_currentNonLegacyShader);
+            // Unlit materials are drawn with a shader that doesn't use the lights
+            if (!m_currentMaterial || m_currentMaterial->isLit())
+                Light::addLightsToShader(*m_currentNonLegacyShader);
 
             unsigned int arrayObject = 0;
             bool newArray = true;
@@ -419,18 +521,19 @@ void RenderTarget::draw(const VertexBuffer& buffer, const RenderStates& states)
         }
 
         // Unbind the shader, if any was bound in legacy mode
-        if (states.shader && !m_defaultShader)
+        if (customShader && !m_defaultShader)
             applyShader(NULL);
 
         if (m_defaultShader)
         {
             m_currentNonLegacyShader->endParameterBlock();
 
-            if (states.shader)
-                states.shader->warnMissing(previousShaderWarnSetting);
+            if (customShader)
+                customShader->warnMissing(previousShaderWarnSetting);
 
             m_lastNonLegacyShader = m_currentNonLegacyShader;
             m_currentNonLegacyShader = NULL;
+            m_currentMaterial = NULL;
         }
     }
 }
@@ -455,18 +558,51 @@ void RenderTarget::draw(const Vertex* vertices, unsigned int vertexCount,
 
         bool previousShaderWarnSetting = true;
 
+        // Shaders still compiling in the background are replaced by the default shader until they are ready
+        const Shader* customShader = states.shader;
+        if (customShader && (customShader->getStatus() != Shader::Ready))
+            customShader = NULL;
+
+        // The texture of the material overrides the one of the states
+        const Texture* texture = states.texture;
+        if (states.material && states.material->getTexture())
+            texture = states.material->getTexture();
+
         if (m_defaultShader)
         {
             // Non-legacy rendering, need to set uniforms
-            if (states.shader)
+            if (customShader)
             {
-                m_currentNonLegacyShader = states.shader;
-                previousShaderWarnSetting = states.shader->warnMissing(false);
+                m_currentNonLegacyShader = customShader;
+                previousShaderWarnSetting = customShader->warnMissing(false);
             }
             else
+            {
                 m_currentNonLegacyShader = m_defaultShader;
 
-            shaderChanged = (m_currentNonLegacyShader != m_lastNonLegacyShader);
+                // Lit draws sample the shadow maps with a variant of the default shader
+                if (Light::isLightingEnabled() && ShadowMap::hasShadowMaps())
+                {
+                    const Shader* shader = getShadowShader();
+                    if (shader)
+                        m_currentNonLegacyShader = shader;
+                }
+
+                // Draw with the shader permutation compiled for the features of the material
+                if (states.material)
+                {
+                    const Shader* materialShader = states.material->getShader(texture != NULL);
+                    if (materialShader)
+                    {
+                        m_currentNonLegacyShader = materialShader;
+                        m_currentMaterial = states.material;
+                    }
+                }
+            }
+
+            // The shader may be shared with other render targets, which overwrite its uniforms
+            shaderChanged = (m_currentNonLegacyShader != m_lastNonLegacyShader) ||
+                            (m_currentNonLegacyShader->m_targetId != m_id);
 
             m_currentNonLegacyShader->beginParameterBlock();
         }
@@ -482,15 +618,19 @@ void RenderTarget::draw(const Vertex* vertices, unsigned int vertexCount,
             applyBlendMode(states.blendMode);
 
         // Apply the texture
-        Uint64 textureId = states.texture ? states.texture->m_cacheId : 0;
+        Uint64 textureId = texture ? texture->m_cacheId : 0;
         if (shaderChanged || (textureId != m_cache.lastTextureId))
-            applyTexture(states.texture);
+            applyTexture(texture);
+
+        // Apply the material
+        if (m_currentMaterial && (shaderChanged || (m_currentMaterial->m_cacheId != m_cache.lastMaterialId)))
+            applyMaterial(*m_currentMaterial);
 
         // Apply the shader
-        if (states.shader)
-            applyShader(states.shader);
-        else if (m_defaultShader)
-            applyShader(m_defaultShader);
+        if (m_defaultShader)
+            applyShader(m_currentNonLegacyShader);
+        else if (customShader)
+            applyShader(customShader);
 
         // Unbind any bound vertex buffer
         if (m_cache.lastVertexBufferId)
@@ -518,7 +658,9 @@ void RenderTarget::draw(const Vertex* vertices, unsigned int vertexCount,
         }
         else
         {
-            Light::addLightsToShader(*m_currentNonLegacyShader);
+            // Unlit materials are drawn with a shader that doesn't use the lights
+            if (!m_currentMaterial || m_currentMaterial->isLit())
+                Light::addLightsToShader(*m_currentNonLegacyShader);
 
             int vertexLocation   = m_currentNonLegacyShader->getVertexAttributeLocation("sf_Vertex");
             int colorLocation    = m_currentNonLegacyShader->getVertexAttributeLocation("sf_Color");
@@ -568,18 +710,19 @@ void RenderTarget::draw(const Vertex* vertices, unsigned int vertexCount,
         }
 
         // Unbind the shader, if any was bound in legacy mode
-        if (states.shader && !m_defaultShader)
+        if (customShader && !m_defaultShader)
             applyShader(NULL);
 
         if (m_defaultShader)
         {
             m_currentNonLegacyShader->endParameterBlock();
 
-            if (states.shader)
-                states.shader->warnMissing(previousShaderWarnSetting);
+            if (customShader)
+                customShader->warnMissing(previousShaderWarnSetting);
 
             m_lastNonLegacyShader = m_currentNonLegacyShader;
             m_currentNonLegacyShader = NULL;
+            m_currentMaterial = NULL;
         }
     }
 }
@@ -739,6 +882,7 @@ void RenderTarget::applyCurrentView()
         else
             shader = m_defaultShader;
 
+        shader->m_targetId = m_id;
         shader->setParameter("sf_ProjectionMatrix", m_view->getTransform());
         shader->setParameter("sf_ViewMatrix", m_view->getViewTransform());
         shader->setParameter("sf_ViewerPosition", m_view->getPosition());
@@ -809,6 +953,7 @@ void RenderTarget::applyTransform(const Transform& transform)
         else
             shader = m_defaultShader;
 
+        shader->m_targetId = m_id;
         shader->setParameter("sf_ModelMatrix", transform);
 
         const float* modelMatrix = transform.getMatrix();
@@ -849,6 +994,8 @@ void RenderTarget::applyTexture(const Texture* texture)
         else
             shader = m_defaultShader;
 
+        shader->m_targetId = m_id;
+
         float xScale = 1.f;
         float yScale = 1.f;
         float yFlip  = 0.f;
@@ -873,10 +1020,11 @@ void RenderTarget::applyTexture(const Texture* texture)
 
             shader->setParameter("sf_TextureMatrix", textureMatrix);
             shader->setParameter("sf_Texture0", *texture);
-            shader->setParameter("sf_TextureEnabled", 1);
         }
-        else
-            shader->setParameter("sf_TextureEnabled", 0);
+
+        // Material permutations are compiled with or without texturing, they have no switch
+        if (!m_currentMaterial)
+            shader->setParameter("sf_TextureEnabled", texture ? 1 : 0);
     }
     else
         Texture::bind(texture, Texture::Pixels);
@@ -892,6 +1040,21 @@ void RenderTarget::applyShader(const Shader* shader)
 }
 
 
+////////////////////////////////////////////////////////////
+void RenderTarget::applyMaterial(const Material& material)
+{
+    const Shader* shader = m_currentNonLegacyShader;
+
+    shader->m_targetId = m_id;
+    shader->setParameter("sf_MaterialDiffuseColor", material.m_diffuseColor);
+    shader->setParameter("sf_MaterialSpecularColor", material.m_specularColor);
+    shader->setParameter("sf_MaterialShininess", material.m_shininess);
+    shader->setParameter("sf_MaterialAlphaThreshold", material.m_alphaThreshold);
+
+    m_cache.lastMaterialId = material.m_cacheId;
+}
+
+
 ////////////////////////////////////////////////////////////
 void RenderTarget::applyVertexBuffer(const VertexBuffer* buffer)
 {
@@ -905,8 +1068,7 @@ void RenderTarget::applyVertexBuffer(const VertexBuffer* buffer)
 void RenderTarget::setupNonLegacyPipeline()
 {
     // Setup the default shader if non-legacy rendering is supported
-    delete m_defaultShader;
-    m_defaultShader = NULL;
+    releaseDefaultShader(m_defaultShader);
 
     // Check if our shader lighting implementation is supported
     if (!Light::hasShaderLighting())
@@ -924,159 +1086,26 @@ void RenderTarget::setupNonLegacyPipeline()
     // This will only succeed if the supported version is not GLSL ES
     if (versionNumber > 1.29)
     {
-        m_defaultShader = new Shader;
-
-        std::stringstream vertexShaderSource;
-        vertexShaderSource << "#version 130\n"
-                              "\n"
-                              "// Uniforms\n"
-                              "uniform mat4 sf_ModelMatrix;\n"
-                              "uniform mat4 sf_ViewMatrix;\n"
-                              "uniform mat4 sf_ProjectionMatrix;\n"
-                              "uniform mat4 sf_TextureMatrix;\n"
-                              "uniform int sf_TextureEnabled;\n"
-                              "uniform int sf_LightingEnabled;\n"
-                              "\n"
-                              "// Vertex attributes\n"
-                              "in vec3 sf_Vertex;\n"
-                              "in vec4 sf_Color;\n"
-                              "in vec2 sf_MultiTexCoord0;\n"
-                              "in vec3 sf_Normal;\n"
-                              "\n"
-                              "// Vertex shader outputs\n"
-                              "out vec4 sf_FrontColor;\n"
-                              "out vec2 sf_TexCoord0;\n"
-                              "out vec3 sf_FragWorldPosition;\n"
-                              "out vec3 sf_FragNormal;\n"
-                              "\n"
-                              "void main()\n"
-                              "{\n"
-                              "    // Vertex position\n"
-                              "    gl_Position = sf_ProjectionMatrix * sf_ViewMatrix * sf_ModelMatrix * vec4(sf_Vertex, 1.0);\n"
-                              "\n"
-                              "    // Vertex color\n"
-                              "    sf_FrontColor = sf_Color;\n"
-                              "\n"
-                              "    // Texture data\n"
-                              "    if (sf_TextureEnabled == 1)\n"
-                              "        sf_TexCoord0 = (sf_TextureMatrix * vec4(sf_MultiTexCoord0, 0.0, 1.0)).st;\n"
-                              "\n"
-                              "    // Lighting data\n"
-                              "    if (sf_LightingEnabled > 0)\n"
-                              "    {\n"
-                              "        sf_FragNormal = sf_Normal;\n"
-                              "        sf_FragWorldPosition = vec3(sf_ModelMatrix * vec4(sf_Vertex, 1.0));\n"
-                              "    }\n"
-                              "}\n";
-
-        std::stringstream fragmentShaderSource;
-        fragmentShaderSource << "#version 130\n";
-
-        if (Shader::isUniformBufferAvailable())
-            fragmentShaderSource << "#extension GL_ARB_uniform_buffer_object : enable\n";
-
-        fragmentShaderSource << "\n"
-                                "// Light structure\n"
-                                "struct Light\n"
-                                "{\n"
-                                "    vec4 ambientColor;\n"
-                                "    vec4 diffuseColor;\n"
-                                "    vec4 specularColor;\n"
-                                "    vec4 positionDirection;\n"
-                                "    vec4 attenuation;\n"
-                                "};\n"
-                                "\n"
-                                "// Uniforms\n"
-                                "uniform mat4 sf_ModelMatrix;\n"
-                                "uniform mat4 sf_NormalMatrix;\n"
-                                "uniform sampler2D sf_Texture0;\n"
-                                "uniform int sf_TextureEnabled;\n"
-                                "uniform int sf_LightCount;\n"
-                                "uniform int sf_LightingEnabled;\n"
-                                "uniform vec3 sf_ViewerPosition;\n"
-                                "\n";
-
-        if (Shader::isUniformBufferAvailable())
-            fragmentShaderSource << "layout (std140) uniform Lights\n"
-                                    "{\n"
-                                    "    Light sf_Lights[" << Light::getMaximumLights() << "];\n"
-                                    "};\n";
-        else
-            fragmentShaderSource << "uniform Light sf_Lights[" << Light::getMaximumLights() << "];\n";
-
-        fragmentShaderSource << "\n"
-                                "// Fragment attributes\n"
-                                "in vec4 sf_FrontColor;\n"
-                                "in vec2 sf_TexCoord0;\n"
-                                "in vec3 sf_FragWorldPosition;\n"
-                                "in vec3 sf_FragNormal;\n"
-                                "\n"
-                                "// Fragment shader outputs\n"
-                                "out vec4 sf_FragColor;\n"
-                                "\n"
-                                "vec4 computeLighting()\n"
-                                "{\n"
-                                "    // Early return in case lighting disabled\n"
-                                "    if (sf_LightingEnabled == 0)\n"
-                                "        return vec4(1.0, 1.0, 1.0, 1.0);\n"
-                                "\n"
-                                "    // TODO: Implement way to manipulate materials\n"
-                                "    const float materialShininess = 1.0;\n"
-                                "    const vec4 materialSpecularColor = vec4(0.0001, 0.0001, 0.0001, 1.0);\n"
-                                "\n"
-                                "    vec3 fragmentNormal = normalize((sf_NormalMatrix * vec4(sf_FragNormal, 1.0)).xyz);\n"
-                                "    vec3 fragmentDistanceToViewer = normalize(sf_ViewerPosition - sf_FragWorldPosition);"
-                                "\n"
-                                "    vec4 totalIntensity = vec4(0.0, 0.0, 0.0, 0.0);\n"
-                                "\n"
-                                "    for (int index = 0; index < sf_LightCount; ++index)\n"
-                                "    {\n"
-                                "        vec3 rayDirection = normalize(sf_Lights[index].positionDirection.xyz);\n"
-                                "        float attenuationFactor = 1.0;"
-                                "\n"
-                                "        if (sf_Lights[index].positionDirection.w > 0.0)\n"
-                                "        {\n"
-                                "            rayDirection = normalize(sf_FragWorldPosition - sf_Lights[index].positionDirection.xyz);\n"
-                                "            float rayLength = length(sf_Lights[index].positionDirection.xyz - sf_FragWorldPosition);"
-                                "            vec4 attenuationCoefficients = vec4(1.0, rayLength, rayLength * rayLength, 0.0);"
-                                "            attenuationFactor = dot(sf_Lights[index].attenuation, attenuationCoefficients);\n"
-                                "        }\n"
-                                "\n"
-                                "        vec4 ambientIntensity = sf_Lights[index].ambientColor;\n"
-                                "\n"
-                                "        float diffuseCoefficient = max(0.0, dot(fragmentNormal, -rayDirection));\n"
-                                "        vec4 diffuseIntensity = sf_Lights[index].diffuseColor * diffuseCoefficient;\n"
-                                "\n"
-                                "        float specularCoefficient = 0.0;\n"
-                                "        if(diffuseCoefficient > 0.0)"
-                                "            specularCoefficient = pow(max(0.0, dot(fragmentDistanceToViewer, reflect(rayDirection, fragmentNormal))), materialShininess);"
-                                "        vec4 specularIntensity = specularCoefficient * materialSpecularColor * sf_Lights[index].specularColor;"
-                                "\n"
-                                "        totalIntensity += ambientIntensity + (diffuseIntensity + specularIntensity) / attenuationFactor;\n"
-                                "    }\n"
-                                "\n"
-                                "    return vec4(totalIntensity.rgb, 1.0);\n"
-                                "}\n"
-                                "\n"
-                                "vec4 computeTexture()\n"
-                                "{\n"
-                                "    if (sf_TextureEnabled == 0)\n"
-                                "        return vec4(1.0, 1.0, 1.0, 1.0);\n"
-                                "\n"
-                                "    return texture2D(sf_Texture0, sf_TexCoord0);\n"
-                                "}\n"
-                                "\n"
-                                "void main()\n"
-                                "{\n"
-                                "    // Fragment color\n"
-                                "    sf_FragColor = sf_FrontColor * computeTexture() * computeLighting();\n"
-                                "}\n";
-
-        if (!m_defaultShader->loadFromMemory(vertexShaderSource.str(), fragmentShaderSource.str()))
+        Lock lock(defaultShaderMutex);
+
+        // Compile the default shader for the first render target only
+        if (!defaultShader && !defaultShaderFailed)
+        {
+            defaultShader = new Shader;
+
+            if (!defaultShader->loadFromMemory(priv::getDefaultVertexShaderSource(), priv::getDefaultFragmentShaderSource()))
+            {
+                err() << "Compiling default shader failed. Falling back to legacy pipeline..." << std::endl;
+                delete defaultShader;
+                defaultShader = NULL;
+                defaultShaderFailed = true;
+            }
+        }
+
+        if (defaultShader)
         {
-            err() << "Compiling default shader failed. Falling back to legacy pipeline..." << std::endl;
-            delete m_defaultShader;
-            m_defaultShader = NULL;
+            m_defaultShader = defaultShader;
+            defaultShaderCount++;
         }
     }
 }
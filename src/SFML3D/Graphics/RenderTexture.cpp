@@ -28,11 +28,44 @@
 #include <SFML3D/Graphics/RenderTexture.hpp>
 #include <SFML3D/Graphics/RenderTextureImplFBO.hpp>
 #include <SFML3D/Graphics/RenderTextureImplDefault.hpp>
+#include <SFML3D/Graphics/GLCheck.hpp>
 #include <SFML3D/System/Err.hpp>
+#include <cassert>
+
+
+namespace
+{
+    // OpenGL storage of the color formats, in the order of RenderTexture::Format
+    struct FormatStorage
+    {
+        GLint  internalFormat;
+        GLenum format;
+    };
+
+    const FormatStorage formatStorages[] =
+    {
+        {GL_RGBA8,        GL_RGBA},
+        {GL_RGBA16F_ARB,  GL_RGBA},
+        {GL_RGBA32F_ARB,  GL_RGBA},
+        {GL_RG16F,        GL_RG},
+        {GL_R32F,         GL_RED}
+    };
+}
 
 
 namespace sf3d
 {
+////////////////////////////////////////////////////////////
+RenderTexture::Settings::Settings(bool depth, bool stencil, unsigned int antialiasing) :
+colorFormats     (1, Rgba8),
+depthBuffer      (depth),
+depthTexture     (false),
+stencilBuffer    (stencil),
+antialiasingLevel(antialiasing)
+{
+}
+
+
 ////////////////////////////////////////////////////////////
 RenderTexture::RenderTexture() :
 m_impl(NULL)
@@ -45,25 +78,109 @@ m_impl(NULL)
 RenderTexture::~RenderTexture()
 {
     delete m_impl;
+
+    for (std::size_t i = 0; i < m_extraTextures.size(); ++i)
+        delete m_extraTextures[i];
 }
 
 
 ////////////////////////////////////////////////////////////
 bool RenderTexture::create(unsigned int width, unsigned int height, bool depthBuffer, bool stencilBuffer)
 {
-    // Create the texture
-    if (!m_texture.create(width, height))
+    return create(width, height, Settings(depthBuffer, stencilBuffer));
+}
+
+
+////////////////////////////////////////////////////////////
+bool RenderTexture::create(unsigned int width, unsigned int height, const Settings& settings)
+{
+    // Check the requested buffers
+    std::size_t colorCount = settings.colorFormats.size();
+    if (!colorCount)
+    {
+        err() << "Impossible to create render texture (no color texture requested)" << std::endl;
+        return false;
+    }
+
+    bool useFrameBuffer = priv::RenderTextureImplFBO::isAvailable();
+    if (!useFrameBuffer && ((colorCount > 1) || (settings.colorFormats[0] != Rgba8) || settings.depthTexture))
+    {
+        err() << "Impossible to create render texture (multiple targets, float formats "
+              << "and depth textures require frame buffer objects)" << std::endl;
+        return false;
+    }
+
+    unsigned int maxColorCount = getMaximumColorTextureCount();
+    if (colorCount > maxColorCount)
+    {
+        err() << "Impossible to create render texture (" << colorCount << " color textures requested, "
+              << "maximum is " << maxColorCount << ")" << std::endl;
+        return false;
+    }
+
+    for (std::size_t i = 0; i < colorCount; ++i)
+    {
+        if (!isFormatAvailable(settings.colorFormats[i]))
+        {
+            err() << "Impossible to create render texture (the format of color texture " << i
+                  << " is not supported by the graphics driver)" << std::endl;
+            return false;
+        }
+    }
+
+    if (settings.depthTexture && !priv::RenderTextureImplFBO::isDepthTextureAvailable(settings.stencilBuffer))
     {
-        err() << "Impossible to create render texture (failed to create the target texture)" << std::endl;
+        err() << "Impossible to create render texture (depth textures are not supported by the graphics driver)" << std::endl;
         return false;
     }
 
+    // Create the color textures
+    for (std::size_t i = 0; i < m_extraTextures.size(); ++i)
+        delete m_extraTextures[i];
+    m_extraTextures.clear();
+
+    std::vector<unsigned int> colorTextures;
+    for (std::size_t i = 0; i < colorCount; ++i)
+    {
+        Texture* texture = &m_texture;
+        if (i > 0)
+        {
+            texture = new Texture;
+            m_extraTextures.push_back(texture);
+        }
+
+        Format format = settings.colorFormats[i];
+        bool created = (format == Rgba8) ? texture->create(width, height) :
+                       texture->createStorage(width, height, formatStorages[format].internalFormat, formatStorages[format].format, GL_FLOAT);
+        if (!created)
+        {
+            err() << "Impossible to create render texture (failed to create the target texture)" << std::endl;
+            return false;
+        }
+
+        colorTextures.push_back(texture->m_texture);
+    }
+
     // We disable smoothing by default for render textures
     setSmooth(false);
 
+    // Create the depth texture
+    m_depthTexture = Texture();
+    if (settings.depthTexture)
+    {
+        bool created = settings.stencilBuffer ?
+                       m_depthTexture.createStorage(width, height, GL_DEPTH24_STENCIL8_EXT, GL_DEPTH_STENCIL_EXT, GL_UNSIGNED_INT_24_8_EXT) :
+                       m_depthTexture.createStorage(width, height, GL_DEPTH_COMPONENT24, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT);
+        if (!created)
+        {
+            err() << "Impossible to create render texture (failed to create the depth texture)" << std::endl;
+            return false;
+        }
+    }
+
     // Create the implementation
     delete m_impl;
-    if (priv::RenderTextureImplFBO::isAvailable())
+    if (useFrameBuffer)
     {
         // Use frame-buffer object (FBO)
         m_impl = new priv::RenderTextureImplFBO;
@@ -75,13 +192,13 @@ bool RenderTexture::create(unsigned int width, unsigned int height, bool depthBu
     }
 
     // Initialize the render texture
-    if (!m_impl->create(width, height, m_texture.m_texture, depthBuffer, stencilBuffer))
+    if (!m_impl->create(width, height, colorTextures, m_depthTexture.m_texture, settings))
         return false;
 
     // We can now initialize the render target part
     RenderTarget::initialize();
 
-    m_clearDepth = depthBuffer;
+    m_clearDepth = settings.depthBuffer || settings.depthTexture;
 
     return true;
 }
@@ -91,6 +208,9 @@ bool RenderTexture::create(unsigned int width, unsigned int height, bool depthBu
 void RenderTexture::setSmooth(bool smooth)
 {
     m_texture.setSmooth(smooth);
+
+    for (std::size_t i = 0; i < m_extraTextures.size(); ++i)
+        m_extraTextures[i]->setSmooth(smooth);
 }
 
 
@@ -105,6 +225,9 @@ bool RenderTexture::isSmooth() const
 void RenderTexture::setRepeated(bool repeated)
 {
     m_texture.setRepeated(repeated);
+
+    for (std::size_t i = 0; i < m_extraTextures.size(); ++i)
+        m_extraTextures[i]->setRepeated(repeated);
 }
 
 
@@ -125,11 +248,22 @@ bool RenderTexture::setActive(bool active)
 ////////////////////////////////////////////////////////////
 void RenderTexture::display()
 {
-    // Update the target texture
+    // Update the target textures
     if (setActive(true))
     {
         m_impl->updateTexture(m_texture.m_texture);
         m_texture.m_pixelsFlipped = true;
+        m_depthTexture.m_pixelsFlipped = true;
+
+        // Keep the mipmaps in sync with the new contents
+        m_texture.updateMipmap(0, 0, m_texture.m_size.x, m_texture.m_size.y);
+
+        for (std::size_t i = 0; i < m_extraTextures.size(); ++i)
+        {
+            Texture& texture = *m_extraTextures[i];
+            texture.m_pixelsFlipped = true;
+            texture.updateMipmap(0, 0, texture.m_size.x, texture.m_size.y);
+        }
     }
 }
 
@@ -142,9 +276,39 @@ Vector2u RenderTexture::getSize() const
 
 
 ////////////////////////////////////////////////////////////
-const Texture& RenderTexture::getTexture() const
+const Texture& RenderTexture::getTexture(unsigned int index) const
+{
+    assert(index < getColorTextureCount());
+
+    return index ? *m_extraTextures[index - 1] : m_texture;
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int RenderTexture::getColorTextureCount() const
+{
+    return static_cast<unsigned int>(m_extraTextures.size()) + 1;
+}
+
+
+////////////////////////////////////////////////////////////
+const Texture& RenderTexture::getDepthTexture() const
+{
+    return m_depthTexture;
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int RenderTexture::getMaximumColorTextureCount()
+{
+    return priv::RenderTextureImplFBO::getMaximumColorAttachmentCount();
+}
+
+
+////////////////////////////////////////////////////////////
+bool RenderTexture::isFormatAvailable(Format format)
 {
-    return m_texture;
+    return priv::RenderTextureImplFBO::isFormatAvailable(format);
 }
 
 
@@ -28,7 +28,9 @@
 ////////////////////////////////////////////////////////////
 // Headers
 ////////////////////////////////////////////////////////////
+#include <SFML3D/Graphics/RenderTexture.hpp>
 #include <SFML3D/System/NonCopyable.hpp>
+#include <vector>
 
 
 namespace sf3d
@@ -52,16 +54,16 @@ public :
     ////////////////////////////////////////////////////////////
     /// \brief Create the render texture implementation
     ///
-    /// \param width         Width of the texture to render to
-    /// \param height        Height of the texture to render to
-    /// \param textureId     OpenGL identifier of the target texture
-    /// \param depthBuffer   Is a depth buffer requested?
-    /// \param stencilBuffer Is a stencil buffer requested?
+    /// \param width          Width of the texture to render to
+    /// \param height         Height of the texture to render to
+    /// \param colorTextures  OpenGL identifiers of the target color textures
+    /// \param depthTexture   OpenGL identifier of the target depth texture, 0 if none
+    /// \param settings       Requested buffers
     ///
     /// \return True if creation has been successful
     ///
     ////////////////////////////////////////////////////////////
-    virtual bool create(unsigned int width, unsigned int height, unsigned int textureId, bool depthBuffer, bool stencilBuffer) = 0;
+    virtual bool create(unsigned int width, unsigned int height, const std::vector<unsigned int>& colorTextures, unsigned int depthTexture, const RenderTexture::Settings& settings) = 0;
 
     ////////////////////////////////////////////////////////////
     /// \brief Activate or deactivate the render texture for rendering
@@ -74,7 +76,7 @@ public :
     virtual bool activate(bool active) = 0;
 
     ////////////////////////////////////////////////////////////
-    /// \brief Update the pixels of the target texture
+    /// \brief Update the pixels of the target textures
     ///
     /// \param textureId OpenGL identifier of the target texture
     ///
@@ -55,14 +55,15 @@ RenderTextureImplDefault::~RenderTextureImplDefault()
 
 
 ////////////////////////////////////////////////////////////
-bool RenderTextureImplDefault::create(unsigned int width, unsigned int height, unsigned int, bool depthBuffer, bool stencilBuffer)
+bool RenderTextureImplDefault::create(unsigned int width, unsigned int height, const std::vector<unsigned int>&, unsigned int, const RenderTexture::Settings& settings)
 {
     // Store the dimensions
     m_width = width;
     m_height = height;
 
-    // Create the in-memory OpenGL context
-    m_context = new Context(ContextSettings(depthBuffer ? 32 : 0, stencilBuffer ? 8 : 0), width, height);
+    // Create the in-memory OpenGL context, which takes care of multisampling too
+    ContextSettings contextSettings(settings.depthBuffer ? 32 : 0, settings.stencilBuffer ? 8 : 0, settings.antialiasingLevel);
+    m_context = new Context(contextSettings, width, height);
 
     return true;
 }
@@ -63,16 +63,16 @@ private :
     ////////////////////////////////////////////////////////////
     /// \brief Create the render texture implementation
     ///
-    /// \param width         Width of the texture to render to
-    /// \param height        Height of the texture to render to
-    /// \param textureId     OpenGL identifier of the target texture
-    /// \param depthBuffer   Is a depth buffer requested?
-    /// \param stencilBuffer Is a stencil buffer requested?
+    /// \param width          Width of the texture to render to
+    /// \param height         Height of the texture to render to
+    /// \param colorTextures  OpenGL identifiers of the target color textures
+    /// \param depthTexture   OpenGL identifier of the target depth texture, 0 if none
+    /// \param settings       Requested buffers
     ///
     /// \return True if creation has been successful
     ///
     ////////////////////////////////////////////////////////////
-    virtual bool create(unsigned int width, unsigned int height, unsigned int textureId, bool depthBuffer, bool stencilBuffer);
+    virtual bool create(unsigned int width, unsigned int height, const std::vector<unsigned int>& colorTextures, unsigned int depthTexture, const RenderTexture::Settings& settings);
 
     ////////////////////////////////////////////////////////////
     /// \brief Activate or deactivate the render texture for rendering
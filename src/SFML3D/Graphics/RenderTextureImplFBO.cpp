@@ -27,8 +27,31 @@
 ////////////////////////////////////////////////////////////
 #include <SFML3D/Graphics/RenderTextureImplFBO.hpp>
 #include <SFML3D/Graphics/Texture.hpp>
+#include <SFML3D/Graphics/TextureSaver.hpp>
 #include <SFML3D/Graphics/GLCheck.hpp>
 #include <SFML3D/System/Err.hpp>
+#include <algorithm>
+
+
+namespace
+{
+    // Create a render buffer, multisampled if samples is not 0
+    unsigned int createRenderBuffer(GLenum internalFormat, unsigned int samples, unsigned int width, unsigned int height)
+    {
+        GLuint buffer = 0;
+        glCheck(glGenRenderbuffersEXT(1, &buffer));
+        if (buffer)
+        {
+            glCheck(glBindRenderbufferEXT(GL_RENDERBUFFER_EXT, buffer));
+            if (samples)
+                glCheck(glRenderbufferStorageMultisampleEXT(GL_RENDERBUFFER_EXT, samples, internalFormat, width, height));
+            else
+                glCheck(glRenderbufferStorageEXT(GL_RENDERBUFFER_EXT, internalFormat, width, height));
+        }
+
+        return static_cast<unsigned int>(buffer);
+    }
+}
 
 
 namespace sf3d
@@ -37,9 +60,14 @@ namespace priv
 {
 ////////////////////////////////////////////////////////////
 RenderTextureImplFBO::RenderTextureImplFBO() :
-m_frameBuffer  (0),
-m_depthBuffer  (0),
-m_stencilBuffer(0)
+m_context           (NULL),
+m_frameBuffer       (0),
+m_resolveFrameBuffer(0),
+m_depthBuffer       (0),
+m_stencilBuffer     (0),
+m_width             (0),
+m_height            (0),
+m_resolveMask       (0)
 {
 
 }
@@ -64,7 +92,20 @@ RenderTextureImplFBO::~RenderTextureImplFBO()
         glCheck(glDeleteRenderbuffersEXT(1, &depthBuffer));
     }
 
-    // Destroy the frame buffer
+    // Destroy the multisampled color buffers
+    for (std::size_t i = 0; i < m_colorBuffers.size(); ++i)
+    {
+        GLuint colorBuffer = static_cast<GLuint>(m_colorBuffers[i]);
+        glCheck(glDeleteRenderbuffersEXT(1, &colorBuffer));
+    }
+
+    // Destroy the frame buffers
+    if (m_resolveFrameBuffer)
+    {
+        GLuint frameBuffer = static_cast<GLuint>(m_resolveFrameBuffer);
+        glCheck(glDeleteFramebuffersEXT(1, &frameBuffer));
+    }
+
     if (m_frameBuffer)
     {
         GLuint frameBuffer = static_cast<GLuint>(m_frameBuffer);
@@ -89,57 +130,172 @@ bool RenderTextureImplFBO::isAvailable()
 
 
 ////////////////////////////////////////////////////////////
-bool RenderTextureImplFBO::create(unsigned int width, unsigned int height, unsigned int textureId, bool depthBuffer, bool stencilBuffer)
+unsigned int RenderTextureImplFBO::getMaximumColorAttachmentCount()
+{
+    if (!isAvailable() || !GLEW_ARB_draw_buffers)
+        return 1;
+
+    GLint attachments = 1;
+    GLint drawBuffers = 1;
+    glCheck(glGetIntegerv(GL_MAX_COLOR_ATTACHMENTS_EXT, &attachments));
+    glCheck(glGetIntegerv(GL_MAX_DRAW_BUFFERS_ARB, &drawBuffers));
+
+    return static_cast<unsigned int>(std::max(std::min(attachments, drawBuffers), 1));
+}
+
+
+////////////////////////////////////////////////////////////
+bool RenderTextureImplFBO::isFormatAvailable(RenderTexture::Format format)
 {
+    if (!isAvailable())
+        return format == RenderTexture::Rgba8;
+
+    switch (format)
+    {
+        case RenderTexture::Rgba8   : return true;
+        case RenderTexture::Rgba16f :
+        case RenderTexture::Rgba32f : return GLEW_ARB_texture_float != 0;
+        case RenderTexture::Rg16f   :
+        case RenderTexture::R32f    : return GLEW_ARB_texture_float && GLEW_ARB_texture_rg;
+        default                     : return false;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+bool RenderTextureImplFBO::isDepthTextureAvailable(bool stencil)
+{
+    return isAvailable() && GLEW_ARB_depth_texture && (!stencil || GLEW_EXT_packed_depth_stencil);
+}
+
+
+////////////////////////////////////////////////////////////
+bool RenderTextureImplFBO::create(unsigned int width, unsigned int height, const std::vector<unsigned int>& colorTextures, unsigned int depthTexture, const RenderTexture::Settings& settings)
+{
+    m_width = width;
+    m_height = height;
+
     // Create the context
     m_context = new Context;
 
-    // Create the framebuffer object
+    // Lower the number of samples to what the driver supports
+    unsigned int samples = 0;
+    if (settings.antialiasingLevel && GLEW_EXT_framebuffer_multisample && GLEW_EXT_framebuffer_blit)
+    {
+        GLint maxSamples = 0;
+        glCheck(glGetIntegerv(GL_MAX_SAMPLES_EXT, &maxSamples));
+        samples = std::min(settings.antialiasingLevel, static_cast<unsigned int>(maxSamples));
+    }
+
+    // When the depth texture also requested the stencil, it is a packed depth-stencil texture
+    bool packedDepthStencil = depthTexture && settings.stencilBuffer;
+
+    // Create the framebuffer object holding the target textures
     GLuint frameBuffer = 0;
     glCheck(glGenFramebuffersEXT(1, &frameBuffer));
-    m_frameBuffer = static_cast<unsigned int>(frameBuffer);
-    if (!m_frameBuffer)
+    if (!frameBuffer)
     {
         err() << "Impossible to create render texture (failed to create the frame buffer object)" << std::endl;
         return false;
     }
-    glCheck(glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, m_frameBuffer));
+    glCheck(glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, frameBuffer));
 
-    // Create the depth buffer if requested
-    if (depthBuffer)
+    // Link the textures to the frame buffer
+    for (std::size_t i = 0; i < colorTextures.size(); ++i)
+        glCheck(glFramebufferTexture2DEXT(GL_FRAMEBUFFER_EXT, static_cast<GLenum>(GL_COLOR_ATTACHMENT0_EXT + i), GL_TEXTURE_2D, colorTextures[i], 0));
+
+    if (depthTexture)
+    {
+        glCheck(glFramebufferTexture2DEXT(GL_FRAMEBUFFER_EXT, GL_DEPTH_ATTACHMENT_EXT, GL_TEXTURE_2D, depthTexture, 0));
+        if (packedDepthStencil)
+            glCheck(glFramebufferTexture2DEXT(GL_FRAMEBUFFER_EXT, GL_STENCIL_ATTACHMENT_EXT, GL_TEXTURE_2D, depthTexture, 0));
+    }
+
+    setDrawBuffers(colorTextures.size());
+
+    if (samples)
     {
-        GLuint depth = 0;
-        glCheck(glGenRenderbuffersEXT(1, &depth));
-        m_depthBuffer = static_cast<unsigned int>(depth);
+        // Rendering goes to multisampled buffers instead, which updateTexture resolves to the textures
+        if (glCheckFramebufferStatusEXT(GL_FRAMEBUFFER_EXT) != GL_FRAMEBUFFER_COMPLETE_EXT)
+        {
+            glCheck(glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, 0));
+            glCheck(glDeleteFramebuffersEXT(1, &frameBuffer));
+            err() << "Impossible to create render texture (failed to link the target textures to the frame buffer)" << std::endl;
+            return false;
+        }
+        m_resolveFrameBuffer = static_cast<unsigned int>(frameBuffer);
+
+        frameBuffer = 0;
+        glCheck(glGenFramebuffersEXT(1, &frameBuffer));
+        if (!frameBuffer)
+        {
+            err() << "Impossible to create render texture (failed to create the multisample frame buffer object)" << std::endl;
+            return false;
+        }
+        glCheck(glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, frameBuffer));
+
+        // Give each color buffer the format of its texture
+        for (std::size_t i = 0; i < colorTextures.size(); ++i)
+        {
+            GLint internalFormat = GL_RGBA8;
+            {
+                priv::TextureSaver save;
+                glCheck(glBindTexture(GL_TEXTURE_2D, colorTextures[i]));
+                glCheck(glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_INTERNAL_FORMAT, &internalFormat));
+            }
+
+            unsigned int colorBuffer = createRenderBuffer(internalFormat, samples, width, height);
+            if (!colorBuffer)
+            {
+                err() << "Impossible to create render texture (failed to create the multisample color buffer)" << std::endl;
+                return false;
+            }
+            m_colorBuffers.push_back(colorBuffer);
+            glCheck(glFramebufferRenderbufferEXT(GL_FRAMEBUFFER_EXT, static_cast<GLenum>(GL_COLOR_ATTACHMENT0_EXT + i), GL_RENDERBUFFER_EXT, colorBuffer));
+        }
+
+        setDrawBuffers(colorTextures.size());
+
+        // The depth texture is filled from the multisampled depth buffer too
+        if (depthTexture)
+            m_resolveMask = GL_DEPTH_BUFFER_BIT | (packedDepthStencil ? GL_STENCIL_BUFFER_BIT : 0);
+    }
+
+    m_frameBuffer = static_cast<unsigned int>(frameBuffer);
+
+    // Create the depth buffer if requested and not already provided by the depth texture.
+    // It must match the format of the depth texture for the multisample resolve
+    if ((settings.depthBuffer || depthTexture) && (samples || !depthTexture))
+    {
+        GLenum format = GL_DEPTH_COMPONENT;
+        if (packedDepthStencil)
+            format = GL_DEPTH24_STENCIL8_EXT;
+        else if (depthTexture)
+            format = GL_DEPTH_COMPONENT24;
+
+        m_depthBuffer = createRenderBuffer(format, samples, width, height);
         if (!m_depthBuffer)
         {
             err() << "Impossible to create render texture (failed to create the attached depth buffer)" << std::endl;
             return false;
         }
-        glCheck(glBindRenderbufferEXT(GL_RENDERBUFFER_EXT, m_depthBuffer));
-        glCheck(glRenderbufferStorageEXT(GL_RENDERBUFFER_EXT, GL_DEPTH_COMPONENT, width, height));
         glCheck(glFramebufferRenderbufferEXT(GL_FRAMEBUFFER_EXT, GL_DEPTH_ATTACHMENT_EXT, GL_RENDERBUFFER_EXT, m_depthBuffer));
+        if (packedDepthStencil)
+            glCheck(glFramebufferRenderbufferEXT(GL_FRAMEBUFFER_EXT, GL_STENCIL_ATTACHMENT_EXT, GL_RENDERBUFFER_EXT, m_depthBuffer));
     }
 
-    // Create the stencil buffer if requested
-    if (stencilBuffer)
+    // Create the stencil buffer if requested and not packed with the depth
+    if (settings.stencilBuffer && !packedDepthStencil)
     {
-        GLuint stencil = 0;
-        glCheck(glGenRenderbuffersEXT(1, &stencil));
-        m_stencilBuffer = static_cast<unsigned int>(stencil);
+        m_stencilBuffer = createRenderBuffer(GL_STENCIL_INDEX, samples, width, height);
         if (!m_stencilBuffer)
         {
             err() << "Impossible to create render texture (failed to create the attached stencil buffer)" << std::endl;
             return false;
         }
-        glCheck(glBindRenderbufferEXT(GL_RENDERBUFFER_EXT, m_stencilBuffer));
-        glCheck(glRenderbufferStorageEXT(GL_RENDERBUFFER_EXT, GL_STENCIL_INDEX, width, height));
         glCheck(glFramebufferRenderbufferEXT(GL_FRAMEBUFFER_EXT, GL_STENCIL_ATTACHMENT_EXT, GL_RENDERBUFFER_EXT, m_stencilBuffer));
     }
 
-    // Link the texture to the frame buffer
-    glCheck(glFramebufferTexture2DEXT(GL_FRAMEBUFFER_EXT, GL_COLOR_ATTACHMENT0_EXT, GL_TEXTURE_2D, textureId, 0));
-
     // A final check, just to be sure...
     if (glCheckFramebufferStatusEXT(GL_FRAMEBUFFER_EXT) != GL_FRAMEBUFFER_COMPLETE_EXT)
     {
@@ -162,9 +318,48 @@ bool RenderTextureImplFBO::activate(bool active)
 ////////////////////////////////////////////////////////////
 void RenderTextureImplFBO::updateTexture(unsigned int)
 {
+    if (m_resolveFrameBuffer)
+    {
+        // Copy the multisampled buffers to the textures, one color attachment at a time
+        glCheck(glBindFramebufferEXT(GL_READ_FRAMEBUFFER_EXT, m_frameBuffer));
+        glCheck(glBindFramebufferEXT(GL_DRAW_FRAMEBUFFER_EXT, m_resolveFrameBuffer));
+        for (std::size_t i = 0; i < m_colorBuffers.size(); ++i)
+        {
+            GLenum attachment = static_cast<GLenum>(GL_COLOR_ATTACHMENT0_EXT + i);
+            glCheck(glReadBuffer(attachment));
+            glCheck(glDrawBuffer(attachment));
+            glCheck(glBlitFramebufferEXT(0, 0, m_width, m_height, 0, 0, m_width, m_height,
+                                         GL_COLOR_BUFFER_BIT | (i ? 0 : m_resolveMask), GL_NEAREST));
+        }
+
+        // Restore the buffers selected by both frame buffers
+        setDrawBuffers(m_colorBuffers.size());
+        glCheck(glReadBuffer(GL_COLOR_ATTACHMENT0_EXT));
+        glCheck(glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, m_frameBuffer));
+    }
+
     glFlush();
 }
 
+
+////////////////////////////////////////////////////////////
+void RenderTextureImplFBO::setDrawBuffers(std::size_t count)
+{
+    // Write to every color attachment
+    if (count > 1)
+    {
+        std::vector<GLenum> buffers(count);
+        for (std::size_t i = 0; i < count; ++i)
+            buffers[i] = static_cast<GLenum>(GL_COLOR_ATTACHMENT0_EXT + i);
+
+        glCheck(glDrawBuffersARB(static_cast<GLsizei>(count), &buffers[0]));
+    }
+    else
+    {
+        glCheck(glDrawBuffer(GL_COLOR_ATTACHMENT0_EXT));
+    }
+}
+
 } // namespace priv
 
 } // namespace sf3d
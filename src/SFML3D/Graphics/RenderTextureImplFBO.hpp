@@ -66,21 +66,49 @@ public :
     ////////////////////////////////////////////////////////////
     static bool isAvailable();
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the maximum number of color attachments
+    ///
+    /// \return Maximum number of textures written at once by a frame buffer
+    ///
+    ////////////////////////////////////////////////////////////
+    static unsigned int getMaximumColorAttachmentCount();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Check whether a color format can be rendered to
+    ///
+    /// \param format Format to check
+    ///
+    /// \return True if frame buffers can render to textures of this format
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool isFormatAvailable(RenderTexture::Format format);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Check whether depth textures can be rendered to
+    ///
+    /// \param stencil Must the depth texture hold the stencil too?
+    ///
+    /// \return True if frame buffers can render to depth textures
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool isDepthTextureAvailable(bool stencil);
+
 private :
 
     ////////////////////////////////////////////////////////////
     /// \brief Create the render texture implementation
     ///
-    /// \param width         Width of the texture to render to
-    /// \param height        Height of the texture to render to
-    /// \param textureId     OpenGL identifier of the target texture
-    /// \param depthBuffer   Is a depth buffer requested?
-    /// \param stencilBuffer Is a stencil buffer requested?
+    /// \param width          Width of the texture to render to
+    /// \param height         Height of the texture to render to
+    /// \param colorTextures  OpenGL identifiers of the target color textures
+    /// \param depthTexture   OpenGL identifier of the target depth texture, 0 if none
+    /// \param settings       Requested buffers
     ///
     /// \return True if creation has been successful
     ///
     ////////////////////////////////////////////////////////////
-    virtual bool create(unsigned int width, unsigned int height, unsigned int textureId, bool depthBuffer, bool stencilBuffer);
+    virtual bool create(unsigned int width, unsigned int height, const std::vector<unsigned int>& colorTextures, unsigned int depthTexture, const RenderTexture::Settings& settings);
 
     ////////////////////////////////////////////////////////////
     /// \brief Activate or deactivate the render texture for rendering
@@ -100,13 +128,26 @@ private :
     ////////////////////////////////////////////////////////////
     virtual void updateTexture(unsigned textureId);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Select the color attachments written by the bound frame buffer
+    ///
+    /// \param count Number of color attachments
+    ///
+    ////////////////////////////////////////////////////////////
+    static void setDrawBuffers(std::size_t count);
+
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
-    Context*     m_context;       ///< Needs a separate OpenGL context for not messing up the other ones
-    unsigned int m_frameBuffer;   ///< OpenGL frame buffer object
-    unsigned int m_depthBuffer;   ///< Optional depth buffer attached to the frame buffer
-    unsigned int m_stencilBuffer; ///< Optional depth buffer attached to the frame buffer
+    Context*                  m_context;            ///< Needs a separate OpenGL context for not messing up the other ones
+    unsigned int              m_frameBuffer;        ///< OpenGL frame buffer object, the one rendered to
+    unsigned int              m_resolveFrameBuffer; ///< Frame buffer holding the target textures, when multisampling
+    std::vector<unsigned int> m_colorBuffers;       ///< Multisampled color buffers attached to the frame buffer
+    unsigned int              m_depthBuffer;        ///< Optional depth buffer attached to the frame buffer
+    unsigned int              m_stencilBuffer;      ///< Optional stencil buffer attached to the frame buffer
+    unsigned int              m_width;              ///< Width of the frame buffer
+    unsigned int              m_height;             ///< Height of the frame buffer
+    unsigned int              m_resolveMask;        ///< Buffers to copy to the textures when multisampling
 };
 
 } // namespace priv
@@ -88,15 +88,12 @@ Image RenderWindow::capture() const
         int width = static_cast<int>(getSize().x);
         int height = static_cast<int>(getSize().y);
 
-        // copy rows one by one and flip them (OpenGL's origin is bottom while SFML3D's origin is top)
+        // read all the rows at once, then flip them (OpenGL's origin is bottom while SFML3D's origin is top)
         std::vector<Uint8> pixels(width * height * 4);
-        for (int i = 0; i < height; ++i)
-        {
-            Uint8* ptr = &pixels[i * width * 4];
-            glCheck(glReadPixels(0, height - i - 1, width, 1, GL_RGBA, GL_UNSIGNED_BYTE, ptr));
-        }
+        glCheck(glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, &pixels[0]));
 
         image.create(width, height, &pixels[0]);
+        image.flipVertically();
     }
 
     return image;
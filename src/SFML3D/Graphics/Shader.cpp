@@ -35,9 +35,17 @@
 #include <SFML3D/System/Lock.hpp>
 #include <SFML3D/System/Err.hpp>
 #include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
 #include <vector>
 
 
+#ifndef GL_COMPLETION_STATUS_KHR
+    #define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+
 namespace
 {
     // Thread-safe unique identifier generator,
@@ -101,6 +109,133 @@ namespace
         buffer.push_back('\0');
         return success;
     }
+
+    // Directory of the program binary cache, empty if disabled
+    sf3d::Mutex cacheMutex;
+    std::string cacheDirectory;
+
+    // Identifies the files of the program binary cache, and their layout
+    const char         cacheMagic[4] = {'S', 'F', 'P', 'B'};
+    const sf3d::Uint32 cacheVersion = 1;
+
+    // Feed a string to a 64-bit FNV-1a hash
+    sf3d::Uint64 hashString(sf3d::Uint64 hash, const char* data)
+    {
+        const sf3d::Uint64 prime = (static_cast<sf3d::Uint64>(0x100) << 32) | 0x1b3;
+
+        for (; data && *data; ++data)
+        {
+            hash ^= static_cast<unsigned char>(*data);
+            hash *= prime;
+        }
+
+        // Terminate each string, so that text moved from a source to the next changes the hash
+        hash ^= 0xff;
+        hash *= prime;
+        return hash;
+    }
+
+    // Get the string identifying the current OpenGL driver
+    std::string getDriverString()
+    {
+        std::string driver;
+        const GLenum names[] = {GL_VENDOR, GL_RENDERER, GL_VERSION};
+
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            const GLubyte* value = NULL;
+            glCheck(value = glGetString(names[i]));
+            if (value)
+                driver += reinterpret_cast<const char*>(value);
+            driver += '\n';
+        }
+
+        return driver;
+    }
+
+    // Write a value to a cache file
+    template <typename T>
+    void writeValue(std::ofstream& file, const T& value)
+    {
+        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    // Read a value from a cache file
+    template <typename T>
+    bool readValue(std::ifstream& file, T& value)
+    {
+        return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(value)));
+    }
+
+    // Load a cached binary into a program, fails if it is missing, invalid or rejected by the driver
+    bool loadProgramBinary(GLuint program, const std::string& path, sf3d::Uint64 hash, const std::string& driver)
+    {
+        std::ifstream file(path.c_str(), std::ios_base::binary);
+        if (!file)
+            return false;
+
+        char magic[4];
+        sf3d::Uint32 version = 0;
+        sf3d::Uint64 fileHash = 0;
+        sf3d::Uint32 driverLength = 0;
+        if (!file.read(magic, 4) || !std::equal(magic, magic + 4, cacheMagic) ||
+            !readValue(file, version) || (version != cacheVersion) ||
+            !readValue(file, fileHash) || (fileHash != hash) ||
+            !readValue(file, driverLength) || (driverLength != driver.size()))
+            return false;
+
+        // The binary is only valid for the driver that produced it
+        std::string fileDriver(driverLength, '\0');
+        if (driverLength && !file.read(&fileDriver[0], driverLength))
+            return false;
+        if (fileDriver != driver)
+            return false;
+
+        sf3d::Uint32 format = 0;
+        sf3d::Uint32 length = 0;
+        if (!readValue(file, format) || !readValue(file, length) || !length)
+            return false;
+
+        std::vector<char> binary(length);
+        if (!file.read(&binary[0], length))
+            return false;
+
+        // Drivers reject binaries they can't use anymore, e.g. after an update
+        glCheck(glProgramBinary(program, format, &binary[0], static_cast<GLsizei>(length)));
+
+        GLint success = GL_FALSE;
+        glCheck(glGetObjectParameterivARB(program, GL_OBJECT_LINK_STATUS_ARB, &success));
+        return success == GL_TRUE;
+    }
+
+    // Save the binary of a linked program to the cache
+    void saveProgramBinary(GLuint program, const std::string& path, sf3d::Uint64 hash, const std::string& driver)
+    {
+        GLint length = 0;
+        glCheck(glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length));
+        if (length <= 0)
+            return;
+
+        std::vector<char> binary(static_cast<std::size_t>(length));
+        GLenum format = 0;
+        glCheck(glGetProgramBinary(program, length, NULL, &format, &binary[0]));
+
+        std::ofstream file(path.c_str(), std::ios_base::binary | std::ios_base::trunc);
+        if (file)
+        {
+            file.write(cacheMagic, 4);
+            writeValue(file, cacheVersion);
+            writeValue(file, hash);
+            writeValue(file, static_cast<sf3d::Uint32>(driver.size()));
+            file.write(driver.c_str(), driver.size());
+            writeValue(file, static_cast<sf3d::Uint32>(format));
+            writeValue(file, static_cast<sf3d::Uint32>(length));
+            file.write(&binary[0], length);
+        }
+
+        if (!file)
+            sf3d::err() << "Failed to save program binary to cache file \"" << path << "\"" << std::endl;
+    }
 }
 
 
@@ -120,6 +255,11 @@ m_attributes    (),
 m_blockBindings (),
 m_warnMissing   (true),
 m_id            (0),
+m_targetId      (0),
+m_status        (Unloaded),
+m_pendingStages (),
+m_cachePath     (),
+m_cacheHash     (0),
 m_parameterBlock(false),
 m_blockProgram  (0)
 {
@@ -131,6 +271,10 @@ Shader::~Shader()
 {
     ensureGlContext();
 
+    // Destroy the shaders of a pending compilation
+    for (std::size_t i = 0; i < m_pendingStages.size(); ++i)
+        glCheck(glDeleteObjectARB(m_pendingStages[i]));
+
     // Destroy effect program
     if (m_shaderProgram)
         glCheck(glDeleteObjectARB(m_shaderProgram));
@@ -288,6 +432,69 @@ bool Shader::loadFromStream(InputStream& vertexShaderStream, InputStream& fragme
 }
 
 
+////////////////////////////////////////////////////////////
+bool Shader::loadFromFileAsync(const std::string& vertexShaderFilename, const std::string& fragmentShaderFilename, const std::string& geometryShaderFilename)
+{
+    // Read the vertex shader file
+    std::vector<char> vertexShader;
+    if (!getFileContents(vertexShaderFilename, vertexShader))
+    {
+        err() << "Failed to open vertex shader file \"" << vertexShaderFilename << "\"" << std::endl;
+        return false;
+    }
+
+    // Read the fragment shader file
+    std::vector<char> fragmentShader;
+    if (!getFileContents(fragmentShaderFilename, fragmentShader))
+    {
+        err() << "Failed to open fragment shader file \"" << fragmentShaderFilename << "\"" << std::endl;
+        return false;
+    }
+
+    // Read the geometry shader file
+    std::vector<char> geometryShader;
+    if (!geometryShaderFilename.empty() && !getFileContents(geometryShaderFilename, geometryShader))
+    {
+        err() << "Failed to open geometry shader file \"" << geometryShaderFilename << "\"" << std::endl;
+        return false;
+    }
+
+    // Submit the compilation of the shader program
+    return compile(&vertexShader[0], &fragmentShader[0], geometryShaderFilename.empty() ? NULL : &geometryShader[0], true);
+}
+
+
+////////////////////////////////////////////////////////////
+bool Shader::loadFromMemoryAsync(const std::string& vertexShader, const std::string& fragmentShader, const std::string& geometryShader)
+{
+    // Submit the compilation of the shader program
+    return compile(vertexShader.c_str(), fragmentShader.c_str(), geometryShader.empty() ? NULL : geometryShader.c_str(), true);
+}
+
+
+////////////////////////////////////////////////////////////
+Shader::Status Shader::getStatus() const
+{
+    if (m_status == Compiling)
+    {
+        ensureGlContext();
+
+        // Without parallel compilation, the driver can only be asked for the result, which waits for it
+        if (isParallelCompileAvailable())
+        {
+            GLint completed = GL_FALSE;
+            glCheck(glGetProgramiv(m_shaderProgram, GL_COMPLETION_STATUS_KHR, &completed));
+            if (completed == GL_FALSE)
+                return Compiling;
+        }
+
+        finishCompile();
+    }
+
+    return m_status;
+}
+
+
 ////////////////////////////////////////////////////////////
 void Shader::setParameter(const std::string& name, int x) const
 {
@@ -766,7 +973,7 @@ void Shader::bind(const Shader* shader)
 {
     ensureGlContext();
 
-    if (shader && shader->m_shaderProgram)
+    if (shader && (shader->getStatus() == Ready))
     {
         // Enable the program
         glCheck(glUseProgramObjectARB(shader->m_shaderProgram));
@@ -871,7 +1078,87 @@ unsigned int Shader::getMaximumUniformComponents()
 
 
 ////////////////////////////////////////////////////////////
-bool Shader::compile(const char* vertexShaderCode, const char* fragmentShaderCode, const char* geometryShaderCode)
+bool Shader::isProgramBinaryAvailable()
+{
+    static bool checked = false;
+    static bool programBinarySupported = false;
+
+    if (!checked)
+    {
+        checked = true;
+
+        if (isAvailable() && GLEW_ARB_get_program_binary)
+        {
+            // Some drivers expose the extension without supporting any binary format
+            GLint formats = 0;
+            glCheck(glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats));
+            programBinarySupported = (formats > 0);
+        }
+    }
+
+    return programBinarySupported;
+}
+
+
+////////////////////////////////////////////////////////////
+bool Shader::isParallelCompileAvailable()
+{
+    static bool checked = false;
+    static bool parallelCompileSupported = false;
+
+    if (!checked)
+    {
+        checked = true;
+
+        // The extension is not known by GLEW, look for it in the list of extensions
+        if (isAvailable() && GLEW_VERSION_3_0)
+        {
+            GLint count = 0;
+            glCheck(glGetIntegerv(GL_NUM_EXTENSIONS, &count));
+
+            for (GLint i = 0; (i < count) && !parallelCompileSupported; ++i)
+            {
+                const GLubyte* name = NULL;
+                glCheck(name = glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)));
+
+                if (name)
+                {
+                    std::string extension(reinterpret_cast<const char*>(name));
+                    parallelCompileSupported = (extension == "GL_KHR_parallel_shader_compile") ||
+                                               (extension == "GL_ARB_parallel_shader_compile");
+                }
+            }
+        }
+    }
+
+    return parallelCompileSupported;
+}
+
+
+////////////////////////////////////////////////////////////
+void Shader::setProgramCacheDirectory(const std::string& directory)
+{
+    Lock lock(cacheMutex);
+
+    cacheDirectory = directory;
+
+    // Strip the trailing separator, it is added when building the paths of the cache files
+    while (!cacheDirectory.empty() && ((*cacheDirectory.rbegin() == '/') || (*cacheDirectory.rbegin() == '\\')))
+        cacheDirectory.erase(cacheDirectory.size() - 1);
+}
+
+
+////////////////////////////////////////////////////////////
+std::string Shader::getProgramCacheDirectory()
+{
+    Lock lock(cacheMutex);
+
+    return cacheDirectory;
+}
+
+
+////////////////////////////////////////////////////////////
+bool Shader::compile(const char* vertexShaderCode, const char* fragmentShaderCode, const char* geometryShaderCode, bool async)
 {
     ensureGlContext();
 
@@ -883,6 +1170,10 @@ bool Shader::compile(const char* vertexShaderCode, const char* fragmentShaderCod
         return false;
     }
 
+    // Destroy the shaders of a pending compilation
+    for (std::size_t i = 0; i < m_pendingStages.size(); ++i)
+        glCheck(glDeleteObjectARB(m_pendingStages[i]));
+
     // Destroy the shader if it was already created
     if (m_shaderProgram)
         glCheck(glDeleteObjectARB(m_shaderProgram));
@@ -894,118 +1185,144 @@ bool Shader::compile(const char* vertexShaderCode, const char* fragmentShaderCod
     m_attributes.clear();
     m_blockBindings.clear();
     m_boundBuffers.clear();
+    m_pendingStages.clear();
+    m_cachePath.clear();
+    m_targetId = 0;
+    m_status = Unloaded;
 
     // Create the program
     m_shaderProgram = glCreateProgramObjectARB();
+    m_id = getUniqueId();
 
-    // Create the vertex shader if needed
-    if (vertexShaderCode)
+    // Look for a binary of the same sources in the cache
+    if (isProgramBinaryAvailable())
     {
-        // Create and compile the shader
-        GLhandleARB vertexShader = glCreateShaderObjectARB(GL_VERTEX_SHADER_ARB);
-        glCheck(glShaderSourceARB(vertexShader, 1, &vertexShaderCode, NULL));
-        glCheck(glCompileShaderARB(vertexShader));
-
-        // Check the compile log
-        GLint success;
-        glCheck(glGetObjectParameterivARB(vertexShader, GL_OBJECT_COMPILE_STATUS_ARB, &success));
-        if (success == GL_FALSE)
+        std::string directory = getProgramCacheDirectory();
+
+        if (!directory.empty())
         {
-            char log[1024];
-            glCheck(glGetInfoLogARB(vertexShader, sizeof(log), 0, log));
-            err() << "Failed to compile vertex shader:" << std::endl
-                  << log << std::endl;
-            glCheck(glDeleteObjectARB(vertexShader));
+            const Uint64 offsetBasis = (static_cast<Uint64>(0xcbf29ce4) << 32) | 0x84222325;
+
+            std::string driver = getDriverString();
+            Uint64 hash = hashString(offsetBasis, driver.c_str());
+            hash = hashString(hash, vertexShaderCode);
+            hash = hashString(hash, fragmentShaderCode);
+            hash = hashString(hash, geometryShaderCode);
+
+            std::ostringstream path;
+            path << directory << '/' << std::hex << std::setfill('0') << std::setw(16) << hash << ".bin";
+
+            if (loadProgramBinary(m_shaderProgram, path.str(), hash, driver))
+            {
+                glCheck(glFlush());
+                m_status = Ready;
+                return true;
+            }
+
+            // The program may be left in a failed state, start over with a new one
             glCheck(glDeleteObjectARB(m_shaderProgram));
-            m_shaderProgram = 0;
-            return false;
+            m_shaderProgram = glCreateProgramObjectARB();
+
+            // Make the driver keep the binary of the program once linked
+            glCheck(glProgramParameteri(m_shaderProgram, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+
+            m_cachePath = path.str();
+            m_cacheHash = hash;
         }
+    }
 
-        // Attach the shader to the program, and delete it (not needed anymore)
-        glCheck(glAttachObjectARB(m_shaderProgram, vertexShader));
-        glCheck(glDeleteObjectARB(vertexShader));
+    // Submit the compilation of the shaders and the link of the program,
+    // their results are only checked afterwards so that the driver can work in the background
+    const char* sources[] = {vertexShaderCode, fragmentShaderCode, geometryShaderCode};
+    const GLenum types[] = {GL_VERTEX_SHADER_ARB, GL_FRAGMENT_SHADER_ARB, GL_GEOMETRY_SHADER};
+
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        if (sources[i])
+        {
+            GLhandleARB shader = glCreateShaderObjectARB(types[i]);
+            glCheck(glShaderSourceARB(shader, 1, &sources[i], NULL));
+            glCheck(glCompileShaderARB(shader));
+            glCheck(glAttachObjectARB(m_shaderProgram, shader));
+            m_pendingStages.push_back(shader);
+        }
     }
 
-    // Create the fragment shader if needed
-    if (fragmentShaderCode)
+    glCheck(glLinkProgramARB(m_shaderProgram));
+
+    // Force an OpenGL flush, so that the shader will appear updated
+    // in all contexts immediately (solves problems in multi-threaded apps)
+    glCheck(glFlush());
+
+    m_status = Compiling;
+
+    if (async)
+        return true;
+
+    // Wait for the result
+    return finishCompile();
+}
+
+
+////////////////////////////////////////////////////////////
+bool Shader::finishCompile() const
+{
+    bool success = true;
+
+    // Check the compile logs
+    for (std::size_t i = 0; i < m_pendingStages.size(); ++i)
     {
-        // Create and compile the shader
-        GLhandleARB fragmentShader = glCreateShaderObjectARB(GL_FRAGMENT_SHADER_ARB);
-        glCheck(glShaderSourceARB(fragmentShader, 1, &fragmentShaderCode, NULL));
-        glCheck(glCompileShaderARB(fragmentShader));
-
-        // Check the compile log
-        GLint success;
-        glCheck(glGetObjectParameterivARB(fragmentShader, GL_OBJECT_COMPILE_STATUS_ARB, &success));
-        if (success == GL_FALSE)
+        GLint compiled;
+        glCheck(glGetObjectParameterivARB(m_pendingStages[i], GL_OBJECT_COMPILE_STATUS_ARB, &compiled));
+        if (compiled == GL_FALSE)
         {
+            GLint type;
+            glCheck(glGetObjectParameterivARB(m_pendingStages[i], GL_OBJECT_SUBTYPE_ARB, &type));
+
             char log[1024];
-            glCheck(glGetInfoLogARB(fragmentShader, sizeof(log), 0, log));
-            err() << "Failed to compile fragment shader:" << std::endl
+            glCheck(glGetInfoLogARB(m_pendingStages[i], sizeof(log), 0, log));
+            err() << "Failed to compile " << ((type == GL_VERTEX_SHADER_ARB) ? "vertex" : (type == GL_FRAGMENT_SHADER_ARB) ? "fragment" : "geometry")
+                  << " shader:" << std::endl
                   << log << std::endl;
-            glCheck(glDeleteObjectARB(fragmentShader));
-            glCheck(glDeleteObjectARB(m_shaderProgram));
-            m_shaderProgram = 0;
-            return false;
+            success = false;
         }
 
-        // Attach the shader to the program, and delete it (not needed anymore)
-        glCheck(glAttachObjectARB(m_shaderProgram, fragmentShader));
-        glCheck(glDeleteObjectARB(fragmentShader));
+        // The shader is attached, it is only deleted along with the program
+        glCheck(glDeleteObjectARB(m_pendingStages[i]));
     }
 
-    // Create the geometry shader if needed
-    if (geometryShaderCode)
+    m_pendingStages.clear();
+
+    // Check the link log, link errors are caused by compile errors when there are some
+    if (success)
     {
-        // Create and compile the shader
-        GLhandleARB geometryShader = glCreateShaderObjectARB(GL_GEOMETRY_SHADER);
-        glCheck(glShaderSourceARB(geometryShader, 1, &geometryShaderCode, NULL));
-        glCheck(glCompileShaderARB(geometryShader));
-
-        // Check the compile log
-        GLint success;
-        glCheck(glGetObjectParameterivARB(geometryShader, GL_OBJECT_COMPILE_STATUS_ARB, &success));
-        if (success == GL_FALSE)
+        GLint linked;
+        glCheck(glGetObjectParameterivARB(m_shaderProgram, GL_OBJECT_LINK_STATUS_ARB, &linked));
+        if (linked == GL_FALSE)
         {
             char log[1024];
-            glCheck(glGetInfoLogARB(geometryShader, sizeof(log), 0, log));
-            err() << "Failed to compile geometry shader:" << std::endl
+            glCheck(glGetInfoLogARB(m_shaderProgram, sizeof(log), 0, log));
+            err() << "Failed to link shader:" << std::endl
                   << log << std::endl;
-            glCheck(glDeleteObjectARB(geometryShader));
-            glCheck(glDeleteObjectARB(m_shaderProgram));
-            m_shaderProgram = 0;
-            return false;
+            success = false;
         }
-
-        // Attach the shader to the program, and delete it (not needed anymore)
-        glCheck(glAttachObjectARB(m_shaderProgram, geometryShader));
-        glCheck(glDeleteObjectARB(geometryShader));
     }
 
-    // Link the program
-    glCheck(glLinkProgramARB(m_shaderProgram));
+    // Save the program, so that the next load doesn't have to compile it
+    if (success && !m_cachePath.empty())
+        saveProgramBinary(m_shaderProgram, m_cachePath, m_cacheHash, getDriverString());
 
-    // Check the link log
-    GLint success;
-    glCheck(glGetObjectParameterivARB(m_shaderProgram, GL_OBJECT_LINK_STATUS_ARB, &success));
-    if (success == GL_FALSE)
+    // A failed program is unloaded
+    if (!success)
     {
-        char log[1024];
-        glCheck(glGetInfoLogARB(m_shaderProgram, sizeof(log), 0, log));
-        err() << "Failed to link shader:" << std::endl
-              << log << std::endl;
         glCheck(glDeleteObjectARB(m_shaderProgram));
         m_shaderProgram = 0;
-        return false;
     }
 
-    // Force an OpenGL flush, so that the shader will appear updated
-    // in all contexts immediately (solves problems in multi-threaded apps)
-    glCheck(glFlush());
-
-    m_id = getUniqueId();
+    m_cachePath.clear();
+    m_status = success ? Ready : Failed;
 
-    return true;
+    return success;
 }
 
 
@@ -0,0 +1,826 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/Graphics/ShadowMap.hpp>
+#include <SFML3D/Graphics/Light.hpp>
+#include <SFML3D/Graphics/Polyhedron.hpp>
+#include <SFML3D/Graphics/Shader.hpp>
+#include <SFML3D/Graphics/View.hpp>
+#include <SFML3D/Graphics/DefaultShader.hpp>
+#include <SFML3D/Graphics/GLCheck.hpp>
+#include <SFML3D/System/Mutex.hpp>
+#include <SFML3D/System/Lock.hpp>
+#include <SFML3D/System/Err.hpp>
+#include <algorithm>
+#include <sstream>
+#include <cmath>
+
+
+namespace
+{
+    // Maximum number of shadow maps used by the default shader
+    const unsigned int maxShadowMaps = 4;
+
+    // Maximum number of cascades of a directional light
+    const unsigned int maxCascades = 4;
+
+    // Near plane of the cube faces of a positional light, relative to its range
+    const float faceNearRatio = 0.002f;
+
+    // Weight of the logarithmic distribution of the cascade splits, the rest is uniform
+    const float cascadeSplitWeight = 0.75f;
+
+    // Shadow map slots and depth shader, shared by all the shadow maps
+    sf3d::Mutex           mutex;
+    unsigned int          count = 0;
+    sf3d::ShadowMap*      slots[maxShadowMaps] = {NULL};
+    sf3d::Shader*         depthShader = NULL;
+    bool                  depthShaderFailed = false;
+
+    // Get the shader rendering the casters, compiling it on first use
+    const sf3d::Shader* getDepthShader()
+    {
+        sf3d::Lock lock(mutex);
+
+        if (!depthShader && !depthShaderFailed)
+        {
+            depthShader = new sf3d::Shader;
+            if (!depthShader->loadFromMemory(sf3d::priv::getDefaultVertexShaderSource(),
+                                             sf3d::priv::getDefaultFragmentShaderSource("#define SF_DEPTH_ONLY\n")))
+            {
+                sf3d::err() << "Compiling shadow map depth shader failed" << std::endl;
+                delete depthShader;
+                depthShader = NULL;
+                depthShaderFailed = true;
+            }
+        }
+
+        return depthShader;
+    }
+
+    // Get the first of the texture units reserved for the shadow maps
+    int getFirstShadowUnit()
+    {
+        GLint maxUnits = 0;
+        glCheck(glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS_ARB, &maxUnits));
+        return static_cast<int>(maxUnits) - static_cast<int>(maxShadowMaps);
+    }
+
+    // Get the name of a shadow uniform, given its prefix and index
+    const std::string& getUniformName(std::vector<std::string>& names, const char* prefix, const char* suffix, unsigned int index, unsigned int size)
+    {
+        if (names.empty())
+        {
+            names.reserve(size);
+            for (unsigned int i = 0; i < size; ++i)
+            {
+                std::ostringstream name;
+                name << prefix << i << suffix;
+                names.push_back(name.str());
+            }
+        }
+
+        return names[index];
+    }
+
+    // Vector helpers
+    float dot(const sf3d::Vector3f& left, const sf3d::Vector3f& right)
+    {
+        return left.x * right.x + left.y * right.y + left.z * right.z;
+    }
+
+    sf3d::Vector3f cross(const sf3d::Vector3f& left, const sf3d::Vector3f& right)
+    {
+        return sf3d::Vector3f(left.y * right.z - left.z * right.y,
+                              left.z * right.x - left.x * right.z,
+                              left.x * right.y - left.y * right.x);
+    }
+
+    sf3d::Vector3f normalize(const sf3d::Vector3f& vector)
+    {
+        return vector / std::sqrt(dot(vector, vector));
+    }
+
+    // Transform a point from clip space back to world space
+    sf3d::Vector3f unproject(const sf3d::Transform& inverse, float x, float y, float z)
+    {
+        const float* m = inverse.getMatrix();
+        float w = m[3] * x + m[7] * y + m[11] * z + m[15];
+        return inverse.transformPoint(x, y, z) / w;
+    }
+
+    // Get the corners of a box
+    void getCorners(const sf3d::FloatBox& box, sf3d::Vector3f* corners)
+    {
+        for (int i = 0; i < 8; ++i)
+            corners[i] = sf3d::Vector3f((i & 1) ? box.left + box.width  : box.left,
+                                        (i & 2) ? box.top  + box.height : box.top,
+                                        (i & 4) ? box.front + box.depth : box.front);
+    }
+
+    // Check whether a box may be inside a frustum, given its view projection transform
+    bool isInFrustum(const sf3d::Transform& viewProjection, const sf3d::FloatBox& box)
+    {
+        sf3d::Vector3f corners[8];
+        getCorners(box, corners);
+
+        // Count, for each clipping plane, the corners that are outside of it
+        const float* m = viewProjection.getMatrix();
+        int outside[6] = {0, 0, 0, 0, 0, 0};
+        for (int i = 0; i < 8; ++i)
+        {
+            const sf3d::Vector3f& p = corners[i];
+            float x = m[0] * p.x + m[4] * p.y + m[8]  * p.z + m[12];
+            float y = m[1] * p.x + m[5] * p.y + m[9]  * p.z + m[13];
+            float z = m[2] * p.x + m[6] * p.y + m[10] * p.z + m[14];
+            float w = m[3] * p.x + m[7] * p.y + m[11] * p.z + m[15];
+
+            outside[0] += (x < -w);
+            outside[1] += (x >  w);
+            outside[2] += (y < -w);
+            outside[3] += (y >  w);
+            outside[4] += (z < -w);
+            outside[5] += (z >  w);
+        }
+
+        // The box is outside if all its corners are on the outer side of the same plane
+        for (int i = 0; i < 6; ++i)
+        {
+            if (outside[i] == 8)
+                return false;
+        }
+
+        return true;
+    }
+
+    // View rendering from a light, with precomputed transforms
+    class LightView : public sf3d::View
+    {
+    public :
+
+        LightView(const sf3d::Transform& projection, const sf3d::Transform& view, const sf3d::Vector3f& position) :
+        m_projection(projection),
+        m_view      (view),
+        m_position  (position)
+        {
+        }
+
+        virtual const sf3d::Transform& getTransform() const
+        {
+            return m_projection;
+        }
+
+        virtual const sf3d::Transform& getViewTransform() const
+        {
+            return m_view;
+        }
+
+        virtual const sf3d::Vector3f& getPosition() const
+        {
+            return m_position;
+        }
+
+    private :
+
+        sf3d::Transform m_projection;
+        sf3d::Transform m_view;
+        sf3d::Vector3f  m_position;
+    };
+}
+
+
+namespace sf3d
+{
+////////////////////////////////////////////////////////////
+struct ShadowMap::Caster
+{
+    const Drawable*   drawable;   ///< Drawable casting shadows
+    const Polyhedron* polyhedron; ///< Same object as a polyhedron, if its bounds are tracked automatically
+    FloatBox          bounds;     ///< Global bounds of the drawable
+};
+
+
+////////////////////////////////////////////////////////////
+struct ShadowMap::Tile
+{
+    Transform projection;     ///< Projection of the cascade or face
+    Transform view;           ///< View transform of the cascade or face
+    Transform viewProjection; ///< Combined transform, from world space to clip space
+    bool      valid;          ///< Was the tile rendered with these transforms?
+    bool      dirty;          ///< Must the tile be rendered by the current update?
+};
+
+
+////////////////////////////////////////////////////////////
+ShadowMap::ShadowMap() :
+m_light       (NULL),
+m_slot        (-1),
+m_texture     (),
+m_resolution  (0),
+m_cascadeCount(0),
+m_directional (false),
+m_range       (1000.f),
+m_depthBias   (0.001f),
+m_updatedTiles(0)
+{
+    Lock lock(mutex);
+    count++;
+}
+
+
+////////////////////////////////////////////////////////////
+ShadowMap::~ShadowMap()
+{
+    if (m_light)
+        m_light->m_shadowMap = NULL;
+
+    clearCasters();
+
+    {
+        Lock lock(mutex);
+
+        if (m_slot >= 0)
+            slots[m_slot] = NULL;
+
+        for (std::size_t i = 0; i < m_tiles.size(); ++i)
+            delete m_tiles[i];
+
+        count--;
+        if (!count)
+        {
+            delete depthShader;
+            depthShader = NULL;
+            depthShaderFailed = false;
+        }
+    }
+
+    Light::setNeedUniformUpload();
+}
+
+
+////////////////////////////////////////////////////////////
+bool ShadowMap::create(Light& light, unsigned int resolution, unsigned int cascadeCount)
+{
+    if (!Light::hasShaderLighting())
+    {
+        err() << "Failed to create shadow map, shader lighting is not available" << std::endl;
+        return false;
+    }
+
+    if (!resolution)
+    {
+        err() << "Failed to create shadow map, invalid resolution (" << resolution << ")" << std::endl;
+        return false;
+    }
+
+    // Get a slot in the default shader
+    if (m_slot < 0)
+    {
+        Lock lock(mutex);
+
+        for (unsigned int i = 0; (i < maxShadowMaps) && (m_slot < 0); ++i)
+        {
+            if (!slots[i])
+            {
+                slots[i] = this;
+                m_slot = static_cast<int>(i);
+            }
+        }
+
+        if (m_slot < 0)
+        {
+            err() << "Failed to create shadow map, at most " << maxShadowMaps << " shadow maps can exist at the same time" << std::endl;
+            return false;
+        }
+    }
+
+    // Lay the tiles out: the cascades side by side, or the cube faces in 3 columns and 2 rows
+    bool directional = light.isDirectional();
+    unsigned int cascades = std::min(std::max(cascadeCount, 1u), maxCascades);
+    unsigned int columns = directional ? cascades : 3;
+    unsigned int rows = directional ? 1 : 2;
+
+    RenderTexture::Settings settings;
+    settings.depthTexture = true;
+    if (!m_texture.create(resolution * columns, resolution * rows, settings))
+    {
+        err() << "Failed to create shadow map, the depth texture couldn't be created" << std::endl;
+        return false;
+    }
+
+    // Set up the states of the render texture once, so that the first draw doesn't reset the view
+    m_texture.resetGLStates();
+    if (m_texture.setActive(true))
+        m_texture.enableDepthTest(true);
+
+    // Attach to the light, detaching from any previous one
+    if (m_light && (m_light != &light))
+        m_light->m_shadowMap = NULL;
+    if (light.m_shadowMap && (light.m_shadowMap != this))
+        light.m_shadowMap->m_light = NULL;
+
+    m_light = &light;
+    m_light->m_shadowMap = this;
+    m_resolution = resolution;
+    m_cascadeCount = cascades;
+    m_directional = directional;
+
+    {
+        Lock lock(mutex);
+
+        for (std::size_t i = 0; i < m_tiles.size(); ++i)
+            delete m_tiles[i];
+        m_tiles.clear();
+
+        for (unsigned int i = 0; i < columns * rows; ++i)
+        {
+            Tile* tile = new Tile;
+            tile->valid = false;
+            tile->dirty = true;
+            m_tiles.push_back(tile);
+        }
+    }
+
+    // The light now refers to the slot of the shadow map
+    Light::setNeedUniformUpload();
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+void ShadowMap::setRange(float range)
+{
+    m_range = range;
+}
+
+
+////////////////////////////////////////////////////////////
+float ShadowMap::getRange() const
+{
+    return m_range;
+}
+
+
+////////////////////////////////////////////////////////////
+void ShadowMap::setDepthBias(float bias)
+{
+    m_depthBias = bias;
+}
+
+
+////////////////////////////////////////////////////////////
+float ShadowMap::getDepthBias() const
+{
+    return m_depthBias;
+}
+
+
+////////////////////////////////////////////////////////////
+void ShadowMap::addCaster(const Polyhedron& caster)
+{
+    Caster* entry = new Caster;
+    entry->drawable = &caster;
+    entry->polyhedron = &caster;
+    entry->bounds = caster.getGlobalBounds();
+    m_casters.push_back(entry);
+
+    m_changes.push_back(entry->bounds);
+}
+
+
+////////////////////////////////////////////////////////////
+void ShadowMap::addCaster(const Drawable& caster, const FloatBox& bounds)
+{
+    Caster* entry = new Caster;
+    entry->drawable = &caster;
+    entry->polyhedron = NULL;
+    entry->bounds = bounds;
+    m_casters.push_back(entry);
+
+    m_changes.push_back(bounds);
+}
+
+
+////////////////////////////////////////////////////////////
+void ShadowMap::setCasterBounds(const Drawable& caster, const FloatBox& bounds)
+{
+    for (std::size_t i = 0; i < m_casters.size(); ++i)
+    {
+        if ((m_casters[i]->drawable == &caster) && (m_casters[i]->bounds != bounds))
+        {
+            // Both the area the caster left and the one it entered must be re-rendered
+            m_changes.push_back(m_casters[i]->bounds);
+            m_changes.push_back(bounds);
+            m_casters[i]->bounds = bounds;
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void ShadowMap::removeCaster(const Drawable& caster)
+{
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < m_casters.size(); ++i)
+    {
+        if (m_casters[i]->drawable == &caster)
+        {
+            m_changes.push_back(m_casters[i]->bounds);
+            delete m_casters[i];
+        }
+        else
+        {
+            m_casters[kept++] = m_casters[i];
+        }
+    }
+
+    m_casters.resize(kept);
+}
+
+
+////////////////////////////////////////////////////////////
+void ShadowMap::clearCasters()
+{
+    for (std::size_t i = 0; i < m_casters.size(); ++i)
+    {
+        m_changes.push_back(m_casters[i]->bounds);
+        delete m_casters[i];
+    }
+
+    m_casters.clear();
+}
+
+
+////////////////////////////////////////////////////////////
+void ShadowMap::invalidate()
+{
+    {
+        Lock lock(mutex);
+
+        for (std::size_t i = 0; i < m_tiles.size(); ++i)
+            m_tiles[i]->valid = false;
+    }
+
+    // The lights stop sampling the shadow map until it is rendered again
+    Light::setNeedUniformUpload();
+}
+
+
+////////////////////////////////////////////////////////////
+void ShadowMap::update(const View& view)
+{
+    m_updatedTiles = 0;
+
+    if (!m_light || m_tiles.empty())
+        return;
+
+    // The layout depends on the type of the light
+    if (m_light->isDirectional() != m_directional)
+    {
+        if (!create(*m_light, m_resolution, m_cascadeCount))
+            return;
+    }
+
+    // Track the polyhedra that moved
+    for (std::size_t i = 0; i < m_casters.size(); ++i)
+    {
+        Caster& caster = *m_casters[i];
+        if (caster.polyhedron)
+        {
+            FloatBox bounds = caster.polyhedron->getGlobalBounds();
+            if (bounds != caster.bounds)
+            {
+                m_changes.push_back(caster.bounds);
+                m_changes.push_back(bounds);
+                caster.bounds = bounds;
+            }
+        }
+    }
+
+    // Keep the previous transforms, to detect the tiles that moved
+    std::vector<Transform> previous(m_tiles.size());
+    for (std::size_t i = 0; i < m_tiles.size(); ++i)
+        previous[i] = m_tiles[i]->viewProjection;
+
+    if (m_directional)
+        computeCascades(view);
+    else
+        computeFaces();
+
+    // A tile must be rendered if it moved, or if a caster changed inside it
+    bool needRender = false;
+    for (std::size_t i = 0; i < m_tiles.size(); ++i)
+    {
+        Tile& tile = *m_tiles[i];
+        tile.dirty = !tile.valid || !std::equal(tile.viewProjection.getMatrix(), tile.viewProjection.getMatrix() + 16, previous[i].getMatrix());
+
+        for (std::size_t j = 0; (j < m_changes.size()) && !tile.dirty; ++j)
+            tile.dirty = isInFrustum(tile.viewProjection, m_changes[j]);
+
+        needRender = needRender || tile.dirty;
+    }
+
+    m_changes.clear();
+
+    if (!needRender || !getDepthShader() || !m_texture.setActive(true))
+        return;
+
+    // Only the depth is rendered, restricted to one tile at a time
+    glCheck(glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE));
+    glCheck(glEnable(GL_SCISSOR_TEST));
+
+    bool wasReady = m_tiles[0]->valid;
+
+    for (std::size_t i = 0; i < m_tiles.size(); ++i)
+    {
+        if (m_tiles[i]->dirty)
+        {
+            renderTile(i);
+            m_updatedTiles++;
+
+            Lock lock(mutex);
+            m_tiles[i]->valid = true;
+        }
+    }
+
+    glCheck(glDisable(GL_SCISSOR_TEST));
+    glCheck(glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE));
+
+    m_texture.display();
+
+    // The lights start sampling the shadow map once it has been rendered
+    if (!wasReady)
+        Light::setNeedUniformUpload();
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int ShadowMap::getUpdatedTileCount() const
+{
+    return m_updatedTiles;
+}
+
+
+////////////////////////////////////////////////////////////
+const Texture& ShadowMap::getTexture() const
+{
+    return m_texture.getDepthTexture();
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int ShadowMap::getMaximumShadowMaps()
+{
+    return maxShadowMaps;
+}
+
+
+////////////////////////////////////////////////////////////
+void ShadowMap::computeCascades(const View& view)
+{
+    // Get the corners of the near and far planes of the view
+    Transform inverse = (view.getTransform() * view.getViewTransform()).getInverse();
+    Vector3f nearCorners[4];
+    Vector3f farCorners[4];
+    Vector3f nearCenter;
+    Vector3f farCenter;
+    for (int i = 0; i < 4; ++i)
+    {
+        float x = (i & 1) ? 1.f : -1.f;
+        float y = (i & 2) ? 1.f : -1.f;
+        nearCorners[i] = unproject(inverse, x, y, -1.f);
+        farCorners[i] = unproject(inverse, x, y, 1.f);
+        nearCenter += nearCorners[i] / 4.f;
+        farCenter += farCorners[i] / 4.f;
+    }
+
+    Vector3f eye = view.getPosition();
+    float nearDistance = std::sqrt(dot(nearCenter - eye, nearCenter - eye));
+    float farDistance = std::sqrt(dot(farCenter - eye, farCenter - eye));
+    float shadowDistance = std::max(std::min(farDistance, m_range), nearDistance);
+    float viewDepth = std::max(farDistance - nearDistance, 0.0001f);
+
+    // Basis of the light space, independent of the view so that cascades only move with the viewer
+    Vector3f direction = normalize(m_light->getDirection());
+    Vector3f up = (std::fabs(direction.y) > 0.99f) ? Vector3f(1.f, 0.f, 0.f) : Vector3f(0.f, 1.f, 0.f);
+    Vector3f side = normalize(cross(direction, up));
+    up = cross(side, direction);
+
+    Transform lightView(side.x,       side.y,       side.z,      0.f,
+                        up.x,         up.y,         up.z,        0.f,
+                        -direction.x, -direction.y, -direction.z, 0.f,
+                        0.f,          0.f,          0.f,          1.f);
+
+    float splitStart = 0.f;
+    for (std::size_t i = 0; i < m_tiles.size(); ++i)
+    {
+        // Split the view between logarithmic and uniform distributions
+        float ratio = static_cast<float>(i + 1) / m_tiles.size();
+        float uniform = nearDistance + (shadowDistance - nearDistance) * ratio;
+        float logarithmic = (nearDistance > 0.f) ? nearDistance * std::pow(shadowDistance / nearDistance, ratio) : uniform;
+        float splitEnd = ((cascadeSplitWeight * logarithmic + (1.f - cascadeSplitWeight) * uniform) - nearDistance) / viewDepth;
+
+        // Bound the slice of the view with a sphere, which doesn't change size when the view rotates
+        Vector3f corners[8];
+        Vector3f center;
+        for (int j = 0; j < 4; ++j)
+        {
+            corners[j] = nearCorners[j] + (farCorners[j] - nearCorners[j]) * splitStart;
+            corners[j + 4] = nearCorners[j] + (farCorners[j] - nearCorners[j]) * splitEnd;
+            center += (corners[j] + corners[j + 4]) / 8.f;
+        }
+
+        float radius = 0.f;
+        for (int j = 0; j < 8; ++j)
+            radius = std::max(radius, dot(corners[j] - center, corners[j] - center));
+        radius = std::sqrt(radius);
+
+        // Round the radius up, so that rounding errors don't change it from one update to the next
+        float step = std::pow(2.f, std::floor(std::log(std::max(radius, 0.0001f)) / std::log(2.f)) - 6.f);
+        radius = std::ceil(radius / step) * step;
+
+        // Snap the center to the texels of the cascade
+        float texel = 2.f * radius / m_resolution;
+        float x = std::floor(dot(center, side) / texel) * texel;
+        float y = std::floor(dot(center, up) / texel) * texel;
+        float depth = dot(center, direction);
+        float nearDepth = depth - radius;
+        float farDepth = depth + radius;
+
+        // Pull the near plane toward the light, to include the casters between the light and the slice
+        for (std::size_t j = 0; j < m_casters.size(); ++j)
+        {
+            Vector3f casterCorners[8];
+            getCorners(m_casters[j]->bounds, casterCorners);
+
+            float minX = dot(casterCorners[0], side);
+            float maxX = minX;
+            float minY = dot(casterCorners[0], up);
+            float maxY = minY;
+            float minDepth = dot(casterCorners[0], direction);
+            for (int k = 1; k < 8; ++k)
+            {
+                float cornerX = dot(casterCorners[k], side);
+                float cornerY = dot(casterCorners[k], up);
+                minX = std::min(minX, cornerX);
+                maxX = std::max(maxX, cornerX);
+                minY = std::min(minY, cornerY);
+                maxY = std::max(maxY, cornerY);
+                minDepth = std::min(minDepth, dot(casterCorners[k], direction));
+            }
+
+            if ((maxX >= x - radius) && (minX <= x + radius) && (maxY >= y - radius) && (minY <= y + radius) && (minDepth < farDepth))
+                nearDepth = std::min(nearDepth, minDepth);
+        }
+
+        // Orthographic projection of the box around the slice
+        float width = 2.f * radius;
+        float length = farDepth - nearDepth;
+        Transform projection(2.f / width, 0.f,          0.f,            -2.f * x / width,
+                             0.f,         2.f / width,  0.f,            -2.f * y / width,
+                             0.f,         0.f,          -2.f / length,  -(farDepth + nearDepth) / length,
+                             0.f,         0.f,          0.f,            1.f);
+
+        Tile& tile = *m_tiles[i];
+        tile.projection = projection;
+        tile.view = lightView;
+        tile.viewProjection = projection * lightView;
+
+        splitStart = splitEnd;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void ShadowMap::computeFaces()
+{
+    // Directions and up vectors of the faces, in the order the default shader selects them
+    static const float directions[6][3] = {{1.f, 0.f, 0.f}, {-1.f, 0.f, 0.f}, {0.f, 1.f, 0.f}, {0.f, -1.f, 0.f}, {0.f, 0.f, 1.f}, {0.f, 0.f, -1.f}};
+    static const float ups[6][3] = {{0.f, 1.f, 0.f}, {0.f, 1.f, 0.f}, {0.f, 0.f, 1.f}, {0.f, 0.f, 1.f}, {0.f, 1.f, 0.f}, {0.f, 1.f, 0.f}};
+
+    // Perspective projection with a 90 degrees field of view
+    float nearPlane = m_range * faceNearRatio;
+    float farPlane = m_range;
+    Transform projection(1.f, 0.f, 0.f,                                            0.f,
+                         0.f, 1.f, 0.f,                                            0.f,
+                         0.f, 0.f, (farPlane + nearPlane) / (nearPlane - farPlane), 2.f * farPlane * nearPlane / (nearPlane - farPlane),
+                         0.f, 0.f, -1.f,                                           0.f);
+
+    const Vector3f& position = m_light->getPosition();
+    for (std::size_t i = 0; i < 6; ++i)
+    {
+        Vector3f direction(directions[i][0], directions[i][1], directions[i][2]);
+        Vector3f side = cross(direction, Vector3f(ups[i][0], ups[i][1], ups[i][2]));
+        Vector3f up = cross(side, direction);
+
+        Transform view(side.x,       side.y,       side.z,       0.f,
+                       up.x,         up.y,         up.z,         0.f,
+                       -direction.x, -direction.y, -direction.z, 0.f,
+                       0.f,          0.f,          0.f,          1.f);
+        view.translate(-position);
+
+        Tile& tile = *m_tiles[i];
+        tile.projection = projection;
+        tile.view = view;
+        tile.viewProjection = projection * view;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void ShadowMap::renderTile(std::size_t index)
+{
+    Tile& tile = *m_tiles[index];
+
+    unsigned int columns = m_directional ? static_cast<unsigned int>(m_tiles.size()) : 3;
+    unsigned int rows = m_directional ? 1 : 2;
+    unsigned int column = static_cast<unsigned int>(index) % columns;
+    unsigned int row = static_cast<unsigned int>(index) / columns;
+
+    // Clear the tile only, the others may still be valid
+    glCheck(glScissor(column * m_resolution, row * m_resolution, m_resolution, m_resolution));
+    glCheck(glClear(GL_DEPTH_BUFFER_BIT));
+
+    // Viewports are given from the top of the target, rows are counted from the bottom of the texture
+    LightView view(tile.projection, tile.view, m_light->getPosition());
+    view.setViewport(FloatRect(static_cast<float>(column) / columns, 1.f - static_cast<float>(row + 1) / rows,
+                               1.f / columns, 1.f / rows));
+    m_texture.setView(view);
+
+    // Draw the casters inside the tile
+    RenderStates states(getDepthShader());
+    for (std::size_t i = 0; i < m_casters.size(); ++i)
+    {
+        if (isInFrustum(tile.viewProjection, m_casters[i]->bounds))
+            m_texture.draw(*m_casters[i]->drawable, states);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void ShadowMap::addShadowMapsToShader(const Shader& shader)
+{
+    // Casters are rendered without lighting
+    if (&shader == depthShader)
+        return;
+
+    static const int firstUnit = getFirstShadowUnit();
+    static std::vector<std::string> infoNames;
+    static std::vector<std::string> matrixNames;
+    static std::vector<std::string> mapNames;
+
+    Lock lock(mutex);
+
+    // Shaders compiled without SF_SHADOWS don't declare the shadow uniforms
+    bool previousWarnSetting = shader.warnMissing(false);
+
+    for (unsigned int slot = 0; slot < maxShadowMaps; ++slot)
+    {
+        const ShadowMap* shadowMap = slots[slot];
+        if (!shadowMap || !shadowMap->isReady())
+            continue;
+
+        float cascades = shadowMap->m_directional ? static_cast<float>(shadowMap->m_tiles.size()) : 0.f;
+        shader.setParameter(getUniformName(infoNames, "sf_ShadowInfo[", "]", slot, maxShadowMaps),
+                            cascades, shadowMap->m_depthBias, 1.f / shadowMap->m_resolution, 0.f);
+
+        for (std::size_t i = 0; i < shadowMap->m_tiles.size(); ++i)
+            shader.setParameter(getUniformName(matrixNames, "sf_ShadowMatrices[", "]", slot * 6 + static_cast<unsigned int>(i), maxShadowMaps * 6),
+                                shadowMap->m_tiles[i]->viewProjection);
+
+        // The depth texture is bound to a reserved unit, so that the shader doesn't keep a pointer to it
+        shader.setParameter(getUniformName(mapNames, "sf_ShadowMap", "", slot, maxShadowMaps), firstUnit + static_cast<int>(slot));
+        glCheck(glActiveTextureARB(GL_TEXTURE0_ARB + firstUnit + slot));
+        Texture::bind(&shadowMap->m_texture.getDepthTexture());
+        glCheck(glActiveTextureARB(GL_TEXTURE0_ARB));
+    }
+
+    shader.warnMissing(previousWarnSetting);
+}
+
+
+////////////////////////////////////////////////////////////
+bool ShadowMap::hasShadowMaps()
+{
+    Lock lock(mutex);
+    return count > 0;
+}
+
+
+////////////////////////////////////////////////////////////
+bool ShadowMap::isReady() const
+{
+    return (m_slot >= 0) && m_light && !m_tiles.empty() && m_tiles[0]->valid;
+}
+
+
+////////////////////////////////////////////////////////////
+int ShadowMap::getShaderSlot() const
+{
+    Lock lock(mutex);
+
+    return isReady() ? m_slot : -1;
+}
+
+} // namespace sf3d
@@ -0,0 +1,61 @@
+////////////////////////////////////////////////////////////
+//
+// SFML3D - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2014 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+#ifndef SFML3D_SIMD_HPP
+#define SFML3D_SIMD_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/Config.hpp>
+
+
+////////////////////////////////////////////////////////////
+/// Detect the SIMD instruction sets that the compiler is
+/// allowed to emit for the current target. Every kernel that
+/// uses them must also provide a scalar fallback, selected
+/// when the corresponding macro is not defined.
+////////////////////////////////////////////////////////////
+#if !defined(SFML3D_NO_SIMD)
+
+    #if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+
+        // SSE2 is part of the x86-64 baseline
+        #define SFML3D_SIMD_SSE2
+        #include <emmintrin.h>
+
+    #endif
+
+    #if defined(__AVX2__)
+
+        // AVX2 is only used when the compiler targets it explicitly
+        #define SFML3D_SIMD_AVX2
+        #include <immintrin.h>
+
+    #endif
+
+#endif
+
+
+#endif // SFML3D_SIMD_HPP
@@ -0,0 +1,735 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/Graphics/SkinnedModel.hpp>
+#include <SFML3D/Graphics/Shader.hpp>
+#include <SFML3D/Graphics/Light.hpp>
+#include <SFML3D/Graphics/Image.hpp>
+#include <SFML3D/Graphics/RenderStates.hpp>
+#include <SFML3D/Graphics/DefaultShader.hpp>
+#include <SFML3D/Graphics/Parallel.hpp>
+#include <SFML3D/Graphics/Simd.hpp>
+#include <SFML3D/System/Mutex.hpp>
+#include <SFML3D/System/Lock.hpp>
+#include <SFML3D/System/Err.hpp>
+#include <algorithm>
+#include <sstream>
+#include <cmath>
+
+
+namespace
+{
+    // Maximum number of bones supported by the skinning shader
+    const unsigned int maxGpuBones = 64;
+
+    // Number of vertices stored in a row of the bone weights texture (2 texels each)
+    const unsigned int weightsPerRow = 512;
+
+    // Minimum number of vertices skinned by a thread
+    const std::size_t skinningGrain = 4096;
+
+    // Skinning shader, shared by all the skinned models
+    sf3d::Mutex   mutex;
+    unsigned int  count = 0;
+    sf3d::Shader* skinningShader = NULL;
+    bool          skinningShaderFailed = false;
+
+    // Get the skinning shader, compiling it on first use
+    const sf3d::Shader* getSkinningShader()
+    {
+        sf3d::Lock lock(mutex);
+
+        if (!skinningShader && !skinningShaderFailed)
+        {
+            std::ostringstream defines;
+            defines << "#define SF_SKINNING\n"
+                    << "#define SF_MAX_BONES " << maxGpuBones << "\n"
+                    << "#define SF_BONE_WEIGHTS_PER_ROW " << weightsPerRow << "\n";
+
+            skinningShader = new sf3d::Shader;
+            if (!skinningShader->loadFromMemory(sf3d::priv::getDefaultVertexShaderSource(defines.str()),
+                                                sf3d::priv::getDefaultFragmentShaderSource()))
+            {
+                sf3d::err() << "Compiling skinning shader failed. Falling back to CPU skinning..." << std::endl;
+                delete skinningShader;
+                skinningShader = NULL;
+                skinningShaderFailed = true;
+            }
+        }
+
+        return skinningShader;
+    }
+
+    // Get the name of the uniform holding the matrix of a bone
+    const std::string& getBoneUniformName(unsigned int bone)
+    {
+        static std::vector<std::string> names;
+
+        if (names.empty())
+        {
+            names.reserve(maxGpuBones);
+            for (unsigned int i = 0; i < maxGpuBones; ++i)
+            {
+                std::ostringstream name;
+                name << "sf_BoneMatrices[" << i << "]";
+                names.push_back(name.str());
+            }
+        }
+
+        return names[bone];
+    }
+
+    // Minimal quaternion, used to interpolate bone rotations
+    struct Quaternion
+    {
+        float x, y, z, w;
+    };
+
+    // Build a quaternion from an axis and an angle in degrees
+    Quaternion fromAxisAngle(const sf3d::Vector3f& axis, float angle)
+    {
+        Quaternion q = {0.f, 0.f, 0.f, 1.f};
+
+        float norm = std::sqrt(axis.x * axis.x + axis.y * axis.y + axis.z * axis.z);
+        if (norm == 0.f)
+            return q;
+
+        float half = angle * 3.141592654f / 360.f;
+        float sine = std::sin(half) / norm;
+
+        q.x = axis.x * sine;
+        q.y = axis.y * sine;
+        q.z = axis.z * sine;
+        q.w = std::cos(half);
+        return q;
+    }
+
+    // Spherical linear interpolation between two quaternions
+    Quaternion slerp(const Quaternion& a, Quaternion b, float t)
+    {
+        float cosine = a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+
+        // Take the shortest path
+        if (cosine < 0.f)
+        {
+            cosine = -cosine;
+            b.x = -b.x; b.y = -b.y; b.z = -b.z; b.w = -b.w;
+        }
+
+        float wa = 1.f - t;
+        float wb = t;
+
+        // Fall back to a normalized linear interpolation for close rotations
+        if (cosine < 0.9995f)
+        {
+            float angle = std::acos(cosine);
+            float sine = std::sin(angle);
+            wa = std::sin(wa * angle) / sine;
+            wb = std::sin(wb * angle) / sine;
+        }
+
+        Quaternion q = {a.x * wa + b.x * wb, a.y * wa + b.y * wb, a.z * wa + b.z * wb, a.w * wa + b.w * wb};
+
+        float norm = std::sqrt(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+        q.x /= norm; q.y /= norm; q.z /= norm; q.w /= norm;
+        return q;
+    }
+
+    // Build a translation * rotation * scale transform
+    sf3d::Transform compose(const sf3d::Vector3f& t, const Quaternion& q, const sf3d::Vector3f& s)
+    {
+        float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+        float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+        float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+
+        return sf3d::Transform((1.f - 2.f * (yy + zz)) * s.x, 2.f * (xy - wz) * s.y,         2.f * (xz + wy) * s.z,         t.x,
+                               2.f * (xy + wz) * s.x,         (1.f - 2.f * (xx + zz)) * s.y, 2.f * (yz - wx) * s.z,         t.y,
+                               2.f * (xz - wy) * s.x,         2.f * (yz + wx) * s.y,         (1.f - 2.f * (xx + yy)) * s.z, t.z,
+                               0.f,                           0.f,                           0.f,                           1.f);
+    }
+
+    // Keyframe ordering predicate
+    bool keyframeBefore(const sf3d::SkinnedModel::Keyframe& left, const sf3d::SkinnedModel::Keyframe& right)
+    {
+        return left.time < right.time;
+    }
+}
+
+
+namespace sf3d
+{
+////////////////////////////////////////////////////////////
+struct SkinnedModel::SkinningTask : priv::ParallelTask
+{
+    SkinningTask(SkinnedModel& theModel) : model(theModel) {}
+
+    virtual void run(std::size_t begin, std::size_t end)
+    {
+        model.skinVertices(begin, end);
+    }
+
+    SkinnedModel& model;
+};
+
+
+////////////////////////////////////////////////////////////
+SkinnedModel::Keyframe::Keyframe() :
+time         (Time::Zero),
+translation  (0.f, 0.f, 0.f),
+rotationAxis (0.f, 0.f, 1.f),
+rotationAngle(0.f),
+scale        (1.f, 1.f, 1.f)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+SkinnedModel::VertexWeights::VertexWeights()
+{
+    for (int i = 0; i < 4; ++i)
+    {
+        bones[i] = 0;
+        weights[i] = 0.f;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+SkinnedModel::SkinnedModel() :
+m_time          (Time::Zero),
+m_duration      (Time::Zero),
+m_looping       (true),
+m_mode          (CpuSkinning),
+m_threadCount   (0),
+m_weightsChanged(true)
+{
+    Lock lock(mutex);
+    count++;
+}
+
+
+////////////////////////////////////////////////////////////
+SkinnedModel::SkinnedModel(const SkinnedModel& copy) :
+Model           (copy),
+m_bones         (copy.m_bones),
+m_tracks        (copy.m_tracks),
+m_weights       (copy.m_weights),
+m_bindPositions (copy.m_bindPositions),
+m_bindNormals   (copy.m_bindNormals),
+m_skinMatrices  (copy.m_skinMatrices),
+m_time          (copy.m_time),
+m_duration      (copy.m_duration),
+m_looping       (copy.m_looping),
+m_mode          (copy.m_mode),
+m_threadCount   (copy.m_threadCount),
+m_weightsChanged(true)
+{
+    Lock lock(mutex);
+    count++;
+}
+
+
+////////////////////////////////////////////////////////////
+SkinnedModel::~SkinnedModel()
+{
+    Lock lock(mutex);
+    count--;
+
+    if (!count)
+    {
+        delete skinningShader;
+        skinningShader = NULL;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int SkinnedModel::getBoneCount() const
+{
+    return static_cast<unsigned int>(m_bones.size());
+}
+
+
+////////////////////////////////////////////////////////////
+int SkinnedModel::getBoneParent(unsigned int bone) const
+{
+    return m_bones[bone].parent;
+}
+
+
+////////////////////////////////////////////////////////////
+const Transform& SkinnedModel::getBoneTransform(unsigned int bone) const
+{
+    return m_bones[bone].skinning;
+}
+
+
+////////////////////////////////////////////////////////////
+void SkinnedModel::setAnimationTime(Time time)
+{
+    // Wrap or clamp the time to the animation range
+    Int64 duration = m_duration.asMicroseconds();
+    Int64 current = time.asMicroseconds();
+
+    if (duration > 0)
+    {
+        if (m_looping)
+        {
+            current %= duration;
+            if (current < 0)
+                current += duration;
+        }
+        else
+        {
+            current = std::max(Int64(0), std::min(current, duration));
+        }
+    }
+    else
+    {
+        current = 0;
+    }
+
+    m_time = microseconds(current);
+
+    // Evaluate the hierarchy, parents always come before their children
+    float seconds = m_time.asSeconds();
+    m_skinMatrices.resize(m_bones.size() * 16);
+
+    for (std::size_t i = 0; i < m_bones.size(); ++i)
+    {
+        Bone& bone = m_bones[i];
+
+        Transform local = sampleBone(static_cast<unsigned int>(i), seconds);
+        bone.global = (bone.parent >= 0) ? m_bones[bone.parent].global * local : local;
+        bone.skinning = bone.global * bone.inverseBind;
+
+        std::copy(bone.skinning.getMatrix(), bone.skinning.getMatrix() + 16, m_skinMatrices.begin() + i * 16);
+    }
+
+    // The shader does the work in GPU mode, the matrices are uploaded when drawing
+    if ((m_mode == GpuSkinning) || m_bones.empty())
+        return;
+
+    if (m_bindPositions.size() != getVertexCount())
+        updateBindPose();
+
+    SkinningTask task(*this);
+    priv::parallelFor(task, m_bindPositions.size(), skinningGrain, m_threadCount);
+
+    update();
+}
+
+
+////////////////////////////////////////////////////////////
+Time SkinnedModel::getAnimationTime() const
+{
+    return m_time;
+}
+
+
+////////////////////////////////////////////////////////////
+Time SkinnedModel::getAnimationDuration() const
+{
+    return m_duration;
+}
+
+
+////////////////////////////////////////////////////////////
+void SkinnedModel::setLooping(bool looping)
+{
+    m_looping = looping;
+}
+
+
+////////////////////////////////////////////////////////////
+bool SkinnedModel::isLooping() const
+{
+    return m_looping;
+}
+
+
+////////////////////////////////////////////////////////////
+void SkinnedModel::setSkinningMode(SkinningMode mode)
+{
+    if (mode == GpuSkinning)
+    {
+        if (!isGpuSkinningAvailable() || !getSkinningShader())
+        {
+            err() << "GPU skinning is not available, using CPU skinning" << std::endl;
+            mode = CpuSkinning;
+        }
+        else if (m_bones.size() > maxGpuBones)
+        {
+            err() << "Too many bones for GPU skinning (" << m_bones.size() << ", maximum is "
+                  << maxGpuBones << "), using CPU skinning" << std::endl;
+            mode = CpuSkinning;
+        }
+    }
+
+    if (mode == m_mode)
+        return;
+
+    m_mode = mode;
+
+    if (m_mode == GpuSkinning)
+    {
+        // The shader expects the vertices in their bind pose
+        restoreBindPose();
+        m_weightsChanged = true;
+    }
+    else
+    {
+        setAnimationTime(m_time);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+SkinnedModel::SkinningMode SkinnedModel::getSkinningMode() const
+{
+    return m_mode;
+}
+
+
+////////////////////////////////////////////////////////////
+void SkinnedModel::setThreadCount(unsigned int threadCount)
+{
+    m_threadCount = threadCount;
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int SkinnedModel::getThreadCount() const
+{
+    return m_threadCount;
+}
+
+
+////////////////////////////////////////////////////////////
+bool SkinnedModel::isGpuSkinningAvailable()
+{
+    // Same requirements as the default non-legacy shader
+    return Light::hasShaderLighting();
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int SkinnedModel::getMaximumGpuBones()
+{
+    return maxGpuBones;
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int SkinnedModel::addBone(int parent, const Transform& bindTransform)
+{
+    if (parent >= static_cast<int>(m_bones.size()))
+    {
+        err() << "Bone parent " << parent << " must be added before its children, "
+              << "the bone is added as a root" << std::endl;
+        parent = -1;
+    }
+
+    Bone bone;
+    bone.parent      = parent;
+    bone.inverseBind = bindTransform.getInverse();
+    bone.bindLocal   = (parent >= 0) ? m_bones[parent].inverseBind * bindTransform : bindTransform;
+    bone.global      = bindTransform;
+
+    m_bones.push_back(bone);
+    m_tracks.push_back(std::vector<Keyframe>());
+
+    return static_cast<unsigned int>(m_bones.size() - 1);
+}
+
+
+////////////////////////////////////////////////////////////
+void SkinnedModel::setVertexWeights(unsigned int index, const VertexWeights& weights)
+{
+    if (m_weights.size() <= index)
+        m_weights.resize(getVertexCount() > index ? getVertexCount() : index + 1);
+
+    VertexWeights& target = m_weights[index];
+    target = weights;
+
+    // Normalize the weights and discard invalid bones
+    float sum = 0.f;
+    for (int i = 0; i < 4; ++i)
+    {
+        if ((target.bones[i] >= m_bones.size()) || (target.weights[i] < 0.f))
+        {
+            if (target.weights[i] != 0.f)
+                err() << "Invalid bone weight for vertex " << index << ", it is ignored" << std::endl;
+
+            target.bones[i] = 0;
+            target.weights[i] = 0.f;
+        }
+
+        sum += target.weights[i];
+    }
+
+    if (sum > 0.f)
+    {
+        for (int i = 0; i < 4; ++i)
+            target.weights[i] /= sum;
+    }
+
+    m_weightsChanged = true;
+}
+
+
+////////////////////////////////////////////////////////////
+void SkinnedModel::addKeyframe(unsigned int bone, const Keyframe& keyframe)
+{
+    std::vector<Keyframe>& track = m_tracks[bone];
+    track.insert(std::upper_bound(track.begin(), track.end(), keyframe, keyframeBefore), keyframe);
+
+    if (keyframe.time > m_duration)
+        m_duration = keyframe.time;
+}
+
+
+////////////////////////////////////////////////////////////
+void SkinnedModel::clearKeyframes()
+{
+    for (std::size_t i = 0; i < m_tracks.size(); ++i)
+        m_tracks[i].clear();
+
+    m_duration = Time::Zero;
+}
+
+
+////////////////////////////////////////////////////////////
+void SkinnedModel::updateBindPose()
+{
+    unsigned int vertexCount = getVertexCount();
+
+    m_bindPositions.resize(vertexCount);
+    m_bindNormals.resize(vertexCount);
+    m_weights.resize(vertexCount);
+
+    for (unsigned int i = 0; i < vertexCount; ++i)
+    {
+        m_bindPositions[i] = getVertex(i).position;
+        m_bindNormals[i] = getVertex(i).normal;
+    }
+
+    m_weightsChanged = true;
+}
+
+
+////////////////////////////////////////////////////////////
+void SkinnedModel::draw(RenderTarget& target, RenderStates states) const
+{
+    if ((m_mode == GpuSkinning) && !m_bones.empty())
+    {
+        const Shader* shader = getSkinningShader();
+
+        if (shader)
+        {
+            if (m_weightsChanged)
+                updateWeightsTexture();
+
+            shader->setParameter("sf_BoneWeights", m_weightsTexture);
+
+            for (std::size_t i = 0; i < m_bones.size(); ++i)
+                shader->setParameter(getBoneUniformName(static_cast<unsigned int>(i)), m_bones[i].skinning);
+
+            states.shader = shader;
+        }
+    }
+
+    Model::draw(target, states);
+}
+
+
+////////////////////////////////////////////////////////////
+Transform SkinnedModel::sampleBone(unsigned int bone, float time) const
+{
+    const std::vector<Keyframe>& track = m_tracks[bone];
+
+    if (track.empty())
+        return m_bones[bone].bindLocal;
+
+    // Find the first keyframe after the current time
+    Keyframe key;
+    key.time = seconds(time);
+    std::vector<Keyframe>::const_iterator next = std::upper_bound(track.begin(), track.end(), key, keyframeBefore);
+
+    if (next == track.begin())
+        return compose(next->translation, fromAxisAngle(next->rotationAxis, next->rotationAngle), next->scale);
+
+    std::vector<Keyframe>::const_iterator previous = next - 1;
+
+    if (next == track.end())
+        return compose(previous->translation, fromAxisAngle(previous->rotationAxis, previous->rotationAngle), previous->scale);
+
+    // Interpolate between the surrounding keyframes
+    float start = previous->time.asSeconds();
+    float span = next->time.asSeconds() - start;
+    float t = (span > 0.f) ? (time - start) / span : 0.f;
+
+    Vector3f translation = previous->translation + (next->translation - previous->translation) * t;
+    Vector3f scale = previous->scale + (next->scale - previous->scale) * t;
+    Quaternion rotation = slerp(fromAxisAngle(previous->rotationAxis, previous->rotationAngle),
+                                fromAxisAngle(next->rotationAxis, next->rotationAngle), t);
+
+    return compose(translation, rotation, scale);
+}
+
+
+////////////////////////////////////////////////////////////
+void SkinnedModel::skinVertices(std::size_t begin, std::size_t end)
+{
+    const float* matrices = &m_skinMatrices[0];
+
+    for (std::size_t i = begin; i < end; ++i)
+    {
+        const VertexWeights& skin = m_weights[i];
+        const Vector3f& position = m_bindPositions[i];
+        const Vector3f& normal = m_bindNormals[i];
+
+        Vertex vertex = getVertex(static_cast<unsigned int>(i));
+
+        float total = skin.weights[0] + skin.weights[1] + skin.weights[2] + skin.weights[3];
+
+        if (total <= 0.f)
+        {
+            // Vertex not attached to any bone
+            vertex.position = position;
+            vertex.normal = normal;
+            setVertex(static_cast<unsigned int>(i), vertex);
+            continue;
+        }
+
+#if defined(SFML3D_SIMD_SSE2)
+
+        // Blend the columns of the bone matrices
+        __m128 c0 = _mm_setzero_ps();
+        __m128 c1 = _mm_setzero_ps();
+        __m128 c2 = _mm_setzero_ps();
+        __m128 c3 = _mm_setzero_ps();
+
+        for (int j = 0; j < 4; ++j)
+        {
+            if (skin.weights[j] == 0.f)
+                continue;
+
+            const float* m = matrices + skin.bones[j] * 16;
+            __m128 w = _mm_set1_ps(skin.weights[j]);
+            c0 = _mm_add_ps(c0, _mm_mul_ps(_mm_loadu_ps(m + 0),  w));
+            c1 = _mm_add_ps(c1, _mm_mul_ps(_mm_loadu_ps(m + 4),  w));
+            c2 = _mm_add_ps(c2, _mm_mul_ps(_mm_loadu_ps(m + 8),  w));
+            c3 = _mm_add_ps(c3, _mm_mul_ps(_mm_loadu_ps(m + 12), w));
+        }
+
+        __m128 p = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(position.x)),
+                                         _mm_mul_ps(c1, _mm_set1_ps(position.y))),
+                              _mm_add_ps(_mm_mul_ps(c2, _mm_set1_ps(position.z)), c3));
+        __m128 n = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(normal.x)),
+                                         _mm_mul_ps(c1, _mm_set1_ps(normal.y))),
+                              _mm_mul_ps(c2, _mm_set1_ps(normal.z)));
+
+        float result[8];
+        _mm_storeu_ps(result, p);
+        _mm_storeu_ps(result + 4, n);
+
+        vertex.position = Vector3f(result[0], result[1], result[2]);
+        Vector3f skinnedNormal(result[4], result[5], result[6]);
+
+#else
+
+        // Blend the bone matrices
+        float m[16] = {0.f};
+
+        for (int j = 0; j < 4; ++j)
+        {
+            if (skin.weights[j] == 0.f)
+                continue;
+
+            const float* bone = matrices + skin.bones[j] * 16;
+            for (int k = 0; k < 16; ++k)
+                m[k] += bone[k] * skin.weights[j];
+        }
+
+        vertex.position = Vector3f(m[0] * position.x + m[4] * position.y + m[8]  * position.z + m[12],
+                                   m[1] * position.x + m[5] * position.y + m[9]  * position.z + m[13],
+                                   m[2] * position.x + m[6] * position.y + m[10] * position.z + m[14]);
+        Vector3f skinnedNormal(m[0] * normal.x + m[4] * normal.y + m[8]  * normal.z,
+                               m[1] * normal.x + m[5] * normal.y + m[9]  * normal.z,
+                               m[2] * normal.x + m[6] * normal.y + m[10] * normal.z);
+
+#endif
+
+        float length = std::sqrt(skinnedNormal.x * skinnedNormal.x +
+                                 skinnedNormal.y * skinnedNormal.y +
+                                 skinnedNormal.z * skinnedNormal.z);
+        if (length != 0.f)
+            skinnedNormal /= length;
+
+        vertex.normal = skinnedNormal;
+        setVertex(static_cast<unsigned int>(i), vertex);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void SkinnedModel::restoreBindPose()
+{
+    if (m_bindPositions.size() != getVertexCount())
+        updateBindPose();
+
+    for (std::size_t i = 0; i < m_bindPositions.size(); ++i)
+    {
+        Vertex vertex = getVertex(static_cast<unsigned int>(i));
+        vertex.position = m_bindPositions[i];
+        vertex.normal = m_bindNormals[i];
+        setVertex(static_cast<unsigned int>(i), vertex);
+    }
+
+    update();
+}
+
+
+////////////////////////////////////////////////////////////
+void SkinnedModel::updateWeightsTexture() const
+{
+    m_weightsChanged = false;
+
+    // The geometry is drawn as an expanded triangle list, so the
+    // weights are stored per face corner rather than per vertex
+    unsigned int cornerCount = getFaceCount() * 3;
+    if (!cornerCount)
+        return;
+
+    unsigned int rows = (cornerCount + weightsPerRow - 1) / weightsPerRow;
+    std::vector<Uint8> pixels(weightsPerRow * 2 * rows * 4, 0);
+
+    for (unsigned int face = 0; face < getFaceCount(); ++face)
+    {
+        unsigned int indices[3];
+        getFaceIndices(face, indices[0], indices[1], indices[2]);
+
+        for (unsigned int corner = 0; corner < 3; ++corner)
+        {
+            unsigned int id = face * 3 + corner;
+            Uint8* texel = &pixels[((id / weightsPerRow) * weightsPerRow * 2 + (id % weightsPerRow) * 2) * 4];
+
+            if (indices[corner] >= m_weights.size())
+                continue;
+
+            const VertexWeights& skin = m_weights[indices[corner]];
+            for (int j = 0; j < 4; ++j)
+            {
+                texel[j]     = static_cast<Uint8>(skin.bones[j]);
+                texel[j + 4] = static_cast<Uint8>(skin.weights[j] * 255.f + 0.5f);
+            }
+        }
+    }
+
+    Image image;
+    image.create(weightsPerRow * 2, rows, &pixels[0]);
+    m_weightsTexture.loadFromImage(image);
+}
+
+} // namespace sf3d
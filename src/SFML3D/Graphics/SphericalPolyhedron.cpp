@@ -2,6 +2,7 @@
 // Headers
 ////////////////////////////////////////////////////////////
 #include <SFML3D/Graphics/SphericalPolyhedron.hpp>
+#include <algorithm>
 #include <cmath>
 
 
@@ -80,6 +81,20 @@ Polyhedron::Face SphericalPolyhedron::getFace(unsigned int index) const
 }
 
 
+////////////////////////////////////////////////////////////
+void SphericalPolyhedron::getFaces(Vertex* vertices, unsigned int first, unsigned int count) const
+{
+    if (m_geometry.empty())
+        construct();
+
+    std::copy(m_geometry.begin() + first * 3, m_geometry.begin() + (first + count) * 3, vertices);
+
+    // Same as getFace, release the geometry once the last face was read
+    if (first + count == m_geometry.size() / 3)
+        std::vector<Vertex>().swap(m_geometry);
+}
+
+
 ////////////////////////////////////////////////////////////
 void SphericalPolyhedron::construct() const
 {
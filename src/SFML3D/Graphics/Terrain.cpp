@@ -0,0 +1,574 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/Graphics/Terrain.hpp>
+#include <SFML3D/Graphics/RenderTarget.hpp>
+#include <SFML3D/Graphics/Image.hpp>
+#include <SFML3D/Graphics/Texture.hpp>
+#include <SFML3D/Graphics/Parallel.hpp>
+#include <SFML3D/System/Lock.hpp>
+#include <SFML3D/System/Err.hpp>
+#include <algorithm>
+#include <cmath>
+
+
+namespace sf3d
+{
+////////////////////////////////////////////////////////////
+struct Terrain::BuildTask : priv::ParallelTask
+{
+    BuildTask(const Terrain& theTerrain, std::vector<Job*>& theJobs) : terrain(theTerrain), jobs(theJobs) {}
+
+    virtual void run(std::size_t begin, std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; ++i)
+            terrain.buildChunk(*jobs[i]);
+    }
+
+    const Terrain&     terrain;
+    std::vector<Job*>& jobs;
+};
+
+
+////////////////////////////////////////////////////////////
+Terrain::Chunk::Chunk() :
+lod     (0),
+dirty   (true),
+building(false),
+vertices(Triangles)
+{
+    for (int i = 0; i < 4; ++i)
+        edgeLods[i] = 0;
+}
+
+
+////////////////////////////////////////////////////////////
+Terrain::Terrain() :
+m_heights    (),
+m_size       (0, 0),
+m_chunkSize  (32),
+m_chunkCount (0, 0),
+m_maxLod     (0),
+m_lodDistance(64.f),
+m_texture    (NULL),
+m_textureSize(0.f, 0.f),
+m_bounds     (),
+m_thread     (&Terrain::processJobs, this),
+m_working    (false),
+m_workDone   (false)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+Terrain::~Terrain()
+{
+    m_thread.wait();
+
+    for (std::size_t i = 0; i < m_activeJobs.size(); ++i)
+        delete m_activeJobs[i];
+
+    for (std::size_t i = 0; i < m_pendingJobs.size(); ++i)
+        delete m_pendingJobs[i];
+}
+
+
+////////////////////////////////////////////////////////////
+bool Terrain::loadFromImage(const Image& image, float heightScale)
+{
+    Vector2u size = image.getSize();
+    if ((size.x < 2) || (size.y < 2))
+    {
+        err() << "Failed to load terrain from image, it must be at least 2x2 pixels (size is "
+              << size.x << "x" << size.y << ")" << std::endl;
+        return false;
+    }
+
+    std::vector<float> heights(size.x * size.y);
+    const Uint8* pixels = image.getPixelsPtr();
+    float factor = heightScale / (255.f * 3.f);
+
+    for (std::size_t i = 0; i < heights.size(); ++i)
+        heights[i] = (pixels[i * 4 + 0] + pixels[i * 4 + 1] + pixels[i * 4 + 2]) * factor;
+
+    return loadFromHeights(&heights[0], size.x, size.y);
+}
+
+
+////////////////////////////////////////////////////////////
+bool Terrain::loadFromHeights(const float* heights, unsigned int width, unsigned int depth)
+{
+    if (!heights || (width < 2) || (depth < 2))
+    {
+        err() << "Failed to load terrain, the heightfield must be at least 2x2 samples (size is "
+              << width << "x" << depth << ")" << std::endl;
+        return false;
+    }
+
+    // The worker thread must not use the old heights anymore
+    collectJobs();
+
+    m_heights.assign(heights, heights + width * depth);
+    m_size = Vector2u(width, depth);
+
+    initialize();
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+Vector2u Terrain::getSize() const
+{
+    return m_size;
+}
+
+
+////////////////////////////////////////////////////////////
+void Terrain::setHeight(unsigned int x, unsigned int z, float height)
+{
+    if ((x >= m_size.x) || (z >= m_size.y))
+        return;
+
+    m_heights[z * m_size.x + x] = height;
+
+    // Grow the bounds if needed
+    float bottom = std::min(m_bounds.top, height);
+    float top = std::max(m_bounds.top + m_bounds.height, height);
+    m_bounds.top = bottom;
+    m_bounds.height = top - bottom;
+
+    // Every chunk whose geometry (including normals) depends
+    // on this sample must be rebuilt
+    unsigned int size = m_chunkSize;
+    unsigned int left   = (x >= 2) ? (x - 2) / size : 0;
+    unsigned int right  = std::min((x + 1) / size, m_chunkCount.x - 1);
+    unsigned int front  = (z >= 2) ? (z - 2) / size : 0;
+    unsigned int back   = std::min((z + 1) / size, m_chunkCount.y - 1);
+
+    for (unsigned int cz = front; cz <= back; ++cz)
+        for (unsigned int cx = left; cx <= right; ++cx)
+            m_chunks[cz * m_chunkCount.x + cx].dirty = true;
+}
+
+
+////////////////////////////////////////////////////////////
+float Terrain::getHeight(unsigned int x, unsigned int z) const
+{
+    return m_heights[z * m_size.x + x];
+}
+
+
+////////////////////////////////////////////////////////////
+void Terrain::setChunkSize(unsigned int size)
+{
+    unsigned int powerOfTwo = 1;
+    while (powerOfTwo < size)
+        powerOfTwo *= 2;
+
+    if (powerOfTwo == m_chunkSize)
+        return;
+
+    // The worker thread must not build chunks of the old size anymore
+    collectJobs();
+
+    m_chunkSize = powerOfTwo;
+
+    // Split the loaded heightfield again with the new size
+    if (!m_heights.empty())
+        initialize();
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int Terrain::getChunkSize() const
+{
+    return m_chunkSize;
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int Terrain::getChunkCount() const
+{
+    return static_cast<unsigned int>(m_chunks.size());
+}
+
+
+////////////////////////////////////////////////////////////
+void Terrain::setLodDistance(float distance)
+{
+    m_lodDistance = distance;
+}
+
+
+////////////////////////////////////////////////////////////
+float Terrain::getLodDistance() const
+{
+    return m_lodDistance;
+}
+
+
+////////////////////////////////////////////////////////////
+void Terrain::setTexture(const Texture* texture)
+{
+    m_texture = texture;
+
+    // Texture coordinates are in pixels, rebuild the chunks if the size changed
+    Vector2f size = texture ? Vector2f(texture->getSize()) : Vector2f(0.f, 0.f);
+    if (size != m_textureSize)
+    {
+        m_textureSize = size;
+
+        for (std::size_t i = 0; i < m_chunks.size(); ++i)
+            m_chunks[i].dirty = true;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+const Texture* Terrain::getTexture() const
+{
+    return m_texture;
+}
+
+
+////////////////////////////////////////////////////////////
+FloatBox Terrain::getLocalBounds() const
+{
+    return m_bounds;
+}
+
+
+////////////////////////////////////////////////////////////
+void Terrain::update(const Vector3f& viewerPosition)
+{
+    if (m_chunks.empty())
+        return;
+
+    // Collect the chunks rebuilt by the worker thread
+    {
+        bool done;
+        {
+            Lock lock(m_mutex);
+            done = m_working && m_workDone;
+        }
+
+        if (done)
+            collectJobs();
+    }
+
+    Vector3f viewer = getInverseTransform().transformPoint(viewerPosition);
+
+    // Select the level of detail of each chunk from its distance to the viewer
+    std::vector<unsigned int> lods(m_chunks.size(), 0);
+
+    if (m_lodDistance > 0.f)
+    {
+        float half = m_chunkSize / 2.f;
+        float dy = std::max(0.f, std::max(m_bounds.top - viewer.y, viewer.y - (m_bounds.top + m_bounds.height)));
+
+        for (unsigned int cz = 0; cz < m_chunkCount.y; ++cz)
+        {
+            for (unsigned int cx = 0; cx < m_chunkCount.x; ++cx)
+            {
+                float dx = std::max(0.f, std::fabs(viewer.x - (cx * m_chunkSize + half)) - half);
+                float dz = std::max(0.f, std::fabs(viewer.z - (cz * m_chunkSize + half)) - half);
+                float distance = std::sqrt(dx * dx + dy * dy + dz * dz);
+
+                unsigned int lod = 0;
+                for (float limit = m_lodDistance; (distance >= limit) && (lod < m_maxLod); limit *= 2.f)
+                    ++lod;
+
+                lods[cz * m_chunkCount.x + cx] = lod;
+            }
+        }
+    }
+
+    // Find the chunks that need to be rebuilt
+    std::vector<Job*> immediateJobs;
+
+    for (unsigned int cz = 0; cz < m_chunkCount.y; ++cz)
+    {
+        for (unsigned int cx = 0; cx < m_chunkCount.x; ++cx)
+        {
+            unsigned int index = cz * m_chunkCount.x + cx;
+            Chunk& chunk = m_chunks[index];
+
+            if (chunk.building)
+                continue;
+
+            // An edge shared with a coarser chunk must follow its resolution
+            unsigned int lod = lods[index];
+            unsigned int edges[4];
+            edges[0] = (cx > 0)                  ? std::max(lod, lods[index - 1])              : lod;
+            edges[1] = (cx + 1 < m_chunkCount.x) ? std::max(lod, lods[index + 1])              : lod;
+            edges[2] = (cz > 0)                  ? std::max(lod, lods[index - m_chunkCount.x]) : lod;
+            edges[3] = (cz + 1 < m_chunkCount.y) ? std::max(lod, lods[index + m_chunkCount.x]) : lod;
+
+            bool changed = chunk.dirty || (chunk.lod != lod);
+            for (int i = 0; i < 4; ++i)
+                changed = changed || (chunk.edgeLods[i] != edges[i]);
+
+            if (!changed)
+                continue;
+
+            Job* job = new Job;
+            prepareJob(*job, index, lod, edges);
+            chunk.dirty = false;
+
+            if (chunk.vertices.getVertexCount() == 0)
+            {
+                // Nothing to draw yet, don't wait for the worker thread
+                immediateJobs.push_back(job);
+            }
+            else
+            {
+                chunk.building = true;
+                m_pendingJobs.push_back(job);
+            }
+        }
+    }
+
+    // Build the missing chunks right away, spread over all the processors
+    if (!immediateJobs.empty())
+    {
+        BuildTask task(*this, immediateJobs);
+        priv::parallelFor(task, immediateJobs.size(), 1);
+
+        for (std::size_t i = 0; i < immediateJobs.size(); ++i)
+        {
+            applyJob(*immediateJobs[i]);
+            delete immediateJobs[i];
+        }
+    }
+
+    // Hand the other chunks to the worker thread if it's idle
+    if (!m_working && !m_pendingJobs.empty())
+    {
+        m_activeJobs.swap(m_pendingJobs);
+        m_working = true;
+        m_workDone = false;
+        m_thread.launch();
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void Terrain::draw(RenderTarget& target, RenderStates states) const
+{
+    states.transform *= getTransform();
+    states.texture = m_texture;
+
+    for (std::size_t i = 0; i < m_chunks.size(); ++i)
+    {
+        if (m_chunks[i].vertices.getVertexCount())
+            target.draw(m_chunks[i].vertices, states);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void Terrain::initialize()
+{
+    // Discard the jobs of the previous heightfield
+    for (std::size_t i = 0; i < m_pendingJobs.size(); ++i)
+        delete m_pendingJobs[i];
+    m_pendingJobs.clear();
+
+    unsigned int size = m_chunkSize;
+    m_chunkCount = Vector2u((m_size.x - 2) / size + 1, (m_size.y - 2) / size + 1);
+
+    m_maxLod = 0;
+    while ((1u << (m_maxLod + 1)) <= size)
+        ++m_maxLod;
+
+    // Index lists of the chunk grid, the same for every chunk
+    m_indices.resize(m_maxLod + 1);
+    for (unsigned int lod = 0; lod <= m_maxLod; ++lod)
+    {
+        unsigned int cells = size >> lod;
+        std::vector<unsigned int>& indices = m_indices[lod];
+        indices.clear();
+        indices.reserve(cells * cells * 6);
+
+        for (unsigned int j = 0; j < cells; ++j)
+        {
+            for (unsigned int i = 0; i < cells; ++i)
+            {
+                unsigned int topLeft     = j * (cells + 1) + i;
+                unsigned int topRight    = topLeft + 1;
+                unsigned int bottomLeft  = topLeft + cells + 1;
+                unsigned int bottomRight = bottomLeft + 1;
+
+                indices.push_back(topLeft);
+                indices.push_back(bottomLeft);
+                indices.push_back(bottomRight);
+
+                indices.push_back(topLeft);
+                indices.push_back(bottomRight);
+                indices.push_back(topRight);
+            }
+        }
+    }
+
+    m_chunks.clear();
+    m_chunks.resize(m_chunkCount.x * m_chunkCount.y);
+
+    // Bounds of the heightfield
+    float bottom = *std::min_element(m_heights.begin(), m_heights.end());
+    float top = *std::max_element(m_heights.begin(), m_heights.end());
+    m_bounds = FloatBox(0.f, bottom, 0.f, static_cast<float>(m_size.x - 1), top - bottom, static_cast<float>(m_size.y - 1));
+}
+
+
+////////////////////////////////////////////////////////////
+void Terrain::prepareJob(Job& job, unsigned int chunk, unsigned int lod, const unsigned int* edges) const
+{
+    job.chunk = chunk;
+    job.lod = lod;
+    for (int i = 0; i < 4; ++i)
+        job.edgeLods[i] = edges[i];
+    job.textureSize = m_textureSize;
+
+    // Copy the heights of the chunk with a border of one
+    // sample, needed to compute the normals of its edges
+    int size = static_cast<int>(m_chunkSize);
+    int left = static_cast<int>(chunk % m_chunkCount.x) * size - 1;
+    int front = static_cast<int>(chunk / m_chunkCount.x) * size - 1;
+    int width = static_cast<int>(m_size.x);
+    int depth = static_cast<int>(m_size.y);
+
+    job.heights.resize((size + 3) * (size + 3));
+    for (int j = 0; j < size + 3; ++j)
+    {
+        int z = std::max(0, std::min(front + j, depth - 1));
+        for (int i = 0; i < size + 3; ++i)
+        {
+            int x = std::max(0, std::min(left + i, width - 1));
+            job.heights[j * (size + 3) + i] = m_heights[z * width + x];
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void Terrain::buildChunk(Job& job) const
+{
+    unsigned int size = m_chunkSize;
+    unsigned int stride = size + 3;
+    unsigned int step = 1u << job.lod;
+    unsigned int cells = size >> job.lod;
+    unsigned int left = (job.chunk % m_chunkCount.x) * size;
+    unsigned int front = (job.chunk / m_chunkCount.x) * size;
+    const float* heights = &job.heights[stride + 1];
+
+    // Grid of the chunk, the chunks on the far sides of the terrain
+    // may be partial and have their extra cells collapsed on the edge
+    std::vector<Vertex> grid((cells + 1) * (cells + 1));
+
+    for (unsigned int gj = 0; gj <= cells; ++gj)
+    {
+        for (unsigned int gi = 0; gi <= cells; ++gi)
+        {
+            unsigned int i = gi * step;
+            unsigned int j = gj * step;
+            float height = heights[j * stride + i];
+
+            // Move the vertices on an edge shared with a coarser
+            // chunk onto the coarser edge, to avoid cracks
+            unsigned int edge = 4;
+            if (gi == 0)
+                edge = 0;
+            else if (gi == cells)
+                edge = 1;
+            else if (gj == 0)
+                edge = 2;
+            else if (gj == cells)
+                edge = 3;
+
+            if ((edge < 4) && (job.edgeLods[edge] > job.lod))
+            {
+                unsigned int coarseStep = 1u << job.edgeLods[edge];
+                unsigned int position = (edge < 2) ? j : i;
+                unsigned int offset = position % coarseStep;
+
+                if (offset)
+                {
+                    unsigned int start = position - offset;
+                    unsigned int end = start + coarseStep;
+                    float h0 = (edge < 2) ? heights[start * stride + i] : heights[j * stride + start];
+                    float h1 = (edge < 2) ? heights[end * stride + i] : heights[j * stride + end];
+                    height = h0 + (h1 - h0) * offset / coarseStep;
+                }
+            }
+
+            // Normal from the full resolution heights
+            const float* sample = heights + j * stride + i;
+            Vector3f normal(sample[-1] - sample[1],
+                            2.f,
+                            *(sample - stride) - sample[stride]);
+            normal /= std::sqrt(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+
+            float x = static_cast<float>(std::min(left + i, m_size.x - 1));
+            float z = static_cast<float>(std::min(front + j, m_size.y - 1));
+            Vector2f texCoords(x / (m_size.x - 1) * job.textureSize.x,
+                               z / (m_size.y - 1) * job.textureSize.y);
+
+            grid[gj * (cells + 1) + gi] = Vertex(Vector3f(x, height, z), Color::White, texCoords, normal);
+        }
+    }
+
+    // Expand the shared index list into triangles
+    const std::vector<unsigned int>& indices = m_indices[job.lod];
+    job.vertices.resize(indices.size());
+
+    for (std::size_t k = 0; k < indices.size(); ++k)
+        job.vertices[k] = grid[indices[k]];
+}
+
+
+////////////////////////////////////////////////////////////
+void Terrain::applyJob(const Job& job)
+{
+    Chunk& chunk = m_chunks[job.chunk];
+
+    chunk.vertices.assign(&job.vertices[0], static_cast<unsigned int>(job.vertices.size()));
+    chunk.lod = job.lod;
+    for (int i = 0; i < 4; ++i)
+        chunk.edgeLods[i] = job.edgeLods[i];
+    chunk.building = false;
+}
+
+
+////////////////////////////////////////////////////////////
+void Terrain::processJobs()
+{
+    for (std::size_t i = 0; i < m_activeJobs.size(); ++i)
+        buildChunk(*m_activeJobs[i]);
+
+    Lock lock(m_mutex);
+    m_workDone = true;
+}
+
+
+////////////////////////////////////////////////////////////
+void Terrain::collectJobs()
+{
+    if (!m_working)
+        return;
+
+    m_thread.wait();
+
+    for (std::size_t i = 0; i < m_activeJobs.size(); ++i)
+    {
+        if (m_activeJobs[i]->chunk < m_chunks.size())
+            applyJob(*m_activeJobs[i]);
+
+        delete m_activeJobs[i];
+    }
+
+    m_activeJobs.clear();
+    m_working = false;
+}
+
+} // namespace sf3d
@@ -28,9 +28,46 @@
 #include <SFML3D/Graphics/Text.hpp>
 #include <SFML3D/Graphics/Texture.hpp>
 #include <SFML3D/Graphics/RenderTarget.hpp>
+#include <SFML3D/Graphics/Shader.hpp>
+#include <SFML3D/Graphics/Light.hpp>
+#include <SFML3D/Graphics/DefaultShader.hpp>
+#include <SFML3D/System/Mutex.hpp>
+#include <SFML3D/System/Lock.hpp>
+#include <SFML3D/System/Err.hpp>
 #include <cassert>
 
 
+namespace
+{
+    // Distance field shader, shared by all the texts
+    sf3d::Mutex   mutex;
+    unsigned int  count = 0;
+    sf3d::Shader* distanceFieldShader = NULL;
+    bool          distanceFieldShaderFailed = false;
+
+    // Get the distance field shader, compiling it on first use
+    const sf3d::Shader* getDistanceFieldShader()
+    {
+        sf3d::Lock lock(mutex);
+
+        if (!distanceFieldShader && !distanceFieldShaderFailed)
+        {
+            distanceFieldShader = new sf3d::Shader;
+            if (!distanceFieldShader->loadFromMemory(sf3d::priv::getDefaultVertexShaderSource(),
+                                                     sf3d::priv::getDefaultFragmentShaderSource("#define SF_DISTANCE_FIELD\n")))
+            {
+                sf3d::err() << "Compiling distance field shader failed. Falling back to regular glyphs..." << std::endl;
+                delete distanceFieldShader;
+                distanceFieldShader = NULL;
+                distanceFieldShaderFailed = true;
+            }
+        }
+
+        return distanceFieldShader;
+    }
+}
+
+
 namespace sf3d
 {
 ////////////////////////////////////////////////////////////
@@ -40,11 +77,15 @@ m_font              (NULL),
 m_characterSize     (30),
 m_style             (Regular),
 m_color             (255, 255, 255),
+m_distanceField     (false),
 m_vertices          (Triangles),
 m_bounds            (),
-m_geometryNeedUpdate(false)
+m_geometryNeedUpdate(false),
+m_fontRevision      (0),
+m_layoutStart       (0)
 {
-
+    Lock lock(mutex);
+    count++;
 }
 
 
@@ -55,11 +96,50 @@ m_font              (&font),
 m_characterSize     (characterSize),
 m_style             (Regular),
 m_color             (255, 255, 255),
+m_distanceField     (false),
 m_vertices          (Triangles),
 m_bounds            (),
-m_geometryNeedUpdate(true)
+m_geometryNeedUpdate(true),
+m_fontRevision      (0),
+m_layoutStart       (0)
 {
+    Lock lock(mutex);
+    count++;
+}
+
 
+////////////////////////////////////////////////////////////
+Text::Text(const Text& copy) :
+Drawable            (copy),
+Transformable       (copy),
+m_string            (copy.m_string),
+m_font              (copy.m_font),
+m_characterSize     (copy.m_characterSize),
+m_style             (copy.m_style),
+m_color             (copy.m_color),
+m_distanceField     (copy.m_distanceField),
+m_vertices          (Triangles),
+m_bounds            (),
+m_geometryNeedUpdate(true),
+m_fontRevision      (0),
+m_layoutStart       (0)
+{
+    Lock lock(mutex);
+    count++;
+}
+
+
+////////////////////////////////////////////////////////////
+Text::~Text()
+{
+    Lock lock(mutex);
+    count--;
+
+    if (!count)
+    {
+        delete distanceFieldShader;
+        distanceFieldShader = NULL;
+    }
 }
 
 
@@ -68,7 +148,14 @@ void Text::setString(const String& string)
 {
     if (m_string != string)
     {
+        // Only the characters after the common prefix need a new layout
+        std::size_t prefix = 0;
+        std::size_t size = std::min(m_string.getSize(), string.getSize());
+        while ((prefix < size) && (m_string[prefix] == string[prefix]))
+            ++prefix;
+
         m_string = string;
+        m_layoutStart = std::min(m_layoutStart, prefix);
         m_geometryNeedUpdate = true;
     }
 }
@@ -80,6 +167,7 @@ void Text::setFont(const Font& font)
     if (m_font != &font)
     {
         m_font = &font;
+        m_layoutStart = 0;
         m_geometryNeedUpdate = true;
     }
 }
@@ -91,6 +179,7 @@ void Text::setCharacterSize(unsigned int size)
     if (m_characterSize != size)
     {
         m_characterSize = size;
+        m_layoutStart = 0;
         m_geometryNeedUpdate = true;
     }
 }
@@ -102,6 +191,7 @@ void Text::setStyle(Uint32 style)
     if (m_style != style)
     {
         m_style = style;
+        m_layoutStart = 0;
         m_geometryNeedUpdate = true;
     }
 }
@@ -114,13 +204,23 @@ void Text::setColor(const Color& color)
     {
         m_color = color;
 
-        // Change vertex colors directly, no need to update whole geometry
-        // (if geometry is updated anyway, we can skip this step)
-        if (!m_geometryNeedUpdate)
-        {
-            for (unsigned int i = 0; i < m_vertices.getVertexCount(); ++i)
-                m_vertices[i].color = m_color;
-        }
+        // Change vertex colors directly, no need to update the layout;
+        // the geometry is uploaded again on next use
+        for (std::size_t i = 0; i < m_layoutVertices.size(); ++i)
+            m_layoutVertices[i].color = m_color;
+        m_geometryNeedUpdate = true;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void Text::setDistanceField(bool distanceField)
+{
+    if (m_distanceField != distanceField)
+    {
+        m_distanceField = distanceField;
+        m_layoutStart = 0;
+        m_geometryNeedUpdate = true;
     }
 }
 
@@ -160,6 +260,20 @@ const Color& Text::getColor() const
 }
 
 
+////////////////////////////////////////////////////////////
+bool Text::isDistanceField() const
+{
+    return m_distanceField;
+}
+
+
+////////////////////////////////////////////////////////////
+bool Text::isDistanceFieldAvailable()
+{
+    return Light::hasShaderLighting() && getDistanceFieldShader();
+}
+
+
 ////////////////////////////////////////////////////////////
 Vector3f Text::findCharacterPos(std::size_t index) const
 {
@@ -167,43 +281,22 @@ Vector3f Text::findCharacterPos(std::size_t index) const
     if (!m_font)
         return Vector2f();
 
+    // The layout stores the pen position before each character
+    ensureGeometryUpdate();
+
+    // Make sure that we have a valid layout
+    if (m_layout.empty())
+        return getTransform().transformPoint(Vector2f());
+
     // Adjust the index if it's out of range
     if (index > m_string.getSize())
         index = m_string.getSize();
 
-    // Precompute the variables needed by the algorithm
-    bool  bold   = (m_style & Bold) != 0;
-    float hspace = static_cast<float>(m_font->getGlyph(L' ', m_characterSize, bold).advance);
-    float vspace = static_cast<float>(m_font->getLineSpacing(m_characterSize));
-
-    // Compute the position
-    Vector2f position;
-    Uint32 prevChar = 0;
-    for (std::size_t i = 0; i < index; ++i)
-    {
-        Uint32 curChar = m_string[i];
-
-        // Apply the kerning offset
-        position.x += static_cast<float>(m_font->getKerning(prevChar, curChar, m_characterSize));
-        prevChar = curChar;
-
-        // Handle special characters
-        switch (curChar)
-        {
-            case ' ' :  position.x += hspace;                 continue;
-            case '\t' : position.x += hspace * 4;             continue;
-            case '\n' : position.y += vspace; position.x = 0; continue;
-            case '\v' : position.y += vspace * 4;             continue;
-        }
-
-        // For regular characters, add the advance offset of the glyph
-        position.x += static_cast<float>(m_font->getGlyph(curChar, m_characterSize, bold).advance);
-    }
+    // Make the position relative to the top of the first line, rather than to its baseline
+    Vector2f position(m_layout[index].x, m_layout[index].y - m_characterSize);
 
     // Transform the position to global coordinates
-    position = getTransform().transformPoint(position);
-
-    return position;
+    return getTransform().transformPoint(position);
 }
 
 
@@ -231,7 +324,7 @@ void Text::draw(RenderTarget& target, RenderStates states) const
         ensureGeometryUpdate();
 
         states.transform *= getTransform();
-        states.texture = &m_font->getTexture(m_characterSize);
+        applyRenderStates(states);
         target.draw(m_vertices, states);
     }
 }
@@ -240,6 +333,17 @@ void Text::draw(RenderTarget& target, RenderStates states) const
 ////////////////////////////////////////////////////////////
 void Text::ensureGeometryUpdate() const
 {
+    // Glyphs loaded in the background may replace placeholders
+    if (m_font)
+    {
+        m_font->update();
+        if (m_font->getRevision() != m_fontRevision)
+        {
+            m_layoutStart = 0;
+            m_geometryNeedUpdate = true;
+        }
+    }
+
     // Do nothing, if geometry has not changed
     if (!m_geometryNeedUpdate)
         return;
@@ -247,17 +351,18 @@ void Text::ensureGeometryUpdate() const
     // Mark geometry as updated
     m_geometryNeedUpdate = false;
 
-    // Clear the previous geometry
-    m_vertices.clear();
-    m_bounds = FloatRect();
-
-    // No font: nothing to draw
-    if (!m_font)
+    // No font or no text: nothing to draw
+    if (!m_font || m_string.isEmpty())
+    {
+        m_vertices.clear();
+        m_layoutVertices.clear();
+        m_layout.clear();
+        m_layoutStart = 0;
+        m_bounds = FloatRect();
         return;
+    }
 
-    // No text: nothing to draw
-    if (m_string.isEmpty())
-        return;
+    m_fontRevision = m_font->getRevision();
 
     // Compute values related to the text style
     bool  bold               = (m_style & Bold) != 0;
@@ -266,70 +371,86 @@ void Text::ensureGeometryUpdate() const
     float underlineOffset    = m_characterSize * 0.1f;
     float underlineThickness = m_characterSize * (bold ? 0.1f : 0.07f);
 
+    // Distance field glyphs are scaled from the distance field size
+    bool         distanceField = usesDistanceField();
+    unsigned int glyphSize     = distanceField ? Font::getDistanceFieldSize() : m_characterSize;
+    float        scale         = static_cast<float>(m_characterSize) / glyphSize;
+
     // Precompute the variables needed by the algorithm
-    float hspace = static_cast<float>(m_font->getGlyph(L' ', m_characterSize, bold).advance);
-    float vspace = static_cast<float>(m_font->getLineSpacing(m_characterSize));
-    float x      = 0.f;
-    float y      = static_cast<float>(m_characterSize);
+    float hspace = getGlyph(L' ', bold, distanceField).advance * scale;
+    float vspace = m_font->getLineSpacing(glyphSize) * scale;
+
+    // Resume the layout at the first modified character, the
+    // characters before it and their vertices are still valid
+    std::size_t start = std::min(m_layoutStart, m_layout.empty() ? 0 : m_layout.size() - 1);
+    LayoutState state;
+    if (start > 0)
+    {
+        state = m_layout[start];
+    }
+    else
+    {
+        state.x = 0.f;
+        state.y = static_cast<float>(m_characterSize);
+        state.minX = static_cast<float>(m_characterSize);
+        state.minY = static_cast<float>(m_characterSize);
+        state.maxX = 0.f;
+        state.maxY = 0.f;
+        state.vertexCount = 0;
+    }
+    m_layout.resize(start);
+    m_layoutVertices.resize(state.vertexCount);
 
     // Create one quad for each character
-    float minX = static_cast<float>(m_characterSize);
-    float minY = static_cast<float>(m_characterSize);
-    float maxX = 0.f;
-    float maxY = 0.f;
-    Uint32 prevChar = 0;
-    for (std::size_t i = 0; i < m_string.getSize(); ++i)
+    Uint32 prevChar = (start > 0) ? m_string[start - 1] : 0;
+    for (std::size_t i = start; i < m_string.getSize(); ++i)
     {
+        // Remember where the character starts, to resume the layout from it later
+        state.vertexCount = static_cast<unsigned int>(m_layoutVertices.size());
+        m_layout.push_back(state);
+
         Uint32 curChar = m_string[i];
 
         // Apply the kerning offset
-        x += static_cast<float>(m_font->getKerning(prevChar, curChar, m_characterSize));
+        state.x += m_font->getKerning(prevChar, curChar, glyphSize) * scale;
         prevChar = curChar;
 
         // If we're using the underlined style and there's a new line, draw a line
         if (underlined && (curChar == L'\n'))
-        {
-            float top = y + underlineOffset;
-            float bottom = top + underlineThickness;
-
-            m_vertices.append(Vertex(Vector2f(0, top),    m_color, Vector2f(1, 1)));
-            m_vertices.append(Vertex(Vector2f(0, bottom), m_color, Vector2f(1, 1)));
-            m_vertices.append(Vertex(Vector2f(x, bottom), m_color, Vector2f(1, 1)));
-            m_vertices.append(Vertex(Vector2f(0, top),    m_color, Vector2f(1, 1)));
-            m_vertices.append(Vertex(Vector2f(x, bottom), m_color, Vector2f(1, 1)));
-            m_vertices.append(Vertex(Vector2f(x, top),    m_color, Vector2f(1, 1)));
-        }
+            appendUnderline(state.x, state.y + underlineOffset, underlineThickness);
 
         // Handle special characters
         if ((curChar == ' ') || (curChar == '\t') || (curChar == '\n') || (curChar == '\v'))
         {
             // Update the current bounds (min coordinates)
-            minX = std::min(minX, x);
-            minY = std::min(minY, y);
+            state.minX = std::min(state.minX, state.x);
+            state.minY = std::min(state.minY, state.y);
 
             switch (curChar)
             {
-                case ' ' :  x += hspace;        break;
-                case '\t' : x += hspace * 4;    break;
-                case '\n' : y += vspace; x = 0; break;
-                case '\v' : y += vspace * 4;    break;
+                case ' ' :  state.x += hspace;              break;
+                case '\t' : state.x += hspace * 4;          break;
+                case '\n' : state.y += vspace; state.x = 0; break;
+                case '\v' : state.y += vspace * 4;          break;
             }
 
             // Update the current bounds (max coordinates)
-            maxX = std::max(maxX, x);
-            maxY = std::max(maxY, y);
+            state.maxX = std::max(state.maxX, state.x);
+            state.maxY = std::max(state.maxY, state.y);
 
             // Next glyph, no need to create a quad for whitespace
             continue;
         }
 
         // Extract the current glyph's description
-        const Glyph& glyph = m_font->getGlyph(curChar, m_characterSize, bold);
+        const Glyph& glyph = getGlyph(curChar, bold, distanceField);
 
-        int left   = glyph.bounds.left;
-        int top    = glyph.bounds.top;
-        int right  = glyph.bounds.left + glyph.bounds.width;
-        int bottom = glyph.bounds.top  + glyph.bounds.height;
+        float x      = state.x;
+        float y      = state.y;
+        float left   = glyph.bounds.left * scale;
+        float top    = glyph.bounds.top * scale;
+        float right  = (glyph.bounds.left + glyph.bounds.width) * scale;
+        float bottom = (glyph.bounds.top  + glyph.bounds.height) * scale;
 
         float u1 = static_cast<float>(glyph.textureRect.left);
         float v1 = static_cast<float>(glyph.textureRect.top);
@@ -337,42 +458,92 @@ void Text::ensureGeometryUpdate() const
         float v2 = static_cast<float>(glyph.textureRect.top  + glyph.textureRect.height);
 
         // Add a quad for the current character
-        m_vertices.append(Vertex(Vector2f(x + left  - italic * top,    y + top),    m_color, Vector2f(u1, v1)));
-        m_vertices.append(Vertex(Vector2f(x + left  - italic * bottom, y + bottom), m_color, Vector2f(u1, v2)));
-        m_vertices.append(Vertex(Vector2f(x + right - italic * bottom, y + bottom), m_color, Vector2f(u2, v2)));
-        m_vertices.append(Vertex(Vector2f(x + left  - italic * top,    y + top),    m_color, Vector2f(u1, v1)));
-        m_vertices.append(Vertex(Vector2f(x + right - italic * bottom, y + bottom), m_color, Vector2f(u2, v2)));
-        m_vertices.append(Vertex(Vector2f(x + right - italic * top,    y + top),    m_color, Vector2f(u2, v1)));
+        m_layoutVertices.push_back(Vertex(Vector2f(x + left  - italic * top,    y + top),    m_color, Vector2f(u1, v1)));
+        m_layoutVertices.push_back(Vertex(Vector2f(x + left  - italic * bottom, y + bottom), m_color, Vector2f(u1, v2)));
+        m_layoutVertices.push_back(Vertex(Vector2f(x + right - italic * bottom, y + bottom), m_color, Vector2f(u2, v2)));
+        m_layoutVertices.push_back(Vertex(Vector2f(x + left  - italic * top,    y + top),    m_color, Vector2f(u1, v1)));
+        m_layoutVertices.push_back(Vertex(Vector2f(x + right - italic * bottom, y + bottom), m_color, Vector2f(u2, v2)));
+        m_layoutVertices.push_back(Vertex(Vector2f(x + right - italic * top,    y + top),    m_color, Vector2f(u2, v1)));
 
         // Update the current bounds
-        minX = std::min(minX, x + left - italic * bottom);
-        maxX = std::max(maxX, x + right - italic * top);
-        minY = std::min(minY, y + top);
-        maxY = std::max(maxY, y + bottom);
+        state.minX = std::min(state.minX, x + left - italic * bottom);
+        state.maxX = std::max(state.maxX, x + right - italic * top);
+        state.minY = std::min(state.minY, y + top);
+        state.maxY = std::max(state.maxY, y + bottom);
 
         // Advance to the next character
-        x += glyph.advance;
+        state.x += glyph.advance * scale;
     }
 
+    // Remember the state after the last character, appending text resumes from it
+    state.vertexCount = static_cast<unsigned int>(m_layoutVertices.size());
+    m_layout.push_back(state);
+    m_layoutStart = m_string.getSize();
+
     // If we're using the underlined style, add the last line
     if (underlined)
+        appendUnderline(state.x, state.y + underlineOffset, underlineThickness);
+
+    // Upload the whole geometry at once
+    if (!m_layoutVertices.empty())
+        m_vertices.assign(&m_layoutVertices[0], static_cast<unsigned int>(m_layoutVertices.size()));
+    else
+        m_vertices.clear();
+
+    // Update the bounding rectangle
+    m_bounds.left = state.minX;
+    m_bounds.top = state.minY;
+    m_bounds.width = state.maxX - state.minX;
+    m_bounds.height = state.maxY - state.minY;
+}
+
+
+////////////////////////////////////////////////////////////
+void Text::appendUnderline(float width, float top, float thickness) const
+{
+    float bottom = top + thickness;
+
+    m_layoutVertices.push_back(Vertex(Vector2f(0, top),        m_color, Vector2f(1, 1)));
+    m_layoutVertices.push_back(Vertex(Vector2f(0, bottom),     m_color, Vector2f(1, 1)));
+    m_layoutVertices.push_back(Vertex(Vector2f(width, bottom), m_color, Vector2f(1, 1)));
+    m_layoutVertices.push_back(Vertex(Vector2f(0, top),        m_color, Vector2f(1, 1)));
+    m_layoutVertices.push_back(Vertex(Vector2f(width, bottom), m_color, Vector2f(1, 1)));
+    m_layoutVertices.push_back(Vertex(Vector2f(width, top),    m_color, Vector2f(1, 1)));
+}
+
+
+////////////////////////////////////////////////////////////
+void Text::applyRenderStates(RenderStates& states) const
+{
+    if (usesDistanceField())
     {
-        float top = y + underlineOffset;
-        float bottom = top + underlineThickness;
-
-        m_vertices.append(Vertex(Vector2f(0, top),    m_color, Vector2f(1, 1)));
-        m_vertices.append(Vertex(Vector2f(0, bottom), m_color, Vector2f(1, 1)));
-        m_vertices.append(Vertex(Vector2f(x, bottom), m_color, Vector2f(1, 1)));
-        m_vertices.append(Vertex(Vector2f(0, top),    m_color, Vector2f(1, 1)));
-        m_vertices.append(Vertex(Vector2f(x, bottom), m_color, Vector2f(1, 1)));
-        m_vertices.append(Vertex(Vector2f(x, top),    m_color, Vector2f(1, 1)));
+        states.texture = &m_font->getDistanceFieldTexture();
+
+        // Keep the user's shader, if any
+        if (!states.shader)
+            states.shader = getDistanceFieldShader();
+    }
+    else
+    {
+        states.texture = &m_font->getTexture(m_characterSize);
     }
+}
 
-    // Update the bounding rectangle
-    m_bounds.left = minX;
-    m_bounds.top = minY;
-    m_bounds.width = maxX - minX;
-    m_bounds.height = maxY - minY;
+
+////////////////////////////////////////////////////////////
+bool Text::usesDistanceField() const
+{
+    return m_distanceField && isDistanceFieldAvailable();
+}
+
+
+////////////////////////////////////////////////////////////
+const Glyph& Text::getGlyph(Uint32 codePoint, bool bold, bool distanceField) const
+{
+    if (distanceField)
+        return m_font->getDistanceFieldGlyph(codePoint, bold);
+    else
+        return m_font->getGlyph(codePoint, m_characterSize, bold);
 }
 
 } // namespace sf3d
@@ -0,0 +1,137 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/Graphics/TextBatch.hpp>
+#include <SFML3D/Graphics/Text.hpp>
+#include <SFML3D/Graphics/RenderTarget.hpp>
+#include <cmath>
+
+
+namespace sf3d
+{
+////////////////////////////////////////////////////////////
+TextBatch::Batch::Batch() :
+container (Triangles),
+needUpload(false)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+TextBatch::TextBatch() :
+m_textCount(0)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+void TextBatch::add(const Text& text)
+{
+    if (!text.getFont())
+        return;
+
+    text.ensureGeometryUpdate();
+    m_textCount++;
+
+    const std::vector<Vertex>& source = text.m_layoutVertices;
+    if (source.empty())
+        return;
+
+    // Find the batch sharing the texture and shader of the text
+    RenderStates states;
+    text.applyRenderStates(states);
+    Batch& batch = m_batches[BatchKey(states.texture, states.shader)];
+    batch.needUpload = true;
+
+    // Normals are transformed by the inverse transpose of the transform
+    const Transform& transform = text.getTransform();
+    Transform normalTransform = transform.getInverse().getTranspose();
+
+    std::size_t first = batch.vertices.size();
+    batch.vertices.insert(batch.vertices.end(), source.begin(), source.end());
+
+    for (std::size_t i = first; i < batch.vertices.size(); ++i)
+    {
+        Vertex& vertex = batch.vertices[i];
+        vertex.position = transform.transformPoint(vertex.position);
+
+        Vector3f normal = normalTransform.transformPoint(vertex.normal);
+        float length = std::sqrt(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+        if (length > 0.f)
+            vertex.normal = normal / length;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void TextBatch::clear()
+{
+    for (BatchTable::iterator it = m_batches.begin(); it != m_batches.end(); ++it)
+    {
+        it->second.vertices.clear();
+        it->second.needUpload = true;
+    }
+
+    m_textCount = 0;
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int TextBatch::getTextCount() const
+{
+    return m_textCount;
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int TextBatch::getVertexCount() const
+{
+    std::size_t count = 0;
+    for (BatchTable::const_iterator it = m_batches.begin(); it != m_batches.end(); ++it)
+        count += it->second.vertices.size();
+
+    return static_cast<unsigned int>(count);
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int TextBatch::getDrawCallCount() const
+{
+    unsigned int count = 0;
+    for (BatchTable::const_iterator it = m_batches.begin(); it != m_batches.end(); ++it)
+    {
+        if (!it->second.vertices.empty())
+            count++;
+    }
+
+    return count;
+}
+
+
+////////////////////////////////////////////////////////////
+void TextBatch::draw(RenderTarget& target, RenderStates states) const
+{
+    for (BatchTable::const_iterator it = m_batches.begin(); it != m_batches.end(); ++it)
+    {
+        const Batch& batch = it->second;
+        if (batch.vertices.empty())
+            continue;
+
+        // Upload the geometry of the batch at once
+        if (batch.needUpload)
+        {
+            batch.container.assign(&batch.vertices[0], static_cast<unsigned int>(batch.vertices.size()));
+            batch.needUpload = false;
+        }
+
+        // Keep the user's shader, if any
+        RenderStates batchStates = states;
+        batchStates.texture = it->first.first;
+        if (!batchStates.shader)
+            batchStates.shader = it->first.second;
+
+        target.draw(batch.container, batchStates);
+    }
+}
+
+} // namespace sf3d
@@ -27,15 +27,27 @@
 ////////////////////////////////////////////////////////////
 #include <SFML3D/Graphics/Texture.hpp>
 #include <SFML3D/Graphics/Image.hpp>
+#include <SFML3D/Graphics/VolumeImage.hpp>
 #include <SFML3D/Graphics/GLCheck.hpp>
 #include <SFML3D/Graphics/TextureSaver.hpp>
 #include <SFML3D/Window/Window.hpp>
 #include <SFML3D/System/Mutex.hpp>
 #include <SFML3D/System/Lock.hpp>
 #include <SFML3D/System/Err.hpp>
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <cmath>
+#include <string>
+
+
+#ifndef GL_COMPRESSED_RGB8_ETC2
+    #define GL_COMPRESSED_RGB8_ETC2 0x9274
+#endif
+
+#ifndef GL_COMPRESSED_RGBA8_ETC2_EAC
+    #define GL_COMPRESSED_RGBA8_ETC2_EAC 0x9278
+#endif
 
 
 namespace
@@ -50,6 +62,45 @@ namespace
         sf3d::Lock lock(mutex);
         return id++;
     }
+
+    // Maximum amount of texels uploaded to a 3D texture in a single call
+    const std::size_t maxSlabSize = 16 * 1024 * 1024;
+
+    // Check whether the ETC2 formats of OpenGL ES 3 are supported, through OpenGL 4.3 or
+    // GL_ARB_ES3_compatibility; neither is known by GLEW, so the context is queried directly
+    bool hasEs3Compatibility()
+    {
+        static bool checked = false;
+        static bool es3CompatibilitySupported = false;
+
+        if (!checked)
+        {
+            checked = true;
+
+            if (GLEW_VERSION_3_0)
+            {
+                GLint major = 0;
+                GLint minor = 0;
+                glCheck(glGetIntegerv(GL_MAJOR_VERSION, &major));
+                glCheck(glGetIntegerv(GL_MINOR_VERSION, &minor));
+                es3CompatibilitySupported = (major > 4) || ((major == 4) && (minor >= 3));
+
+                GLint count = 0;
+                glCheck(glGetIntegerv(GL_NUM_EXTENSIONS, &count));
+
+                for (GLint i = 0; (i < count) && !es3CompatibilitySupported; ++i)
+                {
+                    const GLubyte* name = NULL;
+                    glCheck(name = glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)));
+
+                    if (name)
+                        es3CompatibilitySupported = (std::string(reinterpret_cast<const char*>(name)) == "GL_ARB_ES3_compatibility");
+                }
+            }
+        }
+
+        return es3CompatibilitySupported;
+    }
 }
 
 
@@ -63,6 +114,9 @@ m_texture      (0),
 m_isSmooth     (false),
 m_isRepeated   (false),
 m_pixelsFlipped(false),
+m_hasMipmap    (false),
+m_isCompressed (false),
+m_anisotropy   (1.f),
 m_cacheId      (getUniqueId())
 {
 
@@ -77,10 +131,22 @@ m_texture      (0),
 m_isSmooth     (copy.m_isSmooth),
 m_isRepeated   (copy.m_isRepeated),
 m_pixelsFlipped(false),
+m_hasMipmap    (false),
+m_isCompressed (false),
+m_anisotropy   (copy.m_anisotropy),
 m_cacheId      (getUniqueId())
 {
     if (copy.m_texture)
-        loadFromImage(copy.copyToImage());
+    {
+        // Copy 2D textures on the graphics card when possible
+        if (copy.m_size.y && !copy.m_size.z && create(copy.m_size.x, copy.m_size.y))
+            update(copy);
+        else
+            loadFromImage(copy.copyToImage());
+
+        if (copy.m_hasMipmap)
+            generateMipmap();
+    }
 }
 
 
@@ -142,6 +208,8 @@ bool Texture::create(unsigned int width, unsigned int height, unsigned int depth
     m_size.z        = depth;
     m_actualSize    = actualSize;
     m_pixelsFlipped = false;
+    m_hasMipmap     = false;
+    m_isCompressed  = false;
 
     ensureGlContext();
 
@@ -173,6 +241,9 @@ bool Texture::create(unsigned int width, unsigned int height, unsigned int depth
     glCheck(glTexParameteri(target, GL_TEXTURE_MAG_FILTER, m_isSmooth ? GL_LINEAR : GL_NEAREST));
     glCheck(glTexParameteri(target, GL_TEXTURE_MIN_FILTER, m_isSmooth ? GL_LINEAR : GL_NEAREST));
 
+    if ((m_anisotropy > 1.f) && GLEW_EXT_texture_filter_anisotropic)
+        glCheck(glTexParameterf(target, GL_TEXTURE_MAX_ANISOTROPY_EXT, m_anisotropy));
+
     if (!height)
         glCheck(glTexImage1D(target, 0, GL_RGBA8, m_actualSize.x, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL));
     else if (!depth)
@@ -254,14 +325,12 @@ bool Texture::loadFromImage(const Image& image, const IntRect& area)
             // Make sure that the current texture binding will be preserved
             priv::TextureSaver save;
 
-            // Copy the pixels to the texture, row by row
+            // Copy the pixels to the texture in a single call, telling OpenGL the length of the source rows
             const Uint8* pixels = image.getPixelsPtr() + 4 * (rectangle.left + (width * rectangle.top));
             glCheck(glBindTexture(GL_TEXTURE_2D, m_texture));
-            for (int i = 0; i < rectangle.height; ++i)
-            {
-                glCheck(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, i, rectangle.width, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixels));
-                pixels += 4 * width;
-            }
+            glCheck(glPixelStorei(GL_UNPACK_ROW_LENGTH, width));
+            glCheck(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, rectangle.width, rectangle.height, GL_RGBA, GL_UNSIGNED_BYTE, pixels));
+            glCheck(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
 
             // Force an OpenGL flush, so that the texture will appear updated
             // in all contexts immediately (solves problems in multi-threaded apps)
@@ -277,6 +346,118 @@ bool Texture::loadFromImage(const Image& image, const IntRect& area)
 }
 
 
+////////////////////////////////////////////////////////////
+bool Texture::loadFromCompressedImage(const CompressedImage& image)
+{
+    Vector2u size = image.getSize();
+    if (!image.getLevelCount())
+    {
+        err() << "Failed to load texture from compressed image (image is empty)" << std::endl;
+        return false;
+    }
+
+    if (!isCompressedFormatAvailable(image.getFormat()))
+    {
+        err() << "Failed to load texture from compressed image (the format is not supported by the graphics driver)" << std::endl;
+        return false;
+    }
+
+    // Compressed blocks can't be padded to a power of two
+    if ((getValidSize(size.x) != size.x) || (getValidSize(size.y) != size.y))
+    {
+        err() << "Failed to load texture from compressed image (size " << size.x << "x" << size.y
+              << " is not a power of two, and NPOT textures are not supported)" << std::endl;
+        return false;
+    }
+
+    unsigned int maxSize = getMaximumSize();
+    if ((size.x > maxSize) || (size.y > maxSize))
+    {
+        err() << "Failed to load texture from compressed image, its size is too high "
+              << "(" << size.x << "x" << size.y << ", maximum is " << maxSize << "x" << maxSize << ")" << std::endl;
+        return false;
+    }
+
+    static const GLenum formats[] = {GL_COMPRESSED_RGBA_S3TC_DXT1_EXT,
+                                     GL_COMPRESSED_RGBA_S3TC_DXT3_EXT,
+                                     GL_COMPRESSED_RGBA_S3TC_DXT5_EXT,
+                                     GL_COMPRESSED_RGB8_ETC2,
+                                     GL_COMPRESSED_RGBA8_ETC2_EAC};
+
+    ensureGlContext();
+
+    // Create the OpenGL texture if it doesn't exist yet
+    if (!m_texture)
+    {
+        GLuint texture;
+        glCheck(glGenTextures(1, &texture));
+        m_texture = static_cast<unsigned int>(texture);
+    }
+
+    // Make sure that the current texture binding will be preserved
+    priv::TextureSaver save;
+
+    // Upload every level as it is
+    unsigned int levelCount = image.getLevelCount();
+    glCheck(glBindTexture(GL_TEXTURE_2D, m_texture));
+    for (unsigned int i = 0; i < levelCount; ++i)
+    {
+        Vector2u levelSize = image.getSize(i);
+        glCheck(glCompressedTexImage2D(GL_TEXTURE_2D, i, formats[image.getFormat()], levelSize.x, levelSize.y, 0,
+                                       static_cast<GLsizei>(image.getLevelDataSize(i)), image.getLevelData(i)));
+    }
+
+    // Incomplete mipmap chains are valid as long as the last level is declared
+    m_hasMipmap = levelCount > 1;
+    glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levelCount - 1));
+    glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, m_isRepeated ? GL_REPEAT : GL_CLAMP_TO_EDGE));
+    glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, m_isRepeated ? GL_REPEAT : GL_CLAMP_TO_EDGE));
+    glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, m_isSmooth ? GL_LINEAR : GL_NEAREST));
+    glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, getMinificationFilter()));
+
+    if ((m_anisotropy > 1.f) && GLEW_EXT_texture_filter_anisotropic)
+        glCheck(glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, m_anisotropy));
+
+    // Force an OpenGL flush, so that the texture will appear updated
+    // in all contexts immediately (solves problems in multi-threaded apps)
+    glCheck(glFlush());
+
+    m_size          = Vector3u(size.x, size.y, 0);
+    m_actualSize    = m_size;
+    m_pixelsFlipped = false;
+    m_isCompressed  = true;
+    m_cacheId       = getUniqueId();
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool Texture::loadFromVolumeImage(const VolumeImage& volume, bool generateMipmaps)
+{
+    Vector3u size = volume.getSize();
+    if (!size.z)
+    {
+        err() << "Failed to load texture from volume image (volume is empty)" << std::endl;
+        return false;
+    }
+
+    if (!create(size.x, size.y, size.z))
+        return false;
+
+    update(volume);
+
+    if (generateMipmaps)
+        generateMipmap();
+
+    // Force an OpenGL flush, so that the texture will appear updated
+    // in all contexts immediately (solves problems in multi-threaded apps)
+    glCheck(glFlush());
+
+    return true;
+}
+
+
 ////////////////////////////////////////////////////////////
 Vector2u Texture::getSize() const
 {
@@ -309,6 +490,17 @@ Image Texture::copyToImage() const
         glCheck(glBindTexture(GL_TEXTURE_2D, m_texture));
         glCheck(glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, &pixels[0]));
     }
+    else if (readVisiblePixels(&pixels[0]))
+    {
+        // The visible area was read through a framebuffer, only the orientation needs fixing
+        if (m_pixelsFlipped)
+        {
+            Image image;
+            image.create(m_size.x, m_size.y, &pixels[0]);
+            image.flipVertically();
+            return image;
+        }
+    }
     else
     {
         // Texture is either padded or flipped, we have to use a slower algorithm
@@ -402,6 +594,8 @@ void Texture::update(const Uint8* texels, unsigned int width, unsigned int heigh
         glCheck(glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, texels));
         m_pixelsFlipped = false;
         m_cacheId = getUniqueId();
+
+        updateMipmap(x, y, width, height);
     }
 }
 
@@ -424,9 +618,13 @@ void Texture::update(const Uint8* texels, unsigned int width, unsigned int heigh
 
         // Copy texels from the given array to the texture
         glCheck(glBindTexture(GL_TEXTURE_3D, m_texture));
-        glCheck(glTexSubImage3D(GL_TEXTURE_3D, 0, x, y, z, width, height, depth, GL_RGBA, GL_UNSIGNED_BYTE, texels));
+        uploadSlices(texels, width, height, depth, x, y, z);
         m_pixelsFlipped = false;
         m_cacheId = getUniqueId();
+
+        // 3D mipmaps can't be updated partially
+        if (m_hasMipmap)
+            generateMipmap();
     }
 }
 
@@ -446,6 +644,118 @@ void Texture::update(const Image& image, unsigned int x, unsigned int y)
 }
 
 
+////////////////////////////////////////////////////////////
+void Texture::update(const VolumeImage& volume)
+{
+    // Update the whole texture
+    update(volume, 0, 0, 0);
+}
+
+
+////////////////////////////////////////////////////////////
+void Texture::update(const VolumeImage& volume, unsigned int x, unsigned int y, unsigned int z)
+{
+    Vector3u size = volume.getSize();
+    if (size.z)
+        update(volume.getPixelsPtr(), size.x, size.y, size.z, x, y, z);
+}
+
+
+////////////////////////////////////////////////////////////
+void Texture::updateSlice(const Uint8* texels, unsigned int z)
+{
+    assert(m_size.z);
+    assert(z < m_size.z);
+
+    if (texels && m_texture)
+    {
+        ensureGlContext();
+
+        // Make sure that the current 3D texture binding will be preserved
+        priv::TextureSaver save(0, 0);
+
+        // Copy texels from the given array to the slice
+        glCheck(glBindTexture(GL_TEXTURE_3D, m_texture));
+        glCheck(glTexSubImage3D(GL_TEXTURE_3D, 0, 0, 0, z, m_size.x, m_size.y, 1, GL_RGBA, GL_UNSIGNED_BYTE, texels));
+        m_pixelsFlipped = false;
+        m_cacheId = getUniqueId();
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void Texture::updateSlice(const Image& slice, unsigned int z)
+{
+    assert(slice.getSize().x == m_size.x);
+    assert(slice.getSize().y == m_size.y);
+
+    updateSlice(slice.getPixelsPtr(), z);
+}
+
+
+////////////////////////////////////////////////////////////
+void Texture::update(const Texture& texture)
+{
+    // Update the whole texture
+    update(texture, 0, 0);
+}
+
+
+////////////////////////////////////////////////////////////
+void Texture::update(const Texture& texture, unsigned int x, unsigned int y)
+{
+    assert(m_size.y && texture.m_size.y);
+    assert(!m_size.z && !texture.m_size.z);
+    assert(x + texture.m_size.x <= m_size.x);
+    assert(y + texture.m_size.y <= m_size.y);
+
+    if (!m_texture || !texture.m_texture)
+        return;
+
+    ensureGlContext();
+
+    if (!GLEW_EXT_framebuffer_object)
+    {
+        // No framebuffer objects: go through system memory
+        update(texture.copyToImage(), x, y);
+        return;
+    }
+
+    // Make sure that the current texture and framebuffer bindings will be preserved
+    priv::TextureSaver save;
+    GLint previousFrameBuffer = 0;
+    glCheck(glGetIntegerv(GL_FRAMEBUFFER_BINDING_EXT, &previousFrameBuffer));
+
+    // Attach the source texture to a temporary framebuffer, to read from it
+    GLuint frameBuffer = 0;
+    glCheck(glGenFramebuffersEXT(1, &frameBuffer));
+    glCheck(glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, frameBuffer));
+    glCheck(glFramebufferTexture2DEXT(GL_FRAMEBUFFER_EXT, GL_COLOR_ATTACHMENT0_EXT, GL_TEXTURE_2D, texture.m_texture, 0));
+
+    if (glCheckFramebufferStatusEXT(GL_FRAMEBUFFER_EXT) == GL_FRAMEBUFFER_COMPLETE_EXT)
+    {
+        // Copy the pixels on the graphics card
+        glCheck(glBindTexture(GL_TEXTURE_2D, m_texture));
+        glCheck(glCopyTexSubImage2D(GL_TEXTURE_2D, 0, x, y, 0, 0, texture.m_size.x, texture.m_size.y));
+        m_pixelsFlipped = texture.m_pixelsFlipped;
+        m_cacheId = getUniqueId();
+
+        glCheck(glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, previousFrameBuffer));
+        glCheck(glDeleteFramebuffersEXT(1, &frameBuffer));
+
+        updateMipmap(x, y, texture.m_size.x, texture.m_size.y);
+    }
+    else
+    {
+        glCheck(glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, previousFrameBuffer));
+        glCheck(glDeleteFramebuffersEXT(1, &frameBuffer));
+
+        // The source texture can't be read on the graphics card: go through system memory
+        update(texture.copyToImage(), x, y);
+    }
+}
+
+
 ////////////////////////////////////////////////////////////
 void Texture::update(const Window& window)
 {
@@ -471,6 +781,8 @@ void Texture::update(const Window& window, unsigned int x, unsigned int y)
         glCheck(glCopyTexSubImage2D(GL_TEXTURE_2D, 0, x, y, 0, 0, window.getSize().x, window.getSize().y));
         m_pixelsFlipped = true;
         m_cacheId = getUniqueId();
+
+        updateMipmap(x, y, window.getSize().x, window.getSize().y);
     }
 }
 
@@ -493,7 +805,7 @@ void Texture::setSmooth(bool smooth)
 
                 glCheck(glBindTexture(GL_TEXTURE_3D, m_texture));
                 glCheck(glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, m_isSmooth ? GL_LINEAR : GL_NEAREST));
-                glCheck(glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, m_isSmooth ? GL_LINEAR : GL_NEAREST));
+                glCheck(glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, getMinificationFilter()));
             }
             else if (m_size.y)
             {
@@ -502,7 +814,7 @@ void Texture::setSmooth(bool smooth)
 
                 glCheck(glBindTexture(GL_TEXTURE_2D, m_texture));
                 glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, m_isSmooth ? GL_LINEAR : GL_NEAREST));
-                glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, m_isSmooth ? GL_LINEAR : GL_NEAREST));
+                glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, getMinificationFilter()));
             }
             else
             {
@@ -575,6 +887,94 @@ bool Texture::isRepeated() const
 }
 
 
+////////////////////////////////////////////////////////////
+bool Texture::generateMipmap()
+{
+    if (!m_texture || !m_size.y)
+        return false;
+
+    // Neither the driver nor the CPU fallback can filter compressed blocks
+    if (m_isCompressed)
+    {
+        err() << "Failed to generate the mipmaps of a compressed texture, "
+              << "they must be stored in the compressed image" << std::endl;
+        return false;
+    }
+
+    ensureGlContext();
+
+    // Make sure that GLEW is initialized
+    priv::ensureGlewInit();
+
+    if (!GLEW_EXT_framebuffer_object)
+        return generateMipmapOnCpu();
+
+    // Make sure that the current texture bindings will be preserved
+    priv::TextureSaver save2D;
+    priv::TextureSaver save3D(0, 0);
+
+    // Declare every level down to 1x1, in case a compressed image limited them
+    GLint maxLevel = 0;
+    for (unsigned int size = std::max(m_actualSize.x, std::max(m_actualSize.y, m_actualSize.z)); size > 1; size /= 2)
+        ++maxLevel;
+
+    GLenum target = m_size.z ? GL_TEXTURE_3D : GL_TEXTURE_2D;
+    glCheck(glBindTexture(target, m_texture));
+    glCheck(glTexParameteri(target, GL_TEXTURE_MAX_LEVEL, maxLevel));
+    glCheck(glGenerateMipmapEXT(target));
+
+    m_hasMipmap = true;
+    glCheck(glTexParameteri(target, GL_TEXTURE_MIN_FILTER, getMinificationFilter()));
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool Texture::hasMipmap() const
+{
+    return m_hasMipmap;
+}
+
+
+////////////////////////////////////////////////////////////
+void Texture::setAnisotropy(float anisotropy)
+{
+    anisotropy = std::max(1.f, std::min(anisotropy, getMaximumAnisotropy()));
+
+    if (anisotropy != m_anisotropy)
+    {
+        m_anisotropy = anisotropy;
+
+        if (m_texture && GLEW_EXT_texture_filter_anisotropic)
+        {
+            ensureGlContext();
+
+            GLenum target = GL_TEXTURE_3D;
+            if (!m_size.y)
+                target = GL_TEXTURE_1D;
+            else if (!m_size.z)
+                target = GL_TEXTURE_2D;
+
+            // Make sure that the current texture bindings will be preserved
+            priv::TextureSaver save2D;
+            priv::TextureSaver save1D(0);
+            priv::TextureSaver save3D(0, 0);
+
+            glCheck(glBindTexture(target, m_texture));
+            glCheck(glTexParameterf(target, GL_TEXTURE_MAX_ANISOTROPY_EXT, m_anisotropy));
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+float Texture::getAnisotropy() const
+{
+    return m_anisotropy;
+}
+
+
 ////////////////////////////////////////////////////////////
 void Texture::bind(const Texture* texture, CoordinateType coordinateType)
 {
@@ -665,23 +1065,67 @@ unsigned int Texture::getMaximumSize()
 }
 
 
+////////////////////////////////////////////////////////////
+bool Texture::isCompressedFormatAvailable(CompressedImage::Format format)
+{
+    ensureGlContext();
+
+    // Make sure that GLEW is initialized
+    priv::ensureGlewInit();
+
+    if ((format == CompressedImage::Etc2Rgb) || (format == CompressedImage::Etc2Rgba))
+        return hasEs3Compatibility();
+    else
+        return GLEW_EXT_texture_compression_s3tc != GL_FALSE;
+}
+
+
+////////////////////////////////////////////////////////////
+float Texture::getMaximumAnisotropy()
+{
+    ensureGlContext();
+
+    // Make sure that GLEW is initialized
+    priv::ensureGlewInit();
+
+    if (!GLEW_EXT_texture_filter_anisotropic)
+        return 1.f;
+
+    GLfloat anisotropy = 1.f;
+    glCheck(glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &anisotropy));
+
+    return anisotropy;
+}
+
+
 ////////////////////////////////////////////////////////////
 Texture& Texture::operator =(const Texture& right)
 {
     Texture temp(right);
 
-    std::swap(m_size,          temp.m_size);
-    std::swap(m_actualSize,    temp.m_actualSize);
-    std::swap(m_texture,       temp.m_texture);
-    std::swap(m_isSmooth,      temp.m_isSmooth);
-    std::swap(m_isRepeated,    temp.m_isRepeated);
-    std::swap(m_pixelsFlipped, temp.m_pixelsFlipped);
-    m_cacheId = getUniqueId();
+    swap(temp);
 
     return *this;
 }
 
 
+////////////////////////////////////////////////////////////
+void Texture::swap(Texture& right)
+{
+    std::swap(m_size,          right.m_size);
+    std::swap(m_actualSize,    right.m_actualSize);
+    std::swap(m_texture,       right.m_texture);
+    std::swap(m_isSmooth,      right.m_isSmooth);
+    std::swap(m_isRepeated,    right.m_isRepeated);
+    std::swap(m_pixelsFlipped, right.m_pixelsFlipped);
+    std::swap(m_hasMipmap,     right.m_hasMipmap);
+    std::swap(m_isCompressed,  right.m_isCompressed);
+    std::swap(m_anisotropy,    right.m_anisotropy);
+    m_cacheId = getUniqueId();
+    right.m_cacheId = getUniqueId();
+}
+
+
 ////////////////////////////////////////////////////////////
 unsigned int Texture::getValidSize(unsigned int size)
 {
@@ -705,4 +1149,225 @@ unsigned int Texture::getValidSize(unsigned int size)
     }
 }
 
+
+////////////////////////////////////////////////////////////
+bool Texture::createStorage(unsigned int width, unsigned int height, int internalFormat, unsigned int format, unsigned int type)
+{
+    if (!create(width, height))
+        return false;
+
+    // Make sure that the current texture binding will be preserved
+    priv::TextureSaver save;
+
+    // Replace the RGBA storage allocated by create
+    glCheck(glBindTexture(GL_TEXTURE_2D, m_texture));
+    glCheck(glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, m_actualSize.x, m_actualSize.y, 0, format, type, NULL));
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+int Texture::getMinificationFilter() const
+{
+    if (m_hasMipmap)
+        return m_isSmooth ? GL_LINEAR_MIPMAP_LINEAR : GL_NEAREST_MIPMAP_LINEAR;
+    else
+        return m_isSmooth ? GL_LINEAR : GL_NEAREST;
+}
+
+
+////////////////////////////////////////////////////////////
+void Texture::updateMipmap(unsigned int x, unsigned int y, unsigned int width, unsigned int height)
+{
+    if (!m_hasMipmap || !width || !height)
+        return;
+
+    // Large updates, or no way to copy between levels on the graphics card: rebuild the whole chain
+    if ((width * height * 4 >= m_actualSize.x * m_actualSize.y) || !GLEW_EXT_framebuffer_blit)
+    {
+        generateMipmap();
+        return;
+    }
+
+    // Make sure that the current framebuffer binding will be preserved
+    GLint previousFrameBuffer = 0;
+    glCheck(glGetIntegerv(GL_FRAMEBUFFER_BINDING_EXT, &previousFrameBuffer));
+
+    GLuint frameBuffers[2] = {0, 0};
+    glCheck(glGenFramebuffersEXT(2, frameBuffers));
+    glCheck(glBindFramebufferEXT(GL_READ_FRAMEBUFFER_EXT, frameBuffers[0]));
+    glCheck(glBindFramebufferEXT(GL_DRAW_FRAMEBUFFER_EXT, frameBuffers[1]));
+
+    // Downsample the touched area from each level to the next one: a
+    // linear blit at exactly half the size averages 2x2 texel blocks
+    unsigned int left = x;
+    unsigned int top = y;
+    unsigned int right = x + width;
+    unsigned int bottom = y + height;
+    Vector2u size(m_actualSize.x, m_actualSize.y);
+    bool complete = true;
+    for (int level = 1; complete && ((size.x > 1) || (size.y > 1)); ++level)
+    {
+        Vector2u nextSize(std::max(size.x / 2, 1u), std::max(size.y / 2, 1u));
+        unsigned int nextLeft = left / 2;
+        unsigned int nextTop = top / 2;
+        unsigned int nextRight = std::min((right + 1) / 2, nextSize.x);
+        unsigned int nextBottom = std::min((bottom + 1) / 2, nextSize.y);
+
+        glCheck(glFramebufferTexture2DEXT(GL_READ_FRAMEBUFFER_EXT, GL_COLOR_ATTACHMENT0_EXT, GL_TEXTURE_2D, m_texture, level - 1));
+        glCheck(glFramebufferTexture2DEXT(GL_DRAW_FRAMEBUFFER_EXT, GL_COLOR_ATTACHMENT0_EXT, GL_TEXTURE_2D, m_texture, level));
+        complete = (glCheckFramebufferStatusEXT(GL_READ_FRAMEBUFFER_EXT) == GL_FRAMEBUFFER_COMPLETE_EXT) &&
+                   (glCheckFramebufferStatusEXT(GL_DRAW_FRAMEBUFFER_EXT) == GL_FRAMEBUFFER_COMPLETE_EXT);
+
+        if (complete)
+        {
+            glCheck(glBlitFramebufferEXT(std::min(nextLeft * 2, size.x - 1), std::min(nextTop * 2, size.y - 1),
+                                         std::min(nextRight * 2, size.x), std::min(nextBottom * 2, size.y),
+                                         nextLeft, nextTop, nextRight, nextBottom,
+                                         GL_COLOR_BUFFER_BIT, GL_LINEAR));
+        }
+
+        left = nextLeft;
+        top = nextTop;
+        right = nextRight;
+        bottom = nextBottom;
+        size = nextSize;
+    }
+
+    glCheck(glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, previousFrameBuffer));
+    glCheck(glDeleteFramebuffersEXT(2, frameBuffers));
+
+    // Some levels couldn't be attached: fall back to the full rebuild
+    if (!complete)
+        generateMipmap();
+}
+
+
+////////////////////////////////////////////////////////////
+bool Texture::generateMipmapOnCpu()
+{
+    if (m_size.z)
+    {
+        // Make sure that the current 3D texture binding will be preserved
+        priv::TextureSaver save(0, 0);
+
+        // Read the whole first level, including the padding
+        std::vector<Uint8> pixels(static_cast<std::size_t>(m_actualSize.x) * m_actualSize.y * m_actualSize.z * 4);
+        glCheck(glBindTexture(GL_TEXTURE_3D, m_texture));
+        glCheck(glGetTexImage(GL_TEXTURE_3D, 0, GL_RGBA, GL_UNSIGNED_BYTE, &pixels[0]));
+        VolumeImage volume;
+        volume.create(m_actualSize.x, m_actualSize.y, m_actualSize.z, &pixels[0]);
+
+        std::vector<VolumeImage> levels;
+        volume.createMipmaps(levels);
+
+        for (std::size_t i = 0; i < levels.size(); ++i)
+        {
+            Vector3u size = levels[i].getSize();
+            glCheck(glTexImage3D(GL_TEXTURE_3D, static_cast<GLint>(i + 1), GL_RGBA8, size.x, size.y, size.z, 0, GL_RGBA, GL_UNSIGNED_BYTE, levels[i].getPixelsPtr()));
+        }
+
+        m_hasMipmap = true;
+        glCheck(glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(levels.size())));
+        glCheck(glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, getMinificationFilter()));
+
+        return true;
+    }
+
+    // Read the whole first level, including the padding
+    std::vector<Uint8> pixels(m_actualSize.x * m_actualSize.y * 4);
+    Image image;
+
+    {
+        // Make sure that the current texture binding will be preserved
+        priv::TextureSaver save;
+
+        glCheck(glBindTexture(GL_TEXTURE_2D, m_texture));
+        glCheck(glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, &pixels[0]));
+        image.create(m_actualSize.x, m_actualSize.y, &pixels[0]);
+    }
+
+    std::vector<Image> levels;
+    image.createMipmaps(levels);
+
+    // Make sure that the current texture binding will be preserved
+    priv::TextureSaver save;
+
+    glCheck(glBindTexture(GL_TEXTURE_2D, m_texture));
+    for (std::size_t i = 0; i < levels.size(); ++i)
+    {
+        Vector2u size = levels[i].getSize();
+        glCheck(glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(i + 1), GL_RGBA8, size.x, size.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, levels[i].getPixelsPtr()));
+    }
+
+    m_hasMipmap = true;
+    glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(levels.size())));
+    glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, getMinificationFilter()));
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+void Texture::uploadSlices(const Uint8* texels, unsigned int width, unsigned int height, unsigned int depth, unsigned int x, unsigned int y, unsigned int z)
+{
+    // Split big volumes into slabs, so that the driver never stages the
+    // whole volume at once, and mapped files are read progressively
+    std::size_t sliceSize = static_cast<std::size_t>(width) * height * 4;
+    unsigned int slabDepth = static_cast<unsigned int>(std::max<std::size_t>(maxSlabSize / sliceSize, 1));
+
+    for (unsigned int slice = 0; slice < depth; slice += slabDepth)
+    {
+        unsigned int count = std::min(slabDepth, depth - slice);
+        glCheck(glTexSubImage3D(GL_TEXTURE_3D, 0, x, y, z + slice, width, height, count, GL_RGBA, GL_UNSIGNED_BYTE, texels + slice * sliceSize));
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+bool Texture::readVisiblePixels(Uint8* pixels) const
+{
+    if (!GLEW_EXT_framebuffer_object)
+        return false;
+
+    // Make sure that the current framebuffer binding will be preserved
+    GLint previousFrameBuffer = 0;
+    glCheck(glGetIntegerv(GL_FRAMEBUFFER_BINDING_EXT, &previousFrameBuffer));
+
+    // Attach the texture to a temporary framebuffer, to read only its visible area
+    GLuint frameBuffer = 0;
+    glCheck(glGenFramebuffersEXT(1, &frameBuffer));
+    glCheck(glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, frameBuffer));
+    glCheck(glFramebufferTexture2DEXT(GL_FRAMEBUFFER_EXT, GL_COLOR_ATTACHMENT0_EXT, GL_TEXTURE_2D, m_texture, 0));
+
+    bool complete = glCheckFramebufferStatusEXT(GL_FRAMEBUFFER_EXT) == GL_FRAMEBUFFER_COMPLETE_EXT;
+    if (complete)
+        glCheck(glReadPixels(0, 0, m_size.x, m_size.y, GL_RGBA, GL_UNSIGNED_BYTE, pixels));
+
+    glCheck(glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, previousFrameBuffer));
+    glCheck(glDeleteFramebuffersEXT(1, &frameBuffer));
+
+    return complete;
+}
+
+
+////////////////////////////////////////////////////////////
+void Texture::updateFromPixelBuffer(unsigned int width, unsigned int height, unsigned int x, unsigned int y)
+{
+    // Make sure that the current 2D texture binding will be preserved
+    priv::TextureSaver save;
+
+    // A null pointer is an offset of 0 in the bound buffer
+    glCheck(glBindTexture(GL_TEXTURE_2D, m_texture));
+    glCheck(glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, NULL));
+    m_pixelsFlipped = false;
+    m_cacheId = getUniqueId();
+
+    // The CPU mipmap fallback uploads from client memory, which would be read from the buffer
+    glCheck(glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0));
+
+    updateMipmap(x, y, width, height);
+}
+
 } // namespace sf3d
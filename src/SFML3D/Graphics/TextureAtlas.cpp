@@ -0,0 +1,246 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/Graphics/TextureAtlas.hpp>
+#include <SFML3D/Graphics/Texture.hpp>
+#include <SFML3D/Graphics/Image.hpp>
+#include <SFML3D/Graphics/RectanglePacker.hpp>
+#include <SFML3D/System/Err.hpp>
+#include <algorithm>
+#include <cassert>
+
+
+namespace
+{
+    // Orders images from the largest to the smallest
+    struct LargerImage
+    {
+        LargerImage(const std::vector<sf3d::Image>& theImages) :
+        images(theImages)
+        {
+        }
+
+        bool operator ()(std::size_t left, std::size_t right) const
+        {
+            sf3d::Vector2u leftSize = images[left].getSize();
+            sf3d::Vector2u rightSize = images[right].getSize();
+            unsigned int leftSide = std::max(leftSize.x, leftSize.y);
+            unsigned int rightSide = std::max(rightSize.x, rightSize.y);
+            if (leftSide != rightSide)
+                return leftSide > rightSide;
+
+            return leftSize.x * leftSize.y > rightSize.x * rightSize.y;
+        }
+
+        const std::vector<sf3d::Image>& images;
+    };
+}
+
+
+namespace sf3d
+{
+////////////////////////////////////////////////////////////
+struct TextureAtlas::Page
+{
+    Texture               texture; ///< Texture holding the images
+    priv::RectanglePacker packer;  ///< Free space of the texture
+};
+
+
+////////////////////////////////////////////////////////////
+TextureAtlas::Region::Region() :
+page   (0),
+rect   (),
+rotated(false)
+{
+
+}
+
+
+////////////////////////////////////////////////////////////
+TextureAtlas::TextureAtlas() :
+m_pageSize     (1024),
+m_padding      (1),
+m_allowRotation(false),
+m_isSmooth     (false),
+m_pages        ()
+{
+
+}
+
+
+////////////////////////////////////////////////////////////
+TextureAtlas::~TextureAtlas()
+{
+    clear();
+}
+
+
+////////////////////////////////////////////////////////////
+bool TextureAtlas::create(unsigned int pageSize, unsigned int padding, bool allowRotation)
+{
+    clear();
+
+    unsigned int maxSize = Texture::getMaximumSize();
+    if ((pageSize == 0) || (pageSize > maxSize) || (padding * 2 >= pageSize))
+    {
+        err() << "Failed to create texture atlas, invalid page size (" << pageSize
+              << ", maximum is " << maxSize << ") or padding (" << padding << ")" << std::endl;
+        return false;
+    }
+
+    m_pageSize = pageSize;
+    m_padding = padding;
+    m_allowRotation = allowRotation;
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool TextureAtlas::add(const Image& image, Region& region)
+{
+    region = Region();
+
+    Vector2u size = image.getSize();
+    unsigned int width = size.x + m_padding * 2;
+    unsigned int height = size.y + m_padding * 2;
+    bool fits = (width <= m_pageSize) && (height <= m_pageSize);
+    if (!size.x || !size.y || !fits)
+    {
+        err() << "Failed to add image to texture atlas, its size (" << size.x << "x" << size.y
+              << ") doesn't fit in a page (" << m_pageSize << "x" << m_pageSize << ")" << std::endl;
+        return false;
+    }
+
+    return insert(image, region);
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t TextureAtlas::add(const std::vector<Image>& images, std::vector<Region>& regions)
+{
+    regions.assign(images.size(), Region());
+
+    // Insert the largest images first, they are the hardest to place
+    std::vector<std::size_t> order(images.size());
+    for (std::size_t i = 0; i < order.size(); ++i)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(), LargerImage(images));
+
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < order.size(); ++i)
+    {
+        if (add(images[order[i]], regions[order[i]]))
+            ++count;
+    }
+
+    return count;
+}
+
+
+////////////////////////////////////////////////////////////
+void TextureAtlas::clear()
+{
+    for (std::vector<Page*>::iterator it = m_pages.begin(); it != m_pages.end(); ++it)
+        delete *it;
+
+    m_pages.clear();
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int TextureAtlas::getPageCount() const
+{
+    return static_cast<unsigned int>(m_pages.size());
+}
+
+
+////////////////////////////////////////////////////////////
+const Texture& TextureAtlas::getTexture(unsigned int page) const
+{
+    assert(page < m_pages.size());
+
+    return m_pages[page]->texture;
+}
+
+
+////////////////////////////////////////////////////////////
+float TextureAtlas::getOccupancy(unsigned int page) const
+{
+    return page < m_pages.size() ? m_pages[page]->packer.getOccupancy() : 0.f;
+}
+
+
+////////////////////////////////////////////////////////////
+void TextureAtlas::setSmooth(bool smooth)
+{
+    m_isSmooth = smooth;
+
+    for (std::vector<Page*>::iterator it = m_pages.begin(); it != m_pages.end(); ++it)
+        (*it)->texture.setSmooth(smooth);
+}
+
+
+////////////////////////////////////////////////////////////
+bool TextureAtlas::insert(const Image& image, Region& region)
+{
+    Vector2u size = image.getSize();
+    unsigned int width = size.x + m_padding * 2;
+    unsigned int height = size.y + m_padding * 2;
+
+    // Find room in the existing pages, or start a new one
+    IntRect rect;
+    bool rotated = false;
+    std::size_t page = 0;
+    while ((page < m_pages.size()) && !m_pages[page]->packer.insert(width, height, m_allowRotation, rect, rotated))
+        ++page;
+
+    if (page == m_pages.size())
+    {
+        Page* newPage = new Page;
+        if (!newPage->texture.create(m_pageSize, m_pageSize))
+        {
+            delete newPage;
+            return false;
+        }
+
+        // Start with a transparent texture, so that the free space is clean
+        std::vector<Uint8> transparent(m_pageSize * m_pageSize * 4, 0);
+        newPage->texture.update(&transparent[0]);
+        newPage->texture.setSmooth(m_isSmooth);
+        newPage->packer.reset(m_pageSize, m_pageSize);
+        m_pages.push_back(newPage);
+
+        if (!newPage->packer.insert(width, height, m_allowRotation, rect, rotated))
+            return false;
+    }
+
+    // Build the stored pixels: the image, rotated if needed, surrounded
+    // by the padding filled with copies of its border
+    const Uint8* source = image.getPixelsPtr();
+    std::vector<Uint8> pixels(rect.width * rect.height * 4);
+    for (int y = 0; y < rect.height; ++y)
+    {
+        int innerY = std::min(std::max(y - static_cast<int>(m_padding), 0), (rotated ? static_cast<int>(size.x) : static_cast<int>(size.y)) - 1);
+        for (int x = 0; x < rect.width; ++x)
+        {
+            int innerX = std::min(std::max(x - static_cast<int>(m_padding), 0), (rotated ? static_cast<int>(size.y) : static_cast<int>(size.x)) - 1);
+
+            // A clockwise rotation maps the stored pixel (x, y) to the source pixel (y, height - 1 - x)
+            std::size_t index = rotated ? (innerY + (size.y - 1 - innerX) * size.x) : (innerX + innerY * size.x);
+            const Uint8* pixel = source + index * 4;
+            std::copy(pixel, pixel + 4, &pixels[(x + y * rect.width) * 4]);
+        }
+    }
+
+    m_pages[page]->texture.update(&pixels[0], rect.width, rect.height, rect.left, rect.top);
+
+    region.page = static_cast<unsigned int>(page);
+    region.rect = IntRect(rect.left + m_padding, rect.top + m_padding, rect.width - m_padding * 2, rect.height - m_padding * 2);
+    region.rotated = rotated;
+
+    return true;
+}
+
+} // namespace sf3d
@@ -289,7 +289,7 @@ FloatBox Transform::transformBox(const FloatBox& box) const
     float right  = points[0].x;
     float bottom = points[0].y;
     float back   = points[0].z;
-    for (int i = 1; i < 4; ++i)
+    for (int i = 1; i < 8; ++i)
     {
         if      (points[i].x < left)   left   = points[i].x;
         else if (points[i].x > right)  right  = points[i].x;
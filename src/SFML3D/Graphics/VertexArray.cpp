@@ -91,6 +91,13 @@ void VertexArray::append(const Vertex& vertex)
 }
 
 
+////////////////////////////////////////////////////////////
+void VertexArray::assign(const Vertex* vertices, unsigned int vertexCount)
+{
+    m_vertices.assign(vertices, vertices + vertexCount);
+}
+
+
 ////////////////////////////////////////////////////////////
 void VertexArray::setPrimitiveType(PrimitiveType type)
 {
@@ -156,6 +156,15 @@ void VertexBuffer::append(const Vertex& vertex)
 }
 
 
+////////////////////////////////////////////////////////////
+void VertexBuffer::assign(const Vertex* vertices, unsigned int vertexCount)
+{
+    m_needUpload = true;
+
+    m_vertices.assign(vertices, vertices + vertexCount);
+}
+
+
 ////////////////////////////////////////////////////////////
 void VertexBuffer::setPrimitiveType(PrimitiveType type)
 {
@@ -116,6 +116,13 @@ void VertexContainer::append(const Vertex& vertex)
 }
 
 
+////////////////////////////////////////////////////////////
+void VertexContainer::assign(const Vertex* vertices, unsigned int vertexCount)
+{
+    m_impl->assign(vertices, vertexCount);
+}
+
+
 ////////////////////////////////////////////////////////////
 void VertexContainer::setPrimitiveType(PrimitiveType type)
 {
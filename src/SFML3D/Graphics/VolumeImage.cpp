@@ -0,0 +1,318 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/Graphics/VolumeImage.hpp>
+#include <SFML3D/Graphics/FileMapping.hpp>
+#include <SFML3D/Graphics/ImageKernels.hpp>
+#include <SFML3D/System/Err.hpp>
+#include <algorithm>
+#include <fstream>
+#include <cstring>
+
+
+namespace sf3d
+{
+////////////////////////////////////////////////////////////
+VolumeImage::VolumeImage() :
+m_size   (0, 0, 0),
+m_mapping(NULL)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+VolumeImage::VolumeImage(const VolumeImage& copy) :
+m_size   (0, 0, 0),
+m_mapping(NULL)
+{
+    if (copy.m_size.z)
+        create(copy.m_size.x, copy.m_size.y, copy.m_size.z, copy.getPixelsPtr());
+}
+
+
+////////////////////////////////////////////////////////////
+VolumeImage::~VolumeImage()
+{
+    delete m_mapping;
+}
+
+
+////////////////////////////////////////////////////////////
+void VolumeImage::create(unsigned int width, unsigned int height, unsigned int depth, const Color& color)
+{
+    create(width, height, depth, static_cast<const Uint8*>(NULL));
+
+    if (width && height && depth)
+    {
+        // Assign the new size
+        m_size = Vector3u(width, height, depth);
+
+        // Fill the first pixel, then double the filled area until the whole volume is covered
+        m_pixels.resize(static_cast<std::size_t>(width) * height * depth * 4);
+        m_pixels[0] = color.r;
+        m_pixels[1] = color.g;
+        m_pixels[2] = color.b;
+        m_pixels[3] = color.a;
+        for (std::size_t filled = 4; filled < m_pixels.size(); filled *= 2)
+            std::memcpy(&m_pixels[filled], &m_pixels[0], std::min(filled, m_pixels.size() - filled));
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void VolumeImage::create(unsigned int width, unsigned int height, unsigned int depth, const Uint8* pixels)
+{
+    // Drop the mapped file, if any
+    delete m_mapping;
+    m_mapping = NULL;
+
+    if (pixels && width && height && depth)
+    {
+        // Assign the new size
+        m_size = Vector3u(width, height, depth);
+
+        // Copy the pixels
+        std::size_t size = static_cast<std::size_t>(width) * height * depth * 4;
+        m_pixels.resize(size);
+        std::memcpy(&m_pixels[0], pixels, size);
+    }
+    else
+    {
+        // Create an empty volume
+        m_size = Vector3u(0, 0, 0);
+        std::vector<Uint8>().swap(m_pixels);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+bool VolumeImage::loadFromImages(const std::vector<Image>& slices)
+{
+    if (slices.empty())
+    {
+        err() << "Failed to load volume image from images (no image given)" << std::endl;
+        return false;
+    }
+
+    Vector2u size = slices[0].getSize();
+    for (std::size_t i = 0; i < slices.size(); ++i)
+    {
+        Vector2u sliceSize = slices[i].getSize();
+        if (!sliceSize.x || !sliceSize.y || (sliceSize != size))
+        {
+            err() << "Failed to load volume image from images (slice " << i << " is " << sliceSize.x << "x" << sliceSize.y
+                  << ", expected " << size.x << "x" << size.y << ")" << std::endl;
+            return false;
+        }
+    }
+
+    // Stack the slices
+    std::size_t sliceSize = static_cast<std::size_t>(size.x) * size.y * 4;
+    std::vector<Uint8> pixels(sliceSize * slices.size());
+    for (std::size_t i = 0; i < slices.size(); ++i)
+        std::memcpy(&pixels[i * sliceSize], slices[i].getPixelsPtr(), sliceSize);
+
+    delete m_mapping;
+    m_mapping = NULL;
+    m_size = Vector3u(size.x, size.y, static_cast<unsigned int>(slices.size()));
+    m_pixels.swap(pixels);
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool VolumeImage::loadFromFiles(const std::vector<std::string>& filenames, unsigned int threadCount)
+{
+    std::vector<Image> slices;
+    if (Image::loadMany(filenames, slices, threadCount) != filenames.size())
+    {
+        err() << "Failed to load volume image from files (some slices couldn't be loaded)" << std::endl;
+        return false;
+    }
+
+    return loadFromImages(slices);
+}
+
+
+////////////////////////////////////////////////////////////
+bool VolumeImage::loadFromFile(const std::string& filename, unsigned int width, unsigned int height, unsigned int depth, Uint64 offset)
+{
+    if (!width || !height || !depth)
+    {
+        err() << "Failed to load volume image \"" << filename << "\", invalid size ("
+              << width << "x" << height << "x" << depth << ")" << std::endl;
+        return false;
+    }
+
+    std::size_t size = static_cast<std::size_t>(width) * height * depth * 4;
+    priv::FileMapping* mapping = new priv::FileMapping;
+    if (!mapping->open(filename, offset, size))
+    {
+        delete mapping;
+        err() << "Failed to load volume image \"" << filename << "\" (the file can't be opened, or is smaller than "
+              << width << "x" << height << "x" << depth << " pixels)" << std::endl;
+        return false;
+    }
+
+    delete m_mapping;
+    m_mapping = mapping;
+    m_size = Vector3u(width, height, depth);
+    std::vector<Uint8>().swap(m_pixels);
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool VolumeImage::saveToFile(const std::string& filename) const
+{
+    const Uint8* pixels = getPixelsPtr();
+    if (!pixels)
+    {
+        err() << "Failed to save volume image \"" << filename << "\" (the volume is empty)" << std::endl;
+        return false;
+    }
+
+    std::ofstream file(filename.c_str(), std::ios_base::binary);
+    if (!file)
+    {
+        err() << "Failed to save volume image \"" << filename << "\" (the file can't be opened)" << std::endl;
+        return false;
+    }
+
+    // Write one slice at a time, so that mapped volumes are paged in progressively
+    std::size_t sliceSize = static_cast<std::size_t>(m_size.x) * m_size.y * 4;
+    for (unsigned int z = 0; (z < m_size.z) && file; ++z)
+        file.write(reinterpret_cast<const char*>(pixels + z * sliceSize), static_cast<std::streamsize>(sliceSize));
+
+    if (!file)
+    {
+        err() << "Failed to save volume image \"" << filename << "\" (write error)" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+Vector3u VolumeImage::getSize() const
+{
+    return m_size;
+}
+
+
+////////////////////////////////////////////////////////////
+void VolumeImage::setPixel(unsigned int x, unsigned int y, unsigned int z, const Color& color)
+{
+    Uint8* pixel = getData() + ((static_cast<std::size_t>(z) * m_size.y + y) * m_size.x + x) * 4;
+    *pixel++ = color.r;
+    *pixel++ = color.g;
+    *pixel++ = color.b;
+    *pixel++ = color.a;
+}
+
+
+////////////////////////////////////////////////////////////
+Color VolumeImage::getPixel(unsigned int x, unsigned int y, unsigned int z) const
+{
+    const Uint8* pixel = getPixelsPtr() + ((static_cast<std::size_t>(z) * m_size.y + y) * m_size.x + x) * 4;
+    return Color(pixel[0], pixel[1], pixel[2], pixel[3]);
+}
+
+
+////////////////////////////////////////////////////////////
+const Uint8* VolumeImage::getPixelsPtr() const
+{
+    if (m_mapping)
+    {
+        return m_mapping->getData();
+    }
+    else if (!m_pixels.empty())
+    {
+        return &m_pixels[0];
+    }
+    else
+    {
+        err() << "Trying to access the pixels of an empty volume image" << std::endl;
+        return NULL;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+const Uint8* VolumeImage::getSlicePtr(unsigned int z) const
+{
+    const Uint8* pixels = getPixelsPtr();
+    return pixels ? pixels + static_cast<std::size_t>(z) * m_size.x * m_size.y * 4 : NULL;
+}
+
+
+////////////////////////////////////////////////////////////
+Image VolumeImage::copySlice(unsigned int z) const
+{
+    Image slice;
+    if (z < m_size.z)
+        slice.create(m_size.x, m_size.y, getSlicePtr(z));
+
+    return slice;
+}
+
+
+////////////////////////////////////////////////////////////
+void VolumeImage::createMipmaps(std::vector<VolumeImage>& levels) const
+{
+    levels.clear();
+
+    // Reserve all the levels up front, so that they don't move while the chain is built
+    std::size_t count = 0;
+    for (unsigned int size = std::max(m_size.x, std::max(m_size.y, m_size.z)); size > 1; size /= 2)
+        ++count;
+    levels.reserve(count);
+
+    const VolumeImage* previous = this;
+    while ((previous->m_size.x > 1) || (previous->m_size.y > 1) || (previous->m_size.z > 1))
+    {
+        Vector3u size(std::max(previous->m_size.x / 2, 1u), std::max(previous->m_size.y / 2, 1u), std::max(previous->m_size.z / 2, 1u));
+
+        levels.push_back(VolumeImage());
+        VolumeImage& level = levels.back();
+        level.m_size = size;
+        level.m_pixels.resize(static_cast<std::size_t>(size.x) * size.y * size.z * 4);
+        priv::downsampleBox(previous->getPixelsPtr(), previous->m_size.x, previous->m_size.y, previous->m_size.z, &level.m_pixels[0]);
+
+        previous = &level;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+VolumeImage& VolumeImage::operator =(const VolumeImage& right)
+{
+    VolumeImage temp(right);
+    swap(temp);
+
+    return *this;
+}
+
+
+////////////////////////////////////////////////////////////
+void VolumeImage::swap(VolumeImage& right)
+{
+    std::swap(m_size,    right.m_size);
+    std::swap(m_mapping, right.m_mapping);
+    m_pixels.swap(right.m_pixels);
+}
+
+
+////////////////////////////////////////////////////////////
+Uint8* VolumeImage::getData()
+{
+    if (m_mapping)
+        return m_mapping->getData();
+    else
+        return m_pixels.empty() ? NULL : &m_pixels[0];
+}
+
+} // namespace sf3d
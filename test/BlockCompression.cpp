@@ -0,0 +1,204 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/Graphics/BlockCompression.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+
+namespace
+{
+    // Number of failed checks
+    unsigned int failures = 0;
+
+    // Compare decoded pixels with the expected ones
+    void checkPixels(const char* test, const sf3d::Uint8* pixels, const sf3d::Uint8* expected)
+    {
+        for (int i = 0; i < 64; ++i)
+        {
+            if (pixels[i] != expected[i])
+            {
+                std::cout << test << ": pixel " << i / 4 << " channel " << i % 4 << " is " << static_cast<int>(pixels[i])
+                          << ", expected " << static_cast<int>(expected[i]) << std::endl;
+                ++failures;
+                return;
+            }
+        }
+    }
+
+    // Report a round trip whose error is above its bound
+    void checkError(const char* test, int error, int bound, int block)
+    {
+        if (error > bound)
+        {
+            std::cout << test << ": error of " << error << " above the bound of " << bound << " (block " << block << ")" << std::endl;
+            ++failures;
+        }
+    }
+
+    // Fill the 16 pixels of a block with the same value
+    void fill(sf3d::Uint8* pixels, sf3d::Uint8 r, sf3d::Uint8 g, sf3d::Uint8 b, sf3d::Uint8 a)
+    {
+        for (int i = 0; i < 16; ++i)
+        {
+            pixels[i * 4 + 0] = r;
+            pixels[i * 4 + 1] = g;
+            pixels[i * 4 + 2] = b;
+            pixels[i * 4 + 3] = a;
+        }
+    }
+
+    // Decode hand-made blocks, whose values are given by the format specification
+    void testDecoding()
+    {
+        sf3d::Uint8 pixels[64];
+        sf3d::Uint8 expected[64];
+
+        // BC1, 4 colors mode (color0 > color1): white, black, 2/3 and 1/3 of white
+        const sf3d::Uint8 opaque[8] = {0xFF, 0xFF, 0x00, 0x00, 0xE4, 0xE4, 0xE4, 0xE4};
+        const sf3d::Uint8 levels[4] = {255, 0, 170, 85};
+        for (int i = 0; i < 16; ++i)
+        {
+            std::memset(expected + i * 4, levels[i % 4], 3);
+            expected[i * 4 + 3] = 255;
+        }
+        sf3d::priv::decodeBc1Block(opaque, pixels);
+        checkPixels("BC1 4 colors", pixels, expected);
+
+        // BC1, 3 colors mode (color0 <= color1): black, white, half and transparent black
+        const sf3d::Uint8 transparent[8] = {0x00, 0x00, 0xFF, 0xFF, 0xE4, 0xE4, 0xE4, 0xE4};
+        const sf3d::Uint8 transparentLevels[4] = {0, 255, 127, 0};
+        for (int i = 0; i < 16; ++i)
+        {
+            std::memset(expected + i * 4, transparentLevels[i % 4], 3);
+            expected[i * 4 + 3] = (i % 4 == 3) ? 0 : 255;
+        }
+        sf3d::priv::decodeBc1Block(transparent, pixels);
+        checkPixels("BC1 3 colors", pixels, expected);
+
+        // BC2: explicit 4 bits alpha, expanded by 17; the color part is always in 4 colors mode
+        sf3d::Uint8 explicitAlpha[16] = {0x10, 0x32, 0x54, 0x76, 0x98, 0xBA, 0xDC, 0xFE, 0x00, 0x00, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00};
+        fill(expected, 0, 0, 0, 0);
+        for (int i = 0; i < 16; ++i)
+            expected[i * 4 + 3] = static_cast<sf3d::Uint8>(i * 17);
+        sf3d::priv::decodeBc2Block(explicitAlpha, pixels);
+        checkPixels("BC2", pixels, expected);
+
+        // BC3, 8 values mode (alpha0 > alpha1): indices 0 to 7 on the first 8 pixels
+        sf3d::Uint8 interpolated[16] = {252, 0, 0x88, 0xC6, 0xFA, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00};
+        const sf3d::Uint8 alphas[8] = {252, 0, 216, 180, 144, 108, 72, 36};
+        for (int i = 0; i < 16; ++i)
+            expected[i * 4 + 3] = (i < 8) ? alphas[i] : 252;
+        sf3d::priv::decodeBc3Block(interpolated, pixels);
+        checkPixels("BC3 8 values", pixels, expected);
+
+        // BC3, 6 values mode (alpha0 <= alpha1): indices 6 and 7 are 0 and 255
+        interpolated[0] = 0;
+        interpolated[1] = 100;
+        const sf3d::Uint8 sixAlphas[8] = {0, 100, 20, 40, 60, 80, 0, 255};
+        for (int i = 0; i < 16; ++i)
+            expected[i * 4 + 3] = (i < 8) ? sixAlphas[i] : 0;
+        sf3d::priv::decodeBc3Block(interpolated, pixels);
+        checkPixels("BC3 6 values", pixels, expected);
+    }
+
+    // Encode and decode random blocks, and check the error against
+    // the precision of the format
+    void testRoundTrips()
+    {
+        sf3d::Uint8 pixels[64];
+        sf3d::Uint8 block[16];
+        sf3d::Uint8 decoded[64];
+
+        for (int n = 0; n < 20000; ++n)
+        {
+            // Solid color: only the 5:6:5 quantization remains
+            fill(pixels, std::rand() % 256, std::rand() % 256, std::rand() % 256, 255);
+            sf3d::priv::encodeBc1Block(pixels, block);
+            sf3d::priv::decodeBc1Block(block, decoded);
+            checkError("BC1 solid red", std::abs(decoded[0] - pixels[0]), 4, n);
+            checkError("BC1 solid green", std::abs(decoded[1] - pixels[1]), 2, n);
+            checkError("BC1 solid blue", std::abs(decoded[2] - pixels[2]), 4, n);
+
+            // Gradient between two random colors: the 4 colors palette spans 7/8 of the
+            // range (the endpoints are moved inside by 1/16), so every pixel is within
+            // 7/48 of the range of the nearest entry, plus the quantization and rounding
+            int first[3];
+            int last[3];
+            for (int c = 0; c < 3; ++c)
+            {
+                first[c] = std::rand() % 256;
+                last[c] = std::rand() % 256;
+            }
+            for (int i = 0; i < 16; ++i)
+            {
+                int t = std::rand() % 256;
+                for (int c = 0; c < 3; ++c)
+                    pixels[i * 4 + c] = static_cast<sf3d::Uint8>((first[c] * (255 - t) + last[c] * t) / 255);
+                pixels[i * 4 + 3] = static_cast<sf3d::Uint8>(std::rand() % 256);
+            }
+
+            sf3d::priv::encodeBc3Block(pixels, block);
+            sf3d::priv::decodeBc3Block(block, decoded);
+
+            int minAlpha = 255;
+            int maxAlpha = 0;
+            for (int i = 0; i < 16; ++i)
+            {
+                minAlpha = std::min<int>(minAlpha, pixels[i * 4 + 3]);
+                maxAlpha = std::max<int>(maxAlpha, pixels[i * 4 + 3]);
+            }
+
+            for (int i = 0; i < 16; ++i)
+            {
+                for (int c = 0; c < 3; ++c)
+                    checkError("BC3 gradient color", std::abs(decoded[i * 4 + c] - pixels[i * 4 + c]), std::abs(first[c] - last[c]) * 7 / 48 + 8, n);
+
+                // 8 alpha values spread over the range of the block
+                checkError("BC3 alpha", std::abs(decoded[i * 4 + 3] - pixels[i * 4 + 3]), (maxAlpha - minAlpha) / 14 + 1, n);
+            }
+
+            // BC1 alpha: 1 bit, the threshold is 128
+            sf3d::priv::encodeBc1Block(pixels, block);
+            sf3d::priv::decodeBc1Block(block, decoded);
+            for (int i = 0; i < 16; ++i)
+            {
+                int expected = pixels[i * 4 + 3] < 128 ? 0 : 255;
+                checkError("BC1 alpha", std::abs(decoded[i * 4 + 3] - expected), 0, n);
+            }
+        }
+
+        // Alpha extremes are kept exactly
+        fill(pixels, 0, 0, 0, 0);
+        pixels[3] = 255;
+        sf3d::priv::encodeBc3Block(pixels, block);
+        sf3d::priv::decodeBc3Block(block, decoded);
+        checkError("BC3 alpha extremes", std::abs(decoded[3] - 255) + decoded[7], 0, 0);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+/// Entry point of the test
+///
+/// \return EXIT_SUCCESS if the blocks are decoded as specified
+///         and the round trips stay within their error bounds
+///
+////////////////////////////////////////////////////////////
+int main()
+{
+    std::srand(42);
+
+    testDecoding();
+    testRoundTrips();
+
+    if (failures)
+    {
+        std::cout << failures << " block compression checks failed" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,366 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/Graphics.hpp>
+#include <SFML3D/System/Err.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+
+namespace
+{
+    // Number of failed checks
+    unsigned int failures = 0;
+
+    // Report a failed check
+    void fail(const std::string& test, const std::string& message)
+    {
+        std::cout << test << ": " << message << std::endl;
+        ++failures;
+    }
+
+    // Append a little-endian 32 bits value
+    void write(std::vector<sf3d::Uint8>& data, sf3d::Uint32 value)
+    {
+        for (int i = 0; i < 4; ++i)
+            data.push_back(static_cast<sf3d::Uint8>(value >> (i * 8)));
+    }
+
+    // Append a big-endian 32 bits value
+    void writeSwapped(std::vector<sf3d::Uint8>& data, sf3d::Uint32 value)
+    {
+        for (int i = 3; i >= 0; --i)
+            data.push_back(static_cast<sf3d::Uint8>(value >> (i * 8)));
+    }
+
+    // Append bytes numbered from a start value, so that levels can be told apart
+    void writeLevel(std::vector<sf3d::Uint8>& data, std::size_t size, sf3d::Uint8 start)
+    {
+        for (std::size_t i = 0; i < size; ++i)
+            data.push_back(static_cast<sf3d::Uint8>(start + i));
+    }
+
+    // Build a DDS header; a DX10 extended header is added when dxgiFormat is not 0
+    std::vector<sf3d::Uint8> ddsHeader(sf3d::Uint32 width, sf3d::Uint32 height, sf3d::Uint32 levels, const char* fourCC, sf3d::Uint32 dxgiFormat = 0)
+    {
+        std::vector<sf3d::Uint8> data(4);
+        std::memcpy(&data[0], "DDS ", 4);
+        write(data, 124);
+        write(data, 0x1 | 0x2 | 0x4 | 0x1000 | 0x20000);
+        write(data, height);
+        write(data, width);
+        write(data, 0);
+        write(data, 0);
+        write(data, levels);
+        data.resize(76, 0);
+        write(data, 32);
+        write(data, 0x4);
+        data.insert(data.end(), fourCC, fourCC + 4);
+        data.resize(128, 0);
+
+        if (dxgiFormat)
+        {
+            write(data, dxgiFormat);
+            write(data, 3); // 2D texture
+            write(data, 0);
+            write(data, 1);
+            write(data, 0);
+        }
+
+        return data;
+    }
+
+    // Build a KTX header, in little or big endian
+    std::vector<sf3d::Uint8> ktxHeader(sf3d::Uint32 internalFormat, sf3d::Uint32 width, sf3d::Uint32 height, sf3d::Uint32 levels,
+                                       sf3d::Uint32 keyValueSize = 0, sf3d::Uint32 faces = 1, bool bigEndian = false)
+    {
+        const sf3d::Uint8 identifier[12] = {0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n'};
+        const sf3d::Uint32 fields[13] = {0x04030201, 0, 1, 0, internalFormat, 0x1908, width, height, 0, 0, faces, levels, keyValueSize};
+
+        std::vector<sf3d::Uint8> data(identifier, identifier + 12);
+        for (int i = 0; i < 13; ++i)
+        {
+            if (bigEndian)
+                writeSwapped(data, fields[i]);
+            else
+                write(data, fields[i]);
+        }
+
+        return data;
+    }
+
+    // Load a file from memory and check that it is accepted with the expected properties
+    void checkLoad(const std::string& test, const std::vector<sf3d::Uint8>& data, sf3d::CompressedImage::Format format,
+                   sf3d::Vector2u size, unsigned int levels)
+    {
+        sf3d::CompressedImage image;
+        if (!image.loadFromMemory(&data[0], data.size()))
+        {
+            fail(test, "valid file rejected");
+            return;
+        }
+
+        if (image.getFormat() != format)
+            fail(test, "wrong format");
+        if (image.getSize() != size)
+            fail(test, "wrong size");
+        if (image.getLevelCount() != levels)
+            fail(test, "wrong number of levels");
+    }
+
+    // Load a file from memory and check that it is rejected, leaving the image empty
+    void checkReject(const std::string& test, const std::vector<sf3d::Uint8>& data)
+    {
+        sf3d::CompressedImage image;
+        if (image.loadFromMemory(data.empty() ? NULL : &data[0], data.size()))
+            fail(test, "invalid file accepted");
+        else if ((image.getLevelCount() != 0) || (image.getSize() != sf3d::Vector2u(0, 0)))
+            fail(test, "image not empty after a failure");
+    }
+
+    // Check that every strict prefix of a single level file is rejected
+    void checkTruncations(const std::string& test, const std::vector<sf3d::Uint8>& data)
+    {
+        for (std::size_t size = 0; size < data.size(); ++size)
+        {
+            sf3d::CompressedImage image;
+            if (image.loadFromMemory(size ? &data[0] : NULL, size))
+            {
+                fail(test, "truncated file accepted");
+                return;
+            }
+        }
+    }
+
+    void testDds()
+    {
+        // BC1, single level, odd size: 3x2 blocks of 8 bytes
+        std::vector<sf3d::Uint8> bc1 = ddsHeader(10, 5, 1, "DXT1");
+        writeLevel(bc1, 3 * 2 * 8, 0);
+        checkLoad("DDS BC1", bc1, sf3d::CompressedImage::Bc1, sf3d::Vector2u(10, 5), 1);
+        checkTruncations("DDS BC1", bc1);
+
+        // The level data is copied as is
+        sf3d::CompressedImage image;
+        image.loadFromMemory(&bc1[0], bc1.size());
+        if ((image.getLevelDataSize(0) != 48) || (std::memcmp(image.getLevelData(0), &bc1[128], 48) != 0))
+            fail("DDS BC1", "wrong level data");
+
+        // BC2 and BC3, full mip chain of an 8x8 image: 8x8, 4x4, 2x2, 1x1
+        std::vector<sf3d::Uint8> bc2 = ddsHeader(8, 8, 4, "DXT3");
+        writeLevel(bc2, 4 * 16 + 3 * 16, 0);
+        checkLoad("DDS BC2 mipmaps", bc2, sf3d::CompressedImage::Bc2, sf3d::Vector2u(8, 8), 4);
+
+        std::vector<sf3d::Uint8> bc3 = ddsHeader(8, 8, 4, "DXT5");
+        writeLevel(bc3, 4 * 16 + 3 * 16, 0);
+        checkLoad("DDS BC3 mipmaps", bc3, sf3d::CompressedImage::Bc3, sf3d::Vector2u(8, 8), 4);
+
+        // Missing levels are dropped, the first ones are kept
+        bc3.resize(128 + 4 * 16 + 16);
+        checkLoad("DDS missing levels", bc3, sf3d::CompressedImage::Bc3, sf3d::Vector2u(8, 8), 2);
+
+        // A level count past 1x1 stops at 1x1
+        std::vector<sf3d::Uint8> tooManyLevels = ddsHeader(4, 4, 10, "DXT1");
+        writeLevel(tooManyLevels, 8 * 5, 0);
+        checkLoad("DDS too many levels", tooManyLevels, sf3d::CompressedImage::Bc1, sf3d::Vector2u(4, 4), 3);
+
+        // DX10 extended header
+        std::vector<sf3d::Uint8> dx10 = ddsHeader(4, 4, 1, "DX10", 77);
+        writeLevel(dx10, 16, 0);
+        checkLoad("DDS DX10", dx10, sf3d::CompressedImage::Bc3, sf3d::Vector2u(4, 4), 1);
+        checkTruncations("DDS DX10", dx10);
+
+        // Malformed headers
+        std::vector<sf3d::Uint8> malformed = ddsHeader(4, 4, 1, "ATI2");
+        writeLevel(malformed, 16, 0);
+        checkReject("DDS unsupported four CC", malformed);
+
+        malformed = ddsHeader(4, 4, 1, "DX10", 98);
+        writeLevel(malformed, 16, 0);
+        checkReject("DDS unsupported DXGI format", malformed);
+
+        malformed = ddsHeader(0, 4, 1, "DXT1");
+        writeLevel(malformed, 8, 0);
+        checkReject("DDS zero width", malformed);
+
+        malformed = ddsHeader(4, 0, 1, "DXT1");
+        writeLevel(malformed, 8, 0);
+        checkReject("DDS zero height", malformed);
+
+        // Sizes whose level size overflows
+        malformed = ddsHeader(0xFFFFFFFF, 4, 1, "DXT1");
+        writeLevel(malformed, 8, 0);
+        checkReject("DDS overflowing width", malformed);
+
+        malformed = ddsHeader(0xFFFFFFFF, 0xFFFFFFFF, 1, "DXT5");
+        writeLevel(malformed, 16, 0);
+        checkReject("DDS overflowing size", malformed);
+    }
+
+    void testKtx()
+    {
+        // BC1, single level: the size of the level precedes it
+        std::vector<sf3d::Uint8> bc1 = ktxHeader(0x83F1, 8, 4, 1);
+        write(bc1, 16);
+        writeLevel(bc1, 16, 0);
+        checkLoad("KTX BC1", bc1, sf3d::CompressedImage::Bc1, sf3d::Vector2u(8, 4), 1);
+        checkTruncations("KTX BC1", bc1);
+
+        // Key/value data is skipped, levels are padded to 4 bytes
+        std::vector<sf3d::Uint8> etc2 = ktxHeader(0x9278, 4, 4, 3, 8);
+        writeLevel(etc2, 8, 0xEE);
+        for (int i = 0; i < 3; ++i)
+        {
+            write(etc2, 16);
+            writeLevel(etc2, 16, static_cast<sf3d::Uint8>(i * 16));
+        }
+        checkLoad("KTX ETC2 mipmaps", etc2, sf3d::CompressedImage::Etc2Rgba, sf3d::Vector2u(4, 4), 3);
+
+        sf3d::CompressedImage image;
+        image.loadFromMemory(&etc2[0], etc2.size());
+        if ((image.getLevelCount() == 3) && (image.getLevelData(2)[0] != 32))
+            fail("KTX ETC2 mipmaps", "wrong level data");
+
+        // Big endian file
+        std::vector<sf3d::Uint8> bigEndian = ktxHeader(0x83F3, 4, 4, 1, 0, 1, true);
+        writeSwapped(bigEndian, 16);
+        writeLevel(bigEndian, 16, 0);
+        checkLoad("KTX big endian", bigEndian, sf3d::CompressedImage::Bc3, sf3d::Vector2u(4, 4), 1);
+
+        // Malformed headers
+        std::vector<sf3d::Uint8> malformed = ktxHeader(0x8C4C, 4, 4, 1);
+        write(malformed, 8);
+        writeLevel(malformed, 8, 0);
+        checkReject("KTX unsupported internal format", malformed);
+
+        malformed = ktxHeader(0x83F1, 4, 4, 1, 0, 6);
+        write(malformed, 8);
+        writeLevel(malformed, 8 * 6, 0);
+        checkReject("KTX cube map", malformed);
+
+        malformed = ktxHeader(0x83F1, 4, 4, 1);
+        malformed[12] = 0x05;
+        write(malformed, 8);
+        writeLevel(malformed, 8, 0);
+        checkReject("KTX invalid endianness", malformed);
+
+        malformed = ktxHeader(0x83F1, 4, 4, 1, 0xFFFFFFF0);
+        write(malformed, 8);
+        writeLevel(malformed, 8, 0);
+        checkReject("KTX key/value data past the end", malformed);
+
+        malformed = ktxHeader(0x83F1, 8, 8, 1);
+        write(malformed, 8);
+        writeLevel(malformed, 32, 0);
+        checkReject("KTX level size too small", malformed);
+
+        malformed = ktxHeader(0x83F1, 4, 4, 1);
+        write(malformed, 0xFFFFFFFF);
+        writeLevel(malformed, 8, 0);
+        checkReject("KTX level size past the end", malformed);
+
+        malformed = ktxHeader(0x83F1, 0xFFFFFFFF, 4, 1);
+        write(malformed, 8);
+        writeLevel(malformed, 8, 0);
+        checkReject("KTX overflowing width", malformed);
+    }
+
+    void testContainers()
+    {
+        std::vector<sf3d::Uint8> data;
+        checkReject("no data", data);
+
+        data.assign(3, 'D');
+        checkReject("3 bytes", data);
+
+        data.assign(256, 0);
+        std::memcpy(&data[0], "PNG ", 4);
+        checkReject("unknown container", data);
+    }
+
+    // Compress an image, save it in both containers and load it back
+    void testSaveAndLoad()
+    {
+        sf3d::Image source;
+        source.create(37, 21);
+        for (unsigned int y = 0; y < 21; ++y)
+            for (unsigned int x = 0; x < 37; ++x)
+                source.setPixel(x, y, sf3d::Color(x * 7, y * 12, 128, (x + y) % 2 ? 255 : 0));
+
+        const sf3d::CompressedImage::Format formats[2] = {sf3d::CompressedImage::Bc1, sf3d::CompressedImage::Bc3};
+        const char* extensions[2] = {".dds", ".ktx"};
+        for (int i = 0; i < 2; ++i)
+        {
+            sf3d::CompressedImage compressed;
+            if (!compressed.compress(source, formats[i]))
+            {
+                fail("save and load", "compression failed");
+                continue;
+            }
+
+            // 37x21 down to 1x1 is 6 levels
+            if (compressed.getLevelCount() != 6)
+                fail("save and load", "wrong number of mipmaps");
+
+            for (int j = 0; j < 2; ++j)
+            {
+                std::string filename = std::string("test-compressed-image") + extensions[j];
+                sf3d::CompressedImage loaded;
+                if (!compressed.saveToFile(filename) || !loaded.loadFromFile(filename))
+                {
+                    fail(filename, "save or load failed");
+                    continue;
+                }
+                std::remove(filename.c_str());
+
+                if ((loaded.getFormat() != compressed.getFormat()) || (loaded.getSize() != compressed.getSize()) ||
+                    (loaded.getLevelCount() != compressed.getLevelCount()))
+                {
+                    fail(filename, "different properties after loading");
+                    continue;
+                }
+
+                for (unsigned int level = 0; level < loaded.getLevelCount(); ++level)
+                {
+                    if ((loaded.getLevelDataSize(level) != compressed.getLevelDataSize(level)) ||
+                        (std::memcmp(loaded.getLevelData(level), compressed.getLevelData(level), loaded.getLevelDataSize(level)) != 0))
+                        fail(filename, "different level data after loading");
+                }
+
+                // Decompression gives an image of the size of the level
+                if (loaded.decompress(1).getSize() != sf3d::Vector2u(18, 10))
+                    fail(filename, "wrong size of a decompressed level");
+            }
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+/// Entry point of the test
+///
+/// \return EXIT_SUCCESS if the valid files are loaded and
+///         the invalid ones are rejected
+///
+////////////////////////////////////////////////////////////
+int main()
+{
+    // The rejected files are expected to print errors
+    sf3d::err().rdbuf(NULL);
+
+    testContainers();
+    testDds();
+    testKtx();
+    testSaveAndLoad();
+
+    if (failures)
+    {
+        std::cout << failures << " compressed image checks failed" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,197 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/Graphics/ImageKernels.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+
+namespace
+{
+    // Number of failed checks
+    unsigned int failures = 0;
+
+    // Random pixels; a small palette makes equal colors and the
+    // extreme alpha values (0 and 255) frequent
+    std::vector<sf3d::Uint8> randomPixels(std::size_t count, bool palette = false)
+    {
+        const sf3d::Uint8 values[4] = {0, 1, 254, 255};
+        std::vector<sf3d::Uint8> pixels(count * 4);
+        for (std::size_t i = 0; i < pixels.size(); ++i)
+            pixels[i] = palette ? values[std::rand() % 4] : static_cast<sf3d::Uint8>(std::rand());
+        return pixels;
+    }
+
+    // Compare the outputs of the SIMD and scalar paths byte for byte
+    void check(const char* kernel, unsigned int width, unsigned int height, const std::vector<sf3d::Uint8>& simd, const std::vector<sf3d::Uint8>& scalar)
+    {
+        for (std::size_t i = 0; i < simd.size(); ++i)
+        {
+            if (simd[i] != scalar[i])
+            {
+                std::cout << kernel << " (" << width << "x" << height << "): byte " << i << " is "
+                          << static_cast<int>(simd[i]) << " with SIMD and " << static_cast<int>(scalar[i]) << " without" << std::endl;
+                ++failures;
+                return;
+            }
+        }
+    }
+
+    // Run an in-place kernel with and without SIMD on copies of the same pixels
+    template <typename Kernel>
+    void checkInPlace(const char* kernel, unsigned int width, unsigned int height, const std::vector<sf3d::Uint8>& pixels, Kernel run)
+    {
+        std::vector<sf3d::Uint8> simd = pixels;
+        std::vector<sf3d::Uint8> scalar = pixels;
+
+        sf3d::priv::setSimdEnabled(true);
+        run(simd);
+        sf3d::priv::setSimdEnabled(false);
+        run(scalar);
+
+        check(kernel, width, height, simd, scalar);
+    }
+
+    struct MaskColor
+    {
+        void operator ()(std::vector<sf3d::Uint8>& pixels) const
+        {
+            const sf3d::Uint8 color[4] = {255, 0, 255, 255};
+            sf3d::priv::maskColor(&pixels[0], pixels.size() / 4, color, 0);
+        }
+    };
+
+    struct BlendPixels
+    {
+        const std::vector<sf3d::Uint8>* source;
+
+        void operator ()(std::vector<sf3d::Uint8>& pixels) const
+        {
+            sf3d::priv::blendPixels(&(*source)[0], &pixels[0], pixels.size() / 4);
+        }
+    };
+
+    struct ReversePixels
+    {
+        void operator ()(std::vector<sf3d::Uint8>& pixels) const
+        {
+            sf3d::priv::reversePixels(&pixels[0], pixels.size() / 4);
+        }
+    };
+
+    struct SwapPixels
+    {
+        void operator ()(std::vector<sf3d::Uint8>& pixels) const
+        {
+            std::size_t half = pixels.size() / 8;
+            sf3d::priv::swapPixels(&pixels[0], &pixels[half * 4], half);
+        }
+    };
+
+    struct PremultiplyAlpha
+    {
+        void operator ()(std::vector<sf3d::Uint8>& pixels) const
+        {
+            sf3d::priv::premultiplyAlpha(&pixels[0], pixels.size() / 4);
+        }
+    };
+
+    // Run a kernel that writes to a separate destination with and without SIMD
+    template <typename Kernel>
+    void checkResize(const char* kernel, unsigned int width, unsigned int height, unsigned int destinationWidth, unsigned int destinationHeight, Kernel run)
+    {
+        std::vector<sf3d::Uint8> source = randomPixels(width * height);
+        std::vector<sf3d::Uint8> simd(destinationWidth * destinationHeight * 4);
+        std::vector<sf3d::Uint8> scalar(simd.size());
+
+        sf3d::priv::setSimdEnabled(true);
+        run(&source[0], width, height, &simd[0], destinationWidth, destinationHeight);
+        sf3d::priv::setSimdEnabled(false);
+        run(&source[0], width, height, &scalar[0], destinationWidth, destinationHeight);
+
+        check(kernel, width, height, simd, scalar);
+    }
+
+    void downsampleBox2D(const sf3d::Uint8* source, unsigned int width, unsigned int height, sf3d::Uint8* destination, unsigned int, unsigned int)
+    {
+        sf3d::priv::downsampleBox(source, width, height, destination);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+/// Entry point of the test
+///
+/// \return EXIT_SUCCESS if the SIMD and scalar paths of every
+///         kernel give the same results
+///
+////////////////////////////////////////////////////////////
+int main()
+{
+    std::srand(42);
+
+    // Odd sizes exercise the scalar tails after the SIMD loops
+    const unsigned int sizes[][2] = {{1, 1}, {1, 7}, {2, 2}, {3, 5}, {7, 1}, {16, 16}, {33, 17}, {127, 65}, {256, 3}};
+    const std::size_t sizeCount = sizeof(sizes) / sizeof(sizes[0]);
+
+    for (std::size_t i = 0; i < sizeCount; ++i)
+    {
+        unsigned int width = sizes[i][0];
+        unsigned int height = sizes[i][1];
+        std::size_t count = width * height;
+
+        checkInPlace("maskColor", width, height, randomPixels(count, true), MaskColor());
+        checkInPlace("premultiplyAlpha", width, height, randomPixels(count), PremultiplyAlpha());
+        checkInPlace("premultiplyAlpha (extremes)", width, height, randomPixels(count, true), PremultiplyAlpha());
+        checkInPlace("reversePixels", width, height, randomPixels(count), ReversePixels());
+        checkInPlace("swapPixels", width, height, randomPixels(count), SwapPixels());
+
+        std::vector<sf3d::Uint8> source = randomPixels(count);
+        BlendPixels blend = {&source};
+        checkInPlace("blendPixels", width, height, randomPixels(count), blend);
+        std::vector<sf3d::Uint8> extremes = randomPixels(count, true);
+        BlendPixels blendExtremes = {&extremes};
+        checkInPlace("blendPixels (extremes)", width, height, randomPixels(count), blendExtremes);
+
+        checkResize("downsampleBox", width, height, width > 1 ? width / 2 : 1, height > 1 ? height / 2 : 1, downsampleBox2D);
+
+        // Minification, magnification and both at once
+        const unsigned int scales[][2] = {{1, 3}, {3, 1}, {1, 1}, {5, 2}, {2, 5}};
+        for (std::size_t j = 0; j < sizeof(scales) / sizeof(scales[0]); ++j)
+        {
+            unsigned int destinationWidth = std::max(width * scales[j][0] / scales[j][1], 1u);
+            unsigned int destinationHeight = std::max(height * scales[j][1] / scales[j][0], 1u);
+            checkResize("resizeBilinear", width, height, destinationWidth, destinationHeight, sf3d::priv::resizeBilinear);
+            checkResize("resizeBox", width, height, destinationWidth, destinationHeight, sf3d::priv::resizeBox);
+        }
+
+        // 3D box filter, with depths of 1 and odd ones
+        for (unsigned int depth = 1; depth <= 5; depth += 2)
+        {
+            std::vector<sf3d::Uint8> volume = randomPixels(count * depth);
+            std::size_t destinationCount = (width > 1 ? width / 2 : 1) * (height > 1 ? height / 2 : 1) * (depth > 1 ? depth / 2 : 1);
+            std::vector<sf3d::Uint8> simd(destinationCount * 4);
+            std::vector<sf3d::Uint8> scalar(destinationCount * 4);
+
+            sf3d::priv::setSimdEnabled(true);
+            sf3d::priv::downsampleBox(&volume[0], width, height, depth, &simd[0]);
+            sf3d::priv::setSimdEnabled(false);
+            sf3d::priv::downsampleBox(&volume[0], width, height, depth, &scalar[0]);
+
+            check("downsampleBox (3D)", width, height, simd, scalar);
+        }
+    }
+
+    sf3d::priv::setSimdEnabled(true);
+
+    if (failures)
+    {
+        std::cout << failures << " kernel checks failed" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "The SIMD and scalar paths of all the kernels match" << std::endl;
+    return EXIT_SUCCESS;
+}
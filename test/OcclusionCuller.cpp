@@ -0,0 +1,106 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/Graphics.hpp>
+#include <cstdlib>
+#include <iostream>
+
+
+namespace
+{
+    // Number of failed checks
+    unsigned int failures = 0;
+
+    // Compare the visibility of a box with the expected one
+    void checkVisibility(const sf3d::OcclusionCuller& culler, const char* test, const sf3d::FloatBox& box, bool expected)
+    {
+        if (culler.isVisible(box) != expected)
+        {
+            std::cout << test << ": reported " << (expected ? "hidden" : "visible")
+                      << ", expected " << (expected ? "visible" : "hidden") << std::endl;
+            ++failures;
+        }
+    }
+
+    // Compare a counter with the expected value
+    void checkCount(const char* test, unsigned int count, unsigned int expected)
+    {
+        if (count != expected)
+        {
+            std::cout << test << ": " << count << ", expected " << expected << std::endl;
+            ++failures;
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+/// Entry point of the test
+///
+/// The camera is at the origin and looks down the -Z axis,
+/// a 1x1 wall stands 5 units in front of it. The culler
+/// doesn't need a window, only the boxes are tested.
+///
+/// \return EXIT_SUCCESS if every box gets the expected visibility
+///
+////////////////////////////////////////////////////////////
+int main()
+{
+    sf3d::Camera camera(90.f, 0.1f, 100.f);
+
+    sf3d::Cuboid wall(sf3d::Vector3f(1.f, 1.f, 0.5f));
+    wall.setPosition(0.f, 0.f, -5.f);
+
+    sf3d::OcclusionCuller culler;
+    culler.setThreadCount(1);
+    culler.addOccluder(wall);
+    culler.update(camera);
+
+    // A cuboid has 6 faces of 2 triangles, all in front of the camera
+    checkCount("occluder triangles", culler.getTriangleCount(), 12);
+
+    checkVisibility(culler, "box in front of the wall", sf3d::FloatBox(-0.2f, -0.2f, -3.5f, 0.4f, 0.4f, 0.4f), true);
+    checkVisibility(culler, "box behind the wall", sf3d::FloatBox(-0.2f, -0.2f, -11.f, 0.4f, 0.4f, 0.4f), false);
+    checkVisibility(culler, "box crossing the wall", sf3d::FloatBox(-0.2f, -0.2f, -6.f, 0.4f, 0.4f, 2.f), true);
+    checkVisibility(culler, "wide box behind the wall", sf3d::FloatBox(-3.f, -0.2f, -12.f, 6.f, 0.4f, 0.4f), true);
+    checkVisibility(culler, "box beside the wall", sf3d::FloatBox(1.5f, -0.2f, -8.f, 0.4f, 0.4f, 0.4f), true);
+    checkVisibility(culler, "box above the wall", sf3d::FloatBox(-0.2f, 1.5f, -8.f, 0.4f, 0.4f, 0.4f), true);
+    checkVisibility(culler, "box outside the view", sf3d::FloatBox(50.f, -0.2f, -6.f, 0.4f, 0.4f, 0.4f), false);
+    checkVisibility(culler, "box beyond the far plane", sf3d::FloatBox(-0.2f, -0.2f, -200.f, 0.4f, 0.4f, 0.4f), false);
+    checkVisibility(culler, "box around the camera", sf3d::FloatBox(-1.f, -1.f, -1.f, 2.f, 2.f, 2.f), true);
+
+    checkCount("tested boxes", culler.getTestedCount(), 9);
+    checkCount("culled boxes", culler.getCulledCount(), 3);
+
+    // Moving the camera beside the wall reveals the box behind it
+    camera.setPosition(10.f, 0.f, 0.f);
+    camera.setDirection(-1.f, 0.f, -1.f);
+    culler.update(camera);
+    checkVisibility(culler, "box behind the wall, seen from the side", sf3d::FloatBox(-0.2f, -0.2f, -11.f, 0.4f, 0.4f, 0.4f), true);
+    checkCount("tested boxes after an update", culler.getTestedCount(), 1);
+
+    // Without occluders, only the boxes outside the view are hidden
+    camera.setPosition(0.f, 0.f, 0.f);
+    camera.setDirection(0.f, 0.f, -1.f);
+    culler.removeOccluder(wall);
+    culler.update(camera);
+    checkCount("triangles without occluders", culler.getTriangleCount(), 0);
+    checkVisibility(culler, "box behind the removed wall", sf3d::FloatBox(-0.2f, -0.2f, -11.f, 0.4f, 0.4f, 0.4f), true);
+    checkVisibility(culler, "box outside the view without occluders", sf3d::FloatBox(50.f, -0.2f, -6.f, 0.4f, 0.4f, 0.4f), false);
+
+    // The result doesn't depend on the resolution or the number of threads
+    culler.addOccluder(wall);
+    culler.setResolution(61, 37);
+    culler.setThreadCount(0);
+    culler.update(camera);
+    checkVisibility(culler, "box behind the wall, odd resolution", sf3d::FloatBox(-0.2f, -0.2f, -11.f, 0.4f, 0.4f, 0.4f), false);
+    checkVisibility(culler, "box in front of the wall, odd resolution", sf3d::FloatBox(-0.2f, -0.2f, -3.5f, 0.4f, 0.4f, 0.4f), true);
+
+    if (failures)
+    {
+        std::cout << failures << " occlusion culling checks failed" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
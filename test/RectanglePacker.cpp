@@ -0,0 +1,149 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML3D/Graphics/RectanglePacker.hpp>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+
+namespace
+{
+    // Number of failed checks
+    unsigned int failures = 0;
+
+    // Report a failed check
+    void fail(const char* test, const char* message, std::size_t index)
+    {
+        std::cout << test << ": " << message << " (rectangle " << index << ")" << std::endl;
+        ++failures;
+    }
+
+    // Fill an area with random rectangles until the packer has refused
+    // a number of them in a row, and check every placement
+    void packRandom(const char* test, unsigned int size, unsigned int maxSide, bool allowRotation)
+    {
+        sf3d::priv::RectanglePacker packer;
+        packer.reset(size, size);
+
+        std::vector<sf3d::IntRect> placed;
+        std::size_t usedArea = 0;
+        unsigned int refused = 0;
+        while (refused < 50)
+        {
+            unsigned int width = 1 + std::rand() % maxSide;
+            unsigned int height = 1 + std::rand() % maxSide;
+
+            sf3d::IntRect rectangle;
+            bool rotated = false;
+            if (!packer.insert(width, height, allowRotation, rectangle, rotated))
+            {
+                ++refused;
+                continue;
+            }
+
+            refused = 0;
+            std::size_t index = placed.size();
+
+            // Size, swapped when rotated
+            unsigned int expectedWidth = rotated ? height : width;
+            unsigned int expectedHeight = rotated ? width : height;
+            if (rotated && !allowRotation)
+                fail(test, "rotated without being allowed to", index);
+            if ((rectangle.width != static_cast<int>(expectedWidth)) || (rectangle.height != static_cast<int>(expectedHeight)))
+                fail(test, "wrong size", index);
+
+            // Bounds
+            if ((rectangle.left < 0) || (rectangle.top < 0) ||
+                (rectangle.left + rectangle.width > static_cast<int>(size)) ||
+                (rectangle.top + rectangle.height > static_cast<int>(size)))
+                fail(test, "out of the area", index);
+
+            // Overlaps with the previous rectangles
+            for (std::size_t i = 0; i < placed.size(); ++i)
+            {
+                if (placed[i].intersects(rectangle))
+                {
+                    fail(test, "overlaps a previous rectangle", index);
+                    break;
+                }
+            }
+
+            placed.push_back(rectangle);
+            usedArea += width * height;
+        }
+
+        // Occupancy
+        float occupancy = static_cast<float>(usedArea) / (size * size);
+        if (std::fabs(packer.getOccupancy() - occupancy) > 0.0001f)
+        {
+            std::cout << test << ": occupancy is " << packer.getOccupancy() << ", expected " << occupancy << std::endl;
+            ++failures;
+        }
+
+        std::cout << test << ": " << placed.size() << " rectangles, " << occupancy * 100.f << "% occupancy" << std::endl;
+
+        // Reset
+        packer.reset(size, size);
+        if (packer.getOccupancy() != 0.f)
+            fail(test, "occupancy is not 0 after a reset", 0);
+    }
+
+    // Check the edge cases of insert
+    void packEdgeCases()
+    {
+        sf3d::priv::RectanglePacker packer;
+        sf3d::IntRect rectangle;
+        bool rotated = false;
+
+        // Empty packer and empty rectangles
+        if (packer.insert(1, 1, false, rectangle, rotated))
+            fail("edge cases", "inserted into an empty area", 0);
+        packer.reset(64, 32);
+        if (packer.insert(0, 4, true, rectangle, rotated))
+            fail("edge cases", "inserted an empty rectangle", 0);
+
+        // Only fits rotated
+        if (packer.insert(16, 48, false, rectangle, rotated))
+            fail("edge cases", "inserted a rectangle taller than the area", 0);
+        if (!packer.insert(16, 48, true, rectangle, rotated) || !rotated)
+            fail("edge cases", "did not rotate a rectangle that only fits rotated", 0);
+
+        // Exactly fills the rest
+        if (!packer.insert(16, 32, false, rectangle, rotated) || (rectangle != sf3d::IntRect(48, 0, 16, 32)))
+            fail("edge cases", "did not place a rectangle in the free column exactly", 0);
+        if (!packer.insert(48, 16, false, rectangle, rotated) || (rectangle != sf3d::IntRect(0, 16, 48, 16)))
+            fail("edge cases", "did not fill the remaining area exactly", 0);
+        if (packer.getOccupancy() != 1.f)
+            fail("edge cases", "occupancy of a full area is not 1", 0);
+        if (packer.insert(1, 1, true, rectangle, rotated))
+            fail("edge cases", "inserted into a full area", 0);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+/// Entry point of the test
+///
+/// \return EXIT_SUCCESS if all the placements are valid
+///
+////////////////////////////////////////////////////////////
+int main()
+{
+    std::srand(42);
+
+    packEdgeCases();
+    packRandom("small rectangles", 512, 32, false);
+    packRandom("small rectangles, rotated", 512, 32, true);
+    packRandom("large rectangles", 1024, 256, false);
+    packRandom("large rectangles, rotated", 1024, 256, true);
+
+    if (failures)
+    {
+        std::cout << failures << " packing checks failed" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}